@@ -6,80 +6,79 @@
 #include "xipslib.h"
 #include "unzipLIB.h"
 
+#include "JobQueue.h"
+#include "CopyJournal.h"
+#include "Trash.h"
+#include "DirCache.h"
+#include "SizeService.h"
+#include "VolumeInfo.h"
+#include "DiskUsage.h"
+#include "DebugPrint.h"
+
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
 #include <ctype.h>   // toupper
+#include <map>
 
 /*
 ============================================================================
  AppActions
   - Centralized execution of menu actions for FileBrowserApp
-  - Cancel-aware copy/move with a "press B twice to cancel" toast window
+  - Copy/move/delete/unzip are split in two: Execute() validates and builds a
+    Job on the UI thread, the Run*Job() functions do the I/O on the JobQueue
+    worker. Results come back as JobQueue events handled in FrameMove.
   - Uses FsUtil.* helpers for I/O and FileBrowserApp methods for UI refresh
 ============================================================================
 */
 
-// ---- Cancel-aware progress context + thunk ---------------------------------
-// CopyProgCtx: tracks progress, cancel state, and the 2-press B confirmation.
-// The "toast window" behavior:
-//   1) First B press shows "Press B again to cancel" and arms a window.
-//   2) If the second B happens while the toast is still visible, we cancel.
-//   3) If toast expires before second B, the next B just re-arms the window.
-struct CopyProgCtx {
-    FileBrowserApp* app;
+// ---- Worker-side progress context + thunk ----------------------------------
+// Copy/move/delete/unzip run on the JobQueue worker thread. The engines report
+// through the global CopyProgressFn; this thunk forwards that to the UI event
+// ring and turns a pending cancel request into a "stop" return value.
+struct JobProgCtx {
     ULONGLONG base;        // bytes completed from previous items (offset)
-    bool      canceled;    // set when user confirms cancel
-
-    // confirmation state (toast window)
-    bool      confirmArmed;   // true after the first B press
-    DWORD     confirmUntil;   // snapshot of when the toast will expire (informational)
-    bool      prevB;          // for rising-edge detection of B
+    bool      canceled;    // latched once the UI asked us to stop
 };
 
-// Progress callback used by file copy/move loops.
-// - Pumps gamepad input to detect B presses
-// - Updates the app's progress overlay
-// - Implements the "press B twice" cancel logic
-static bool CopyProgThunk(ULONGLONG done, ULONGLONG total, const char* label, void* user){
-    CopyProgCtx* c = (CopyProgCtx*)user;
-
-    // Poll controller to read B presses while copying
-    XBInput_GetInput();
-    const XBGAMEPAD& pad = g_Gamepads[0];
-    const bool  bNow = (pad.bAnalogButtons[XINPUT_GAMEPAD_B] > 30);
-    const DWORD now  = GetTickCount();
-
-    // Paint progress (done is per-current-item, base is previous items)
-    c->app->UpdateProgress(c->base + done, total, label);
-
-    // Rising-edge B?
-    if (bNow && !c->prevB){
-        const DWORD statusUntil = c->app->StatusUntilMs();
-        const bool  toastAlive  = (now < statusUntil);
-
-        if (c->confirmArmed && toastAlive){
-            // Second B while the toast is still up => cancel
-            c->canceled = true;
-            SetLastError(ERROR_OPERATION_ABORTED);
-            c->prevB = bNow;
-            return false; // abort copy/move
-        } else {
-            // First B: arm and show "press B again" toast
-            c->confirmArmed = true;
-            c->app->SetStatus("Press B again to cancel");
-            c->confirmUntil = c->app->StatusUntilMs(); // snapshot (optional)
-        }
-    }
+static bool JobProgThunk(ULONGLONG done, ULONGLONG total, const char* label, void* user){
+    JobProgCtx* c = (JobProgCtx*)user;
 
-    // Disarm if toast has expired
-    if (c->confirmArmed && now >= c->app->StatusUntilMs()){
-        c->confirmArmed = false;
-    }
+    // Publish progress (done is per-current-item, base is previous items)
+    JobQueue::PostProgress(c->base + done, total, label);
 
-    c->prevB = bNow;
+    if (JobQueue::CancelRequested()){
+        c->canceled = true;
+        SetLastError(ERROR_OPERATION_ABORTED);
+        return false; // abort copy/move/extract
+    }
     return true; // keep going
 }
 
+// printf-style write of the job's final toast text.
+static void SetSummary(Job& j, const char* fmt, ...){
+    va_list ap; va_start(ap, fmt);
+    _vsnprintf(j.summary, sizeof(j.summary), fmt, ap);
+    va_end(ap);
+    j.summary[sizeof(j.summary)-1] = 0;
+}
+
+// Append ", 4.20 GB in 3:12, 22.00 MB/s" from the finished phase's statistics.
+static void AppendRate(Job& j){
+    const JobStats& st = JobQueue::Stats();
+    if (!st.isBytes || !st.moved) return;
+
+    char sz[32];   FormatSize(st.moved, sz, sizeof(sz));
+    char rate[32]; FormatSize(st.elapsedMs ? st.moved * 1000 / st.elapsedMs : st.moved, rate, sizeof(rate));
+    const unsigned long secs = st.elapsedMs / 1000;
+
+    const size_t n = strlen(j.summary);
+    if (n + 1 >= sizeof(j.summary)) return;
+    _snprintf(j.summary + n, sizeof(j.summary) - n, ", %s in %lu:%02lu, %s/s",
+              sz, secs / 60, secs % 60, rate);
+    j.summary[sizeof(j.summary)-1] = 0;
+}
+
 // ---- local helpers ----------------------------------------------------------
 
 // Return 1 if both paths are on the same drive letter (case-insensitive).
@@ -409,63 +408,800 @@ namespace AppActions {
 // - Else returns the single current selection (if not "..").
 // - Writes full paths (dir + name) into 'out'.
 static void GatherMarkedOrSelectedFullPaths(const Pane& src, std::vector<std::string>& out) {
-    if (src.mode != 1 || src.items.empty()) return;
+    const Listing& L = src.items;
+    if (src.mode != 1 || L.Empty()) return;
 
     bool any = false;
-    for (size_t i=0; i<src.items.size(); ++i) {
-        const Item& it = src.items[i];
-        if (it.marked && !it.isUpEntry) {
-            char full[512]; JoinPath(full, sizeof(full), src.curPath, it.name);
+    for (size_t i=0; i<L.Count(); ++i) {
+        if (L.Marked(i) && !L.IsUpEntry(i)) {
+            char full[512]; JoinPath(full, sizeof(full), src.curPath, L.Name(i));
             out.push_back(full);
             any = true;
         }
     }
     if (!any) {  // fall back to single selection
-        const Item& sel = src.items[src.sel];
-        if (!sel.isUpEntry) {
-            char full[512]; JoinPath(full, sizeof(full), src.curPath, sel.name);
+        if (!L.IsUpEntry(src.sel)) {
+            char full[512]; JoinPath(full, sizeof(full), src.curPath, L.Name(src.sel));
             out.push_back(full);
         }
     }
 }
 
+// ============================================================================
+// Job runners (JobQueue worker thread)
+//  - Never touch FileBrowserApp/Pane state here; talk to the UI only through
+//    JobQueue::Post*() and the job's summary.
+// ============================================================================
+
+// Cursor for a journaled job, positioned at the start of roots[root].
+static CopyCursor FreshCursor(const OpManifest& man, size_t root){
+    CopyCursor c;
+    c.entry  = (root < man.roots.size()) ? man.roots[root].first : man.entries.size();
+    c.offset = 0;
+    c.fn     = CopyJournal::OnCheckpoint;
+    c.user   = NULL;
+    return c;
+}
+
+// Bytes of whole roots before 'root' (progress base on resume).
+static ULONGLONG RootsBytesBefore(const OpManifest& man, size_t root){
+    ULONGLONG sum = 0;
+    for (size_t i=0; i<root && i<man.roots.size(); ++i) sum += man.roots[i].bytes;
+    return sum;
+}
+
+// Cluster size of the volume holding 'dir' (VolumeInfo, else asked directly).
+static DWORD DestClusterBytes(const char* dir){
+    VolumeInfo::Info vi;
+    if (VolumeInfo::Get(dir, vi) && vi.clusterBytes) return vi.clusterBytes;
+    const char root[4] = { dir[0], ':', '\\', 0 };
+    return XGetDiskClusterSize(root);
+}
+
+// ---- Copy -------------------------------------------------------------------
+// Shared by a fresh copy and a journal resume (resumeAt != NULL: start at
+// roots[startRoot] from the saved cursor).
+static void CopyManifestJob(Job& j, const OpManifest& man, size_t startRoot, const CopyCursor* resumeAt){
+    const std::vector<std::string>& srcs = j.srcs;
+    const char* dstDir = j.dstDir;
+    const ULONGLONG total = man.totalBytes;
+    const DWORD cluster = DestClusterBytes(dstDir);
+
+    // Large copies keep a journal so cancel / power loss can be resumed
+    const bool journaled = resumeAt ||
+        (total >= CopyJournal::kMinBytes && CopyJournal::Begin(j, man));
+    CopyCursor cur = resumeAt ? *resumeAt : FreshCursor(man, startRoot);
+    CopyVerify ver;
+
+    JobQueue::PostBegin(total, srcs[startRoot < srcs.size() ? startRoot : 0].c_str(), j.title);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    ULONGLONG base = RootsBytesBefore(man, startRoot);  // cumulative bytes completed
+    char lastDstTop[512] = {0};   // for cancel cleanup
+
+    // Track results so the final toast reflects reality
+    size_t copiedOk = 0, failed = 0, skipped = 0;
+
+    for (size_t i=startRoot;i<srcs.size();++i){
+        if (JobQueue::CancelRequested()) { ctx.canceled = true; break; }
+
+        const char* sp = srcs[i].c_str();
+        const bool resumingThis = (resumeAt && i == startRoot);
+        if (journaled && !resumingThis){
+            cur = FreshCursor(man, i);
+            CopyJournal::BeginRoot(i, cur.entry);
+        }
+
+        // Compute top-level destination path (dstDir\basename(sp)) for cleanup
+        const char* bn = BaseNameOf(sp);
+        JoinPath(lastDstTop, sizeof(lastDstTop), dstDir, bn);
+
+        ULONGLONG thisSize = man.roots[i].bytes;
+        ctx.base = base;
+
+        // --- prevent copying a folder into its own subfolder (or itself) ---
+        if (IsSubPathCaseI(sp, lastDstTop)) {
+            JobQueue::PostStatus("Cannot copy a folder into its own subfolder");
+            ++skipped;
+            if (journaled) CopyJournal::EndRoot(i, man);
+            continue; // skip this item, proceed to next
+        }
+
+        // --- per-item free-space check (extra safety) ---
+        {
+            // A resumed item already has part of its bytes in place
+            const ULONGLONG onDisk = ManifestOnDiskBytes(man, i, 1, cluster);
+            const ULONGLONG done   = resumingThis ? ManifestBytesBefore(man, i, cur.entry, cur.offset) : 0;
+            const ULONGLONG need   = (onDisk > done) ? onDisk - done : 0;
+            ULONGLONG freeB=0, totB=0;
+            GetDriveFreeTotal(lastDstTop, freeB, totB); // any path on dest volume is fine
+            if (need > freeB) {
+                char needS[64], have[64];
+                FormatSize(need,  needS, sizeof(needS));
+                FormatSize(freeB, have,  sizeof(have));
+                SetSummary(j, "Not enough space for %s: need %s, have %s", bn, needS, have);
+                break; // stop the whole batch (change to 'continue;' to try remaining items)
+            }
+        }
+        // --- end per-item check ---
+
+        if (!CopyManifestRootA(man, i, dstDir, total, journaled ? &cur : NULL,
+                               j.verify ? &ver : NULL)){
+            if (ctx.canceled){
+                // Journaled: keep what is there for resume. Otherwise remove
+                // the partial destination of the current item, then stop.
+                if (!journaled) DeleteRecursiveA(lastDstTop);
+                break;
+            }
+            // Non-cancel failure
+            ++failed;
+        } else {
+            ++copiedOk;
+        }
+        base += thisSize;
+        if (journaled) CopyJournal::EndRoot(i, man);
+    }
+
+    // Clear callback
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled){
+        j.canceled = true;
+        if (journaled){
+            CopyJournal::Suspend();
+            SetSummary(j, "Copy paused (%u done) - resume from menu", (unsigned)copiedOk);
+        } else {
+            SetSummary(j, "Copy canceled (%u done, %u skipped, %u failed)",
+                       (unsigned)copiedOk, (unsigned)skipped, (unsigned)failed);
+        }
+        return;
+    }
+    if (j.summary[0]) { if (journaled) CopyJournal::Suspend(); return; } // batch stopped early; keep the reason
+    if (journaled) CopyJournal::Finish();
+
+    // Verify failures outrank everything else in the toast
+    if (!ver.mismatched.empty()) {
+        for (size_t k=0; k<ver.mismatched.size(); ++k)
+            XBUtil_DebugPrint("Verify: mismatch %s", ver.mismatched[k].c_str());
+        SetSummary(j, "VERIFY FAILED: %u of %u file(s) differ, first: %s",
+                   (unsigned)ver.mismatched.size(), ver.checked, BaseNameOf(ver.mismatched[0].c_str()));
+        return;
+    }
+    if (!ver.unreadable.empty()) {
+        for (size_t k=0; k<ver.unreadable.size(); ++k)
+            XBUtil_DebugPrint("Verify: cannot read back %s", ver.unreadable[k].c_str());
+        SetSummary(j, "VERIFY FAILED: %u file(s) could not be read back, first: %s",
+                   (unsigned)ver.unreadable.size(), BaseNameOf(ver.unreadable[0].c_str()));
+        return;
+    }
+
+    // Final toast that reflects what actually happened
+    if (failed==0 && skipped==0 && j.verify) {
+        SetSummary(j, "Copied %u item(s), %u file(s) verified", (unsigned)copiedOk, ver.checked);
+    } else if (failed==0 && skipped==0) {
+        SetSummary(j, "Copied %u item(s)", (unsigned)copiedOk);
+    } else {
+        SetSummary(j, "Copied %u, %u skipped, %u failed",
+                   (unsigned)copiedOk, (unsigned)skipped, (unsigned)failed);
+    }
+    AppendRate(j);
+}
+
+static void RunCopyJob(Job& j){
+    // One walk per source: feeds the total, preflight, accounting and the copy
+    OpManifest man;
+    BuildManifestA(j.srcs, man);
+
+    // --- preflight free-space check on destination (clusters, not bytes) ---
+    {
+        const ULONGLONG onDisk = ManifestOnDiskBytes(man, 0, man.roots.size(), DestClusterBytes(j.dstDir));
+        ULONGLONG freeB=0, totB=0;
+        GetDriveFreeTotal(j.dstDir, freeB, totB);
+        if (onDisk > freeB){
+            char need[64], have[64];
+            FormatSize(onDisk, need, sizeof(need));
+            FormatSize(freeB, have, sizeof(have));
+            SetSummary(j, "Not enough space: need %s, have %s", need, have);
+            return;
+        }
+    }
+    // --- end preflight ---
+
+    CopyManifestJob(j, man, 0, NULL);
+}
+
+// ---- Move -------------------------------------------------------------------
+// Shared by a fresh move and a journal resume (see CopyManifestJob).
+static void MoveManifestJob(Job& j, const OpManifest& man, size_t startRoot, const CopyCursor* resumeAt){
+    const std::vector<std::string>& srcs = j.srcs;
+    const char* dstDir = j.dstDir;
+    const ULONGLONG total = man.totalBytes;
+
+    // Only cross-volume moves copy data, so only those are journaled
+    const bool sameVol = SameDriveLetter(j.srcDir, dstDir) != 0;
+    const bool journaled = resumeAt ||
+        (!sameVol && total >= CopyJournal::kMinBytes && CopyJournal::Begin(j, man));
+    CopyCursor cur = resumeAt ? *resumeAt : FreshCursor(man, startRoot);
+
+    JobQueue::PostBegin(total, srcs[startRoot < srcs.size() ? startRoot : 0].c_str(), j.title);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    size_t movedOk = 0, failed = 0, skipped = 0;
+    ULONGLONG base = RootsBytesBefore(man, startRoot);
+
+    for (size_t i=startRoot;i<srcs.size();++i){
+        if (JobQueue::CancelRequested()) { ctx.canceled = true; break; }
+
+        const char* sp = srcs[i].c_str();
+        const bool resumingThis = (resumeAt && i == startRoot);
+        if (journaled && !resumingThis){
+            cur = FreshCursor(man, i);
+            CopyJournal::BeginRoot(i, cur.entry);
+        }
+
+        ULONGLONG thisSize = man.roots[i].bytes;
+        ctx.base = base;
+
+        // Destination top (dstDir\basename(sp))
+        const char* baseName = BaseNameOf(sp);
+        char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), dstDir, baseName);
+
+        // Prevent moving a folder into its own subfolder (or onto itself)
+        if (IsSubPathCaseI(sp, dstTop)) {
+            JobQueue::PostStatus("Cannot move a folder into its own subfolder");
+            ++skipped;
+            if (journaled) CopyJournal::EndRoot(i, man);
+            continue; // skip this item and go on
+        }
+
+        BOOL doneThis = FALSE;
+
+        // Resumed after this item's copy completed: only the source delete is left
+        const ManifestRoot& mr = man.roots[i];
+        const bool copiedThis = resumingThis && mr.count && cur.entry >= mr.first + mr.count;
+
+        // Per-item free-space check only if not a fast same-volume rename
+        const BOOL canFastRename =
+            SameDriveLetter(sp, dstDir) && !IsSubPathCaseI(sp, dstTop);
+
+        if (!canFastRename && !copiedThis) {
+            const ULONGLONG onDisk = ManifestOnDiskBytes(man, i, 1, DestClusterBytes(dstDir));
+            const ULONGLONG done   = resumingThis ? ManifestBytesBefore(man, i, cur.entry, cur.offset) : 0;
+            const ULONGLONG need   = (onDisk > done) ? onDisk - done : 0;
+            ULONGLONG freeB=0, totB=0;
+            GetDriveFreeTotal(dstTop, freeB, totB);
+            if (need > freeB) {
+                char needS[64], have[64];
+                FormatSize(need,  needS, sizeof(needS));
+                FormatSize(freeB, have,  sizeof(have));
+                SetSummary(j, "Not enough space to move %s: need %s, have %s", baseName, needS, have);
+                break; // stop the whole batch (use 'continue;' if you prefer to try remaining items)
+            }
+        }
+
+        // Fast path: same drive and not moving into own subfolder -> MoveFileA
+        if (canFastRename) {
+            if (MoveFileA(sp, dstTop)) {
+                doneThis = TRUE;  // instant rename/move within volume
+            }
+        }
+
+        // Fallback: copy -> delete original (only delete if copy succeeded)
+        if (!doneThis) {
+            if (!copiedThis && !CopyManifestRootA(man, i, dstDir, total, journaled ? &cur : NULL)){
+                if (ctx.canceled){
+                    // Journaled: keep partial dest for resume; else clean it. Stop.
+                    if (!journaled) DeleteRecursiveA(dstTop);
+                    break;
+                }
+                // Non-cancel failure
+                ++failed;
+            } else {
+                // Record the finished copy before the first source entry
+                // goes; the chunk checkpoints are throttled and may lag.
+                if (journaled && !copiedThis) CopyJournal::CopiedRoot(i, man);
+
+                // Source delete replays the same manifest. Progress stays in
+                // bytes and a copied item is never left half-deleted, so
+                // the callback is off here.
+                ULONGLONG delDone = 0;
+                SetCopyProgressCallback(NULL, NULL);
+                const bool delOk = DeleteManifestRootA(man, i, delDone, man.roots[i].count);
+                SetCopyProgressCallback(JobProgThunk, &ctx);
+                if (delOk) {
+                    doneThis = TRUE;
+                } else {
+                    // Optional: consider removing dstTop if source delete failed
+                    ++failed;
+                }
+            }
+        }
+
+        if (doneThis) ++movedOk;
+        base += thisSize;
+        if (journaled) CopyJournal::EndRoot(i, man);
+        JobQueue::PostProgress(base, total, sp);
+    }
+
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled){
+        // On cancel we keep originals
+        j.canceled = true;
+        if (journaled){
+            CopyJournal::Suspend();
+            SetSummary(j, "Move paused (%u done) - resume from menu", (unsigned)movedOk);
+        } else {
+            SetSummary(j, "Move canceled (%u done, %u skipped, %u failed)",
+                       (unsigned)movedOk, (unsigned)skipped, (unsigned)failed);
+        }
+        return;
+    }
+    if (j.summary[0]) { if (journaled) CopyJournal::Suspend(); return; } // batch stopped early; keep the reason
+    if (journaled) CopyJournal::Finish();
+
+    if (failed==0 && skipped==0) {
+        SetSummary(j, "Moved %u item(s)", (unsigned)movedOk);
+    } else {
+        SetSummary(j, "Moved %u, %u skipped, %u failed",
+                   (unsigned)movedOk, (unsigned)skipped, (unsigned)failed);
+    }
+    if (!sameVol) AppendRate(j);   // renames move no data
+}
+
+static void RunMoveJob(Job& j){
+    // One walk per source: feeds the total, preflight, accounting, copy and delete
+    OpManifest man;
+    BuildManifestA(j.srcs, man);
+
+    // --- preflight space only when cross-volume (move will copy+delete) ---
+    {
+        const bool sameVol = SameDriveLetter(j.srcDir, j.dstDir) != 0;
+        if (!sameVol){
+            const ULONGLONG onDisk = ManifestOnDiskBytes(man, 0, man.roots.size(), DestClusterBytes(j.dstDir));
+            ULONGLONG freeB=0, totB=0;
+            GetDriveFreeTotal(j.dstDir, freeB, totB);
+            if (onDisk > freeB){
+                char need[64], have[64];
+                FormatSize(onDisk, need, sizeof(need));
+                FormatSize(freeB, have, sizeof(have));
+                SetSummary(j, "Not enough space: need %s, have %s", need, have);
+                return;
+            }
+        }
+    }
+    // --- end preflight ---
+
+    MoveManifestJob(j, man, 0, NULL);
+}
+
+// Fan-out copy: every source chunk is read once and written to all of
+// j.dsts. Destinations fail independently; the summary names the first
+// one that did not get everything.
+static void RunFanOutJob(Job& j){
+    OpManifest man;
+    BuildManifestA(j.srcs, man);
+    const ULONGLONG total = man.totalBytes;
+    const size_t nd = j.dsts.size();
+
+    // Per-destination preflight: a volume without room is dropped up front.
+    // Targets on one partition share its free space, so each is checked
+    // against what the targets already accepted there will use.
+    std::vector<DWORD>     dropped(nd, NO_ERROR);
+    std::vector<unsigned>  failed(nd, 0);
+    std::vector<ULONGLONG> claim(nd, 0);   // on-disk bytes of each accepted target
+    size_t live = 0;
+    for (size_t k=0; k<nd; ++k){
+        // Each destination rounds to its own cluster size
+        const ULONGLONG onDisk = ManifestOnDiskBytes(man, 0, man.roots.size(), DestClusterBytes(j.dsts[k].c_str()));
+        ULONGLONG shared = 0;
+        for (size_t o=0; o<k; ++o)
+            if (SameDriveLetter(j.dsts[o].c_str(), j.dsts[k].c_str())) shared += claim[o];
+        ULONGLONG freeB=0, totB=0;
+        GetDriveFreeTotal(j.dsts[k].c_str(), freeB, totB);
+        if (shared + onDisk > freeB){
+            char need[64], have[64];
+            FormatSize(shared + onDisk, need, sizeof(need));
+            FormatSize(freeB, have, sizeof(have));
+            JobQueue::PostStatus("Skipping %s: need %s, have %s", j.dsts[k].c_str(), need, have);
+            dropped[k] = ERROR_DISK_FULL;
+            continue;
+        }
+        claim[k] = onDisk;
+        ++live;
+    }
+    if (!live) { SetSummary(j, "Not enough space on any destination"); return; }
+
+    JobQueue::PostBegin(total, j.srcs[0].c_str(), j.title);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    ULONGLONG base = 0;
+    size_t copied = 0;
+    for (size_t i=0; i<j.srcs.size(); ++i){
+        if (JobQueue::CancelRequested()) { ctx.canceled = true; break; }
+        ctx.base = base;
+
+        std::vector<DWORD> err(dropped);
+        if (!CopyManifestRootFanOutA(man, i, j.dsts, total, err) && ctx.canceled){
+            // Remove the partial item from every destination, then stop
+            const char* bn = BaseNameOf(j.srcs[i].c_str());
+            for (size_t k=0; k<nd; ++k){
+                if (dropped[k] != NO_ERROR) continue;
+                char top[512]; JoinPath(top, sizeof(top), j.dsts[k].c_str(), bn);
+                DeleteRecursiveA(top);
+            }
+            break;
+        }
+        for (size_t k=0; k<nd; ++k){
+            if (dropped[k] != NO_ERROR || err[k] == NO_ERROR) continue;
+            XBUtil_DebugPrint("Fan-out: %s -> %s failed (err=%lu)",
+                              j.srcs[i].c_str(), j.dsts[k].c_str(), (unsigned long)err[k]);
+            ++failed[k];
+        }
+        ++copied;
+        base += man.roots[i].bytes;
+    }
+
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled){
+        j.canceled = true;
+        SetSummary(j, "Copy canceled (%u of %u item(s) done)", (unsigned)copied, (unsigned)j.srcs.size());
+        return;
+    }
+
+    size_t okDst = 0, firstBad = nd;
+    for (size_t k=0; k<nd; ++k){
+        if (dropped[k] == NO_ERROR && failed[k] == 0) ++okDst;
+        else if (firstBad == nd) firstBad = k;
+    }
+    if (firstBad == nd){
+        SetSummary(j, "Copied %u item(s) to %u destinations", (unsigned)copied, (unsigned)nd);
+    } else if (dropped[firstBad] != NO_ERROR){
+        SetSummary(j, "Copied to %u of %u destinations; %s: not enough space",
+                   (unsigned)okDst, (unsigned)nd, j.dsts[firstBad].c_str());
+    } else {
+        SetSummary(j, "Copied to %u of %u destinations; %s: %u item(s) failed",
+                   (unsigned)okDst, (unsigned)nd, j.dsts[firstBad].c_str(), failed[firstBad]);
+    }
+    AppendRate(j);
+}
+
+// ---- Sync / mirror ----------------------------------------------------------
+// One-way update of dstDir\<item> from each source item: copy what is new or
+// changed, and for ACT_SYNC_MIRROR also delete what the source no longer has.
+// j.verify selects CRC comparison instead of size + time.
+static void RunSyncJob(Job& j){
+    const std::vector<std::string>& srcs = j.srcs;
+    const bool mirror = (j.act == ACT_SYNC_MIRROR);
+
+    // One walk of each side
+    std::vector<std::string> dstTops;
+    for (size_t i=0;i<srcs.size();++i){
+        char top[512]; JoinPath(top, sizeof(top), j.dstDir, BaseNameOf(srcs[i].c_str()));
+        dstTops.push_back(top);
+    }
+    OpManifest srcMan, dstMan;
+    BuildManifestA(srcs, srcMan);
+    BuildManifestA(dstTops, dstMan);
+
+    // Compare (progress in entries; CRC mode reads both sides)
+    JobQueue::PostBegin((ULONGLONG)srcMan.entries.size(), srcs[0].c_str(), "Comparing...", false);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    OpManifest plan, extras;
+    SyncStats st;
+    if (!BuildSyncPlanA(srcMan, dstMan, j.verify, plan, extras, st)){
+        SetCopyProgressCallback(NULL, NULL);
+        j.canceled = ctx.canceled;
+        SetSummary(j, ctx.canceled ? "Sync canceled" : "Sync compare failed");
+        return;
+    }
+
+    // Space, before anything is removed: only the growth has to fit, and a
+    // mirror gets back what its extras occupy
+    {
+        const DWORD     cluster = DestClusterBytes(j.dstDir);
+        const ULONGLONG onDisk  = ManifestOnDiskBytes(plan, 0, plan.roots.size(), cluster);
+        const ULONGLONG freed   = st.replacedBytes +
+            (mirror ? ManifestOnDiskBytes(extras, 0, extras.roots.size(), cluster) : 0);
+        const ULONGLONG need    = (onDisk > freed) ? onDisk - freed : 0;
+        ULONGLONG freeB=0, totB=0;
+        GetDriveFreeTotal(j.dstDir, freeB, totB);
+        if (need > freeB){
+            SetCopyProgressCallback(NULL, NULL);
+            char needS[64], have[64];
+            FormatSize(need,  needS, sizeof(needS));
+            FormatSize(freeB, have,  sizeof(have));
+            SetSummary(j, "Not enough space: need %s, have %s", needS, have);
+            return;
+        }
+    }
+
+    // Mirror: remove extras first so type clashes (file vs folder) clear up
+    unsigned removed = 0;
+    if (mirror && st.extras){
+        JobQueue::PostBegin((ULONGLONG)extras.entries.size(), dstTops[0].c_str(), "Removing extras...", false);
+        ULONGLONG done = 0;
+        for (size_t i=0;i<extras.roots.size() && !ctx.canceled;++i){
+            if (!extras.roots[i].count) continue;
+            DeleteManifestRootA(extras, i, done, (ULONGLONG)extras.entries.size());
+        }
+        removed = (unsigned)done;
+    }
+
+    // Copy the delta with the regular engine
+    JobQueue::PostBegin(plan.totalBytes, srcs[0].c_str(), j.title);
+    ULONGLONG base = 0;
+    unsigned failed = 0;
+    for (size_t i=0;i<plan.roots.size() && !ctx.canceled;++i){
+        if (JobQueue::CancelRequested()) { ctx.canceled = true; break; }
+        if (!plan.roots[i].count) continue;
+        ctx.base = base;
+        if (!CopyManifestRootA(plan, i, j.dstDir, plan.totalBytes) && !ctx.canceled) ++failed;
+        base += plan.roots[i].bytes;
+    }
+
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled){
+        j.canceled = true;
+        SetSummary(j, "Sync canceled");
+        return;
+    }
+    if (mirror){
+        SetSummary(j, "Synced: %u new, %u updated, %u unchanged, %u removed%s",
+                   st.added, st.updated, st.unchanged, removed, failed ? " (errors)" : "");
+    } else {
+        SetSummary(j, "Synced: %u new, %u updated, %u unchanged%s",
+                   st.added, st.updated, st.unchanged, failed ? " (errors)" : "");
+    }
+    AppendRate(j);
+}
+
+// ---- Resume / discard an interrupted copy or move (CopyJournal) -------------
+static void RunResumeJob(Job& j){
+    OpManifest man;
+    size_t root = 0;
+    CopyCursor cur;
+    if (!CopyJournal::Load(j, man, root, cur)){
+        CopyJournal::Discard();
+        SetSummary(j, "Resume data unreadable - discarded");
+        return;
+    }
+    if (j.act == ACT_MOVE) MoveManifestJob(j, man, root, &cur);
+    else                   CopyManifestJob(j, man, root, &cur);
+}
+
+static void RunDiscardJob(Job& j){
+    OpManifest man;
+    size_t root = 0;
+    CopyCursor cur;
+    if (CopyJournal::Load(j, man, root, cur) && root < man.roots.size()){
+        // Only the item in flight is partial; finished ones stay. If its copy
+        // had completed (CopiedRoot: move died while deleting the source) the
+        // destination is the only whole copy - keep it.
+        const ManifestRoot& r = man.roots[root];
+        if (cur.entry < r.first + r.count){
+            char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), j.dstDir, BaseNameOf(r.srcPath));
+            DeleteRecursiveA(dstTop);
+        }
+    }
+    CopyJournal::Discard();
+    SetSummary(j, "Interrupted %s discarded", (j.act == ACT_MOVE) ? "move" : "copy");
+}
+
+// ---- Delete -----------------------------------------------------------------
+// Progress is counted in entries (files + folders), not bytes.
+static void RunDeleteJob(Job& j){
+    const size_t n = j.srcs.size();
+
+    // Walk once, then replay children-first; progress counts entries.
+    OpManifest man;
+    BuildManifestA(j.srcs, man);
+    const ULONGLONG total = (ULONGLONG)man.entries.size();
+
+    JobQueue::PostBegin(total, j.srcs[0].c_str(), j.title, false);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    int ok=0;
+    ULONGLONG done = 0;
+    for (size_t i=0;i<n;++i){
+        if (JobQueue::CancelRequested()) { ctx.canceled = true; break; }
+        if (DeleteManifestRootA(man, i, done, total)) ++ok;
+        if (ctx.canceled) break;
+    }
+
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled) { j.canceled = true; SetSummary(j, "Delete canceled (%d / %d deleted)", ok, (int)n); }
+    else                SetSummary(j, "Deleted %d / %d", ok, (int)n);
+}
+
+// ---- Unzip ------------------------------------------------------------------
+// srcs[0] is the .zip, dstDir the extraction root.
+static void RunUnzipJob(Job& j){
+    const char* zipPath = j.srcs[0].c_str();
+    const char* dstDir  = j.dstDir;
+
+    UNZIP* zip = new UNZIP;
+
+    if (zip->openZIP(zipPath, zipFile_Open, zipFile_Close, zipFile_Read, zipFile_Seek) != UNZ_OK) {
+        zip->closeZIP();
+        delete zip;
+        SetSummary(j, "Bad zip file");
+        return;
+    }
+
+    int rc = zip->gotoFirstFile();
+
+    unz_file_info fi;
+    ULONGLONG total = 0;
+    char szName[512];
+
+    // Compute total bytes for progress bar; the same pass sizes the result
+    // on disk: files rounded to clusters, plus every folder the archive
+    // names or implies (counted per parent for their entry clusters)
+    const DWORD cluster = DestClusterBytes(dstDir);
+    ULONGLONG onDisk = 0;
+    std::map<std::string, bool> paths;   // lower-cased relative path -> is folder
+    while (rc == UNZ_OK) {
+        rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
+        if (rc == UNZ_OK) {
+            total += fi.uncompressed_size;
+            std::string p(szName);
+            for (size_t k=0; k<p.size(); ++k) p[k] = (p[k] == '/') ? '\\' : (char)tolower((unsigned char)p[k]);
+            const bool isDir = !p.empty() && p[p.size()-1] == '\\';
+            if (isDir) p.erase(p.size()-1);
+            if (!isDir) onDisk += ClusterRoundUp(fi.uncompressed_size, cluster);
+            if (!p.empty()) paths[p] = isDir;
+            for (size_t s = p.rfind('\\'); s != std::string::npos && s > 0; s = p.rfind('\\', s-1))
+                if (!paths.insert(std::make_pair(p.substr(0, s), true)).second) break;  // rest known
+            rc = zip->gotoNextFile();
+        }
+    }
+    {
+        std::map<std::string, DWORD> kids;   // folder -> direct entries
+        std::map<std::string, bool>::const_iterator it;
+        for (it = paths.begin(); it != paths.end(); ++it){
+            const size_t s = it->first.rfind('\\');
+            if (s != std::string::npos) ++kids[it->first.substr(0, s)];
+        }
+        for (it = paths.begin(); it != paths.end(); ++it){
+            if (!it->second) continue;
+            std::map<std::string, DWORD>::const_iterator k = kids.find(it->first);
+            onDisk += FolderOnDiskBytes(k != kids.end() ? k->second : 0, cluster);
+        }
+    }
+
+    if (total == 0) {
+        zip->closeZIP();
+        delete zip;
+        SetSummary(j, "Bad zip file");
+        return;
+    }
+
+    // --- preflight free-space check on destination ---
+    ULONGLONG freeB = 0, totB = 0;
+    GetDriveFreeTotal(dstDir, freeB, totB);
+    if (onDisk > freeB) {
+        zip->closeZIP();
+        delete zip;
+        char need[64], have[64];
+        FormatSize(onDisk, need, sizeof(need));
+        FormatSize(freeB, have, sizeof(have));
+        SetSummary(j, "Not enough space: need %s, have %s", need, have);
+        return;
+    }
+    // --- end preflight ---
+
+    if ((rc = zip->gotoFirstFile()) == UNZ_OK) {
+        rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
+    }
+
+    // Begin progress + set callback
+    JobQueue::PostBegin(total, szName, j.title);
+    JobProgCtx ctx = { 0, false };
+    SetCopyProgressCallback(JobProgThunk, &ctx);
+
+    ULONGLONG base = 0; // cumulative bytes completed
+    size_t extractedOk = 0, skipped = 0;
+
+    while (rc == UNZ_OK) {
+
+        if (ctx.canceled) break;
+
+        if ((rc = ExtractCurrentFile(zip, dstDir, true, true, base, total, szName)) != UNZ_OK) skipped += 1;
+        else extractedOk += 1;
+
+        if ((rc = zip->gotoNextFile()) == UNZ_OK) {
+            rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
+        }
+
+        if (CopyProgress::g_copyProgFn) {
+            if (!CopyProgress::g_copyProgFn(base, total, szName, CopyProgress::g_copyProgUser)) {
+                break; // canceled
+            }
+        }
+
+    } //end while
+
+    // Clear callback
+    SetCopyProgressCallback(NULL, NULL);
+
+    if (ctx.canceled) {
+        while (rc == UNZ_OK) {
+            ++skipped;
+            rc = zip->gotoNextFile();
+        }
+        j.canceled = true;
+        SetSummary(j, "Extraction canceled (%u extracted, %u skipped)", (unsigned)extractedOk, (unsigned)skipped);
+    }
+    else {
+        // Final toast that reflects what actually happened
+        SetSummary(j, "%u extracted, %u skipped", (unsigned)extractedOk, (unsigned)skipped);
+        AppendRate(j);
+    }
+
+    zip->closeZIP();
+    delete zip;
+}
+
+// Hand a prepared job to the worker; let the user know if it has to wait.
+static void SubmitJob(FileBrowserApp& app, Job* job){
+    job->volMask = DirCache::VolumeBit(job->srcDir) | DirCache::VolumeBit(job->dstDir);
+    for (size_t k=0; k<job->dsts.size(); ++k) job->volMask |= DirCache::VolumeBit(job->dsts[k].c_str());
+    if (!job->srcDir[0]) job->volMask = 0x03FFFFFFu;         // resumed job: folders unknown yet
+    const bool queued = JobQueue::Busy();
+    JobQueue::Submit(job);
+    if (queued) app.SetStatus("Queued: %s", job->title);
+}
+
 // Main dispatcher: runs the action the user picked from the context menu.
 void Execute(Action act, FileBrowserApp& app) {
     Pane& src = app.m_pane[app.m_active];
 	Pane& dst = app.m_pane[1 - app.m_active];
 
-    const Item* sel = NULL;
-	const Item* sel2 = NULL;
-    if (!src.items.empty()) sel = &src.items[src.sel];
-	if (!dst.items.empty()) sel2 = &dst.items[dst.sel];
+    const bool hasSel  = !src.items.Empty();
+	const bool hasSel2 = !dst.items.Empty();
 
     // Full path of selection (if any). Also supports drive-list selection.
     char srcFull[512] = "";
 	char dstFull[512] = "";
 	const char* ext = NULL;
 	const char* ext2 = NULL;
-    if (sel) {
-        if (src.mode == 1 && !sel->isUpEntry) {
-			if (!sel->isDir) ext = GetExtension(sel->name);
+    if (hasSel) {
+        if (src.mode == 1 && !src.items.IsUpEntry(src.sel)) {
+			if (!src.items.IsDir(src.sel)) ext = GetExtension(src.items.Name(src.sel));
             // Normal directory listing: dir + name
-            JoinPath(srcFull, sizeof(srcFull), src.curPath, sel->name);
+            JoinPath(srcFull, sizeof(srcFull), src.curPath, src.items.Name(src.sel));
             srcFull[sizeof(srcFull)-1] = 0;
-        } else if (src.mode == 0 && sel->isDir && !sel->isUpEntry) {
+        } else if (src.mode == 0 && src.items.IsDir(src.sel) && !src.items.IsUpEntry(src.sel)) {
             // Drive list: item name is already something like "E:\"
-            _snprintf(srcFull, sizeof(srcFull), "%s", sel->name);
+            _snprintf(srcFull, sizeof(srcFull), "%s", src.items.Name(src.sel));
             srcFull[sizeof(srcFull)-1] = 0;
             NormalizeDirA(srcFull); // ensure trailing slash
+        } else if (src.mode == 2 || src.mode == 3) {
+            // Search results / usage view: item name is the full path
+            if (!src.items.IsDir(src.sel)) ext = GetExtension(src.items.Name(src.sel));
+            _snprintf(srcFull, sizeof(srcFull), "%s", src.items.Name(src.sel));
+            srcFull[sizeof(srcFull)-1] = 0;
         }
     }
-	if (sel2) {
-		if (dst.mode == 1 && !sel2->isUpEntry) {
-			if (!sel2->isDir) ext2 = GetExtension(sel2->name);
+	if (hasSel2) {
+		if (dst.mode == 1 && !dst.items.IsUpEntry(dst.sel)) {
+			if (!dst.items.IsDir(dst.sel)) ext2 = GetExtension(dst.items.Name(dst.sel));
             // Normal directory listing: dir + name
-            JoinPath(dstFull, sizeof(dstFull), dst.curPath, sel2->name);
+            JoinPath(dstFull, sizeof(dstFull), dst.curPath, dst.items.Name(dst.sel));
             dstFull[sizeof(dstFull)-1] = 0;
-        } else if (dst.mode == 0 && sel2->isDir && !sel2->isUpEntry) {
+        } else if (dst.mode == 0 && dst.items.IsDir(dst.sel) && !dst.items.IsUpEntry(dst.sel)) {
             // Drive list: item name is already something like "E:\"
-            _snprintf(dstFull, sizeof(dstFull), "%s", sel2->name);
+            _snprintf(dstFull, sizeof(dstFull), "%s", dst.items.Name(dst.sel));
             dstFull[sizeof(dstFull)-1] = 0;
             NormalizeDirA(dstFull); // ensure trailing slash
         }
@@ -475,18 +1211,18 @@ void Execute(Action act, FileBrowserApp& app) {
     {
     // ---- Open / Enter / Launch ------------------------------------------------
     case ACT_OPEN:
-        if (sel){
-            if (sel->isUpEntry) { app.UpOne(src); }
-            else if (sel->isDir) { app.EnterSelection(src); }
-            else if (HasXbeExt(sel->name)){
-                char full[512]; JoinPath(full, sizeof(full), src.curPath, sel->name);
-                if (!LaunchXbeA(full)) app.SetStatusLastErr("Launch failed");
+        if (hasSel){
+            if (src.items.IsUpEntry(src.sel)) { app.UpOne(src); }
+            else if (src.items.IsDir(src.sel)) { app.EnterSelection(src); }
+            else if (HasXbeExt(src.items.Name(src.sel))){
+                if (!LaunchXbeA(srcFull)) app.SetStatusLastErr("Launch failed");
             }
         }
         break;
 
     // ---- Copy -----------------------------------------------------------------
 	case ACT_COPY:
+	case ACT_COPY_VERIFY:
 	{
 		if (src.mode != 1) { app.SetStatus("Open a folder"); break; }
 
@@ -495,115 +1231,115 @@ void Execute(Action act, FileBrowserApp& app) {
 		if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) { app.SetStatus("Pick a destination"); break; }
 		if ((dstDir[0]=='D'||dstDir[0]=='d') && dstDir[1]==':'){ app.SetStatus("Cannot copy to D:\\"); break; }
 		NormalizeDirA(dstDir);
-		if (!CanWriteHereA(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
+		if (!VolumeInfo::CanWrite(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
 
 		// Gather sources
-		std::vector<std::string> srcs;
-		GatherMarkedOrSelectedFullPaths(src, srcs);
-		if (srcs.empty()) { app.SetStatus("Nothing to copy"); break; }
-
-		// Compute total bytes for progress bar
-		ULONGLONG total=0;
-		for (size_t i=0;i<srcs.size();++i) total += DirSizeRecursiveA(srcs[i].c_str());
-
-		// --- preflight free-space check on destination (kept from your version) ---
-		{
-			ULONGLONG freeB=0, totB=0;
-			GetDriveFreeTotal(dstDir, freeB, totB);
-			if (total > freeB){
-				char need[64], have[64];
-				FormatSize(total, need, sizeof(need));
-				FormatSize(freeB, have, sizeof(have));
-				app.SetStatus("Not enough space: need %s, have %s", need, have);
-				break;
-			}
-		}
-		// --- end preflight ---
-
-		// Begin progress + set callback
-		app.BeginProgress(total, srcs[0].c_str(), "Copying...");
-		CopyProgCtx ctx = { &app, 0, false, false, 0, false };
-		SetCopyProgressCallback(CopyProgThunk, &ctx);
-
-		ULONGLONG base = 0;           // cumulative bytes completed
-		char lastDstTop[512] = {0};   // for cancel cleanup
-
-		// NEW: track results so the final toast reflects reality
-		size_t copiedOk = 0, failed = 0, skipped = 0;
-
-		for (size_t i=0;i<srcs.size();++i){
-			const char* sp = srcs[i].c_str();
-
-			// Compute top-level destination path (dstDir\basename(sp)) for cleanup
-			const char* bn = BaseNameOf(sp);
-			JoinPath(lastDstTop, sizeof(lastDstTop), dstDir, bn);
+		Job* job = new Job;
+		GatherMarkedOrSelectedFullPaths(src, job->srcs);
+		if (job->srcs.empty()) { delete job; app.SetStatus("Nothing to copy"); break; }
+
+		// Size walk, preflight and the copy itself run on the worker
+		job->run = RunCopyJob;
+		job->act = ACT_COPY;
+		job->verify = (act == ACT_COPY_VERIFY);
+		_snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+		_snprintf(job->dstDir, sizeof(job->dstDir), "%s", dstDir);      job->dstDir[sizeof(job->dstDir)-1] = 0;
+		_snprintf(job->title,  sizeof(job->title),  job->verify ? "Copying (verify)..." : "Copying...");
+		SubmitJob(app, job);
+		break;
+	}
 
-			ULONGLONG thisSize = DirSizeRecursiveA(sp);
-			ctx.base = base;
 
-			// --- prevent copying a folder into its own subfolder (or itself) ---
-			if (IsSubPathCaseI(sp, lastDstTop)) {
-				app.SetStatus("Cannot copy a folder into its own subfolder");
-				++skipped;
-				continue; // skip this item, proceed to next
-			}
-
-			// --- per-item free-space check (extra safety) ---
-			{
-				ULONGLONG freeB=0, totB=0;
-				GetDriveFreeTotal(lastDstTop, freeB, totB); // any path on dest volume is fine
-				if (thisSize > freeB) {
-					char need[64], have[64];
-					FormatSize(thisSize, need, sizeof(need));
-					FormatSize(freeB,   have, sizeof(have));
-					app.SetStatus("Not enough space for %s: need %s, have %s", bn, need, have);
-					break; // stop the whole batch (change to 'continue;' to try remaining items)
-				}
-			}
-			// --- end per-item check ---
-
-			if (!CopyRecursiveWithProgressA(sp, dstDir, total)){
-				if (ctx.canceled){
-					// Remove partial destination of the current item, then stop
-					DeleteRecursiveA(lastDstTop);
-					break;
-				}
-				// Non-cancel failure
-				++failed;
-			} else {
-				base += thisSize;
-				++copiedOk;
-			}
-		}
+    // ---- Fan-out copy: one source read, several destinations -----------------
+    case ACT_ADD_COPY_TARGET:
+    {
+        char dstDir[512];
+        if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) { app.SetStatus("Pick a destination"); break; }
+        if ((dstDir[0]=='D'||dstDir[0]=='d') && dstDir[1]==':'){ app.SetStatus("Cannot copy to D:\\"); break; }
+        NormalizeDirA(dstDir);
+        if (!VolumeInfo::CanWrite(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
+
+        std::vector<std::string>& t = app.m_copyTargets;
+        bool dup = false;
+        for (size_t k=0; k<t.size(); ++k) if (_stricmp(t[k].c_str(), dstDir) == 0) dup = true;
+        if (dup)                { app.SetStatus("Already a copy target"); break; }
+        if (t.size() >= 3)      { app.SetStatus("Up to 3 copy targets"); break; }
+        t.push_back(dstDir);
+        app.SetStatus("Copy target %u: %s", (unsigned)t.size(), dstDir);
+        break;
+    }
 
-		// End progress and clear callback
-		SetCopyProgressCallback(NULL, NULL);
-		app.EndProgress();
+    case ACT_CLEAR_COPY_TARGETS:
+        app.m_copyTargets.clear();
+        app.SetStatus("Copy targets cleared");
+        break;
 
-		if (ctx.canceled){
-			app.SetStatus("Copy canceled (%u done, %u skipped, %u failed)",
-						(unsigned)copiedOk, (unsigned)skipped, (unsigned)failed);
-			app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
-			break;
-		}
+    case ACT_COPY_FANOUT:
+    {
+        if (src.mode != 1) { app.SetStatus("Open a folder"); break; }
 
-		// If we copied into the currently displayed dest folder, refresh it
-		Pane& dstp = app.m_pane[1 - app.m_active];
-		if (dstp.mode==1 && _stricmp(dstp.curPath, dstDir)==0) ListDirectory(dstp.curPath, dstp.items);
+        // Other pane first, then the remembered targets (no duplicates)
+        char dstDir[512];
+        if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) { app.SetStatus("Pick a destination"); break; }
+        if ((dstDir[0]=='D'||dstDir[0]=='d') && dstDir[1]==':'){ app.SetStatus("Cannot copy to D:\\"); break; }
+        NormalizeDirA(dstDir);
+        if (!VolumeInfo::CanWrite(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
+
+        Job* job = new Job;
+        job->dsts.push_back(dstDir);
+        for (size_t k=0; k<app.m_copyTargets.size(); ++k)
+            if (_stricmp(app.m_copyTargets[k].c_str(), dstDir) != 0) job->dsts.push_back(app.m_copyTargets[k]);
+
+        GatherMarkedOrSelectedFullPaths(src, job->srcs);
+        if (job->srcs.empty()) { delete job; app.SetStatus("Nothing to copy"); break; }
+
+        job->run = RunFanOutJob;
+        job->act = ACT_COPY_FANOUT;
+        _snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+        _snprintf(job->dstDir, sizeof(job->dstDir), "%s", dstDir);      job->dstDir[sizeof(job->dstDir)-1] = 0;
+        _snprintf(job->title,  sizeof(job->title),  "Copying (%u dest)...", (unsigned)job->dsts.size());
+        job->title[sizeof(job->title)-1] = 0;
+        SubmitJob(app, job);
+        break;
+    }
 
-		// Clear marks and refresh both panes
-		for (size_t i=0;i<src.items.size();++i) src.items[i].marked=false;
-		app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
+    // ---- Sync / mirror to the other pane --------------------------------------
+    case ACT_SYNC:
+    case ACT_SYNC_CRC:
+    case ACT_SYNC_MIRROR:
+    {
+        if (src.mode != 1) { app.SetStatus("Open a folder"); break; }
 
-		// Final toast that reflects what actually happened
-		if (failed==0 && skipped==0) {
-			app.SetStatus("Copied %u item(s)", (unsigned)copiedOk);
-		} else {
-			app.SetStatus("Copied %u, %u skipped, %u failed",
-						(unsigned)copiedOk, (unsigned)skipped, (unsigned)failed);
-		}
-		break;
-}
+        char dstDir[512];
+        if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) { app.SetStatus("Pick a destination"); break; }
+        if ((dstDir[0]=='D'||dstDir[0]=='d') && dstDir[1]==':'){ app.SetStatus("Cannot sync to D:\\"); break; }
+        NormalizeDirA(dstDir);
+        if (!VolumeInfo::CanWrite(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
+
+        Job* job = new Job;
+        GatherMarkedOrSelectedFullPaths(src, job->srcs);
+        if (job->srcs.empty()) { delete job; app.SetStatus("Nothing to sync"); break; }
+
+        // The destination tree must lie outside every source: inside one the
+        // source walk would include it, and the source's own parent would make
+        // the destination the source itself (mirror deletes there)
+        bool nested = false;
+        for (size_t i=0; i<job->srcs.size() && !nested; ++i){
+            char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), dstDir, BaseNameOf(job->srcs[i].c_str()));
+            nested = IsSubPathCaseI(job->srcs[i].c_str(), dstTop) != 0;
+        }
+        if (nested) { delete job; app.SetStatus("Cannot sync a folder into itself or its own subfolder"); break; }
+
+        // Both walks, the compare and the delta copy run on the worker
+        job->run    = RunSyncJob;
+        job->act    = (act == ACT_SYNC_MIRROR) ? ACT_SYNC_MIRROR : ACT_SYNC;
+        job->verify = (act == ACT_SYNC_CRC);
+        _snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+        _snprintf(job->dstDir, sizeof(job->dstDir), "%s", dstDir);      job->dstDir[sizeof(job->dstDir)-1] = 0;
+        _snprintf(job->title,  sizeof(job->title),  "Syncing...");
+        SubmitJob(app, job);
+        break;
+    }
 
 
     // ---- Move -----------------------------------------------------------------
@@ -615,139 +1351,18 @@ void Execute(Action act, FileBrowserApp& app) {
 		if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) { app.SetStatus("Pick a destination"); break; }
 		if ((dstDir[0]=='D'||dstDir[0]=='d') && dstDir[1]==':'){ app.SetStatus("Cannot move to D:\\"); break; }
 		NormalizeDirA(dstDir);
-		if (!CanWriteHereA(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
-
-		std::vector<std::string> srcs;
-		GatherMarkedOrSelectedFullPaths(src, srcs);
-		if (srcs.empty()) { app.SetStatus("Nothing to move"); break; }
-
-		// Total bytes for progress
-		ULONGLONG total=0;
-		for (size_t i=0;i<srcs.size();++i) total += DirSizeRecursiveA(srcs[i].c_str());
-
-		// --- preflight space only when cross-volume (move will copy+delete) ---
-		{
-			const bool sameVol = SameDriveLetter(src.curPath, dstDir) != 0;
-			if (!sameVol){
-				ULONGLONG freeB=0, totB=0;
-				GetDriveFreeTotal(dstDir, freeB, totB);
-				if (total > freeB){
-					char need[64], have[64];
-					FormatSize(total, need, sizeof(need));
-					FormatSize(freeB, have, sizeof(have));
-					app.SetStatus("Not enough space: need %s, have %s", need, have);
-					break;
-				}
-			}
-		}
-		// --- end preflight ---
-
-		app.BeginProgress(total, srcs[0].c_str(), "Moving...");
-		CopyProgCtx ctx = { &app, 0, false, false, 0, false };
-		SetCopyProgressCallback(CopyProgThunk, &ctx);
-
-		size_t movedOk = 0, failed = 0, skipped = 0;  // NEW: track results
-		ULONGLONG base = 0;
-
-		for (size_t i=0;i<srcs.size();++i){
-			const char* sp = srcs[i].c_str();
-			ULONGLONG thisSize = DirSizeRecursiveA(sp);
-			ctx.base = base;
-
-			// Destination top (dstDir\basename(sp))
-			const char* baseName = BaseNameOf(sp);
-			char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), dstDir, baseName);
-
-			// --- NEW: prevent moving a folder into its own subfolder (or onto itself)
-			if (IsSubPathCaseI(sp, dstTop)) {
-				app.SetStatus("Cannot move a folder into its own subfolder");
-				++skipped;
-				continue; // skip this item and go on
-			}
-
-			BOOL doneThis = FALSE;
-
-			// --- NEW: per-item free-space check only if not a fast same-volume rename
-			const BOOL canFastRename =
-				SameDriveLetter(sp, dstDir) && !IsSubPathCaseI(sp, dstTop);
-
-			if (!canFastRename) {
-				ULONGLONG freeB=0, totB=0;
-				GetDriveFreeTotal(dstTop, freeB, totB);
-				if (thisSize > freeB) {
-					char need[64], have[64];
-					FormatSize(thisSize, need, sizeof(need));
-					FormatSize(freeB,   have, sizeof(have));
-					app.SetStatus("Not enough space to move %s: need %s, have %s", baseName, need, have);
-					break; // stop the whole batch (use 'continue;' if you prefer to try remaining items)
-				}
-			}
-			// --- end NEW ---
-
-			// Fast path: same drive and not moving into own subfolder -> MoveFileA
-			if (SameDriveLetter(sp, dstDir) && !IsSubPathCaseI(sp, dstTop)) {
-				if (MoveFileA(sp, dstTop)) {
-					doneThis = TRUE;  // instant rename/move within volume
-				}
-			}
-
-			// Fallback: copy -> delete original (only delete if copy succeeded)
-			if (!doneThis) {
-				if (!CopyRecursiveWithProgressA(sp, dstDir, total)){
-					if (ctx.canceled){
-						// Clean partial dest and stop
-						DeleteRecursiveA(dstTop);
-						break;
-					}
-					// Non-cancel failure
-					++failed;
-				} else {
-					if (DeleteRecursiveA(sp)) {
-						doneThis = TRUE;
-					} else {
-						// Optional: consider removing dstTop if source delete failed
-						++failed;
-					}
-				}
-			}
-
-			if (doneThis) ++movedOk;
-			base += thisSize;
-		}
-
-		SetCopyProgressCallback(NULL, NULL);
-		app.EndProgress();
-
-		if (ctx.canceled){
-			app.SetStatus("Move canceled (%u done, %u skipped, %u failed)",
-						(unsigned)movedOk, (unsigned)skipped, (unsigned)failed);
-			// On cancel we keep originals; clear marks and refresh UI
-			for (size_t i=0;i<src.items.size();++i) src.items[i].marked=false;
-			if (src.mode==1) ListDirectory(src.curPath, src.items);
-			{
-				Pane& dstp = app.m_pane[1 - app.m_active];
-				if (dstp.mode==1 && _stricmp(dstp.curPath, dstDir)==0) ListDirectory(dstp.curPath, dstp.items);
-			}
-			app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
-			break;
-		}
-
-		// Normal completion: refresh both panes, clear marks
-		for (size_t i=0;i<src.items.size();++i) src.items[i].marked=false;
-		if (src.mode==1) ListDirectory(src.curPath, src.items);
-		{
-			Pane& dstp = app.m_pane[1 - app.m_active];
-			if (dstp.mode==1 && _stricmp(dstp.curPath, dstDir)==0) ListDirectory(dstp.curPath, dstp.items);
-		}
-		app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
-
-		// NEW: accurate final toast
-		if (failed==0 && skipped==0) {
-			app.SetStatus("Moved %u item(s)", (unsigned)movedOk);
-		} else {
-			app.SetStatus("Moved %u, %u skipped, %u failed",
-						(unsigned)movedOk, (unsigned)skipped, (unsigned)failed);
-		}
+		if (!VolumeInfo::CanWrite(dstDir)){ app.SetStatusLastErr("Dest not writable"); break; }
+
+		Job* job = new Job;
+		GatherMarkedOrSelectedFullPaths(src, job->srcs);
+		if (job->srcs.empty()) { delete job; app.SetStatus("Nothing to move"); break; }
+
+		job->run = RunMoveJob;
+		job->act = act;
+		_snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+		_snprintf(job->dstDir, sizeof(job->dstDir), "%s", dstDir);      job->dstDir[sizeof(job->dstDir)-1] = 0;
+		_snprintf(job->title,  sizeof(job->title),  "Moving...");
+		SubmitJob(app, job);
 		break;
 	}
 
@@ -757,25 +1372,63 @@ void Execute(Action act, FileBrowserApp& app) {
     {
         if (src.mode != 1) { app.SetStatus("Open a folder"); break; }
 
-        std::vector<std::string> srcs;
-        GatherMarkedOrSelectedFullPaths(src, srcs);
-        if (srcs.empty()) { app.SetStatus("Nothing to delete"); break; }
+        std::vector<std::string> paths;
+        GatherMarkedOrSelectedFullPaths(src, paths);
+        if (paths.empty()) { app.SetStatus("Nothing to delete"); break; }
+
+        // Fast path: rename into the volume's trash and let the reaper do the
+        // deleting. A running job may be reading these items, so then (and
+        // for anything that will not rename) queue a real delete instead.
+        Job* job = new Job;
+        unsigned trashed = 0;
+        for (size_t i=0; i<paths.size(); ++i){
+            if (!JobQueue::Busy() && Trash::MoveToTrashA(paths[i].c_str())) ++trashed;
+            else job->srcs.push_back(paths[i]);
+        }
+        if (trashed){
+            Trash::Kick();
+            DirCache::Invalidate(src.curPath);
+            for (size_t i=0; i<paths.size(); ++i) DirCache::InvalidateTree(paths[i].c_str());
+            app.RefreshPanesShowing(src.curPath, NULL);
+        }
+        if (job->srcs.empty()) { delete job; app.SetStatus("Deleted %u item(s)", trashed); break; }
+
+        job->run = RunDeleteJob;
+        job->act = act;
+        _snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+        _snprintf(job->title,  sizeof(job->title),  "Deleting...");
+        SubmitJob(app, job);
+        break;
+    }
 
-        int ok=0;
-        for (size_t i=0;i<srcs.size();++i) if (DeleteRecursiveA(srcs[i].c_str())) ++ok;
+    // ---- Cancel the running background operation ------------------------------
+    case ACT_CANCEL_JOB:
+        if (JobQueue::Busy()) {
+            JobQueue::RequestCancel();
+            app.SetStatus("Canceling...");
+        }
+        break;
 
-        // Clear marks, refresh, and toast result
-        for (size_t i=0;i<src.items.size();++i) src.items[i].marked=false;
-        if (src.mode==1) ListDirectory(src.curPath, src.items);
-        app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
-        app.SetStatus("Deleted %d / %d", ok, (int)srcs.size());
+    // ---- Interrupted copy/move (journal on T:\) -------------------------------
+    case ACT_RESUME_JOB:
+    case ACT_DISCARD_JOB:
+    {
+        if (JobQueue::Busy()) { app.SetStatus("Operation in progress"); break; }
+        if (!CopyJournal::Pending()) { app.SetStatus("Nothing to resume"); break; }
+
+        // The journal supplies sources and folders on the worker
+        Job* job = new Job;
+        job->run = (act == ACT_RESUME_JOB) ? RunResumeJob : RunDiscardJob;
+        job->act = act;
+        _snprintf(job->title, sizeof(job->title), (act == ACT_RESUME_JOB) ? "Resuming..." : "Discarding...");
+        SubmitJob(app, job);
         break;
     }
 
     // ---- Rename (opens modal OSK) --------------------------------------------
     case ACT_RENAME:
-        if (sel && src.mode==1 && !sel->isUpEntry){
-            app.BeginRename(src.curPath, sel->name);
+        if (hasSel && src.mode==1 && !src.items.IsUpEntry(src.sel)){
+            app.BeginRename(src.curPath, src.items.Name(src.sel));
         } else {
             app.SetStatus("Open a folder and select an item");
         }
@@ -788,10 +1441,9 @@ void Execute(Action act, FileBrowserApp& app) {
 
         if (src.mode == 1) {
             _snprintf(baseDir, sizeof(baseDir), "%s", src.curPath);
-        } else if (!src.items.empty()) {
-            const Item& di = src.items[src.sel];
-            if (di.isDir && !di.isUpEntry) {
-                _snprintf(baseDir, sizeof(baseDir), "%s", di.name); // drive root, e.g. "E:\"
+        } else if (!src.items.Empty()) {
+            if (src.items.IsDir(src.sel) && !src.items.IsUpEntry(src.sel)) {
+                _snprintf(baseDir, sizeof(baseDir), "%s", src.items.Name(src.sel)); // drive root, e.g. "E:\"
             }
         }
         baseDir[sizeof(baseDir)-1] = 0;
@@ -802,7 +1454,7 @@ void Execute(Action act, FileBrowserApp& app) {
         }
 
         NormalizeDirA(baseDir);
-        if (!CanWriteHereA(baseDir)) { app.SetStatusLastErr("Dest not writable"); break; }
+        if (!VolumeInfo::CanWrite(baseDir)) { app.SetStatusLastErr("Dest not writable"); break; }
 
         // Auto-name NewFolder[/N] without clobbering existing names
         char nameBuf[64];
@@ -825,6 +1477,7 @@ void Execute(Action act, FileBrowserApp& app) {
             }
             if (++idx > 999){ app.SetStatus("Create folder failed (names exhausted)"); break; }
         }
+        DirCache::Invalidate(baseDir);
 
         app.RefreshPane(app.m_pane[0]); app.RefreshPane(app.m_pane[1]);
 
@@ -838,25 +1491,62 @@ void Execute(Action act, FileBrowserApp& app) {
     // ---- Calculate size -------------------------------------------------------
     case ACT_CALCSIZE:
     {
-        if (!sel) break;
+        if (!hasSel) break;
         if (!srcFull[0]) {
             // Try to derive from selection directly (covers any future cases)
             char tmpPath[512] = "";
-            if (src.mode == 0 && sel->isDir && !sel->isUpEntry) {
-                _snprintf(tmpPath, sizeof(tmpPath), "%s", sel->name);
+            if (src.mode == 0 && src.items.IsDir(src.sel) && !src.items.IsUpEntry(src.sel)) {
+                _snprintf(tmpPath, sizeof(tmpPath), "%s", src.items.Name(src.sel));
                 tmpPath[sizeof(tmpPath)-1] = 0;
                 NormalizeDirA(tmpPath);
             }
             if (!tmpPath[0]) { app.SetStatus("Open a folder or select a drive"); break; }
-            ULONGLONG bytes = DirSizeRecursiveA(tmpPath);
+            _snprintf(srcFull, sizeof(srcFull), "%s", tmpPath); srcFull[sizeof(srcFull)-1] = 0;
+        }
+
+        const DWORD a = GetFileAttributesA(srcFull);
+        if (a != INVALID_FILE_ATTRIBUTES && !(a & FILE_ATTRIBUTE_DIRECTORY)) {
+            char tmp[64]; FormatSize(DirSizeRecursiveA(srcFull), tmp, sizeof(tmp));
+            app.SetStatus("%s", tmp);
+            break;
+        }
+
+        // Folders: memoized by SizeService; otherwise it walks the tree in
+        // the background and PumpCalcSize reports the total.
+        ULONGLONG bytes = 0;
+        if (SizeService::Get(srcFull, bytes, true)) {
             char tmp[64]; FormatSize(bytes, tmp, sizeof(tmp));
             app.SetStatus("%s", tmp);
             break;
         }
+        _snprintf(app.m_calcPath, sizeof(app.m_calcPath), "%s", srcFull); app.m_calcPath[sizeof(app.m_calcPath)-1] = 0;
+        app.m_calcT0 = GetTickCount();
+        app.SetStatus("Calculating size...");
+        break;
+    }
 
-        ULONGLONG bytes = DirSizeRecursiveA(srcFull);
-        char tmp[64]; FormatSize(bytes, tmp, sizeof(tmp));
-        app.SetStatus("%s", tmp);
+    // ---- Disk usage view (scans the volume once, reused until rescanned) -----
+    case ACT_USAGE:
+    {
+        char dir[512] = "";
+        if (src.mode == 0 && hasSel && src.items.IsDir(src.sel) && !src.items.IsUpEntry(src.sel))
+            _snprintf(dir, sizeof(dir), "%s", src.items.Name(src.sel));
+        else if (src.mode == 1 || src.mode == 3)
+            _snprintf(dir, sizeof(dir), "%s", src.curPath);
+        dir[sizeof(dir)-1] = 0;
+        if (!dir[0] || dir[1] != ':') { app.SetStatus("Open a folder or select a drive"); break; }
+
+        const DiskUsage::Status st = DiskUsage::GetStatus();
+        if (src.mode == 3 || toupper((unsigned char)dir[0]) != st.root[0]) {
+            DiskUsage::Scan(dir[0]);
+            app.m_usageDone = false;
+            app.SetStatus("Scanning %c: ...", toupper((unsigned char)dir[0]));
+        } else if (!st.done) {
+            app.SetStatus("Scan of %s in progress", st.root);
+        } else {
+            app.SetStatus("Usage from the last scan - menu in the view rescans");
+        }
+        app.ShowUsage(src, dir, NULL);
         break;
     }
 
@@ -868,27 +1558,56 @@ void Execute(Action act, FileBrowserApp& app) {
                 strncpy(src.curPath, root, sizeof(src.curPath)-1);
                 src.curPath[3] = 0;
                 src.sel = 0; src.scroll = 0;
-                ListDirectory(src.curPath, src.items);
+                app.StreamListing(src, NULL);
             } else {
                 // Already at root -> switch to drive list
                 src.mode = 0; src.curPath[0] = 0; src.sel = 0; src.scroll = 0;
                 BuildDriveItems(src.items);
             }
         } else {
-            // In drive list: refresh it
+            // In drive list: refresh it (search results: back to it)
+            src.mode = 0; src.curPath[0] = 0;
             BuildDriveItems(src.items);
         }
         break;
 
+    // ---- Sort order (per pane; the selected entry stays selected) -------------
+    case ACT_SORT_NEXT:
+    {
+        if (src.mode != 1) break;
+        char keep[256] = "";
+        if (hasSel) { _snprintf(keep, sizeof(keep), "%s", src.items.Name(src.sel)); keep[sizeof(keep)-1] = 0; }
+
+        src.items.SetSortMode((SortMode)((src.items.Mode() + 1) % SORT_COUNT));
+        if (app.m_stream[app.PaneIndex(src)].active) {
+            app.StreamListing(src, keep);      // batches in flight use the old order
+        } else {
+            src.items.Sort((!src.items.Empty() && src.items.IsUpEntry(0)) ? 1 : 0);
+            if (keep[0]) app.SelectItemInPane(src, keep);
+        }
+        app.SetStatus("Sorted by %s", SortModeName(src.items.Mode()));
+        break;
+    }
+
+    case ACT_TOGGLE_DATES:
+        app.m_showDates = !app.m_showDates;
+        break;
+
+    // ---- Jump / filter (live over the active pane), find (all drives) ---------
+    case ACT_JUMP:         app.BeginFind(FileBrowserApp::FIND_JUMP);   break;
+    case ACT_FILTER:       app.BeginFind(FileBrowserApp::FIND_FILTER); break;
+    case ACT_CLEAR_FILTER: app.ClearFilter(src);                       break;
+    case ACT_FIND:         app.BeginFind(FileBrowserApp::FIND_SEARCH); break;
+
     // ---- Marking operations ---------------------------------------------------
     case ACT_MARK_ALL:
     {
         Pane& p = app.m_pane[app.m_active];
-        if (p.mode==1 && !p.items.empty()){
+        if (p.mode==1 && !p.items.Empty()){
             int n=0;
-            for (size_t i=0; i<p.items.size(); ++i){
-                if (!p.items[i].isUpEntry && !p.items[i].marked){
-                    p.items[i].marked = true; ++n;
+            for (size_t i=0; i<p.items.Count(); ++i){
+                if (!p.items.IsUpEntry(i) && !p.items.Marked(i)){
+                    p.items.SetMarked(i, true); ++n;
                 }
             }
             if (n>0) app.SetStatus("Marked %d item%s", n, (n==1?"":"s"));
@@ -900,11 +1619,11 @@ void Execute(Action act, FileBrowserApp& app) {
     case ACT_INVERT_MARKS:
     {
         Pane& p = app.m_pane[app.m_active];
-        if (p.mode==1 && !p.items.empty()){
+        if (p.mode==1 && !p.items.Empty()){
             int toggled=0;
-            for (size_t i=0;i<p.items.size(); ++i){
-                if (!p.items[i].isUpEntry){
-                    p.items[i].marked = !p.items[i].marked;
+            for (size_t i=0;i<p.items.Count(); ++i){
+                if (!p.items.IsUpEntry(i)){
+                    p.items.SetMarked(i, !p.items.Marked(i));
                     ++toggled;
                 }
             }
@@ -916,11 +1635,9 @@ void Execute(Action act, FileBrowserApp& app) {
     case ACT_CLEAR_MARKS:
     {
         Pane& p = app.m_pane[app.m_active];
-        if (p.mode==1 && !p.items.empty()){
-            int cleared=0;
-            for (size_t i=0;i<p.items.size(); ++i){
-                if (p.items[i].marked){ p.items[i].marked=false; ++cleared; }
-            }
+        if (p.mode==1 && !p.items.Empty()){
+            const int cleared = (int)p.items.MarkedCount();
+            p.items.ClearMarks();
             app.SetStatus(cleared ? "Cleared %d" : "No marks", cleared);
         }
         break;
@@ -932,6 +1649,8 @@ void Execute(Action act, FileBrowserApp& app) {
         app.SetStatus("Formatting cache partitions (X/Y/Z)...");
         const bool ok = FormatCacheXYZ(0, true);  // 0 => default 16KiB; also clears E:\CACHE
         if (!ok) { app.SetStatus("Format cache failed"); break; }
+        DirCache::InvalidateVolume('X'); DirCache::InvalidateVolume('Y'); DirCache::InvalidateVolume('Z');
+        DirCache::InvalidateTree("E:\\CACHE");
 
         // If either pane is browsing X:, Y:, or Z:, refresh it
         for (int p = 0; p < 2; ++p) {
@@ -939,7 +1658,7 @@ void Execute(Action act, FileBrowserApp& app) {
             if (pane.mode == 1 && pane.curPath[0]) {
                 char dl = (char)toupper((unsigned char)pane.curPath[0]);
                 if (dl == 'X' || dl == 'Y' || dl == 'Z') {
-                    ListDirectory(pane.curPath, pane.items);
+                    app.ListPaneNow(pane);
                 }
             }
         }
@@ -958,6 +1677,7 @@ void Execute(Action act, FileBrowserApp& app) {
 		if (ext && _stricmp(ext, "ips") == 0 && ext2 && _stricmp(ext2, "xbe") == 0) {
 			if (applyIPS(srcFull, dstFull) == E_NO_ERROR) app.SetStatus("Patch applied");
 			else app.SetStatus("Patch failed");
+			DirCache::Invalidate(dst.curPath);
 		}
 		break;
 
@@ -974,6 +1694,7 @@ void Execute(Action act, FileBrowserApp& app) {
 			default: 
 				app.SetStatus("Bak failed");
 			}
+			DirCache::Invalidate(src.curPath);
 		}
 		app.RefreshPane(app.m_pane[0]);
         app.RefreshPane(app.m_pane[1]);
@@ -983,6 +1704,7 @@ void Execute(Action act, FileBrowserApp& app) {
 		if (ext && _stricmp(ext, "bak") == 0) {
 			if (restoreBak(srcFull, true) == E_NO_ERROR) app.SetStatus("Bak restored");
 			else app.SetStatus("Restore failed");
+			DirCache::Invalidate(src.curPath);
 		}
 		app.RefreshPane(app.m_pane[0]);
         app.RefreshPane(app.m_pane[1]);
@@ -1000,126 +1722,33 @@ void Execute(Action act, FileBrowserApp& app) {
                     app.SetStatus("Pick a destination");
                     break;
                 }
-                if ((dstDir[0] == 'D' || dstDir[0] == 'd') && dstDir[1] == ':') {
-                    app.SetStatus("Cannot extract to D:\\");
-                    break;
-                }
-                NormalizeDirA(dstDir);
-                if (!CanWriteHereA(dstDir)) {
-                    app.SetStatusLastErr("Dest not writable");
-                    break;
-                }
             }
-            else if (act == ACT_UNZIPTO) {
+            else {
                 if (!app.ResolveDestDir(dstDir, sizeof(dstDir))) {
                     app.SetStatus("Pick a destination");
                     break;
                 }
-                if ((dstDir[0] == 'D' || dstDir[0] == 'd') && dstDir[1] == ':') {
-                    app.SetStatus("Cannot extract to D:\\");
-                    break;
-                }
-                NormalizeDirA(dstDir);
-                if (!CanWriteHereA(dstDir)) {
-                    app.SetStatusLastErr("Dest not writable");
-                    break;
-                }
             }
-
-			UNZIP* zip = new UNZIP;
-
-			if (zip->openZIP(srcFull, zipFile_Open, zipFile_Close, zipFile_Read, zipFile_Seek) != UNZ_OK) {
-				zip->closeZIP();
-				app.SetStatus("Bad zip file");
-				break;
-			}
-
-			int rc = zip->gotoFirstFile();
-
-			unz_file_info fi;
-			ULONGLONG total = 0;
-            char szName[512];
-
-			// Compute total bytes for progress bar
-			while (rc == UNZ_OK) {
-				rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
-				if (rc == UNZ_OK) {
-					total += fi.uncompressed_size;
-					rc = zip->gotoNextFile();
-				}
-			}
-
-			if (total == 0) {
-				app.SetStatus("Bad zip file");
-				break;
-			}
-
-			// --- preflight free-space check on destination ---
-			ULONGLONG freeB = 0, totB = 0;
-			GetDriveFreeTotal(dstDir, freeB, totB);
-			if (total > freeB) {
-				zip->closeZIP();
-				char need[64], have[64];
-				FormatSize(total, need, sizeof(need));
-				FormatSize(freeB, have, sizeof(have));
-				app.SetStatus("Not enough space: need %s, have %s", need, have);
-				break;
-			}
-			// --- end preflight ---
-
-            if ((rc = zip->gotoFirstFile()) == UNZ_OK) {
-                rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
-            }
-
-            // Begin progress + set callback
-            app.BeginProgress(total, szName, "Extracting...");
-            CopyProgCtx ctx = { &app, 0, false, false, 0, false };
-            SetCopyProgressCallback(CopyProgThunk, &ctx);
-
-            ULONGLONG base = 0; // cumulative bytes completed
-			size_t extractedOk = 0, skipped = 0;
-
-			while (rc == UNZ_OK) {
-                
-                if (ctx.canceled) break;
-
-				if ((rc = ExtractCurrentFile(zip, dstDir, true, true, base, total, szName)) != UNZ_OK) skipped += 1;
-				else extractedOk += 1;
-
-                if ((rc = zip->gotoNextFile()) == UNZ_OK) {
-                    rc = zip->getFileInfo(&fi, szName, 512, NULL, 0, NULL, 0);
-                }
-
-                if (CopyProgress::g_copyProgFn) {
-                    if (!CopyProgress::g_copyProgFn(base, total, szName, CopyProgress::g_copyProgUser)) {
-                        break; // canceled
-                    }
-                }
-
-			} //end while
-
-            // End progress and clear callback
-            SetCopyProgressCallback(NULL, NULL);
-            app.EndProgress();
-
-            if (ctx.canceled) {
-                while (rc == UNZ_OK) {
-                    ++skipped;
-                    rc = zip->gotoNextFile();
-                }
-                app.SetStatus("Extraction canceled (%u extracted, %u skipped)", (unsigned)extractedOk, (unsigned)skipped);
+            if ((dstDir[0] == 'D' || dstDir[0] == 'd') && dstDir[1] == ':') {
+                app.SetStatus("Cannot extract to D:\\");
+                break;
             }
-            else {
-                // Final toast that reflects what actually happened
-                app.SetStatus("%u extracted, %u skipped", (unsigned)extractedOk, (unsigned)skipped);
+            NormalizeDirA(dstDir);
+            if (!VolumeInfo::CanWrite(dstDir)) {
+                app.SetStatusLastErr("Dest not writable");
+                break;
             }
 
-			zip->closeZIP();
-
+            // Zip scan, preflight and extraction run on the worker
+            Job* job = new Job;
+            job->srcs.push_back(srcFull);
+            job->run = RunUnzipJob;
+            job->act = act;
+            _snprintf(job->srcDir, sizeof(job->srcDir), "%s", src.curPath); job->srcDir[sizeof(job->srcDir)-1] = 0;
+            _snprintf(job->dstDir, sizeof(job->dstDir), "%s", dstDir);      job->dstDir[sizeof(job->dstDir)-1] = 0;
+            _snprintf(job->title,  sizeof(job->title),  "Extracting...");
+            SubmitJob(app, job);
 		}
-
-        app.RefreshPane(app.m_pane[0]);
-        app.RefreshPane(app.m_pane[1]);
 		break;
 
     } // switch
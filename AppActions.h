@@ -23,12 +23,26 @@ class FileBrowserApp;
 enum Action {
     ACT_OPEN,          // Enter dir / up one / launch .xbe (context-sensitive)
     ACT_COPY,          // Copy selected/marked items to other pane/dest
+    ACT_COPY_VERIFY,   // Copy, then CRC32-compare every written file
+    ACT_SYNC,          // Copy only new/changed files (size + time) to other pane
+    ACT_SYNC_CRC,      // Same, but compare equal-size files by CRC32
+    ACT_SYNC_MIRROR,   // Sync and delete destination files the source lacks
+    ACT_ADD_COPY_TARGET,    // Remember the other pane's folder as a fan-out target
+    ACT_COPY_FANOUT,        // Copy once to the other pane + all remembered targets
+    ACT_CLEAR_COPY_TARGETS, // Forget the fan-out targets
     ACT_MOVE,          // Move selected/marked items (rename within volume or copy+delete)
     ACT_DELETE,        // Delete selected/marked items (recursive)
     ACT_RENAME,        // Start on-screen keyboard to rename current item
     ACT_MKDIR,         // Create a new folder in active/selected location
     ACT_CALCSIZE,      // Calculate total size of selected item (recursive)
     ACT_GOROOT,        // Jump to drive root; if at root, return to drive list
+    ACT_SORT_NEXT,     // Cycle the active pane's sort order (Listing SortMode)
+    ACT_TOGGLE_DATES,  // Show/hide the modified-time column
+    ACT_JUMP,          // Type a prefix, selection follows (keyboard)
+    ACT_FILTER,        // Type text, pane shows only matching names (keyboard)
+    ACT_CLEAR_FILTER,  // Show the whole folder again
+    ACT_FIND,          // Search names on all hard disk partitions (keyboard)
+    ACT_USAGE,         // Largest folders / files of a volume (DiskUsage); rescans in the view
 
     ACT_CLEAR_MARKS,   // Clear all mark flags in the active pane
     ACT_MARK_ALL,      // Mark all regular entries (skip "..")
@@ -42,6 +56,10 @@ enum Action {
 	ACT_RESTOREBAK,    //xipslib
     ACT_UNZIPTO,       //unzipLIB
     ACT_UNZIPHERE,     //unzipLIB
+
+    ACT_CANCEL_JOB,    // Cancel the running background operation (JobQueue)
+    ACT_RESUME_JOB,    // Resume the interrupted copy/move (CopyJournal)
+    ACT_DISCARD_JOB,   // Drop the interrupted copy/move and its partial item
 };
 
 // --------------------------------------------------------------------------
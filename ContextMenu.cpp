@@ -25,18 +25,20 @@
   Rendering:
     * Simple framed panel with dynamic header height, divider line,
       then N rows of fixed height (m_rowH).
+    * Taller than maxH: only m_rows rows from m_top are drawn, with a
+      scroll bar; the window follows the selection.
 ===============================================================================
 */
 
 ContextMenu::ContextMenu(){
-    m_count=0; m_sel=0;
+    m_count=0; m_sel=0; m_top=0; m_rows=0;
     m_open=false; m_waitRelease=false;
     m_x=0; m_y=0; m_w=320; m_rowH=28;
     m_prevA=m_prevB=m_prevX=m_prevWhite=m_prevBlack=0;
     m_prevButtons=0;
 }
 
-void ContextMenu::Clear(){ m_count=0; m_sel=0; }
+void ContextMenu::Clear(){ m_count=0; m_sel=0; m_top=0; }
 
 // Add a selectable row
 void ContextMenu::AddItem(const char* label, Action act, bool enabled){
@@ -75,12 +77,32 @@ int ContextMenu::FindNextSelectable(int start, int dir) const{
     return -1;
 }
 
+// Move the row window just enough to show m_sel. Leading / trailing rows
+// that cannot be selected come into view with the first / last item.
+void ContextMenu::ScrollToSel(){
+    if (m_sel < m_top)            m_top = m_sel;
+    if (m_sel >= m_top + m_rows)  m_top = m_sel - m_rows + 1;
+    if (FindNextSelectable(m_sel - 1, -1) < 0) m_top = 0;
+    if (FindNextSelectable(m_sel + 1, +1) < 0 && m_count > m_rows) m_top = m_count - m_rows;
+    if (m_top > m_count - m_rows) m_top = m_count - m_rows;
+    if (m_top < 0)                m_top = 0;
+}
+
 // Position/size the menu and make it active.
 // Also snaps the selection onto a valid (selectable) row and
 // arms a small "wait for release" window so the A/X that opened
 // the menu doesnt immediately trigger a choose/close here.
-void ContextMenu::OpenAt(float x, float y, float width, float rowH){
+void ContextMenu::OpenAt(float x, float y, float width, float rowH, float maxH){
     m_x=x; m_y=y; m_w=width; m_rowH=rowH;
+
+    // Rows that fit under the header (its text is never taller than a row)
+    m_rows = m_count;
+    if (maxH > 0.0f && rowH > 0.0f){
+        const float chrome = 8.0f + rowH + 6.0f + 6.0f + 12.0f;   // see Draw
+        int fit = (int)((maxH - chrome) / rowH);
+        if (fit < 3) fit = 3;
+        if (fit < m_rows) m_rows = fit;
+    }
     if (m_sel < 0) m_sel = 0;
     if (m_sel >= m_count) m_sel = (m_count>0)?(m_count-1):0;
 
@@ -92,6 +114,8 @@ void ContextMenu::OpenAt(float x, float y, float width, float rowH){
         else if (back >= 0) m_sel = back;
         else                m_sel = 0; // no selectable items; harmless default
     }
+    m_top = 0;
+    ScrollToSel();
 
     m_open=true;
     m_waitRelease=true; // avoid immediate A/X carry-over
@@ -137,7 +161,7 @@ void ContextMenu::Draw(CXBFont& font, LPDIRECT3DDEVICE8 dev) const{
 
     const FLOAT lineY   = y + headerTopPad + hdrH + headerBottomPad; // divider Y
     const FLOAT listTop = lineY + 6.0f;                               // first row Y
-    const FLOAT menuH   = (listTop - y) + (m_count * rowH) + bottomPad;
+    const FLOAT menuH   = (listTop - y) + (m_rows * rowH) + bottomPad;
 
     // Frame/background
     DrawRect(dev, x - 6.0f, y - 6.0f, menuW + 12.0f, menuH + 12.0f, 0xA0101010);
@@ -147,9 +171,19 @@ void ContextMenu::Draw(CXBFont& font, LPDIRECT3DDEVICE8 dev) const{
     DrawAnsi(font, x + 10.0f, y + headerTopPad, 0xFFFFFFFF, "Select action");
     DrawRect(dev, x, lineY, menuW, 1.0f, 0x60FFFFFF);
 
+    // Scroll bar along the right edge when not every row fits
+    const bool  scrolls = (m_rows < m_count);
+    const FLOAT barW    = scrolls ? 4.0f : 0.0f;
+    if (scrolls){
+        const FLOAT trackH = m_rows * rowH;
+        DrawRect(dev, x + menuW - barW - 2.0f, listTop, barW, trackH, 0x30FFFFFF);
+        DrawRect(dev, x + menuW - barW - 2.0f, listTop + trackH * m_top / m_count,
+                 barW, trackH * m_rows / m_count, 0xA0FFFFFF);
+    }
+
     // Rows
-    for (int i = 0; i < m_count; ++i){
-        const FLOAT rowY = listTop + i * rowH;
+    for (int i = m_top; i < m_top + m_rows && i < m_count; ++i){
+        const FLOAT rowY = listTop + (i - m_top) * rowH;
         const Item& it = m_items[i];
 
         if (it.separator){
@@ -161,7 +195,7 @@ void ContextMenu::Draw(CXBFont& font, LPDIRECT3DDEVICE8 dev) const{
         // Selection highlight (only meaningful on selectable rows)
         bool sel = (i == m_sel);
         D3DCOLOR row = sel ? 0x60FFFF00 : 0x20202020;
-        DrawRect(dev, x + 6.0f, rowY - 2.0f, menuW - 12.0f, rowH, row);
+        DrawRect(dev, x + 6.0f, rowY - 2.0f, menuW - 12.0f - barW, rowH, row);
 
         // Text color: normal/selected/disabled
         DWORD col = it.enabled ? (sel ? 0xFF202020 : 0xFFE0E0E0) : 0xFF7A7A7A;
@@ -216,6 +250,7 @@ ContextMenu::Result ContextMenu::OnPad(const XBGAMEPAD& pad, Action& outAct){
         int i = FindNextSelectable(m_sel + 1, +1);
         if (i >= 0) m_sel = i;
     }
+    if (up || down) ScrollToSel();
 
     // Button edges
     bool aTrig = (a > 30 && m_prevA <= 30);
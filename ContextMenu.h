@@ -32,8 +32,9 @@ public:
     // Add a visual separator line (non-selectable, just a divider)
     void AddSeparator(); 
 
-    // Open menu at screen coordinates (x,y), with given width and row height
-    void OpenAt(float x, float y, float width, float rowH);
+    // Open menu at screen coordinates (x,y), with given width and row height.
+    // maxH (0 = no limit) caps the panel height; rows past it scroll.
+    void OpenAt(float x, float y, float width, float rowH, float maxH = 0.0f);
 
     // Close the menu
     void Close();
@@ -67,11 +68,14 @@ private:
     // ---- helpers for navigation ----
     bool IsSelectable(int idx) const;            // is item enabled & not separator?
     int  FindNextSelectable(int start, int dir) const; // step up/down to next valid row
+    void ScrollToSel();                          // keep m_sel inside the row window
 
     // ---- state ----
-    Item  m_items[24];   // fixed-capacity list of menu rows
+    Item  m_items[32];   // fixed-capacity list of menu rows
     int   m_count;       // number of items in the list
     int   m_sel;         // currently highlighted row index
+    int   m_top;         // first row drawn
+    int   m_rows;        // rows that fit (== m_count unless scrolling)
 
     bool  m_open;        // true if menu is open
     bool  m_waitRelease; // absorbs the button press that opened the menu
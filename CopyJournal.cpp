@@ -0,0 +1,258 @@
+#include "CopyJournal.h"
+#include "JobQueue.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+
+/*
+============================================================================
+ CopyJournal (implementation)
+  File layout (all little-endian, same build reads and writes it):
+    [0]            JnlHeader (padded to kHdrArea)
+    [kSlot0/1]     JnlCursor, written alternately (512-byte apart)
+    [kDataOff]     ManifestRoot[rootCount]
+                   ManifestEntry[entryCount]
+                   names[namesBytes]
+  Checkpoints flush the destination file first, then the cursor, so the
+  cursor never points past data that is not on disk yet.
+============================================================================
+*/
+
+namespace {
+    const char*  kJournalPath = "T:\\CopyJob.jnl";
+    const DWORD  kMagic       = 0x4A4D4658;   // "XFMJ"
+    const DWORD  kVersion     = 3;            // 2: ManifestEntry gained mtime, 3: ManifestRoot skipped
+    const DWORD  kHdrArea     = 2048;
+    const DWORD  kSlot0       = kHdrArea;
+    const DWORD  kSlot1       = kHdrArea + 512;
+    const DWORD  kDataOff     = kHdrArea + 1024;
+    const DWORD  kEveryMs     = 1000;         // chunk checkpoint throttle
+
+    struct JnlHeader {
+        DWORD     magic;
+        DWORD     version;
+        DWORD     act;
+        DWORD     rootCount;
+        DWORD     entryCount;
+        DWORD     namesBytes;
+        ULONGLONG totalBytes;
+        char      srcDir[512];
+        char      dstDir[512];
+    };
+
+    struct JnlCursor {
+        DWORD     seq;
+        DWORD     root;
+        DWORD     entry;
+        DWORD     check;
+        ULONGLONG offset;
+    };
+
+    HANDLE s_h      = INVALID_HANDLE_VALUE;
+    DWORD  s_seq    = 0;
+    DWORD  s_root   = 0;
+    DWORD  s_lastMs = 0;
+
+    DWORD CursorCheck(const JnlCursor& c){
+        DWORD x = 0x9E3779B9u ^ c.seq;
+        x = (x << 5 | x >> 27) ^ c.root;
+        x = (x << 5 | x >> 27) ^ c.entry;
+        x = (x << 5 | x >> 27) ^ (DWORD)c.offset;
+        x = (x << 5 | x >> 27) ^ (DWORD)(c.offset >> 32);
+        return x;
+    }
+
+    bool WriteAt(DWORD pos, const void* p, DWORD n){
+        if (SetFilePointer(s_h, (LONG)pos, NULL, FILE_BEGIN) == 0xFFFFFFFFu) return false;
+        DWORD wr = 0;
+        return WriteFile(s_h, p, n, &wr, NULL) && wr == n;
+    }
+
+    bool ReadAt(HANDLE h, DWORD pos, void* p, DWORD n){
+        if (SetFilePointer(h, (LONG)pos, NULL, FILE_BEGIN) == 0xFFFFFFFFu) return false;
+        DWORD rd = 0;
+        return ReadFile(h, p, n, &rd, NULL) && rd == n;
+    }
+
+    // Persist the cursor into the older slot.
+    void WriteCursor(DWORD root, DWORD entry, ULONGLONG offset){
+        if (s_h == INVALID_HANDLE_VALUE) return;
+        JnlCursor c;
+        c.seq    = ++s_seq;
+        c.root   = root;
+        c.entry  = entry;
+        c.offset = offset;
+        c.check  = CursorCheck(c);
+        WriteAt((c.seq & 1) ? kSlot1 : kSlot0, &c, sizeof(c));
+        FlushFileBuffers(s_h);
+        s_lastMs = GetTickCount();
+    }
+
+    bool CursorValid(const JnlCursor& c){
+        return c.seq != 0 && c.check == CursorCheck(c);
+    }
+}
+
+namespace CopyJournal {
+
+const ULONGLONG kMinBytes = (ULONGLONG)32 * 1024 * 1024;
+
+bool Begin(const Job& job, const OpManifest& m){
+    Finish();
+
+    s_h = CreateFileA(kJournalPath, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                      CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (s_h == INVALID_HANDLE_VALUE) return false;
+
+    JnlHeader h;
+    ZeroMemory(&h, sizeof(h));
+    h.magic      = kMagic;
+    h.version    = kVersion;
+    h.act        = (DWORD)job.act;
+    h.rootCount  = (DWORD)m.roots.size();
+    h.entryCount = (DWORD)m.entries.size();
+    h.namesBytes = (DWORD)m.names.size();
+    h.totalBytes = m.totalBytes;
+    _snprintf(h.srcDir, sizeof(h.srcDir), "%s", job.srcDir); h.srcDir[sizeof(h.srcDir)-1] = 0;
+    _snprintf(h.dstDir, sizeof(h.dstDir), "%s", job.dstDir); h.dstDir[sizeof(h.dstDir)-1] = 0;
+
+    DWORD pos = kDataOff;
+    bool ok = WriteAt(0, &h, sizeof(h));
+    if (ok && h.rootCount){
+        ok = WriteAt(pos, &m.roots[0], h.rootCount * sizeof(ManifestRoot));
+        pos += h.rootCount * sizeof(ManifestRoot);
+    }
+    if (ok && h.entryCount){
+        ok = WriteAt(pos, &m.entries[0], h.entryCount * sizeof(ManifestEntry));
+        pos += h.entryCount * sizeof(ManifestEntry);
+    }
+    if (ok && h.namesBytes) ok = WriteAt(pos, &m.names[0], h.namesBytes);
+
+    if (!ok){ Finish(); return false; }
+
+    // Fresh cursor in both slots so Load never sees stale data.
+    s_seq = 0; s_root = 0;
+    WriteCursor(0, m.roots.empty() ? 0 : (DWORD)m.roots[0].first, 0);
+    WriteCursor(0, m.roots.empty() ? 0 : (DWORD)m.roots[0].first, 0);
+    return true;
+}
+
+bool Load(Job& job, OpManifest& m, size_t& root, CopyCursor& cursor){
+    Suspend();  // drop any handle we still hold; keep the file
+
+    HANDLE h = CreateFileA(kJournalPath, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
+
+    JnlHeader hd;
+    JnlCursor c0, c1;
+    bool ok = ReadAt(h, 0, &hd, sizeof(hd)) &&
+              hd.magic == kMagic && hd.version == kVersion &&
+              hd.rootCount > 0 && hd.rootCount < 0x10000 &&
+              hd.entryCount < 0x1000000 && hd.namesBytes < 0x4000000 &&
+              ReadAt(h, kSlot0, &c0, sizeof(c0)) &&
+              ReadAt(h, kSlot1, &c1, sizeof(c1));
+
+    if (ok){
+        m.roots.resize(hd.rootCount);
+        m.entries.resize(hd.entryCount);
+        m.names.resize(hd.namesBytes);
+        DWORD pos = kDataOff;
+        ok = ReadAt(h, pos, &m.roots[0], hd.rootCount * sizeof(ManifestRoot));
+        pos += hd.rootCount * sizeof(ManifestRoot);
+        if (ok && hd.entryCount){
+            ok = ReadAt(h, pos, &m.entries[0], hd.entryCount * sizeof(ManifestEntry));
+            pos += hd.entryCount * sizeof(ManifestEntry);
+        }
+        if (ok && hd.namesBytes) ok = ReadAt(h, pos, &m.names[0], hd.namesBytes);
+        m.totalBytes = hd.totalBytes;
+    }
+
+    // Sanity: root ranges inside the entry list, name offsets inside the pool.
+    for (size_t i = 0; ok && i < m.roots.size(); ++i)
+        if (m.roots[i].first > hd.entryCount || m.roots[i].count > hd.entryCount - m.roots[i].first ||
+            m.roots[i].relStart >= sizeof(m.roots[i].srcPath)) ok = false;
+    for (size_t i = 0; ok && i < m.entries.size(); ++i)
+        if (m.entries[i].nameOff >= hd.namesBytes) ok = false;
+    if (ok && hd.namesBytes && m.names[hd.namesBytes-1] != 0) ok = false;
+
+    // Newest intact cursor wins.
+    const JnlCursor* best = NULL;
+    if (ok && CursorValid(c0)) best = &c0;
+    if (ok && CursorValid(c1) && (!best || c1.seq > best->seq)) best = &c1;
+    if (!best) ok = false;
+
+    if (!ok){ CloseHandle(h); return false; }
+
+    job.act = (int)hd.act;
+    memcpy(job.srcDir, hd.srcDir, sizeof(job.srcDir)); job.srcDir[sizeof(job.srcDir)-1] = 0;
+    memcpy(job.dstDir, hd.dstDir, sizeof(job.dstDir)); job.dstDir[sizeof(job.dstDir)-1] = 0;
+    job.srcs.clear();
+    for (size_t i = 0; i < m.roots.size(); ++i){
+        m.roots[i].srcPath[sizeof(m.roots[i].srcPath)-1] = 0;
+        job.srcs.push_back(m.roots[i].srcPath);
+    }
+
+    root           = best->root;
+    cursor.entry   = best->entry;
+    cursor.offset  = best->offset;
+    cursor.fn      = OnCheckpoint;
+    cursor.user    = NULL;
+
+    s_h    = h;
+    s_seq  = best->seq;
+    s_root = best->root;
+    return true;
+}
+
+void BeginRoot(size_t root, size_t firstEntry){
+    s_root = (DWORD)root;
+    WriteCursor(s_root, (DWORD)firstEntry, 0);
+}
+
+void EndRoot(size_t root, const OpManifest& m){
+    const size_t next = root + 1;
+    s_root = (DWORD)next;
+    const DWORD entry = (next < m.roots.size()) ? (DWORD)m.roots[next].first
+                                                : (DWORD)m.entries.size();
+    WriteCursor(s_root, entry, 0);
+}
+
+void CopiedRoot(size_t root, const OpManifest& m){
+    const ManifestRoot& r = m.roots[root];
+    s_root = (DWORD)root;
+    WriteCursor(s_root, (DWORD)(r.first + r.count), 0);
+}
+
+void OnCheckpoint(size_t entry, ULONGLONG offset, HANDLE hDst, void*){
+    if (s_h == INVALID_HANDLE_VALUE) return;
+    if (GetTickCount() - s_lastMs < kEveryMs) return;
+
+    // Data first, then the cursor that vouches for it.
+    if (hDst != INVALID_HANDLE_VALUE) FlushFileBuffers(hDst);
+    WriteCursor(s_root, (DWORD)entry, offset);
+}
+
+void Suspend(){
+    if (s_h == INVALID_HANDLE_VALUE) return;
+    CloseHandle(s_h);
+    s_h = INVALID_HANDLE_VALUE;
+}
+
+void Finish(){
+    if (s_h == INVALID_HANDLE_VALUE) return;
+    CloseHandle(s_h);
+    s_h = INVALID_HANDLE_VALUE;
+    DeleteFileA(kJournalPath);
+}
+
+void Discard(){
+    Suspend();
+    DeleteFileA(kJournalPath);
+}
+
+bool Pending(){
+    return GetFileAttributesA(kJournalPath) != INVALID_FILE_ATTRIBUTES;
+}
+
+} // namespace CopyJournal
@@ -0,0 +1,53 @@
+#ifndef COPYJOURNAL_H
+#define COPYJOURNAL_H
+/*
+============================================================================
+ CopyJournal
+  - On-disk journal for large copy / cross-volume move jobs so an
+    interrupted transfer (cancel, power loss) resumes instead of restarting.
+  - One journal at a time, kept in the title area (T:\). It stores the job
+    (action, folders), the OpManifest and a cursor: current root, first
+    incomplete entry and the bytes of that entry already at the destination.
+  - The cursor lives in two fixed slots written alternately with a sequence
+    number and checksum, so a torn write never loses the previous position.
+  - Worker-thread API except Pending(), which the UI may call.
+============================================================================
+*/
+
+#include <xtl.h>
+#include "FsUtil.h"
+
+struct Job;
+
+namespace CopyJournal {
+    // Jobs below this size are not journaled (cancel cleans up as before).
+    extern const ULONGLONG kMinBytes;
+
+    // Start a journal for 'job' (replaces any previous one).
+    bool Begin(const Job& job, const OpManifest& m);
+    // Reload the interrupted job: fills job.act/srcs/srcDir/dstDir, the
+    // manifest and the resume position. False if missing or unreadable.
+    bool Load(Job& job, OpManifest& m, size_t& root, CopyCursor& cursor);
+
+    // Root boundaries are always persisted; chunk checkpoints are throttled.
+    void BeginRoot(size_t root, size_t firstEntry);
+    void EndRoot(size_t root, const OpManifest& m);
+    // A move has copied all of 'root' and is about to delete its source:
+    // persisted at once (cursor just past the root), so a resume goes
+    // straight to the delete and a discard keeps the destination.
+    void CopiedRoot(size_t root, const OpManifest& m);
+    // CopyCheckpointFn for CopyCursor::fn (user unused).
+    void OnCheckpoint(size_t entry, ULONGLONG offset, HANDLE hDst, void* user);
+
+    // Job stopped early (cancel, out of space): close, keep for resume.
+    void Suspend();
+    // Job completed: remove the journal.
+    void Finish();
+    // User gave up on the interrupted job: remove the journal file.
+    void Discard();
+
+    // True if an interrupted job is waiting (cheap attribute probe).
+    bool Pending();
+}
+
+#endif // COPYJOURNAL_H
@@ -0,0 +1,292 @@
+#include "DirCache.h"
+#include "FsUtil.h"
+#include "SearchIndex.h"
+#include "SizeService.h"
+#include "VolumeInfo.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+#include <ctype.h>
+
+/*
+============================================================================
+ DirCache (implementation)
+  - At most kMaxEntries listings / kMaxBytes; the least recently used one
+    goes first. A linear scan is fine at this size.
+  - Entries are only ever removed by name (or per volume); the volume
+    generation exists for listings in flight: anything that invalidates or
+    starts writing on a volume bumps it, and Store refuses a listing that
+    began under an older generation.
+  - Prefetched entries are evicted before used ones while nobody has
+    looked them up; the first Lookup turns them into ordinary entries.
+  - Hit rate goes to the debug output every kReportEvery lookups.
+============================================================================
+*/
+
+namespace {
+    const size_t kMaxEntries  = 12;
+    const size_t kMaxBytes    = 3 * 1024 * 1024;
+    const DWORD  kReportEvery = 128;
+
+    struct Entry {
+        char    key[512];   // normalized: trailing slash, as listed
+        int     vol;        // 0..25
+        DWORD   lastUse;    // LRU clock
+        bool    prefetched; // stored speculatively, not looked up yet
+        Listing list;
+    };
+
+    CRITICAL_SECTION   s_lock;
+    bool               s_init  = false;
+    std::vector<Entry*> s_entries;
+    DWORD              s_gen[26];
+    LONG               s_busy[26];     // running jobs that may write there
+    DWORD              s_clock = 0;
+    size_t             s_bytes = 0;
+    DirCache::Stats    s_stats;
+
+    void Lock(){
+        if (!s_init){
+            // First use is from the UI thread during init (no race yet)
+            InitializeCriticalSection(&s_lock);
+            ZeroMemory(s_gen,  sizeof(s_gen));
+            ZeroMemory(s_busy, sizeof(s_busy));
+            ZeroMemory(&s_stats, sizeof(s_stats));
+            s_init = true;
+        }
+        EnterCriticalSection(&s_lock);
+    }
+    void Unlock(){ LeaveCriticalSection(&s_lock); }
+
+    int VolOf(const char* p){
+        if (!p || !p[0] || p[1] != ':') return -1;
+        const int c = toupper((unsigned char)p[0]);
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : -1;
+    }
+
+    void MakeKey(const char* dir, char* out, size_t cap){
+        _snprintf(out, cap, "%s", dir); out[cap-1] = 0;
+        NormalizeDirA(out);
+    }
+
+    void Drop(size_t i){
+        s_bytes -= s_entries[i]->list.Bytes();
+        delete s_entries[i];
+        s_entries.erase(s_entries.begin() + i);
+    }
+
+    // Entries whose key starts with 'prefix' (case-insensitive)
+    void DropPrefix(const char* prefix){
+        const size_t n = strlen(prefix);
+        for (size_t i = s_entries.size(); i-- > 0; )
+            if (_strnicmp(s_entries[i]->key, prefix, n) == 0) Drop(i);
+    }
+
+    void Report(){
+        const DWORD looks = s_stats.hits + s_stats.misses;
+        if (!looks || looks % kReportEvery) return;
+        XBUtil_DebugPrint("DirCache: %lu%% hits (%lu/%lu), %lu bypassed, %u entries, %u KB, %lu evicted, %lu invalidated, prefetch %lu/%lu used",
+                          (unsigned long)(s_stats.hits * 100 / looks), (unsigned long)s_stats.hits,
+                          (unsigned long)looks, (unsigned long)s_stats.bypassed,
+                          (unsigned)s_entries.size(), (unsigned)(s_bytes / 1024),
+                          (unsigned long)s_stats.evictions, (unsigned long)s_stats.invalidations,
+                          (unsigned long)s_stats.prefetchHits, (unsigned long)s_stats.prefetchStores);
+    }
+
+    // Eviction order: unused prefetches first, then least recently used
+    bool EvictBefore(const Entry* a, const Entry* b){
+        if (a->prefetched != b->prefetched) return a->prefetched;
+        return a->lastUse < b->lastUse;
+    }
+
+    void Put(const char* dir, const Listing& l, DWORD gen, bool prefetched){
+        const int v = VolOf(dir);
+        if (v < 0) return;
+        const size_t bytes = l.Bytes();
+        if (bytes > kMaxBytes / 2) return;   // one huge folder would flush everything else
+        char key[512]; MakeKey(dir, key, sizeof(key));
+
+        Lock();
+        if (s_busy[v] || gen != s_gen[v]) { Unlock(); return; }
+
+        for (size_t i = 0; i < s_entries.size(); ++i)
+            if (s_entries[i]->vol == v && _stricmp(s_entries[i]->key, key) == 0) { Drop(i); break; }
+
+        // Make room
+        while (!s_entries.empty() &&
+               (s_entries.size() >= kMaxEntries || s_bytes + bytes > kMaxBytes)){
+            size_t lru = 0;
+            for (size_t i = 1; i < s_entries.size(); ++i)
+                if (EvictBefore(s_entries[i], s_entries[lru])) lru = i;
+            Drop(lru);
+            ++s_stats.evictions;
+        }
+
+        Entry* e = new Entry;
+        memcpy(e->key, key, sizeof(e->key));
+        e->vol        = v;
+        e->lastUse    = ++s_clock;
+        e->prefetched = prefetched;
+        e->list       = l;
+        e->list.SetFilter(NULL);     // the cache holds whole folders
+        e->list.ClearMarks();
+        s_entries.push_back(e);
+        s_bytes += e->list.Bytes();
+        ++s_stats.stores;
+        if (prefetched) ++s_stats.prefetchStores;
+        Unlock();
+    }
+}
+
+namespace DirCache {
+
+bool Lookup(const char* dir, Listing& out){
+    const int v = VolOf(dir);
+    if (v < 0) return false;
+    char key[512]; MakeKey(dir, key, sizeof(key));
+
+    const SortMode mode = out.Mode();
+    Lock();
+    if (s_busy[v]) { ++s_stats.bypassed; Unlock(); return false; }
+    bool hit = false;
+    for (size_t i = 0; i < s_entries.size(); ++i){
+        Entry* e = s_entries[i];
+        if (e->vol != v || _stricmp(e->key, key) != 0) continue;
+        e->lastUse = ++s_clock;
+        if (e->prefetched) { e->prefetched = false; ++s_stats.prefetchHits; }
+        out = e->list;
+        hit = true;
+        break;
+    }
+    if (hit) ++s_stats.hits; else ++s_stats.misses;
+    Report();
+    Unlock();
+    if (!hit) return false;
+    if (out.Mode() != mode){
+        // Cached in the other pane's order
+        out.SetSortMode(mode);
+        out.Sort((!out.Empty() && out.IsUpEntry(0)) ? 1 : 0);
+    }
+    out.ClearMarks();
+    return true;
+}
+
+DWORD Generation(const char* dir){
+    const int v = VolOf(dir);
+    if (v < 0) return 0;
+    Lock();
+    const DWORD g = s_gen[v];
+    Unlock();
+    return g;
+}
+
+void Store(const char* dir, const Listing& l, DWORD gen){
+    Put(dir, l, gen, false);
+}
+
+void Store(const char* dir, const Listing& l){
+    Store(dir, l, Generation(dir));
+}
+
+void StorePrefetched(const char* dir, const Listing& l, DWORD gen){
+    Put(dir, l, gen, true);
+}
+
+bool Contains(const char* dir){
+    const int v = VolOf(dir);
+    if (v < 0) return false;
+    char key[512]; MakeKey(dir, key, sizeof(key));
+    Lock();
+    bool found = false;
+    for (size_t i = 0; i < s_entries.size() && !found; ++i)
+        found = s_entries[i]->vol == v && _stricmp(s_entries[i]->key, key) == 0;
+    Unlock();
+    return found;
+}
+
+void Invalidate(const char* dir){
+    const int v = VolOf(dir);
+    if (v < 0) return;
+    char key[512]; MakeKey(dir, key, sizeof(key));
+
+    Lock();
+    ++s_gen[v];
+    for (size_t i = 0; i < s_entries.size(); ++i)
+        if (s_entries[i]->vol == v && _stricmp(s_entries[i]->key, key) == 0) { Drop(i); break; }
+    ++s_stats.invalidations;
+    Unlock();
+    SearchIndex::Changed(dir, false);
+    SizeService::Changed(dir, false);
+    VolumeInfo::Touch(dir);
+}
+
+void InvalidateTree(const char* path){
+    const int v = VolOf(path);
+    if (v < 0) return;
+
+    char key[512];    MakeKey(path, key, sizeof(key));
+    char parent[512]; _snprintf(parent, sizeof(parent), "%s", path); parent[sizeof(parent)-1] = 0;
+    ParentPath(parent);
+    if (parent[0]) NormalizeDirA(parent);
+
+    Lock();
+    ++s_gen[v];
+    DropPrefix(key);                      // the item's folder and everything below
+    for (size_t i = 0; parent[0] && i < s_entries.size(); ++i)
+        if (_stricmp(s_entries[i]->key, parent) == 0) { Drop(i); break; }   // the folder listing it
+    ++s_stats.invalidations;
+    Unlock();
+    SearchIndex::Changed(path, true);
+    SizeService::Changed(path, true);
+    VolumeInfo::Touch(path);
+}
+
+void InvalidateVolume(char letter){
+    const char root[4] = { letter, ':', '\\', 0 };
+    const int v = VolOf(root);
+    if (v < 0) return;
+
+    Lock();
+    ++s_gen[v];
+    for (size_t i = s_entries.size(); i-- > 0; )
+        if (s_entries[i]->vol == v) Drop(i);
+    ++s_stats.invalidations;
+    Unlock();
+    SearchIndex::Changed(root, true);
+    SizeService::Changed(root, true);
+    VolumeInfo::Touch(root);
+}
+
+DWORD VolumeBit(const char* path){
+    const int v = VolOf(path);
+    return v < 0 ? 0 : (1u << v);
+}
+
+void BeginWrite(DWORD volMask){
+    Lock();
+    for (int v = 0; v < 26; ++v)
+        if (volMask & (1u << v)) { ++s_busy[v]; ++s_gen[v]; }
+    Unlock();
+}
+
+void EndWrite(DWORD volMask){
+    Lock();
+    for (int v = 0; v < 26; ++v){
+        if (!(volMask & (1u << v))) continue;
+        if (s_busy[v] > 0) --s_busy[v];
+        ++s_gen[v];   // the job's own folders are invalidated by the caller
+    }
+    Unlock();
+}
+
+Stats GetStats(){
+    Lock();
+    Stats st = s_stats;
+    st.entries = s_entries.size();
+    st.bytes   = s_bytes;
+    Unlock();
+    return st;
+}
+
+} // namespace DirCache
@@ -0,0 +1,58 @@
+#ifndef DIRCACHE_H
+#define DIRCACHE_H
+/*
+============================================================================
+ DirCache
+  - Small LRU of recent folder listings so back-navigation and refreshes
+    after an operation come from memory instead of FindFirstFileA.
+  - Keyed by normalized folder path (case-insensitive) and the volume's
+    generation. Bounded by entry count and by bytes (Listing::Bytes).
+  - Kept exact by explicit invalidation: every operation of ours that
+    changes a folder invalidates it (and whole subtrees for deletes and
+    moves); DVD media changes drop the whole volume. While a background
+    job may write to a volume the cache is bypassed there (BeginWrite /
+    EndWrite), so a half-copied folder is never remembered.
+  - Every invalidation is passed on to SearchIndex::Changed and
+    SizeService::Changed, which rescan the same folders, and to
+    VolumeInfo::Touch (free space changed).
+  - Thread-safe (jobs finish on the worker, the UI looks up).
+============================================================================
+*/
+
+#include <xtl.h>
+#include "Listing.h"
+
+namespace DirCache {
+    struct Stats {
+        DWORD hits, misses, bypassed, stores, evictions, invalidations;
+        DWORD prefetchStores, prefetchHits;   // speculative entries / of those used
+        size_t entries, bytes;
+    };
+
+    // Fill 'out' (marks cleared, in out's sort mode) from the cache; false on a miss.
+    bool  Lookup(const char* dir, Listing& out);
+    // Generation token to take before listing 'dir' asynchronously; Store
+    // with it drops the result if the volume changed in between.
+    DWORD Generation(const char* dir);
+    void  Store(const char* dir, const Listing& l, DWORD gen);
+    void  Store(const char* dir, const Listing& l);   // just listed, synchronously
+    // Speculative listing (nobody asked yet): evicted before anything that
+    // was used, counted as a prefetch hit on its first Lookup.
+    void  StorePrefetched(const char* dir, const Listing& l, DWORD gen);
+    // Cheap presence test (no statistics, no LRU update).
+    bool  Contains(const char* dir);
+
+    void  Invalidate(const char* dir);        // entries of 'dir' changed
+    void  InvalidateTree(const char* path);   // 'path', its parent's entry and all below
+    void  InvalidateVolume(char letter);      // media change, format
+
+    // Volume bitmask (bit n = drive 'A'+n) of a path; 0 if none.
+    DWORD VolumeBit(const char* path);
+    // A job that may write to 'volMask' starts / ends.
+    void  BeginWrite(DWORD volMask);
+    void  EndWrite(DWORD volMask);
+
+    Stats GetStats();
+}
+
+#endif // DIRCACHE_H
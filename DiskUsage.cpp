@@ -0,0 +1,337 @@
+#include "DiskUsage.h"
+#include "FsUtil.h"
+#include "VolumeInfo.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+#include <ctype.h>
+#include <vector>
+#include <algorithm>
+
+/*
+============================================================================
+ DiskUsage (implementation)
+  - Depth-first with one open find handle per level (Frame), so the walk
+    itself costs memory proportional to the depth, not to the folder count.
+  - Record 0 is the volume root; every record links to its parent. A
+    folder's files are summed in its frame and added up the parent chain
+    when its enumeration closes (children close first).
+  - The largest files live in a min-heap (smallest on top) of kTopFiles.
+  - s_lock guards the records, the heap and the status; the enumeration
+    runs outside it.
+============================================================================
+*/
+
+namespace {
+    const DWORD  kUsageStack  = 64 * 1024;
+    const DWORD  kNone        = 0xFFFFFFFFu;
+    const size_t kMaxDirs     = 16384;
+    const size_t kMaxNameBytes = 512 * 1024;
+    const size_t kTopFiles    = 256;
+
+    struct DirRec {
+        DWORD     parent;
+        DWORD     nameOff;     // into s_names
+        ULONGLONG bytes;       // everything below, so far
+        ULONGLONG onDisk;
+    };
+
+    struct TopFile {
+        ULONGLONG bytes;
+        char      path[256];
+    };
+
+    struct SmallerOnTop {
+        bool operator()(const TopFile& a, const TopFile& b) const { return a.bytes > b.bytes; }
+    };
+
+    struct Frame {
+        HANDLE           h;
+        WIN32_FIND_DATAA fd;       // entry to process next
+        DWORD            rec;      // record the contents count towards
+        size_t           pathLen;  // s_path length for this folder
+        ULONGLONG        bytes, onDisk;
+    };
+
+    CRITICAL_SECTION     s_lock;
+    HANDLE               s_wake    = NULL;
+    HANDLE               s_thread  = NULL;
+    volatile LONG        s_request = 0;      // drive letter to scan next, 0: none
+    std::vector<DirRec>  s_dirs;
+    std::vector<char>    s_names;
+    std::vector<TopFile> s_top;              // heap (SmallerOnTop)
+    DiskUsage::Status    s_status;
+    bool                 s_stale   = false;  // Scan() asked for: records belong to the old walk
+    DWORD                s_gen     = 0;
+    char                 s_path[512];        // worker only
+
+    ULONGLONG RoundUp(ULONGLONG n, DWORD cluster){
+        if (!cluster) return n;
+        return (n + cluster - 1) / cluster * cluster;
+    }
+
+    // Record for a new folder; kNone once the budget is used up
+    DWORD AddDir(DWORD parent, const char* name){
+        const size_t len = strlen(name) + 1;
+        if (s_dirs.size() >= kMaxDirs || s_names.size() + len > kMaxNameBytes) return kNone;
+        DirRec d;
+        d.parent  = parent;
+        d.nameOff = (DWORD)s_names.size();
+        d.bytes   = 0;
+        d.onDisk  = 0;
+        s_names.insert(s_names.end(), name, name + len);
+        s_dirs.push_back(d);
+        return (DWORD)(s_dirs.size() - 1);
+    }
+
+    void NoteFile(ULONGLONG bytes, const char* dir, const char* name){
+        if (s_top.size() >= kTopFiles && bytes <= s_top.front().bytes) return;   // the common case, no lock
+        TopFile t;
+        t.bytes = bytes;
+        JoinPath(t.path, sizeof(t.path), dir, name);
+
+        EnterCriticalSection(&s_lock);
+        if (s_top.size() >= kTopFiles){
+            std::pop_heap(s_top.begin(), s_top.end(), SmallerOnTop());
+            s_top.pop_back();
+        }
+        s_top.push_back(t);
+        std::push_heap(s_top.begin(), s_top.end(), SmallerOnTop());
+        LeaveCriticalSection(&s_lock);
+    }
+
+    bool Open(Frame& f){
+        char mask[512]; JoinPath(mask, sizeof(mask), s_path, "*");
+        f.h = FindFirstFileA(mask, &f.fd);
+        f.bytes = f.onDisk = 0;
+        return f.h != INVALID_HANDLE_VALUE;
+    }
+
+    // Folder done: its files count for it and every ancestor
+    void Close(Frame& f, DWORD dirsSeen, DWORD filesSeen){
+        if (f.h != INVALID_HANDLE_VALUE) FindClose(f.h);
+        EnterCriticalSection(&s_lock);
+        for (DWORD r = f.rec; r != kNone; r = s_dirs[r].parent){
+            s_dirs[r].bytes  += f.bytes;
+            s_dirs[r].onDisk += f.onDisk;
+        }
+        if (!s_stale){
+            s_status.dirs   = dirsSeen;
+            s_status.files  = filesSeen;
+            s_status.bytes  = s_dirs[0].bytes;
+            s_status.onDisk = s_dirs[0].onDisk;
+            ++s_gen;
+        }
+        LeaveCriticalSection(&s_lock);
+    }
+
+    void Walk(char letter){
+        const char root[4] = { letter, ':', '\\', 0 };
+        const DWORD t0 = GetTickCount();
+
+        VolumeInfo::Info vi;
+        const DWORD cluster = (VolumeInfo::Get(root, vi) && vi.clusterBytes) ? vi.clusterBytes
+                                                                             : XGetDiskClusterSize(root);
+        EnterCriticalSection(&s_lock);
+        s_dirs.clear();
+        s_names.clear();
+        s_top.clear();
+        s_dirs.reserve(kMaxDirs);
+        s_top.reserve(kTopFiles);
+        ZeroMemory(&s_status, sizeof(s_status));
+        memcpy(s_status.root, root, sizeof(root));
+        s_stale = false;
+        AddDir(kNone, "");
+        ++s_gen;
+        LeaveCriticalSection(&s_lock);
+
+        std::vector<Frame> stack;
+        DWORD dirs = 1, files = 0;
+        bool  folded = false, cancelled = false;
+
+        _snprintf(s_path, sizeof(s_path), "%s", root); s_path[sizeof(s_path)-1] = 0;
+        Frame top;
+        top.rec = 0;
+        top.pathLen = strlen(s_path);
+        if (Open(top)) stack.push_back(top);
+
+        while (!stack.empty()){
+            if (s_request) { cancelled = true; break; }
+            Frame& f = stack.back();
+            s_path[f.pathLen] = 0;
+
+            if (f.h == INVALID_HANDLE_VALUE){
+                Close(f, dirs, files);
+                stack.pop_back();
+                continue;
+            }
+            WIN32_FIND_DATAA fd = f.fd;
+            if (!FindNextFileA(f.h, &f.fd)) { FindClose(f.h); f.h = INVALID_HANDLE_VALUE; }
+            if (!IsListedName(fd.cFileName, f.pathLen <= 3)) continue;
+
+            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY){
+                ++dirs;
+                EnterCriticalSection(&s_lock);
+                DWORD rec = AddDir(f.rec, fd.cFileName);
+                LeaveCriticalSection(&s_lock);
+                if (rec == kNone) { rec = f.rec; folded = true; }
+
+                Frame child;
+                child.rec = rec;
+                char sub[512]; JoinPath(sub, sizeof(sub), s_path, fd.cFileName);
+                _snprintf(s_path, sizeof(s_path), "%s", sub); s_path[sizeof(s_path)-1] = 0;
+                child.pathLen = strlen(s_path);
+                if (!Open(child)) child.h = INVALID_HANDLE_VALUE;
+                stack.push_back(child);            // f is invalid from here on
+            } else {
+                ++files;
+                const ULONGLONG n = (((ULONGLONG)fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+                f.bytes  += n;
+                f.onDisk += RoundUp(n, cluster);
+                NoteFile(n, s_path, fd.cFileName);
+            }
+        }
+        for (size_t i = stack.size(); i-- > 0; )
+            if (stack[i].h != INVALID_HANDLE_VALUE) FindClose(stack[i].h);
+
+        if (cancelled) { XBUtil_DebugPrint("DiskUsage: %s cancelled after %lu folders", root, (unsigned long)dirs); return; }
+
+        EnterCriticalSection(&s_lock);
+        s_status.dirs   = dirs;
+        s_status.files  = files;
+        s_status.folded = folded;
+        s_status.done   = true;
+        s_status.ms     = GetTickCount() - t0;
+        ++s_gen;
+        LeaveCriticalSection(&s_lock);
+
+        char used[64]; FormatSize(s_status.bytes, used, sizeof(used));
+        XBUtil_DebugPrint("DiskUsage: %s %s, %lu folders, %lu files in %lu ms (cluster %lu)%s",
+                          root, used, (unsigned long)dirs, (unsigned long)files,
+                          (unsigned long)s_status.ms, (unsigned long)cluster, folded ? ", folded" : "");
+    }
+
+    DWORD WINAPI UsageMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, INFINITE);
+            for (;;){
+                const LONG letter = InterlockedExchange(&s_request, 0);
+                if (!letter) break;
+                Walk((char)letter);
+            }
+        }
+        return 0;
+    }
+
+    // Record of 'dir' ("F:\a\b"), kNone if not recorded
+    DWORD FindDir(const char* dir){
+        if (s_stale || s_dirs.empty() || toupper((unsigned char)dir[0]) != s_status.root[0] || dir[1] != ':') return kNone;
+        DWORD cur = 0;
+        const char* p = dir + 2;
+        while (*p){
+            while (*p == '\\') ++p;
+            if (!*p) break;
+            const char* e = strchr(p, '\\');
+            const size_t n = e ? (size_t)(e - p) : strlen(p);
+            DWORD next = kNone;
+            for (size_t i = 1; i < s_dirs.size() && next == kNone; ++i){
+                const char* name = &s_names[s_dirs[i].nameOff];
+                if (s_dirs[i].parent == cur && _strnicmp(name, p, n) == 0 && name[n] == 0) next = (DWORD)i;
+            }
+            if (next == kNone) return kNone;
+            cur = next;
+            p += n;
+        }
+        return cur;
+    }
+
+    struct BySize {
+        bool operator()(const std::pair<ULONGLONG, DWORD>& a, const std::pair<ULONGLONG, DWORD>& b) const { return a.first > b.first; }
+    };
+}
+
+namespace DiskUsage {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    ZeroMemory(&s_status, sizeof(s_status));
+    s_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kUsageStack, UsageMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    SetThreadPriority(s_thread, THREAD_PRIORITY_LOWEST);
+    return true;
+}
+
+void Scan(char letter){
+    if (!s_thread) return;
+    letter = (char)toupper((unsigned char)letter);
+    EnterCriticalSection(&s_lock);
+    // Shows up at once as the volume being scanned; the worker owns the
+    // records and resets them when the new walk starts
+    s_stale = true;
+    ZeroMemory(&s_status, sizeof(s_status));
+    s_status.root[0] = letter; s_status.root[1] = ':'; s_status.root[2] = '\\';
+    ++s_gen;
+    LeaveCriticalSection(&s_lock);
+    InterlockedExchange(&s_request, (LONG)letter);   // also stops a walk in progress
+    SetEvent(s_wake);
+}
+
+Status GetStatus(){
+    Status st;
+    ZeroMemory(&st, sizeof(st));
+    if (!s_thread) return st;
+    EnterCriticalSection(&s_lock);
+    st = s_status;
+    LeaveCriticalSection(&s_lock);
+    return st;
+}
+
+DWORD Generation(){
+    return s_gen;
+}
+
+bool View(const char* dir, Listing& out, size_t topN, ULONGLONG& bytes, ULONGLONG& onDisk){
+    out.Clear();
+    bytes = onDisk = 0;
+    if (!s_thread || !dir || !dir[0]) return false;
+
+    EnterCriticalSection(&s_lock);
+    const DWORD d = FindDir(dir);
+    if (d == kNone) { LeaveCriticalSection(&s_lock); return false; }
+    bytes  = s_dirs[d].bytes;
+    onDisk = s_dirs[d].onDisk;
+
+    // Subfolders, biggest first
+    std::vector< std::pair<ULONGLONG, DWORD> > subs;
+    for (size_t i = 1; i < s_dirs.size(); ++i)
+        if (s_dirs[i].parent == d) subs.push_back(std::make_pair(s_dirs[i].bytes, (DWORD)i));
+    const size_t nSubs = subs.size() < topN ? subs.size() : topN;
+    std::partial_sort(subs.begin(), subs.begin() + nSubs, subs.end(), BySize());
+    for (size_t k = 0; k < nSubs; ++k){
+        char full[512]; JoinPath(full, sizeof(full), dir, &s_names[s_dirs[subs[k].second].nameOff]);
+        out.Add(full, true, subs[k].first, FILE_ATTRIBUTE_DIRECTORY);
+    }
+
+    // Largest files below 'dir' (from the volume-wide top list)
+    const size_t n = strlen(dir);
+    const bool   atRoot = dir[n-1] == '\\';
+    std::vector< std::pair<ULONGLONG, DWORD> > files;
+    for (size_t i = 0; i < s_top.size(); ++i){
+        const char* p = s_top[i].path;
+        if (_strnicmp(p, dir, n) == 0 && (atRoot || p[n] == '\\')) files.push_back(std::make_pair(s_top[i].bytes, (DWORD)i));
+    }
+    const size_t nFiles = files.size() < topN ? files.size() : topN;
+    std::partial_sort(files.begin(), files.begin() + nFiles, files.end(), BySize());
+    for (size_t k = 0; k < nFiles; ++k) out.Add(s_top[files[k].second].path, false, files[k].first, 0);
+    LeaveCriticalSection(&s_lock);
+    return true;
+}
+
+} // namespace DiskUsage
@@ -0,0 +1,48 @@
+#ifndef DISKUSAGE_H
+#define DISKUSAGE_H
+/*
+============================================================================
+ DiskUsage
+  - What is using the space on one volume: a low-priority thread walks the
+    volume once and records every folder's total (logical and rounded up
+    to the volume's cluster size) plus the largest files, from the same
+    enumeration.
+  - Results stream: each folder's bytes are added to it and its ancestors
+    as soon as it has been listed, so View() gives useful answers long
+    before the walk ends.
+  - Fixed memory: at most kMaxDirs folder records and a bounded name
+    arena; folders past that are counted in their nearest recorded
+    ancestor (Status::folded). The largest kTopFiles files are kept.
+  - One scan at a time; Scan() replaces the previous one. Thread-safe.
+============================================================================
+*/
+
+#include <xtl.h>
+#include "Listing.h"
+
+namespace DiskUsage {
+    struct Status {
+        char      root[4];      // volume of the current / last scan, "" if none
+        bool      done;         // walk finished (or cancelled by a new Scan)
+        bool      folded;       // folder budget reached, see above
+        DWORD     dirs, files;  // seen so far
+        ULONGLONG bytes;        // logical
+        ULONGLONG onDisk;       // rounded up to clusters
+        DWORD     ms;           // walk time so far
+    };
+
+    bool   Start();
+    // Drop the previous results and walk drive 'letter'.
+    void   Scan(char letter);
+    Status GetStatus();
+    // Bumps whenever totals change (cheap polling for redraws).
+    DWORD  Generation();
+    // Clear 'out' and fill it for folder 'dir' of the scanned volume: its
+    // largest subfolders, then the largest files anywhere below it, at most
+    // 'topN' of each, biggest first. Names are full paths, sizes are
+    // logical totals. 'bytes' / 'onDisk' are the folder's totals. False if
+    // the folder has not been reached (yet).
+    bool   View(const char* dir, Listing& out, size_t topN, ULONGLONG& bytes, ULONGLONG& onDisk);
+}
+
+#endif // DISKUSAGE_H
@@ -2,6 +2,14 @@
 #include "AppActions.h"
 #include "GfxPrims.h"
 #include "FsUtil.h"
+#include "CopyJournal.h"
+#include "Trash.h"
+#include "ListStream.h"
+#include "DirCache.h"
+#include "SearchIndex.h"
+#include "SizeService.h"
+#include "VolumeInfo.h"
+#include "DiskUsage.h"
 #include <wchar.h>
 #include <stdarg.h>
 #include <algorithm>
@@ -29,6 +37,7 @@ namespace {
     inline FLOAT MaxF(FLOAT a, FLOAT b){ return (a>b)?a:b; }
 	inline FLOAT MinF(FLOAT a, FLOAT b) { return (a < b) ? a : b; }
     inline int   MaxI (int a,   int b){ return (a>b)?a:b; }
+    inline int   MinI (int a,   int b){ return (a<b)?a:b; }
     inline FLOAT Snap (FLOAT v){ return (FLOAT)((int)(v + 0.5f)); } // pixel-align
 
     // Draw ANSI string via CXBFont (expects UTF-16); convert on the fly.
@@ -48,6 +57,19 @@ static bool WriteAllA(const char* path, const void* data, DWORD size){
     DWORD wrote = 0; BOOL ok = WriteFile(h, data, size, &wrote, NULL); CloseHandle(h);
     return ok && wrote == size;
 }
+// A job copied/moved 'srcs' into 'dstDir': its entries changed, and below it
+// only the copied items' subtrees (not every sibling folder).
+static void InvalidateCopiedInto(const char* dstDir, const std::vector<std::string>& srcs){
+    DirCache::Invalidate(dstDir);
+    for (size_t k=0; k<srcs.size(); ++k){
+        char src[512]; _snprintf(src, sizeof(src), "%s", srcs[k].c_str()); src[sizeof(src)-1]=0;
+        size_t n = strlen(src);
+        while (n > 3 && src[n-1]=='\\') src[--n]=0;
+        const char* leaf = strrchr(src, '\\');
+        char dst[512]; JoinPath(dst, sizeof(dst), dstDir, leaf ? leaf+1 : src);
+        DirCache::InvalidateTree(dst);
+    }
+}
 
 
 
@@ -320,6 +342,20 @@ FileBrowserApp::FileBrowserApp(){
     m_dvdUsedBytes  = 0;
     m_dvdTotalBytes = 0;
     m_dvdHaveStats  = false;
+    m_fanLabel[0]   = 0;
+    m_sortLabel[0]  = 0;
+    m_showDates     = false;
+    m_findKind      = FIND_JUMP;
+    m_findLast[0]   = 0;
+    m_findPrev[0]   = 0;
+    m_findPrevSel   = 0;
+    m_findPrevScroll= 0;
+    for (int i=0; i<2; ++i) { m_stream[i].active = false; m_stream[i].selectName[0] = 0; }
+    ZeroMemory(&m_prefetch, sizeof(m_prefetch));
+    m_calcPath[0]   = 0;
+    m_calcT0        = 0;
+    for (int i=0; i<2; ++i) { m_usageGen[i] = 0; m_usageBuiltMs[i] = 0; }
+    m_usageDone     = true;
 
     // --- Auto-detect video capabilities and set PresentParams ----------------
 	ZeroMemory(&m_d3dpp, sizeof(m_d3dpp));
@@ -382,6 +418,9 @@ FileBrowserApp::FileBrowserApp(){
     m_dvdUsedBytes  = 0;
     m_dvdTotalBytes = 0;
     m_dvdHaveStats  = 0;
+    m_dvdSerial     = 0xFFFFFFFF;
+    m_dvdSizing     = false;
+    m_dvdSizeT0     = 0;
 }
 
 
@@ -422,26 +461,248 @@ void FileBrowserApp::RefreshPane(Pane& p){
     if (p.mode==1){
         int prevSel   = p.sel;
         int prevScroll= p.scroll;
+        char filter[64]; _snprintf(filter, sizeof(filter), "%s", p.items.Filter()); filter[sizeof(filter)-1]=0;
 
-        ListDirectory(p.curPath, p.items);
+        ListPaneNow(p);
+        if (filter[0]) p.items.SetFilter(filter);   // same folder: keep the view
 
-        if (prevSel >= (int)p.items.size()) prevSel = (int)p.items.size()-1;
+        if (prevSel >= (int)p.items.Count()) prevSel = (int)p.items.Count()-1;
         if (prevSel < 0) prevSel = 0;
         p.sel = prevSel;
 
-        int maxScroll = MaxI(0, (int)p.items.size() - m_visible);
+        int maxScroll = MaxI(0, (int)p.items.Count() - m_visible);
         if (prevScroll > maxScroll) prevScroll = maxScroll;
         if (prevScroll < 0) prevScroll = 0;
         p.scroll = prevScroll;
-    } else {
+    } else if (p.mode==0){
         // Drive list mode: re-enumerate mounted roots
         BuildDriveItems(p.items);
-        if (p.sel >= (int)p.items.size()) p.sel = (int)p.items.size()-1;
+        if (p.sel >= (int)p.items.Count()) p.sel = (int)p.items.Count()-1;
         if (p.sel < 0) p.sel = 0;
         p.scroll = 0;
     }
 }
 
+// List p.curPath asynchronously: ".." right away, entries as they arrive
+// (PumpListings). selectName (optional) is selected when it shows up.
+// A cached listing (DirCache) is shown at once instead.
+void FileBrowserApp::StreamListing(Pane& p, const char* selectName){
+    StreamState& st = m_stream[PaneIndex(p)];
+    if (DirCache::Lookup(p.curPath, p.items)){
+        if (st.active) { ListStream::Cancel(PaneIndex(p)); st.active = false; }
+        st.selectName[0] = 0;
+        NoteEnter(p.curPath, true, 0);
+        if (selectName && selectName[0]) SelectItemInPane(p, selectName);
+        return;
+    }
+    p.items.Clear();
+    if (strlen(p.curPath) > 3) p.items.Add("..", true, 0, 0, true);
+
+    _snprintf(st.selectName, sizeof(st.selectName), "%s", selectName ? selectName : "");
+    st.selectName[sizeof(st.selectName)-1] = 0;
+    st.gen    = DirCache::Generation(p.curPath);
+    st.t0     = GetTickCount();
+    st.active = ListStream::Request(PaneIndex(p), p.curPath, p.items.Mode());
+    if (!st.active){
+        // No stream thread: list in place
+        if (ListDirectory(p.curPath, p.items)) DirCache::Store(p.curPath, p.items, st.gen);
+        if (st.selectName[0]) SelectItemInPane(p, st.selectName);
+        st.selectName[0] = 0;
+    }
+}
+
+// Synchronous listing; anything still streaming for this pane is dropped.
+void FileBrowserApp::ListPaneNow(Pane& p){
+    StreamState& st = m_stream[PaneIndex(p)];
+    if (st.active) { ListStream::Cancel(PaneIndex(p)); st.active = false; st.selectName[0] = 0; }
+    if (DirCache::Lookup(p.curPath, p.items)) return;
+    const DWORD gen = DirCache::Generation(p.curPath);
+    if (ListDirectory(p.curPath, p.items)) DirCache::Store(p.curPath, p.items, gen);
+}
+
+// Merge batches that arrived since the last frame. The highlighted entry
+// stays highlighted and keeps its row on screen while the list grows.
+void FileBrowserApp::PumpListings(){
+    for (int i=0; i<2; ++i){
+        StreamState& st = m_stream[i];
+        if (!st.active) continue;
+        Pane& p = m_pane[i];
+        if (p.mode != 1) { ListStream::Cancel(i); st.active = false; continue; }   // left the folder
+
+        Listing batch;
+        const ListStream::State state = ListStream::Take(i, batch);
+        if (!batch.Empty()){
+            const int row = p.sel - p.scroll;
+            size_t track = (size_t)p.sel;
+            p.items.Merge(batch, (!p.items.Empty() && p.items.IsUpEntry(0)) ? 1 : 0,
+                          p.items.Empty() ? NULL : &track);
+            p.sel    = (int)track;
+            p.scroll = MaxI(0, MinI(p.sel - row, (int)p.items.Count() - m_visible));
+
+            if (st.selectName[0] && p.items.Find(st.selectName) != Listing::npos){
+                SelectItemInPane(p, st.selectName);
+                st.selectName[0] = 0;
+            }
+        }
+        if (state == ListStream::LS_DONE){
+            DirCache::Store(p.curPath, p.items, st.gen);
+            NoteEnter(p.curPath, false, GetTickCount() - st.t0);
+        }
+        if (state != ListStream::LS_RUNNING) { st.active = false; st.selectName[0] = 0; }
+    }
+}
+
+// Prefetch: once the cursor has rested on a folder for kPrefetchDwellMs,
+// list it on ListStream's prefetch slot and keep the result in DirCache;
+// then the active pane's parent if we are deep. Nothing starts while a job
+// runs or a pane is streaming, and the slot itself yields to the panes.
+static const DWORD kPrefetchDwellMs = 300;
+
+void FileBrowserApp::PumpPrefetch(){
+    PrefetchState& pf = m_prefetch;
+    if (pf.busy){
+        Listing got;
+        const ListStream::State state = ListStream::Take(ListStream::kPrefetchSlot, got);
+        if (state == ListStream::LS_RUNNING) return;
+        pf.busy = false;
+        if (state == ListStream::LS_DONE){
+            // Same shape as a pane listing: ".." first, then the folder
+            Listing l;
+            l.SetSortMode(got.Mode());
+            if (strlen(pf.path) > 3) l.Add("..", true, 0, 0, true);
+            l.Merge(got, l.Count(), NULL);
+            DirCache::StorePrefetched(pf.path, l, pf.gen);
+            ++pf.completed;
+        } else {
+            ++pf.abandoned;
+        }
+    }
+
+    const Pane& p = m_pane[m_active];
+    char at[512] = "";
+    if (!p.items.Empty() && p.items.IsDir(p.sel) && !p.items.IsUpEntry(p.sel)){
+        if (p.mode == 1) JoinPath(at, sizeof(at), p.curPath, p.items.Name(p.sel));
+        else { _snprintf(at, sizeof(at), "%s", p.items.Name(p.sel)); at[sizeof(at)-1]=0; }   // drive or result
+    }
+    const DWORD now = GetTickCount();
+    if (_stricmp(at, pf.at) != 0){
+        memcpy(pf.at, at, sizeof(pf.at));
+        pf.since = now;
+        pf.stage = 0;
+        return;
+    }
+    if (!at[0] || now - pf.since < kPrefetchDwellMs) return;
+    if (JobQueue::Busy() || m_stream[0].active || m_stream[1].active) return;
+
+    while (pf.stage < 2){
+        char dir[512] = "";
+        if (pf.stage == 0) memcpy(dir, at, sizeof(dir));
+        else if (p.mode == 1 && strchr(p.curPath + 3, '\\')){
+            // Two or more levels down: B is likely after A
+            _snprintf(dir, sizeof(dir), "%s", p.curPath); dir[sizeof(dir)-1]=0;
+            ParentPath(dir);
+        }
+        ++pf.stage;
+        if (!dir[0] || DirCache::Contains(dir)) continue;
+
+        _snprintf(pf.path, sizeof(pf.path), "%s", dir); pf.path[sizeof(pf.path)-1]=0;
+        pf.gen  = DirCache::Generation(dir);
+        pf.busy = ListStream::Request(ListStream::kPrefetchSlot, dir, p.items.Mode());
+        if (pf.busy) ++pf.issued;
+        return;
+    }
+}
+
+// Toast the "Calculate size" result once SizeService has the total.
+void FileBrowserApp::PumpCalcSize(){
+    if (!m_calcPath[0]) return;
+    ULONGLONG bytes = 0;
+    if (!SizeService::Get(m_calcPath, bytes, true)) {
+        if (GetFileAttributesA(m_calcPath) == INVALID_FILE_ATTRIBUTES) m_calcPath[0] = 0;   // gone meanwhile
+        return;
+    }
+    char tmp[64]; FormatSize(bytes, tmp, sizeof(tmp));
+    SetStatus("%s: %s (%lu ms)", m_calcPath, tmp, (unsigned long)(GetTickCount() - m_calcT0));
+    m_calcPath[0] = 0;
+}
+
+// New disc: used space from the per-serial cache, else size it in the background.
+void FileBrowserApp::BeginDvdStats(DWORD serial){
+    m_dvdSerial = serial;
+    ULONGLONG used = 0;
+    if (DvdGetUsedBytes(serial, used)) {
+        m_dvdUsedBytes  = used;
+        m_dvdTotalBytes = used;
+        m_dvdHaveStats  = true;
+        m_dvdSizing     = false;
+        VolumeInfo::Touch("D:\\");
+        return;
+    }
+    m_dvdUsedBytes  = 0;
+    m_dvdTotalBytes = 0;
+    m_dvdHaveStats  = false;
+    m_dvdSizing     = true;
+    m_dvdSizeT0     = GetTickCount();
+}
+
+// The drive list and footer pick the total up once it is cached.
+void FileBrowserApp::PumpDvdSize(){
+    if (!m_dvdSizing) return;
+    ULONGLONG used = 0;
+    if (!SizeService::Get("D:\\", used, true)) return;
+    m_dvdSizing     = false;
+    m_dvdUsedBytes  = used;
+    m_dvdTotalBytes = used;
+    m_dvdHaveStats  = true;
+    DvdSetUsedBytes(m_dvdSerial, used);
+    VolumeInfo::Touch("D:\\");
+    char tmp[64]; FormatSize(used, tmp, sizeof(tmp));
+    XBUtil_DebugPrint("DVD: %08lX uses %s (%lu ms)", (unsigned long)m_dvdSerial,
+                      tmp, (unsigned long)(GetTickCount() - m_dvdSizeT0));
+}
+
+// Folder open statistics for the debug output: how many came from the
+// cache (prefetched or not) and what the rest cost, D: separately.
+void FileBrowserApp::NoteEnter(const char* dir, bool cached, DWORD ms){
+    PrefetchState& pf = m_prefetch;
+    if (cached) ++pf.enterCached;
+    else {
+        ++pf.enterListed; pf.enterListedMs += ms;
+        if (dir[0]=='D' || dir[0]=='d') { ++pf.enterD; pf.enterDMs += ms; }
+    }
+    const DWORD n = pf.enterCached + pf.enterListed;
+    if (n % 32) return;
+    const DirCache::Stats cs = DirCache::GetStats();
+    XBUtil_DebugPrint("Enter: %lu%% cached (%lu/%lu), listed avg %lu ms (D: %lu ms x%lu); prefetch %lu issued, %lu listed, %lu used, %lu abandoned",
+                      (unsigned long)(pf.enterCached * 100 / n), (unsigned long)pf.enterCached, (unsigned long)n,
+                      (unsigned long)(pf.enterListed ? pf.enterListedMs / pf.enterListed : 0),
+                      (unsigned long)(pf.enterD ? pf.enterDMs / pf.enterD : 0), (unsigned long)pf.enterD,
+                      (unsigned long)pf.issued, (unsigned long)pf.completed,
+                      (unsigned long)cs.prefetchHits, (unsigned long)pf.abandoned);
+}
+
+// Refresh only the panes a finished job could have changed: folders equal to
+// dirA/dirB (trailing slash ignored) and drive lists (free space). Other
+// panes keep their marks and scroll.
+void FileBrowserApp::RefreshPanesShowing(const char* dirA, const char* dirB){
+    for (int i=0; i<2; ++i){
+        Pane& p = m_pane[i];
+        bool hit = (p.mode != 1);
+        if (!hit){
+            char cur[512]; _snprintf(cur, sizeof(cur), "%s", p.curPath); cur[sizeof(cur)-1]=0;
+            NormalizeDirA(cur);
+            const char* dirs[2] = { dirA, dirB };
+            for (int k=0; k<2 && !hit; ++k){
+                if (!dirs[k] || !dirs[k][0]) continue;
+                char d[512]; _snprintf(d, sizeof(d), "%s", dirs[k]); d[sizeof(d)-1]=0;
+                NormalizeDirA(d);
+                hit = (_stricmp(cur, d) == 0);
+            }
+        }
+        if (hit) RefreshPane(p);
+    }
+}
+
 // Resolve the destination directory for copy/move based on the other pane.
 // Returns normalized path with trailing slash in outDst on success.
 bool FileBrowserApp::ResolveDestDir(char* outDst, size_t cap){
@@ -455,10 +716,9 @@ bool FileBrowserApp::ResolveDestDir(char* outDst, size_t cap){
         return true;
     }
     // If the other pane is the drive list, allow selecting a drive as destination.
-    if (!dst.items.empty()){
-        const Item& di = dst.items[dst.sel];
-        if (di.isDir && !di.isUpEntry){
-            _snprintf(outDst, (int)cap, "%s", di.name);  // e.g. "E:\"
+    if (!dst.items.Empty()){
+        if (dst.items.IsDir(dst.sel) && !dst.items.IsUpEntry(dst.sel)){
+            _snprintf(outDst, (int)cap, "%s", dst.items.Name(dst.sel));  // e.g. "E:\"
             outDst[cap-1]=0;
             NormalizeDirA(outDst);
             return true;
@@ -480,10 +740,9 @@ bool FileBrowserApp::ResolveSrcDir(char* srcDst, size_t cap) {
         return true;
     }
     // If the other pane is the drive list, allow selecting a drive as destination.
-    if (!dst.items.empty()) {
-        const Item& di = dst.items[dst.sel];
-        if (di.isDir && !di.isUpEntry) {
-            _snprintf(srcDst, (int)cap, "%s", di.name);  // e.g. "E:\"
+    if (!dst.items.Empty()) {
+        if (dst.items.IsDir(dst.sel) && !dst.items.IsUpEntry(dst.sel)) {
+            _snprintf(srcDst, (int)cap, "%s", dst.items.Name(dst.sel));  // e.g. "E:\"
             srcDst[cap - 1] = 0;
             NormalizeDirA(srcDst);
             return true;
@@ -494,15 +753,12 @@ bool FileBrowserApp::ResolveSrcDir(char* srcDst, size_t cap) {
 
 // Select an item in a pane by name and adjust scroll to reveal it.
 void FileBrowserApp::SelectItemInPane(Pane& p, const char* name){
-    if (!name || p.items.empty()) return;
-    for (int i=0;i<(int)p.items.size();++i){
-        if (_stricmp(p.items[i].name, name) == 0){
-            p.sel = i;
-            if (p.sel < p.scroll) p.scroll = p.sel;
-            if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
-            return;
-        }
-    }
+    if (!name || p.items.Empty()) return;
+    const size_t i = p.items.Find(name);
+    if (i == Listing::npos) return;
+    p.sel = (int)i;
+    if (p.sel < p.scroll) p.scroll = p.sel;
+    if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
 }
 
 // ----- context menu (delegated) ---------------------------------------------
@@ -517,33 +773,55 @@ void FileBrowserApp::BuildContextMenu(){
 	Pane& p2 = m_pane[1 - m_active];
 	bool inDir = (p.mode == 1);
 	bool inDir2 = (p2.mode == 1);
-	bool hasSel = !p.items.empty();
-	bool hasSel2 = !p2.items.empty();
+	bool hasSel = !p.items.Empty();
+	bool hasSel2 = !p2.items.Empty();
 	bool isFile = false;
 	bool isFile2 = false;
 	const char* ext = NULL;
 	const char* ext2 = NULL;
 	if (hasSel){
-		const Item& cur = p.items[p.sel];
-		if (inDir && !cur.isUpEntry && !cur.isDir) isFile = true;
-		if (isFile) ext = GetExtension(cur.name);
+		if (inDir && !p.items.IsUpEntry(p.sel) && !p.items.IsDir(p.sel)) isFile = true;
+		if (isFile) ext = GetExtension(p.items.Name(p.sel));
 	}
 	if (hasSel2){
-		const Item& cur2 = p2.items[p2.sel];
-		if (inDir2 && !cur2.isUpEntry && !cur2.isDir) isFile2 = true;
-		if (isFile) ext2 = GetExtension(cur2.name);
+		if (inDir2 && !p2.items.IsUpEntry(p2.sel) && !p2.items.IsDir(p2.sel)) isFile2 = true;
+		if (isFile) ext2 = GetExtension(p2.items.Name(p2.sel));
 	}	
 
-    int  marked = 0; for (size_t i=0; i<p.items.size(); ++i) if (p.items[i].marked) ++marked;
+    int  marked = (int)p.items.MarkedCount();
 
     m_ctx.Clear();
 
+    // A background job is running: offer to stop it first.
+    if (JobQueue::Busy()) {
+        AddMenuItem("Cancel operation", ACT_CANCEL_JOB, true);
+        m_ctx.AddSeparator();
+    } else if (CopyJournal::Pending()) {
+        // An earlier copy/move was interrupted; it can pick up where it stopped.
+        AddMenuItem("Resume copy",          ACT_RESUME_JOB,  true);
+        AddMenuItem("Discard partial copy", ACT_DISCARD_JOB, true);
+        m_ctx.AddSeparator();
+    }
+
     // Common operations
 	if (ext && _stricmp(ext, "xbe") == 0)
 	AddMenuItem("Launch",          ACT_OPEN,        (hasSel));
 	else
 	AddMenuItem("Open",            ACT_OPEN,        (hasSel));
     AddMenuItem("Copy",            ACT_COPY,        (inDir && hasSel && inDir2));
+    AddMenuItem("Copy + verify",   ACT_COPY_VERIFY, (inDir && hasSel && inDir2));
+    AddMenuItem("Sync to other pane",   ACT_SYNC,        (inDir && hasSel && inDir2));
+    AddMenuItem("Sync (CRC compare)",   ACT_SYNC_CRC,    (inDir && hasSel && inDir2));
+    AddMenuItem("Sync + delete extras", ACT_SYNC_MIRROR, (inDir && hasSel && inDir2));
+    if (!m_copyTargets.empty()) {
+        // Read once, write to the other pane and every remembered target
+        _snprintf(m_fanLabel, sizeof(m_fanLabel), "Copy to %u targets",
+                  (unsigned)m_copyTargets.size() + 1);
+        m_fanLabel[sizeof(m_fanLabel)-1] = 0;
+        AddMenuItem(m_fanLabel,             ACT_COPY_FANOUT,        (inDir && hasSel && inDir2));
+        AddMenuItem("Clear copy targets",   ACT_CLEAR_COPY_TARGETS, true);
+    }
+    AddMenuItem("Add copy target",      ACT_ADD_COPY_TARGET, (inDir2));
     AddMenuItem("Move",            ACT_MOVE,        (inDir && hasSel && inDir2));
     AddMenuItem("Delete",          ACT_DELETE,      (inDir && hasSel));
     AddMenuItem("Rename",          ACT_RENAME,      (inDir && hasSel));
@@ -562,12 +840,26 @@ void FileBrowserApp::BuildContextMenu(){
     AddMenuItem("Make new folder", ACT_MKDIR,       (inDir));
     AddMenuItem("Calculate size",  ACT_CALCSIZE,    (hasSel));
     AddMenuItem("Go to root",      ACT_GOROOT,      (inDir));
+    if (inDir) {
+        _snprintf(m_sortLabel, sizeof(m_sortLabel), "Sort by %s",
+                  SortModeName((SortMode)((p.items.Mode() + 1) % SORT_COUNT)));
+        m_sortLabel[sizeof(m_sortLabel)-1] = 0;
+        AddMenuItem(m_sortLabel,   ACT_SORT_NEXT,   true);
+        AddMenuItem(m_showDates ? "Hide dates" : "Show dates", ACT_TOGGLE_DATES, true);
+    }
+    if (p.mode != 0) {
+        AddMenuItem("Jump to...",  ACT_JUMP,        true);
+        AddMenuItem("Filter...",   ACT_FILTER,      true);
+        if (p.items.Filtered()) AddMenuItem("Clear filter", ACT_CLEAR_FILTER, true);
+    }
+    AddMenuItem("Find...",         ACT_FIND,        true);
+    AddMenuItem(p.mode == 3 ? "Rescan usage" : "Disk usage", ACT_USAGE, p.mode != 0 || hasSel);
     //AddMenuItem("Switch pane",     ACT_SWITCHMEDIA, (hasSel));
 
     // Marking tools (directory mode only; skip the ".." row)
     if (inDir) {
         int selectable = 0;
-        for (size_t i=0;i<p.items.size(); ++i) if (!p.items[i].isUpEntry) ++selectable;
+        for (size_t i=0;i<p.items.Count(); ++i) if (!p.items.IsUpEntry(i)) ++selectable;
         if (selectable > 0) {
             AddMenuItem("Mark all",     ACT_MARK_ALL,     true);
             AddMenuItem("Invert marks", ACT_INVERT_MARKS, true);
@@ -604,10 +896,12 @@ void FileBrowserApp::OpenMenu(){
     if (x < safeInset) x = safeInset;
     if (x + menuW > (FLOAT)vp.Width - safeInset) x = (FLOAT)vp.Width - safeInset - menuW;
 
-    // A bit below the list header (vertical fit is fine; menu is much shorter than the pane)
-    const FLOAT y = kListY + 20.0f;
+    // A bit below the list header; rows that would run into the footer band
+    // scroll instead (folder menus are taller than the 480-line screens)
+    const FLOAT y       = kListY + 20.0f;
+    const FLOAT bottomY = (FLOAT)vp.Height - MaxF(48.0f, vp.Height * 0.09f) - 6.0f;   // -6 outer frame
 
-    m_ctx.OpenAt(x, y, menuW, rowH);
+    m_ctx.OpenAt(x, y, menuW, rowH, bottomY - y);
     m_mode = MODE_MENU;
 }
 
@@ -633,20 +927,22 @@ void FileBrowserApp::AcceptRename(){
     if (!newName) { CancelRename(); return; }
 
     Pane& ap = m_pane[m_active];
-    if (ap.mode != 1 || ap.items.empty()) { SetStatus("Rename failed: no selection"); CancelRename(); return; }
+    if (ap.mode != 1 || ap.items.Empty()) { SetStatus("Rename failed: no selection"); CancelRename(); return; }
 
-    const Item& sel = ap.items[ap.sel];
-    if (sel.isUpEntry) { SetStatus("Rename failed: invalid selection"); CancelRename(); return; }
+    if (ap.items.IsUpEntry(ap.sel)) { SetStatus("Rename failed: invalid selection"); CancelRename(); return; }
 
     // Sanitize to FATX-friendly, then MoveFile within current dir.
     char clean[256]; _snprintf(clean, sizeof(clean), "%s", newName); clean[sizeof(clean)-1]=0;
     SanitizeFatxNameInPlace(clean);
-    if (_stricmp(clean, sel.name)==0){ SetStatus("No change"); CancelRename(); return; }
+    if (_stricmp(clean, ap.items.Name(ap.sel))==0){ SetStatus("No change"); CancelRename(); return; }
 
-    char oldPath[512]; JoinPath(oldPath, sizeof(oldPath), ap.curPath, sel.name);
+    char oldPath[512]; JoinPath(oldPath, sizeof(oldPath), ap.curPath, ap.items.Name(ap.sel));
     char newPath[512]; JoinPath(newPath, sizeof(newPath), ap.curPath, clean);
 
-    if (MoveFileA(oldPath, newPath)){
+    const BOOL moved = MoveFileA(oldPath, newPath);
+    DirCache::InvalidateTree(oldPath);   // the folder listing it, and below if a folder
+    DirCache::InvalidateTree(newPath);
+    if (moved){
         SetStatus("Renamed to %s", clean);
         RefreshPane(m_pane[0]); RefreshPane(m_pane[1]);
         SelectItemInPane(ap, clean);
@@ -657,6 +953,180 @@ void FileBrowserApp::AcceptRename(){
     CancelRename();
 }
 
+// ----- jump / filter / search (OnScreenKeyboard) ----------------------------
+// Jump moves the selection to the first name starting with the typed text;
+// filter narrows the pane to names with a word starting with it. Both
+// update on every keystroke (Listing's prefix index keeps that cheap).
+// Search runs once on accept over SearchIndex and turns the pane into a
+// result list (mode 2, curPath = query).
+static const size_t kMaxSearchHits = 2000;
+
+void FileBrowserApp::BeginFind(FindKind kind){
+    Pane& p = m_pane[m_active];
+    if (kind != FIND_SEARCH && p.mode == 0) { SetStatus("Open a folder first"); return; }
+
+    m_ctx.Close();
+    m_findKind       = kind;
+    m_findPrevSel    = p.sel;
+    m_findPrevScroll = p.scroll;
+    _snprintf(m_findPrev, sizeof(m_findPrev), "%s", p.items.Filter()); m_findPrev[sizeof(m_findPrev)-1]=0;
+
+    if (kind == FIND_SEARCH){
+        m_kb.Open("All drives (C: E: F: G:)", (p.mode == 2) ? p.curPath : "");
+        m_kb.SetTitle("Find");
+        const SearchIndex::Status ix = SearchIndex::GetStatus();
+        if (!ix.ready) SetStatus("Index building (%u names so far)", (unsigned)ix.entries);
+    } else {
+        m_kb.Open(p.curPath, (kind == FIND_FILTER) ? m_findPrev : "");
+        m_kb.SetTitle((kind == FIND_FILTER) ? "Filter" : "Jump to");
+    }
+    _snprintf(m_findLast, sizeof(m_findLast), "%s", m_kb.Buffer()); m_findLast[sizeof(m_findLast)-1]=0;
+    m_mode = MODE_FIND;
+}
+
+void FileBrowserApp::ApplyFind(){
+    if (m_findKind == FIND_SEARCH) return;   // runs on accept only
+    const char* text = m_kb.Buffer();
+    if (!text || strcmp(text, m_findLast) == 0) return;
+    _snprintf(m_findLast, sizeof(m_findLast), "%s", text); m_findLast[sizeof(m_findLast)-1]=0;
+
+    Pane& p = m_pane[m_active];
+    if (p.mode == 0) return;
+
+    if (m_findKind == FIND_FILTER){
+        char keep[256] = "";
+        if (!p.items.Empty()) { _snprintf(keep, sizeof(keep), "%s", p.items.Name(p.sel)); keep[sizeof(keep)-1]=0; }
+
+        p.items.SetFilter(text);
+        const size_t up = (!p.items.Empty() && p.items.IsUpEntry(0)) ? 1 : 0;
+        p.sel = (p.items.Count() > up) ? (int)up : 0;
+        p.scroll = 0;
+        if (keep[0] && p.items.Find(keep) != Listing::npos) SelectItemInPane(p, keep);
+        if (p.items.Filtered())
+            SetStatus("%u of %u match", (unsigned)(p.items.Count() - up), (unsigned)(p.items.Total() - up));
+        return;
+    }
+
+    if (!text[0]) { p.sel = m_findPrevSel; p.scroll = m_findPrevScroll; return; }
+    const size_t i = p.items.FindPrefix(text);
+    if (i == Listing::npos) { SetStatus("No name starts with \"%s\"", text); return; }
+    p.sel = (int)i;
+    if (p.sel < p.scroll) p.scroll = p.sel;
+    if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
+}
+
+void FileBrowserApp::EndFind(bool accept){
+    char query[64] = "";
+    if (m_kb.Buffer()) { _snprintf(query, sizeof(query), "%s", m_kb.Buffer()); query[sizeof(query)-1]=0; }
+    m_kb.Close();
+    m_mode = MODE_BROWSE;
+
+    Pane& p = m_pane[m_active];
+    if (m_findKind == FIND_SEARCH){
+        if (accept && query[0]) RunSearch(p, query);
+        return;
+    }
+    if (p.mode == 0) return;
+    if (!accept){
+        if (m_findKind == FIND_FILTER) p.items.SetFilter(m_findPrev);
+        p.sel    = MaxI(0, MinI(m_findPrevSel, (int)p.items.Count() - 1));
+        p.scroll = MaxI(0, MinI(m_findPrevScroll, p.sel));
+        return;
+    }
+    if (m_findKind == FIND_FILTER && p.items.Filtered()) SetStatus("Filter \"%s\" - B shows all", p.items.Filter());
+}
+
+// Replace the pane with the matches for 'query' (full paths, by name).
+void FileBrowserApp::RunSearch(Pane& p, const char* query){
+    StreamState& st = m_stream[PaneIndex(p)];
+    if (st.active) { ListStream::Cancel(PaneIndex(p)); st.active = false; st.selectName[0] = 0; }
+
+    const DWORD  t0    = GetTickCount();
+    const size_t total = SearchIndex::Query(query, p.items, kMaxSearchHits);
+    p.items.Sort(0);
+    p.mode = 2;
+    _snprintf(p.curPath, sizeof(p.curPath), "%s", query); p.curPath[sizeof(p.curPath)-1]=0;
+    p.sel = 0; p.scroll = 0;
+
+    const SearchIndex::Status ix = SearchIndex::GetStatus();
+    if (!ix.ready)
+        SetStatus("%u found - index still building (%u names)", (unsigned)total, (unsigned)ix.entries);
+    else if (total > p.items.Count())
+        SetStatus("Showing %u of %u matches", (unsigned)p.items.Count(), (unsigned)total);
+    else
+        SetStatus("%u found in %lu ms", (unsigned)total, (unsigned long)(GetTickCount() - t0));
+}
+
+// ----- disk usage view ------------------------------------------------------
+static const size_t kUsageTopN      = 50;    // folders and files each
+static const DWORD  kUsageRebuildMs = 500;   // while the scan streams in
+
+// Show DiskUsage's figures for 'dir' in the pane (mode 3). 'selectName'
+// (full path) is selected; a rebuild of the same folder keeps the selected
+// entry and the scroll position.
+void FileBrowserApp::ShowUsage(Pane& p, const char* dir, const char* selectName){
+    const int pi = PaneIndex(p);
+    StreamState& st = m_stream[pi];
+    if (st.active) { ListStream::Cancel(pi); st.active = false; st.selectName[0] = 0; }
+
+    char path[512]; _snprintf(path, sizeof(path), "%s", dir); path[sizeof(path)-1]=0;
+    const bool same = (p.mode == 3 && _stricmp(p.curPath, path) == 0);
+    char keep[512] = "";
+    if (selectName) _snprintf(keep, sizeof(keep), "%s", selectName);
+    else if (same && !p.items.Empty()) _snprintf(keep, sizeof(keep), "%s", p.items.Name(p.sel));
+    keep[sizeof(keep)-1] = 0;
+
+    p.mode = 3;
+    _snprintf(p.curPath, sizeof(p.curPath), "%s", path); p.curPath[sizeof(p.curPath)-1]=0;
+    DiskUsage::View(p.curPath, p.items, kUsageTopN, p.usageBytes, p.usageOnDisk);
+    if (!same) { p.sel = 0; p.scroll = 0; }
+    p.sel    = MaxI(0, MinI(p.sel, (int)p.items.Count() - 1));
+    p.scroll = MaxI(0, MinI(p.scroll, p.sel));
+    if (keep[0]) SelectItemInPane(p, keep);
+
+    m_usageGen[pi]     = DiskUsage::Generation();
+    m_usageBuiltMs[pi] = GetTickCount();
+}
+
+void FileBrowserApp::PumpUsage(){
+    const DWORD gen = DiskUsage::Generation();
+    const DWORD now = GetTickCount();
+    for (int i=0; i<2; ++i){
+        Pane& p = m_pane[i];
+        if (p.mode != 3 || gen == m_usageGen[i] || now - m_usageBuiltMs[i] < kUsageRebuildMs) continue;
+        ShowUsage(p, p.curPath, NULL);
+    }
+
+    if (m_usageDone) return;
+    const DiskUsage::Status st = DiskUsage::GetStatus();
+    if (!st.done) return;
+    m_usageDone = true;
+    char used[64], disk[64];
+    FormatSize(st.bytes, used, sizeof(used));
+    FormatSize(st.onDisk, disk, sizeof(disk));
+    SetStatus("%s %s (%s on disk), %lu folders, %lu files in %lu s%s", st.root, used, disk,
+              (unsigned long)st.dirs, (unsigned long)st.files, (unsigned long)(st.ms / 1000),
+              st.folded ? " - deep folders folded" : "");
+}
+
+void FileBrowserApp::ClearFilter(Pane& p){
+    if (!p.items.Filtered()) return;
+    char keep[256] = "";
+    if (!p.items.Empty()) { _snprintf(keep, sizeof(keep), "%s", p.items.Name(p.sel)); keep[sizeof(keep)-1]=0; }
+    p.items.SetFilter(NULL);
+    p.sel = 0; p.scroll = 0;
+    if (keep[0]) SelectItemInPane(p, keep);
+    SetStatus("Filter cleared");
+}
+
+// While the keyboard is up, every edit re-runs the jump / filter.
+void FileBrowserApp::OnPad_Find(const XBGAMEPAD& pad){
+    OnScreenKeyboard::Result r = m_kb.OnPad(pad);
+    if (r != OnScreenKeyboard::CANCELED) ApplyFind();
+    if (r != OnScreenKeyboard::NONE) EndFind(r == OnScreenKeyboard::ACCEPTED);
+    AbsorbPadState(pad);
+}
+
 // Absorb the current pad state so the button used to accept/cancel the keyboard
 // does not fall through and act in browse/menu mode.
 void FileBrowserApp::AbsorbPadState(const XBGAMEPAD& pad){
@@ -739,7 +1209,7 @@ void FileBrowserApp::OnPad_Browse(const XBGAMEPAD& pad){
             if (ud < 0){
                 if (p.sel > 0){ --p.sel; if (p.sel < p.scroll) p.scroll = p.sel; }
             }else{
-                int maxSel = (int)p.items.size() - 1;
+                int maxSel = (int)p.items.Count() - 1;
                 if (p.sel < maxSel){ ++p.sel; if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1); }
             }
             m_navUDHeld = true; m_navUDDir = ud; m_navUDNext = now + kInit;
@@ -748,7 +1218,7 @@ void FileBrowserApp::OnPad_Browse(const XBGAMEPAD& pad){
             if (ud < 0){
                 if (p.sel > 0){ --p.sel; if (p.sel < p.scroll) p.scroll = p.sel; }
             }else{
-                int maxSel = (int)p.items.size() - 1;
+                int maxSel = (int)p.items.Count() - 1;
                 if (p.sel < maxSel){ ++p.sel; if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1); }
             }
             m_navUDNext = now + kRep;
@@ -786,9 +1256,9 @@ void FileBrowserApp::OnPad_Browse(const XBGAMEPAD& pad){
         return;
     }
 
-    // A = enter, B = up one
+    // A = enter, B = up one (or drop the filter first)
     if (aTrig) EnterSelection(p);
-    if (bTrig) UpOne(p);
+    if (bTrig) { if (p.items.Filtered()) ClearFilter(p); else UpOne(p); }
 
     // Black/White = page up/down
     if (kTrig){ // BLACK: page up
@@ -796,21 +1266,21 @@ void FileBrowserApp::OnPad_Browse(const XBGAMEPAD& pad){
         if (p.sel < p.scroll) p.scroll = p.sel;
     }
     if (wTrig){ // WHITE: page down
-        int maxSel = (int)p.items.size()-1;
+        int maxSel = (int)p.items.Count()-1;
         p.sel += m_visible; if (p.sel > maxSel) p.sel = maxSel;
         if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
     }
 
     // Y = quick toggle mark (skips the ".." entry)
     if (yTrig) {
-        if (p.mode==1 && !p.items.empty()) {
-            Item& it = p.items[p.sel];
-            if (!it.isUpEntry) {
-                it.marked = !it.marked;
-                SetStatus(it.marked ? "Marked" : "Unmarked");
+        if (p.mode==1 && !p.items.Empty()) {
+            if (!p.items.IsUpEntry(p.sel)) {
+                const bool on = !p.items.Marked(p.sel);
+                p.items.SetMarked(p.sel, on);
+                SetStatus(on ? "Marked" : "Unmarked");
 
                 // Optional auto-advance to speed through marking multiple items.
-                int maxSel = (int)p.items.size()-1;
+                int maxSel = (int)p.items.Count()-1;
                 if (p.sel < maxSel) {
                     ++p.sel;
                     if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
@@ -834,7 +1304,9 @@ void FileBrowserApp::OnPad(const XBGAMEPAD& pad){
 	const bool backTrig = backNow && !(m_prevButtons & XINPUT_GAMEPAD_BACK);
 	DWORD now = GetTickCount();
 
-	if (backTrig){
+	if (backTrig && JobQueue::Busy()){
+		SetStatus("Operation in progress - cancel it first");
+	} else if (backTrig){
 		if (m_backConfirmArmed && now < m_statusUntilMs){
 			ExitNow();
 			return;
@@ -852,6 +1324,7 @@ void FileBrowserApp::OnPad(const XBGAMEPAD& pad){
     // -----------------------------------------------------------------------
 
     if (m_mode == MODE_RENAME){ OnPad_Rename(pad); return; }
+    if (m_mode == MODE_FIND)  { OnPad_Find(pad);   return; }
     if (m_mode == MODE_MENU)  { OnPad_Menu(pad);   return; }
     OnPad_Browse(pad);
 }
@@ -861,6 +1334,14 @@ void FileBrowserApp::OnPad(const XBGAMEPAD& pad){
 HRESULT FileBrowserApp::FrameMove(){
     XBInput_GetInput();
 
+    // Apply whatever the background worker reported since the last frame.
+    PumpJobEvents();
+    PumpListings();
+    PumpPrefetch();
+    PumpCalcSize();
+    PumpDvdSize();
+    PumpUsage();
+
     // --- Poll for general drive-set changes (ignore D:) ----------------------
     {
         static DWORD        s_nextPollMs  = 0;
@@ -877,6 +1358,8 @@ HRESULT FileBrowserApp::FrameMove(){
             if (s_lastMaskNoD == 0xFFFFFFFF) {
                 s_lastMaskNoD = maskNoD;               // prime (no toast)
             } else if (maskNoD != s_lastMaskNoD) {
+                for (int v = 0; v < 26; ++v)            // a volume came or went: forget it
+                    if ((maskNoD ^ s_lastMaskNoD) & (1u << v)) DirCache::InvalidateVolume((char)('A' + v));
                 s_lastMaskNoD = maskNoD;
 
                 RescanDrives();                         // non-D changes
@@ -912,6 +1395,7 @@ HRESULT FileBrowserApp::FrameMove(){
 				m_dvdHaveStats  = false;          // < clear
 				m_dvdUsedBytes  = 0;
 				m_dvdTotalBytes = 0;
+				m_dvdSizing     = false;
                 needRefresh     = TRUE;
                 if (code == DRIVE_OPEN) SetStatus("DVD: Tray Open");
                 else                     SetStatus("DVD: No Disc");
@@ -921,15 +1405,11 @@ HRESULT FileBrowserApp::FrameMove(){
 				DvdColdRemount();
 				s_dMapped = TRUE;
 
-				DWORD curSer = 0;
+				DWORD curSer = 0xFFFFFFFF;
 				if (GetDvdVolumeSerial(&curSer)) s_lastDvdSerial = curSer;
 
-				// Cache total (capacity) and used (sum of files on disc)
-				ULONGLONG fb=0, tb=0;
-				GetDriveFreeTotal("D:\\", fb, tb);
-				m_dvdTotalBytes = tb;
-				m_dvdUsedBytes  = DirSizeRecursiveA("D:\\");   // from FsUtil
-				m_dvdHaveStats  = true;
+				// Used bytes: known disc at once, otherwise walked in the background
+				BeginDvdStats(curSer);
 
 				{ char lbl[64]; if (DvdDetectMediaSimple(lbl, sizeof(lbl))) SetStatus("%s", lbl); }
 				needRefresh = TRUE;
@@ -942,6 +1422,7 @@ HRESULT FileBrowserApp::FrameMove(){
             }
 
             if (needRefresh) {
+                DirCache::InvalidateVolume('D');
                 RescanDrives();
 
                 // Refresh both panes; bounce out of D:\ if it vanished
@@ -950,17 +1431,17 @@ HRESULT FileBrowserApp::FrameMove(){
 
                     if (P.mode == 0) {
                         BuildDriveItems(P.items);
-                        if (P.sel >= (int)P.items.size()) P.sel = (int)P.items.size()-1;
+                        if (P.sel >= (int)P.items.Count()) P.sel = (int)P.items.Count()-1;
                         if (P.sel < 0) P.sel = 0;
                         P.scroll = 0;
-                    } else if (IsDPath(P.curPath)) {
+                    } else if (P.mode == 1 && IsDPath(P.curPath)) {
                         if (s_dMapped) {
                             // HARD re-list so a new disc shows correct files
-                            ListDirectory(P.curPath, P.items);
-                            if (P.sel >= (int)P.items.size()) P.sel = (int)P.items.size()-1;
+                            ListPaneNow(P);
+                            if (P.sel >= (int)P.items.Count()) P.sel = (int)P.items.Count()-1;
                             if (P.sel < 0) P.sel = 0;
                             if (P.scroll > P.sel) P.scroll = P.sel;
-                            { int maxScroll = (int)P.items.size() - m_visible; if (maxScroll < 0) maxScroll = 0; if (P.scroll > maxScroll) P.scroll = maxScroll; }
+                            { int maxScroll = (int)P.items.Count() - m_visible; if (maxScroll < 0) maxScroll = 0; if (P.scroll > maxScroll) P.scroll = maxScroll; }
                         } else {
                             // D: gone => drive list
                             P.mode = 0; P.curPath[0] = 0;
@@ -988,13 +1469,10 @@ HRESULT FileBrowserApp::FrameMove(){
                     if (s_lastDvdSerial != 0xFFFFFFFF && curSer != s_lastDvdSerial) {
                         // New disc detected silently  force remount and refresh
                         DvdColdRemount();
+                        DirCache::InvalidateVolume('D');
                         s_lastDvdSerial = curSer;
 						// refresh cached used/total
-						ULONGLONG fb=0, tb=0;
-						GetDriveFreeTotal("D:\\", fb, tb);
-						m_dvdTotalBytes = tb;
-						m_dvdUsedBytes  = DirSizeRecursiveA("D:\\");
-						m_dvdHaveStats  = true;
+						BeginDvdStats(curSer);
 
 
                         RescanDrives();
@@ -1002,15 +1480,15 @@ HRESULT FileBrowserApp::FrameMove(){
                             Pane& P = m_pane[iPane];
                             if (P.mode == 0) {
                                 BuildDriveItems(P.items);
-                                if (P.sel >= (int)P.items.size()) P.sel = (int)P.items.size()-1;
+                                if (P.sel >= (int)P.items.Count()) P.sel = (int)P.items.Count()-1;
                                 if (P.sel < 0) P.sel = 0;
                                 P.scroll = 0;
-                            } else if (IsDPath(P.curPath)) {
-                                ListDirectory(P.curPath, P.items);
-                                if (P.sel >= (int)P.items.size()) P.sel = (int)P.items.size()-1;
+                            } else if (P.mode == 1 && IsDPath(P.curPath)) {
+                                ListPaneNow(P);
+                                if (P.sel >= (int)P.items.Count()) P.sel = (int)P.items.Count()-1;
                                 if (P.sel < 0) P.sel = 0;
                                 if (P.scroll > P.sel) P.scroll = P.sel;
-                                { int maxScroll = (int)P.items.size() - m_visible; if (maxScroll < 0) maxScroll = 0; if (P.scroll > maxScroll) P.scroll = maxScroll; }
+                                { int maxScroll = (int)P.items.Count() - m_visible; if (maxScroll < 0) maxScroll = 0; if (P.scroll > maxScroll) P.scroll = maxScroll; }
                             } else {
                                 RefreshPane(P);
                             }
@@ -1048,31 +1526,47 @@ void FileBrowserApp::DrawRename(){
 // ----- listing / navigation -------------------------------------------------
 // Ensure a pane has items and indices are in range (after mode/path changes).
 void FileBrowserApp::EnsureListing(Pane& p){
-    if (p.mode==0) BuildDriveItems(p.items);
-    else           ListDirectory(p.curPath, p.items);
+    if (p.mode==0)      BuildDriveItems(p.items);
+    else if (p.mode==1) ListPaneNow(p);     // search results stay as they are
 
-    if (p.sel >= (int)p.items.size()) p.sel = (int)p.items.size()-1;
+    if (p.sel >= (int)p.items.Count()) p.sel = (int)p.items.Count()-1;
     if (p.sel < 0) p.sel = 0;
 
     if (p.scroll > p.sel) p.scroll = p.sel;
-    int maxScroll = MaxI(0, (int)p.items.size() - m_visible);
+    int maxScroll = MaxI(0, (int)p.items.Count() - m_visible);
     if (p.scroll > maxScroll) p.scroll = maxScroll;
 }
 
 // Enter current selection (drive -> directory, ".." -> up, dir -> descend,
 // .xbe -> launch). Other files are no-op here.
 void FileBrowserApp::EnterSelection(Pane& p){
-    if (p.items.empty()) return;
-    const Item& it = p.items[p.sel];
+    if (p.items.Empty()) return;
+    const size_t si = (size_t)p.sel;
+    const bool   isDir = p.items.IsDir(si), isUp = p.items.IsUpEntry(si);
 
     // Drive list -> go into the chosen drive.
     if (p.mode==0){
-        strncpy(p.curPath,it.name,sizeof(p.curPath)-1); p.curPath[sizeof(p.curPath)-1]=0;
-        p.mode=1; p.sel=0; p.scroll=0; ListDirectory(p.curPath,p.items); return;
+        strncpy(p.curPath,p.items.Name(si),sizeof(p.curPath)-1); p.curPath[sizeof(p.curPath)-1]=0;
+        p.mode=1; p.sel=0; p.scroll=0; StreamListing(p, NULL); return;
+    }
+
+    // Usage view -> a folder drills down
+    if (p.mode==3 && isDir){
+        char full[512]; _snprintf(full, sizeof(full), "%s", p.items.Name(si)); full[sizeof(full)-1]=0;
+        ShowUsage(p, full, NULL); return;
+    }
+
+    // Search result (or usage view file) -> a folder opens, a file opens its folder selected
+    if (p.mode==2 || p.mode==3){
+        char full[512]; _snprintf(full, sizeof(full), "%s", p.items.Name(si)); full[sizeof(full)-1]=0;
+        char leaf[256] = "";
+        if (!isDir) { ExtractLastComponent(full, leaf, sizeof(leaf)); ParentPath(full); }
+        strncpy(p.curPath, full, sizeof(p.curPath)-1); p.curPath[sizeof(p.curPath)-1]=0;
+        p.mode=1; p.sel=0; p.scroll=0; StreamListing(p, leaf[0] ? leaf : NULL); return;
     }
 
     // Directory listing
-	if (it.isUpEntry){
+	if (isUp){
 		// Reselect the folder were leaving (same as UpOne)
 		char childName[256]; ExtractLastComponent(p.curPath, childName, sizeof(childName));
 
@@ -1081,32 +1575,29 @@ void FileBrowserApp::EnterSelection(Pane& p){
 			p.mode = 0;
 			p.sel = 0; p.scroll = 0;
 			BuildDriveItems(p.items);
-			for (int i=0; i<(int)p.items.size(); ++i){
-				if (_stricmp(p.items[i].name, driveRoot) == 0){ p.sel = i; break; }
-			}
+			{ const size_t i = p.items.Find(driveRoot); if (i != Listing::npos) p.sel = (int)i; }
 			if (p.sel < p.scroll) p.scroll = p.sel;
 			if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
 			p.curPath[0] = 0;
 		} else {
 			ParentPath(p.curPath);
 			p.sel = 0; p.scroll = 0;
-			ListDirectory(p.curPath, p.items);
-			SelectItemInPane(p, childName);
+			StreamListing(p, childName);
 		}
 		return;
 	}
-    if (it.isDir){
+    if (isDir){
         // Descend into subdirectory.
-        char next[512]; JoinPath(next,sizeof(next),p.curPath,it.name);
+        char next[512]; JoinPath(next,sizeof(next),p.curPath,p.items.Name(si));
         strncpy(p.curPath,next,sizeof(p.curPath)-1); p.curPath[sizeof(p.curPath)-1]=0;
-        p.sel=0; p.scroll=0; ListDirectory(p.curPath,p.items); return;
+        p.sel=0; p.scroll=0; StreamListing(p, NULL); return;
     }
 
     // Files: launch .xbe if selected (other file types are no-op here).
-    if (!it.isDir && !it.isUpEntry) {
-        if (HasXbeExt(it.name)) {
+    if (!isDir && !isUp) {
+        if (HasXbeExt(p.items.Name(si))) {
             char full[512];
-            JoinPath(full, sizeof(full), p.curPath, it.name);
+            JoinPath(full, sizeof(full), p.curPath, p.items.Name(si));
 
             // Small Present for a snappy visual handoff before XLaunchNewImageA.
             m_pd3dDevice->Present(NULL, NULL, NULL, NULL);
@@ -1123,6 +1614,21 @@ void FileBrowserApp::EnterSelection(Pane& p){
 // Move up one level; from root goes back to drive list.
 void FileBrowserApp::UpOne(Pane& p){
     if (p.mode==0) return;
+    if (p.mode==2){
+        // Leave the search results for the drive list
+        p.mode = 0; p.curPath[0] = 0; p.sel = 0; p.scroll = 0;
+        BuildDriveItems(p.items);
+        return;
+    }
+    if (p.mode==3){
+        // Usage view: up to the parent's usage; past the root, list the root
+        if (IsDriveRoot(p.curPath)) { p.mode = 1; p.sel = 0; p.scroll = 0; StreamListing(p, NULL); return; }
+        char child[512]; _snprintf(child, sizeof(child), "%s", p.curPath); child[sizeof(child)-1]=0;
+        char up[512];    _snprintf(up, sizeof(up), "%s", p.curPath); up[sizeof(up)-1]=0;
+        ParentPath(up);
+        ShowUsage(p, up, child);
+        return;
+    }
 
     // Name of the child were currently inside (to reselect in parent)
     char childName[256]; ExtractLastComponent(p.curPath, childName, sizeof(childName));
@@ -1135,9 +1641,7 @@ void FileBrowserApp::UpOne(Pane& p){
         BuildDriveItems(p.items);
 
         // Try to select the drive we came from
-        for (int i=0; i<(int)p.items.size(); ++i){
-            if (_stricmp(p.items[i].name, driveRoot) == 0){ p.sel = i; break; }
-        }
+        { const size_t i = p.items.Find(driveRoot); if (i != Listing::npos) p.sel = (int)i; }
         if (p.sel < p.scroll) p.scroll = p.sel;
         if (p.sel >= p.scroll + m_visible) p.scroll = p.sel - (m_visible - 1);
 
@@ -1148,8 +1652,7 @@ void FileBrowserApp::UpOne(Pane& p){
     // Go to parent and select the child folder we just left
     ParentPath(p.curPath);
     p.sel = 0; p.scroll = 0;
-    ListDirectory(p.curPath, p.items);
-    SelectItemInPane(p, childName);
+    StreamListing(p, childName);
 }
 
 
@@ -1219,6 +1722,22 @@ HRESULT FileBrowserApp::Initialize(){
     BuildDriveItems(m_pane[0].items);
     BuildDriveItems(m_pane[1].items);
 
+    // Folder listings stream in from their own thread
+    if (!ListStream::Start()) XBUtil_DebugPrint("Init: WARNING - list stream failed to start");
+
+    // Background worker for copy/move/delete/unzip
+    if (!JobQueue::Start()) XBUtil_DebugPrint("Init: WARNING - job worker failed to start");
+    if (CopyJournal::Pending()) SetStatus("Interrupted copy found - resume it from the menu");
+
+    // Trash reaper: deletes in the background; first pass purges leftovers
+    if (!Trash::Start()) XBUtil_DebugPrint("Init: WARNING - trash reaper failed to start");
+
+    // Name index for Find: loads / verifies / builds in the background
+    if (!SearchIndex::Start()) XBUtil_DebugPrint("Init: WARNING - search indexer failed to start");
+    if (!SizeService::Start()) XBUtil_DebugPrint("Init: WARNING - size service failed to start");
+    if (!VolumeInfo::Start())  XBUtil_DebugPrint("Init: WARNING - volume info service failed to start");
+    if (!DiskUsage::Start())   XBUtil_DebugPrint("Init: WARNING - disk usage scanner failed to start");
+
     // Layout derived from current backbuffer size (works for any resolution)
     ComputeResponsiveLayout();
     XBUtil_DebugPrint("Init: Layout computed");
@@ -1239,10 +1758,12 @@ void FileBrowserApp::BeginProgress(ULONGLONG total, const char* firstLabel, cons
     _snprintf(m_prog.title, sizeof(m_prog.title), "%s", title ? title : "Working...");
     m_prog.title[sizeof(m_prog.title)-1] = 0;
 
+    ZeroMemory(&m_prog.stats, sizeof(m_prog.stats));
+    m_prog.stats.etaSec = kJobEtaUnknown;
     m_prog.lastPaintMs = 0;
 }
 
-// Update the overlay counters and optional label; throttles repaint to ~25 fps.
+// Update the overlay counters and optional label; the regular frame draws it.
 void FileBrowserApp::UpdateProgress(ULONGLONG done, ULONGLONG total, const char* label){
     m_prog.done  = done;
     m_prog.total = (total ? total : m_prog.total);
@@ -1250,15 +1771,6 @@ void FileBrowserApp::UpdateProgress(ULONGLONG done, ULONGLONG total, const char*
         _snprintf(m_prog.current, sizeof(m_prog.current), "%s", label);
         m_prog.current[sizeof(m_prog.current)-1] = 0;
     }
-
-    DWORD now = GetTickCount();
-    if (now - m_prog.lastPaintMs >= 40){
-        m_prog.lastPaintMs = now;
-
-        // redraw one frame (use the normal Render path)
-        Render();
-        Sleep(0);
-    }
 }
 
 // End and clear the progress overlay state.
@@ -1266,7 +1778,44 @@ void FileBrowserApp::EndProgress(){
     m_prog.active = false;
 }
 
-// Draw the modal progress HUD (centered panel with marquee and bar).
+// ----- background jobs ------------------------------------------------------
+// Drain the worker's event ring; cheap when idle (one index compare).
+void FileBrowserApp::PumpJobEvents(){
+    JobEvent e;
+    while (JobQueue::PollEvent(e)){
+        switch (e.type){
+        case JEV_BEGIN:    BeginProgress(e.total, e.text, e.title); break;
+        case JEV_PROGRESS: UpdateProgress(e.done, e.total, e.text);
+                           m_prog.stats = e.stats;                  break;
+        case JEV_STATUS:   SetStatus("%s", e.text);                 break;
+        case JEV_END:      FinishJob(e.job);                        break;
+        }
+    }
+}
+
+// Job is done (or canceled): hide the HUD, refresh affected panes, toast.
+void FileBrowserApp::FinishJob(Job* job){
+    if (!job) return;
+    EndProgress();
+    // Drop every cached listing the job may have changed before refreshing
+    DirCache::Invalidate(job->srcDir);
+    for (size_t k=0; k<job->srcs.size(); ++k) DirCache::InvalidateTree(job->srcs[k].c_str());
+    if (job->act == ACT_UNZIPHERE || job->act == ACT_UNZIPTO){
+        DirCache::InvalidateTree(job->dstDir);   // archive contents: anything below
+    } else if (job->dstDir[0]){
+        InvalidateCopiedInto(job->dstDir, job->srcs);
+        for (size_t k=0; k<job->dsts.size(); ++k) InvalidateCopiedInto(job->dsts[k].c_str(), job->srcs);
+    }
+    DirCache::EndWrite(job->volMask);
+    RefreshPanesShowing(job->srcDir, job->dstDir);
+    for (size_t k=0; k<job->dsts.size(); ++k)                 // fan-out targets
+        RefreshPanesShowing(job->dsts[k].c_str(), job->dstDir);
+    if (job->summary[0]) SetStatus("%s", job->summary);
+    delete job;
+}
+
+// Draw the progress HUD (panel above the footer with marquee and bar).
+// Non-modal: the panes stay usable underneath while the job runs.
 void FileBrowserApp::DrawProgressOverlay(){
     if (!m_prog.active) return;
 
@@ -1280,9 +1829,10 @@ void FileBrowserApp::DrawProgressOverlay(){
     FLOAT w = MaxF(MaxF(420.0f, vp.Width * 0.50f), fileW + margin*2.0f);
     if (w > vp.Width - margin*2.0f) w = vp.Width - margin*2.0f;
 
-    const FLOAT h = 116.0f;
+    const FLOAT h = 146.0f;
     const FLOAT x = Snap((vp.Width  - w)*0.5f);
-    const FLOAT y = Snap((vp.Height - h)*0.5f);
+    const FLOAT y = Snap((FLOAT)vp.Height - FooterBandPx((FLOAT)vp.Height)
+                         - FooterSpacerPx((FLOAT)vp.Height) - h - 6.0f);
 
     DrawRect(x-6, y-6, w+12, h+12, 0xA0101010);
     DrawRect(x,   y,   w,    h,    0xE0222222);
@@ -1299,11 +1849,11 @@ void FileBrowserApp::DrawProgressOverlay(){
     // title
     DrawAnsi(m_font, x + margin, titleY, 0xFFFFFFFF, m_prog.title[0] ? m_prog.title : "Working...");
 
-    // hint (right)  red "B:" + gray "Cancel"
+    // hint (right) - red "X:" + gray "Cancel (menu)"
 	{
-		const char* pre = "B:";
+		const char* pre = "X:";
 		const char* gap = " ";
-		const char* suf = "Cancel";
+		const char* suf = "Cancel (menu)";
 
 		FLOAT pw, ph, gw, gh, sw, sh;
 		MeasureTextWH(m_font, pre, pw, ph);
@@ -1359,6 +1909,44 @@ void FileBrowserApp::DrawProgressOverlay(){
     const FLOAT tx = Snap(barX + barW - tw);
     const FLOAT ty = Snap(barY + (barH - th) * 0.5f);
     DrawAnsi(m_font, tx, ty, 0xFFEEEEEE, t);
+
+    // --- live statistics: rate, ETA, files/s + per-file latency histogram ---
+    const JobStats& st = m_prog.stats;
+    const FLOAT statY = barY + barH + 6.0f;
+
+    char rate[32];
+    if (st.isBytes) { char sz[24]; FormatSize(st.perSec, sz, sizeof(sz)); _snprintf(rate, sizeof(rate), "%s/s", sz); }
+    else            { _snprintf(rate, sizeof(rate), "%lu items/s", (unsigned long)st.perSec); }
+    rate[sizeof(rate)-1] = 0;
+
+    char eta[16];
+    if (st.etaSec == kJobEtaUnknown) _snprintf(eta, sizeof(eta), "--:--");
+    else _snprintf(eta, sizeof(eta), "%lu:%02lu", (unsigned long)(st.etaSec / 60), (unsigned long)(st.etaSec % 60));
+    eta[sizeof(eta)-1] = 0;
+
+    char line[96];
+    _snprintf(line, sizeof(line), "%s   ETA %s   %lu files/s", rate, eta, (unsigned long)st.filesPerSec);
+    line[sizeof(line)-1] = 0;
+    DrawAnsi(m_font, x + margin, statY, 0xFFCCCCCC, line);
+
+    // Histogram (right): one bar per latency bucket, <1 ms on the left
+    {
+        const FLOAT bw = 4.0f, gap = 1.0f, hh = 18.0f;
+        const FLOAT hw = kJobLatBuckets * (bw + gap) - gap;
+        const FLOAT hx = Snap(x + w - margin - hw);
+        const FLOAT hy = Snap(statY + 2.0f);
+
+        DWORD peak = 0;
+        for (int b=0; b<kJobLatBuckets; ++b) if (st.latHist[b] > peak) peak = st.latHist[b];
+
+        DrawRect(hx - 2.0f, hy - 2.0f, hw + 4.0f, hh + 4.0f, 0xFF0E0E0E);
+        for (int b=0; b<kJobLatBuckets && peak; ++b){
+            if (!st.latHist[b]) continue;
+            FLOAT bh = hh * (FLOAT)st.latHist[b] / (FLOAT)peak;
+            if (bh < 1.0f) bh = 1.0f;
+            DrawRect(hx + b * (bw + gap), hy + hh - bh, bw, bh, (b >= 9) ? 0xFFFF6040 : 0xFF5EA4FF);
+        }
+    }
 }
 
 // ----- main render ----------------------------------------------------------
@@ -1386,6 +1974,7 @@ HRESULT FileBrowserApp::Render(){
     st.paddingX    = kPaddingX;
     st.scrollBarW  = kScrollBarW;
     st.visibleRows = m_visible;
+    st.showDate    = m_showDates;
 
 	// ---- panes ----
 	PaneRenderer::BeginFrameSharedCols();                         // reset per frame
@@ -1417,8 +2006,8 @@ HRESULT FileBrowserApp::Render(){
     // --- (unchanged) footer text building and status toast follow here ---
     {
         const Pane& ap   = m_pane[m_active];
-        const Item* cur  = (ap.items.empty()? NULL : &ap.items[ap.sel]);
-        const char* yLab = (cur && !cur->isUpEntry && cur->marked) ? "Unmark" : "Mark";
+        const bool  cur  = !ap.items.Empty() && !ap.items.IsUpEntry(ap.sel);
+        const char* yLab = (cur && ap.items.Marked(ap.sel)) ? "Unmark" : "Mark";
 
 		const bool isLowRes = (vp2.Height < 700); // 480i/p or 576i count as "small"
 		const bool smallFooter = (isLowRes || footerW <= 620.0f);
@@ -1432,7 +2021,8 @@ HRESULT FileBrowserApp::Render(){
             LeftEllipsizeToFit(m_font, base, footerW - 10.0f, fitted, sizeof(fitted));
             DrawAnsiCenteredX(m_font, footerX, footerW, footerY + 4.0f, 0xFFCCCCCC, fitted);
         } else {
-            const char* curPath = m_pane[m_active].curPath;
+            const Pane& fp      = m_pane[m_active];
+            const char* curPath = (fp.mode == 2) ? (fp.items.Empty() ? "" : fp.items.Name(fp.sel)) : fp.curPath;
             char       leftLabel[16] = "Free";
             ULONGLONG  leftVal = 0, rightVal = 0;
             if (IsDPath(curPath) && m_dvdHaveStats) {
@@ -1440,7 +2030,7 @@ HRESULT FileBrowserApp::Render(){
                 leftVal  = m_dvdUsedBytes;
                 rightVal = m_dvdTotalBytes;
             } else {
-                ULONGLONG fb=0, tb=0; GetDriveFreeTotal(curPath, fb, tb);
+                ULONGLONG fb=0, tb=0; VolumeInfo::GetFreeTotal(curPath, fb, tb);
                 leftVal  = fb; rightVal = tb;
             }
 
@@ -22,6 +22,7 @@
 #include "PaneModel.h"
 #include "PaneRenderer.h"
 #include "AppActions.h"
+#include "JobQueue.h"
 
 // Allow AppActions to call back into private helpers without exposing them.
 namespace AppActions { void Execute(Action, class FileBrowserApp&); }
@@ -29,7 +30,8 @@ namespace AppActions { void Execute(Action, class FileBrowserApp&); }
 /*
 ------------------------------------------------------------------------------
  ProgState
-  - Lightweight progress HUD state (used during copy/move).
+  - Lightweight progress HUD state (fed by JobQueue events while a
+    background copy/move/delete/unzip runs).
 ------------------------------------------------------------------------------
 */
 struct ProgState {
@@ -39,12 +41,14 @@ struct ProgState {
     char        current[256];   // current path/file shown in overlay
     DWORD       lastPaintMs;    // throttle overlay redraw rate
     char        title[24];      // short title ("Copying...", etc.)
+    JobStats    stats;          // rates / ETA / latency histogram (JobQueue)
 
     ProgState()
         : active(false), done(0), total(0), lastPaintMs(0)
     {
         current[0] = 0;
         title[0]   = 0;
+        ZeroMemory(&stats, sizeof(stats));
     }
 };
 
@@ -69,7 +73,7 @@ public:
     // --- Progress HUD API ---------------------------------------------------
     // Show the progress overlay and initialize counters/labels.
     void BeginProgress(ULONGLONG total, const char* firstLabel, const char* title = "Working...");
-    // Update progress (bytes + optional label). Throttles Render() internally.
+    // Update progress (bytes + optional label). Drawn by the next Render().
     void UpdateProgress(ULONGLONG done, ULONGLONG total, const char* label);
     // Hide progress overlay.
     void EndProgress();
@@ -95,7 +99,51 @@ private:
     void  RefreshPane(Pane& p);                    // rebuild items, preserve selection/scroll
     bool  ResolveDestDir(char* outDst, size_t cap);// determine destination dir from other pane
     bool  ResolveSrcDir(char* srcDst, size_t cap); // determine destination dir from current pane
+    void  RefreshPanesShowing(const char* dirA, const char* dirB); // refresh panes on these dirs (+ drive lists)
     void  SelectItemInPane(Pane& p, const char* name);
+    void  StreamListing(Pane& p, const char* selectName); // list p.curPath off-thread (ListStream)
+    void  ListPaneNow(Pane& p);                    // synchronous list (drops a stream in flight)
+    void  PumpListings();                          // merge streamed batches (FrameMove)
+    int   PaneIndex(const Pane& p) const { return (&p == &m_pane[1]) ? 1 : 0; }
+
+    // Streamed listing per pane: in flight + entry to select once it arrives
+    struct StreamState {
+        bool  active;
+        DWORD gen;              // DirCache generation when the stream started
+        DWORD t0;               // request time (enter latency)
+        char  selectName[256];
+    };
+    StreamState m_stream[2];
+
+    // Speculative listing of the folder under the cursor (and the pane's
+    // parent when deep) into DirCache, so A / B find it cached.
+    struct PrefetchState {
+        char    at[512];        // folder under the cursor
+        DWORD   since;          // cursor resting on it since (dwell)
+        int     stage;          // 0: that folder, 1: pane's parent, 2: nothing left
+        bool    busy;           // ListStream::kPrefetchSlot in flight
+        char    path[512];      // ... listing this folder
+        DWORD   gen;            // DirCache generation at the request
+        DWORD   issued, completed, abandoned;
+        // Folder opens: from cache vs listed (and how long that took)
+        DWORD   enterCached, enterListed, enterListedMs, enterD, enterDMs;
+    };
+    PrefetchState m_prefetch;
+    void  PumpPrefetch();                          // dwell check / collect result (FrameMove)
+    void  NoteEnter(const char* dir, bool cached, DWORD ms);
+
+    // --- Background jobs ----------------------------------------------------
+    void  PumpJobEvents();          // drain JobQueue events (FrameMove)
+    void  FinishJob(Job* job);      // overlay off, refresh, toast, delete job
+
+    // "Calculate size" waiting for SizeService: toast once it is known
+    char  m_calcPath[512];
+    DWORD m_calcT0;
+    void  PumpCalcSize();
+
+    // DVD used bytes: from the serial-keyed cache, else walked by SizeService
+    void  BeginDvdStats(DWORD serial);
+    void  PumpDvdSize();
 
     // --- Context menu -------------------------------------------------------
     void  AddMenuItem(const char* label, Action act, bool enabled);
@@ -109,11 +157,27 @@ private:
     void  AcceptRename();     // validate, sanitize, perform MoveFileA
     void  DrawRename();
 
+    // --- Jump / filter / search (same keyboard, over the active pane) ------
+    enum FindKind { FIND_JUMP, FIND_FILTER, FIND_SEARCH };
+    void  BeginFind(FindKind kind); // jump to prefix, narrow the view, or search all drives
+    void  ApplyFind();              // react to the keyboard text (each frame)
+    void  EndFind(bool accept);     // cancel restores the previous view
+    void  ClearFilter(Pane& p);     // show everything again, keep the selection
+    void  RunSearch(Pane& p, const char* query);   // pane -> result list (mode 2)
+
+    // --- Disk usage view (mode 3, fed by DiskUsage) -------------------------
+    void  ShowUsage(Pane& p, const char* dir, const char* selectName);
+    void  PumpUsage();              // rebuild usage panes as the scan streams in
+    DWORD m_usageGen[2];            // DiskUsage::Generation() each pane was built from
+    DWORD m_usageBuiltMs[2];
+    bool  m_usageDone;              // finish toast shown for the current scan
+
     // --- Input routing ------------------------------------------------------
     void  OnPad(const XBGAMEPAD& pad);      // router
     void  OnPad_Browse(const XBGAMEPAD& pad);
     void  OnPad_Menu(const XBGAMEPAD& pad);
     void  OnPad_Rename(const XBGAMEPAD& pad);
+    void  OnPad_Find(const XBGAMEPAD& pad);
 
     // --- Members ------------------------------------------------------------
     CXBFont m_font;           // UI font (XPR asset)
@@ -133,9 +197,9 @@ private:
     DWORD m_navUDNext;        // next repeat time (GetTickCount ms)
 
     // Mode and UI components
-    enum { MODE_BROWSE, MODE_MENU, MODE_RENAME } m_mode;
+    enum { MODE_BROWSE, MODE_MENU, MODE_RENAME, MODE_FIND } m_mode;
     ContextMenu      m_ctx;       // popup menu
-    OnScreenKeyboard m_kb;        // rename overlay
+    OnScreenKeyboard m_kb;        // rename / jump / filter overlay
     PaneRenderer     m_renderer;  // draws a pane (headers, rows, scrollbar)
 
     // Draw the already-open context menu (used by Render()).
@@ -171,9 +235,24 @@ private:
 	// Exit helper (define one of the strategies inside)
 	void ExitNow();
 	
+	// Fan-out copy targets (besides the other pane); see ACT_COPY_FANOUT.
+	std::vector<std::string> m_copyTargets;
+	char      m_fanLabel[32];   // "Copy to N targets" (menu keeps the pointer)
+	char      m_sortLabel[32];  // "Sort by <next mode>"
+	bool      m_showDates;      // date column in both panes (ACT_TOGGLE_DATES)
+
+	// Jump / filter / search session (MODE_FIND)
+	FindKind  m_findKind;
+	char      m_findLast[64];     // keyboard text last acted on
+	char      m_findPrev[64];     // filter before the session (restored on cancel)
+	int       m_findPrevSel, m_findPrevScroll;
+
 	ULONGLONG m_dvdUsedBytes;   // no in-class init here
 	ULONGLONG m_dvdTotalBytes;  // "
 	bool      m_dvdHaveStats;
+	DWORD     m_dvdSerial;      // disc the stats belong to (0xFFFFFFFF: unknown)
+	bool      m_dvdSizing;      // waiting for SizeService to total the disc
+	DWORD     m_dvdSizeT0;
 
     // -------------------------------------------------------------------------
     // Responsive layout state (computed in ComputeResponsiveLayout()).
@@ -1,9 +1,11 @@
 #include "FsUtil.h"
+#include "Trash.h"
 
 #include <algorithm>
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>  // _snprintf
+#include "zlib.h"   // crc32 (unzipLIB)
 
 /*
 ============================================================================
@@ -147,15 +149,73 @@ private:
     DWORD m_dwTrayState, m_dwTrayCount, m_dwLastTrayState;
 };
 
-// DVD size cache (expensive to recompute on CDFS; keyed by volume serial)
+// DVD size cache (expensive to recompute on CDFS; keyed by volume serial).
+// The app computes it off-thread and sets it; known discs come from the HDD.
 static DWORD      g_dvdSerialCache = 0xFFFFFFFFu;  // 0xFFFFFFFF => unknown
 static ULONGLONG  g_dvdUsedCache   = 0;            // bytes used on the disc
-static ULONGLONG  g_dvdTotalCache  = 0;            // disc capacity (for reference)
 
 static void DvdInvalidateSizeCache(){
     g_dvdSerialCache = 0xFFFFFFFFu;
     g_dvdUsedCache   = 0;
-    g_dvdTotalCache  = 0;
+}
+
+// T:\DvdSizes.dat: header + most recently seen discs first
+static const char* const kDvdSizesPath = "T:\\DvdSizes.dat";
+static const DWORD       kDvdSizesMagic = 0x5A534458;   // "XDSZ"
+static const DWORD       kDvdSizesMax   = 64;
+
+struct DvdSizeRec { DWORD serial; DWORD pad; ULONGLONG used; };
+
+static DWORD DvdReadSizes(DvdSizeRec* recs){
+    HANDLE h = CreateFileA(kDvdSizesPath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return 0;
+    DWORD hdr[2] = { 0, 0 }, rd = 0, n = 0;
+    if (ReadFile(h, hdr, sizeof(hdr), &rd, NULL) && rd == sizeof(hdr) &&
+        hdr[0] == kDvdSizesMagic && hdr[1] <= kDvdSizesMax &&
+        ReadFile(h, recs, hdr[1] * sizeof(DvdSizeRec), &rd, NULL) && rd == hdr[1] * sizeof(DvdSizeRec))
+        n = hdr[1];
+    CloseHandle(h);
+    return n;
+}
+
+bool DvdGetUsedBytes(DWORD serial, ULONGLONG& used){
+    if (serial == 0xFFFFFFFFu) return false;
+    if (serial == g_dvdSerialCache) { used = g_dvdUsedCache; return true; }
+
+    DvdSizeRec recs[kDvdSizesMax];
+    const DWORD n = DvdReadSizes(recs);
+    for (DWORD i = 0; i < n; ++i){
+        if (recs[i].serial != serial) continue;
+        g_dvdSerialCache = serial;
+        g_dvdUsedCache   = recs[i].used;
+        used = recs[i].used;
+        return true;
+    }
+    return false;
+}
+
+void DvdSetUsedBytes(DWORD serial, ULONGLONG used){
+    if (serial == 0xFFFFFFFFu) return;
+    g_dvdSerialCache = serial;
+    g_dvdUsedCache   = used;
+
+    DvdSizeRec recs[kDvdSizesMax + 1];
+    DWORD n = DvdReadSizes(recs + 1);
+    for (DWORD i = 1; i <= n; ++i)
+        if (recs[i].serial == serial) { memmove(&recs[i], &recs[i+1], (n - i) * sizeof(DvdSizeRec)); --n; break; }
+    recs[0].serial = serial;
+    recs[0].pad    = 0;
+    recs[0].used   = used;
+    if (++n > kDvdSizesMax) n = kDvdSizesMax;
+
+    HANDLE h = CreateFileA(kDvdSizesPath, GENERIC_WRITE, 0, NULL,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return;
+    const DWORD hdr[2] = { kDvdSizesMagic, n };
+    DWORD wr = 0;
+    if (WriteFile(h, hdr, sizeof(hdr), &wr, NULL)) WriteFile(h, recs, n * sizeof(DvdSizeRec), &wr, NULL);
+    CloseHandle(h);
 }
 
 // Map/unmap D: with cache invalidation
@@ -255,7 +315,6 @@ namespace {
     int  g_presentIdx[16];
     int  g_presentCount = 0;
 
-    inline int ci_cmp(const char* a,const char* b){ return _stricmp(a,b); }
 }
 
 // 26-bit A..Z mask (handy for quick change detection)
@@ -279,14 +338,11 @@ void RescanDrives(){
 }
 
 // Build drive items (e.g., "E:\") into 'out'.
-void BuildDriveItems(std::vector<Item>& out){
-    out.clear();
+void BuildDriveItems(Listing& out){
+    out.Clear();
     for (int j=0;j<g_presentCount;++j){
         int i = g_presentIdx[j];
-        Item it; ZeroMemory(&it, sizeof(it));
-        strncpy(it.name, kRoots[i], 255); it.name[255]=0;
-        it.isDir=true; it.size=0; it.isUpEntry=false; it.marked=false;
-        out.push_back(it);
+        out.Add(kRoots[i], true, 0, FILE_ATTRIBUTE_DIRECTORY);
     }
 }
 
@@ -327,43 +383,37 @@ void NormalizeDirA(char* s){
     EnsureTrailingSlash(s, 512);
 }
 
-// Sort: directories first, then case-insensitive by name.
-static bool ItemLess(const Item& a,const Item& b){
-    if(a.isDir!=b.isDir) return a.isDir>b.isDir;
-    return ci_cmp(a.name,b.name)<0;
-}
-
 // ============================================================================
 // Directory listing
 //  - Prepends a synthetic ".." entry for non-root folders.
 //  - Sorts (dirs first, then by name) while keeping the ".." at index 0.
 // ============================================================================
-bool ListDirectory(const char* path,std::vector<Item>& out){
-    out.clear();
+bool IsListedName(const char* n, bool atRoot){
+    if(!strcmp(n,".")||!strcmp(n,"..")) return false;
+    if(atRoot && !_stricmp(n,Trash::kDirName)) return false; // pending deletes
+    return true;
+}
+
+bool ListDirectory(const char* path,Listing& out){
+    out.Clear();
 
     // For non-root, push ".." to allow going up.
-    if(strlen(path)>3){
-        Item up; ZeroMemory(&up,sizeof(up));
-        strncpy(up.name,"..",3); up.isDir=true; up.size=0; up.isUpEntry=true; up.marked=false; out.push_back(up);
-    }
+    if(strlen(path)>3) out.Add("..",true,0,0,true);
 
     char base[512]; _snprintf(base,sizeof(base),"%s",path); base[sizeof(base)-1]=0; EnsureTrailingSlash(base,sizeof(base));
     char mask[512]; _snprintf(mask,sizeof(mask),"%s*",base); mask[sizeof(mask)-1]=0;
 
+    const bool atRoot=(strlen(path)<=3);
+
     WIN32_FIND_DATAA fd; ZeroMemory(&fd,sizeof(fd));
     HANDLE h=FindFirstFileA(mask,&fd); if(h==INVALID_HANDLE_VALUE) return false;
     do{
-        const char* n=fd.cFileName; if(!strcmp(n,".")||!strcmp(n,"..")) continue;
-        Item it; ZeroMemory(&it,sizeof(it));
-        strncpy(it.name,n,255); it.name[255]=0;
-        it.isDir=(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)!=0;
-        it.size=(((ULONGLONG)fd.nFileSizeHigh)<<32)|fd.nFileSizeLow; it.isUpEntry=false; it.marked=false;
-        out.push_back(it);
+        const char* n=fd.cFileName; if(!IsListedName(n,atRoot)) continue;
+        out.Add(fd);
     }while(FindNextFileA(h,&fd));
     FindClose(h);
 
-    size_t start=(strlen(path)>3)?1:0; // keep ".." in place
-    if(out.size()>start+1) std::sort(out.begin()+(int)start,out.end(),ItemLess);
+    out.Sort((strlen(path)>3)?1:0); // keep ".." in place (order: out.Mode())
     return true;
 }
 
@@ -371,6 +421,23 @@ bool ListDirectory(const char* path,std::vector<Item>& out){
 // Misc info helpers
 // ============================================================================
 
+void FormatFileTime(ULONGLONG ft, char* out, size_t cap)
+{
+    if (!out || cap == 0) return;
+    out[0] = 0;
+    if (!ft) return;
+
+    FILETIME utc, loc;
+    utc.dwLowDateTime  = (DWORD)ft;
+    utc.dwHighDateTime = (DWORD)(ft >> 32);
+    SYSTEMTIME t;
+    if (!FileTimeToLocalFileTime(&utc, &loc) || !FileTimeToSystemTime(&loc, &t)) return;
+    _snprintf(out, cap, "%04u-%02u-%02u %02u:%02u",
+              (unsigned)t.wYear, (unsigned)t.wMonth, (unsigned)t.wDay,
+              (unsigned)t.wHour, (unsigned)t.wMinute);
+    out[cap-1] = 0;
+}
+
 void FormatSize(ULONGLONG bytes, char* out, size_t cap)
 {
     if (!out || cap == 0) return;
@@ -402,7 +469,8 @@ void FormatSize(ULONGLONG bytes, char* out, size_t cap)
 // For normal drives, we return true "free / total".
 // For D:, CDFS reports "free=0". To match the UI label "Free / Total" and avoid
 // confusion, we intentionally return "0 / <used_on_disc>" for DVDs.
-// We recompute <used_on_disc> only when the volume serial changes.
+// <used_on_disc> is whatever DvdSetUsedBytes / DvdGetUsedBytes cached for the
+// current serial; 0 until then (never walks the disc here).
 void GetDriveFreeTotal(const char* anyPathInDrive,
                        ULONGLONG& freeBytes, ULONGLONG& totalBytes)
 {
@@ -418,18 +486,9 @@ void GetDriveFreeTotal(const char* anyPathInDrive,
         DWORD serial = 0xFFFFFFFF;
         GetVolumeInformationA("D:\\", NULL, 0, &serial, NULL, NULL, NULL, 0);
 
-        if (serial != g_dvdSerialCache) {
-            // Disc changed (or first time)  recompute and cache
-            ULARGE_INTEGER a, t, f; a.QuadPart = t.QuadPart = f.QuadPart = 0;
-            GetDiskFreeSpaceExA("D:\\", &a, &t, &f);   // capacity of media
-            g_dvdTotalCache  = t.QuadPart;             // kept for reference
-            g_dvdUsedCache   = DirSizeRecursiveA("D:\\");
-            g_dvdSerialCache = serial;
-        }
-
         // "Free / Total"   =>   "0 / <used>"
         freeBytes  = 0;
-        totalBytes = g_dvdUsedCache;
+        totalBytes = (serial == g_dvdSerialCache) ? g_dvdUsedCache : 0;
         return;
     }
 
@@ -457,55 +516,113 @@ bool EnsureDirA(const char* path){
 // Recursively delete with safety rails:
 //  - Refuses drive roots
 //  - Refuses read-only volumes (CDFS / cache)
-//  - Clears READONLY/SYSTEM/HIDDEN before delete
+//  - Clears READONLY/SYSTEM/HIDDEN only when set (attributes come from the
+//    find data, no extra GetFileAttributesA per child)
+//  - Iterative: one path buffer and an explicit stack of open finds
 //  - Continues on child failures; tiny retry on RemoveDirectoryA
-bool DeleteRecursiveA(const char* path){
-    if (!path || !path[0]) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
-    if (IsDriveRoot(path)) { SetLastError(ERROR_ACCESS_DENIED);     return false; }
-    if (IsReadOnlyVolumeA(path)) { SetLastError(ERROR_WRITE_PROTECT); return false; }
-
-    DWORD a = GetFileAttributesA(path);
-    if (a == INVALID_FILE_ATTRIBUTES) { SetLastError(ERROR_FILE_NOT_FOUND); return false; }
+struct DelFrame {
+    HANDLE find;    // INVALID_HANDLE_VALUE until the folder is opened
+    size_t len;     // length of this folder's path in the shared buffer
+};
 
-    // Make the target itself writable so final delete can succeed.
-    StripROSysHiddenA(path);
+static void NoteDeleteError(DeleteError* fe, DWORD& code, const char* path){
+    const DWORD err = GetLastError();
+    if (err == ERROR_FILE_NOT_FOUND || err == ERROR_PATH_NOT_FOUND) return;   // already gone
+    if (code != NO_ERROR) return;
+    code = err ? err : ERROR_GEN_FAILURE;
+    if (fe){ fe->code = code; _snprintf(fe->path, sizeof(fe->path), "%s", path); fe->path[sizeof(fe->path)-1]=0; }
+}
 
-    if (a & FILE_ATTRIBUTE_DIRECTORY){
-        // Enumerate children
-        char mask[512]; JoinPath(mask, sizeof(mask), path, "*");
-        WIN32_FIND_DATAA fd; HANDLE h = FindFirstFileA(mask, &fd);
-        if (h != INVALID_HANDLE_VALUE){
-            do{
-                if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
+// Up-front refusal: the target itself is the first error.
+static bool RefuseDelete(DeleteError* fe, DWORD code, const char* path){
+    if (fe){ fe->code = code; _snprintf(fe->path, sizeof(fe->path), "%s", path ? path : ""); fe->path[sizeof(fe->path)-1]=0; }
+    SetLastError(code);
+    return false;
+}
 
-                char sub[512]; JoinPath(sub, sizeof(sub), path, fd.cFileName);
+bool DeleteTreeA(const char* root, DeleteError* firstErr){
+    if (firstErr) { firstErr->code = NO_ERROR; firstErr->path[0] = 0; }
+    if (!root || !root[0])       return RefuseDelete(firstErr, ERROR_INVALID_PARAMETER, root);
+    if (IsDriveRoot(root))       return RefuseDelete(firstErr, ERROR_ACCESS_DENIED, root);
+    if (IsReadOnlyVolumeA(root)) return RefuseDelete(firstErr, ERROR_WRITE_PROTECT, root);
+
+    const DWORD kStrip = FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN;
+    const DWORD a = GetFileAttributesA(root);
+    if (a == INVALID_FILE_ATTRIBUTES) return RefuseDelete(firstErr, ERROR_FILE_NOT_FOUND, root);
+
+    char path[512]; _snprintf(path, sizeof(path), "%s", root); path[sizeof(path)-1]=0;
+    size_t len = strlen(path);
+    while (len > 3 && path[len-1] == '\\') path[--len] = 0;
+    if (a & kStrip) SetFileAttributesA(path, a & ~kStrip);
+
+    DWORD code = NO_ERROR;
+    if (!(a & FILE_ATTRIBUTE_DIRECTORY)){
+        if (!DeleteFileA(path)) NoteDeleteError(firstErr, code, path);
+        if (code != NO_ERROR) { SetLastError(code); return false; }
+        return true;
+    }
 
-                // Clear attributes on each child before deleting
-                StripROSysHiddenA(sub);
+    std::vector<DelFrame> stack;
+    DelFrame top = { INVALID_HANDLE_VALUE, len };
+    stack.push_back(top);
+
+    while (!stack.empty()){
+        DelFrame& f = stack.back();
+        WIN32_FIND_DATAA fd;
+        BOOL more;
+        if (f.find == INVALID_HANDLE_VALUE){
+            if (f.len + 2 >= sizeof(path)) { SetLastError(ERROR_FILENAME_EXCED_RANGE); NoteDeleteError(firstErr, code, path); more = FALSE; }
+            else {
+                memcpy(path + f.len, "\\*", 3);
+                f.find = FindFirstFileA(path, &fd);
+                path[f.len] = 0;
+                more = (f.find != INVALID_HANDLE_VALUE);
+            }
+        } else {
+            more = FindNextFileA(f.find, &fd);
+        }
 
-                // Best-effort delete; continue on failure
-                if (!DeleteRecursiveA(sub)){
-                    // Optionally capture first error here
-                }
-            } while (FindNextFileA(h, &fd));
-            FindClose(h);
+        if (!more){
+            // Folder drained: close it and remove it
+            if (f.find != INVALID_HANDLE_VALUE) FindClose(f.find);
+            path[f.len] = 0;
+            if (!RemoveDirectoryA(path)){
+                Sleep(1);
+                if (!RemoveDirectoryA(path)) NoteDeleteError(firstErr, code, path);
+            }
+            stack.pop_back();
+            if (!stack.empty()) path[stack.back().len] = 0;
+            continue;
         }
 
-        // Try removing the (now empty) directory (with a tiny retry)
-        if (!RemoveDirectoryA(path)){
-            Sleep(1);
-            StripROSysHiddenA(path);
-            return RemoveDirectoryA(path) ? true : false;
+        const char* n = fd.cFileName;
+        if (n[0] == '.' && (!n[1] || (n[1] == '.' && !n[2]))) continue;
+
+        const size_t nl = strlen(n);
+        if (f.len + 1 + nl + 1 > sizeof(path)){
+            SetLastError(ERROR_FILENAME_EXCED_RANGE); NoteDeleteError(firstErr, code, path);
+            continue;
         }
-        return true;
-    }else{
-        // File: clear attributes then delete (retry once)
-        if (!DeleteFileA(path)){
-            StripROSysHiddenA(path);
-            return DeleteFileA(path) ? true : false;
+        path[f.len] = '\\';
+        memcpy(path + f.len + 1, n, nl + 1);
+
+        if (fd.dwFileAttributes & kStrip) SetFileAttributesA(path, fd.dwFileAttributes & ~kStrip);
+
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY){
+            DelFrame sub = { INVALID_HANDLE_VALUE, f.len + 1 + nl };
+            stack.push_back(sub);   // invalidates f
+            continue;
         }
-        return true;
+        if (!DeleteFileA(path)) NoteDeleteError(firstErr, code, path);
+        path[f.len] = 0;
     }
+
+    if (code != NO_ERROR) { SetLastError(code); return false; }
+    return true;
+}
+
+bool DeleteRecursiveA(const char* path){
+    return DeleteTreeA(path, NULL);
 }
 
 // ============================================================================
@@ -528,20 +645,161 @@ bool HasXbeExt(const char* name){
 }
 
 // ============================================================================
-// Copy (chunked) + recursive copy with progress/cancel
-//  - 64 KiB fixed buffer (predictable RAM use on Xbox)
+// Copy (pipelined) + recursive copy with progress/cancel
+//  - Ring of kCopySlots x 64 KiB buffers (predictable RAM use on Xbox)
+//  - Source is opened overlapped; up to kCopySlots reads stay in flight, so
+//    the read of chunk k+1.. overlaps the WriteFile of chunk k
+//  - Ring + events are allocated once per CopyManifestRootA call and reused
+//    for every file in the tree
 //  - Normalizes dest attributes before overwrite
 //  - Progress callback may cancel; on cancel we delete the partial output
+//  - Optional CRC32 verify: the source CRC is folded in while the next reads
+//    are in flight, then the destination is re-read unbuffered and compared
+//  - Files above kSmallFileMax are preallocated to their final size, so FATX
+//    builds the cluster chain once instead of extending it on every write
 // ============================================================================
 
-static bool CopyFileChunkedA(const char* s, const char* d,
+static const DWORD kCopyChunk    = 64 * 1024;
+static const int   kCopySlots    = 4;
+static const DWORD kSmallFileMax = kCopyChunk * kCopySlots;  // one read into the whole block
+
+struct CopySlot {
+    char*      buf;      // kCopyChunk bytes inside CopyPipe::block
+    OVERLAPPED ov;       // offset + completion event for the in-flight read
+    DWORD      want;     // bytes requested for this read
+    bool       pending;  // read issued and not yet reaped
+};
+
+struct CopyPipe {
+    char*    block;              // one VirtualAlloc for all slots (page aligned:
+                                 // the verify re-read is unbuffered)
+    CopySlot slot[kCopySlots];
+};
+
+static bool CopyPipeInit(CopyPipe& p){
+    ZeroMemory(&p, sizeof(p));
+    p.block = (char*)VirtualAlloc(NULL, kCopyChunk * kCopySlots, MEM_COMMIT, PAGE_READWRITE);
+    if (!p.block) return false;
+    for (int i=0;i<kCopySlots;++i){
+        p.slot[i].buf       = p.block + i * kCopyChunk;
+        p.slot[i].ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+        if (!p.slot[i].ov.hEvent) return false;
+    }
+    return true;
+}
+
+static void CopyPipeFree(CopyPipe& p){
+    for (int i=0;i<kCopySlots;++i)
+        if (p.slot[i].ov.hEvent) CloseHandle(p.slot[i].ov.hEvent);
+    if (p.block) VirtualFree(p.block, 0, MEM_RELEASE);
+    ZeroMemory(&p, sizeof(p));
+}
+
+// Queue an overlapped read of 'want' bytes at 'offset' into slot s.
+static bool CopySlotIssue(HANDLE hs, CopySlot& s, ULONGLONG offset, DWORD want){
+    s.ov.Offset     = (DWORD)(offset & 0xFFFFFFFFu);
+    s.ov.OffsetHigh = (DWORD)(offset >> 32);
+    s.ov.Internal   = 0;
+    s.ov.InternalHigh = 0;
+    ResetEvent(s.ov.hEvent);
+    s.want    = want;
+    s.pending = true;
+
+    DWORD rd = 0;
+    if (ReadFile(hs, s.buf, want, &rd, &s.ov)) return true;   // completed inline
+    if (GetLastError() == ERROR_IO_PENDING)   return true;   // in flight
+    s.pending = false;
+    return false;
+}
+
+// Set the end of file to 'size' (allocates or frees clusters), then leave
+// the file pointer at 'pos'.
+static bool SetFileSizeA(HANDLE h, ULONGLONG size, ULONGLONG pos){
+    LONG hi = (LONG)(size >> 32);
+    if (SetFilePointer(h, (LONG)(DWORD)size, &hi, FILE_BEGIN) == 0xFFFFFFFFu &&
+        GetLastError() != NO_ERROR) return false;
+    if (!SetEndOfFile(h)) return false;
+    hi = (LONG)(pos >> 32);
+    return !(SetFilePointer(h, (LONG)(DWORD)pos, &hi, FILE_BEGIN) == 0xFFFFFFFFu &&
+             GetLastError() != NO_ERROR);
+}
+
+// Block until slot s has landed; 'got' receives the byte count.
+static bool CopySlotReap(HANDLE hs, CopySlot& s, DWORD& got){
+    got = 0;
+    if (!s.pending) return false;
+    s.pending = false;
+    return GetOverlappedResult(hs, &s.ov, &got, TRUE) ? true : false;
+}
+
+// Wait out any reads still in flight (required before the handle is closed).
+static void CopyPipeDrain(HANDLE hs, CopyPipe& p){
+    for (int i=0;i<kCopySlots;++i){
+        DWORD got = 0;
+        if (p.slot[i].pending) CopySlotReap(hs, p.slot[i], got);
+    }
+}
+
+// Re-read 'd' from disk (unbuffered, so not from the write cache) and
+// compare its CRC32 with 'want'. Uses the whole pipe block as one buffer.
+// The progress callback is polled per block so cancel stays responsive.
+// A file that cannot be opened or read back sets outReadErr instead of
+// being reported as a mismatch. False only when canceled.
+static bool VerifyFileCrcA(const char* d, ULONGLONG size, uLong want, CopyPipe& pipe,
+                           ULONGLONG bytesDone, ULONGLONG totalBytes,
+                           bool& outMatch, DWORD& outReadErr)
+{
+    outMatch   = false;
+    outReadErr = NO_ERROR;
+    HANDLE h = CreateFileA(d, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, NULL);
+    if (h == INVALID_HANDLE_VALUE){
+        outReadErr = GetLastError() ? GetLastError() : ERROR_OPEN_FAILED;
+        return true;
+    }
+
+    const DWORD blk = kCopyChunk * kCopySlots;    // sector multiple, page aligned
+    uLong crc = crc32(0L, Z_NULL, 0);
+    ULONGLONG seen = 0;
+    bool ok = true;
+    for (;;){
+        DWORD got = 0;
+        if (!ReadFile(h, pipe.block, blk, &got, NULL)){
+            outReadErr = GetLastError() ? GetLastError() : ERROR_READ_FAULT;
+            break;
+        }
+        if (got == 0) break;
+        crc   = crc32(crc, (const Bytef*)pipe.block, got);
+        seen += got;
+
+        if (CopyProgress::g_copyProgFn &&
+            !CopyProgress::g_copyProgFn(bytesDone, totalBytes, d, CopyProgress::g_copyProgUser))
+            { ok = false; break; } // canceled
+    }
+    CloseHandle(h);
+
+    outMatch = (seen == size && crc == want);
+    return ok;
+}
+
+// Copy one file. startAt > 0 resumes: the destination is kept up to startAt
+// (it must already be at least that long) and only the tail is copied.
+static bool CopyFileChunkedA(const char* s, const char* d, CopyPipe& pipe,
+                             ULONGLONG startAt, CopyCursor* cursor, size_t entry,
+                             CopyVerify* verify,
                              ULONGLONG& inoutBytesDone, ULONGLONG totalBytes)
 {
-    // Open source (read-only, allow readers to share)
+    // Open source (read-only, allow readers to share). Overlapped so reads can
+    // be queued ahead of the writer.
     HANDLE hs = CreateFileA(s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
-                            FILE_ATTRIBUTE_NORMAL, NULL);
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
     if (hs == INVALID_HANDLE_VALUE) return false;
 
+    DWORD sizeHi = 0;
+    DWORD sizeLo = GetFileSize(hs, &sizeHi);
+    if (sizeLo == 0xFFFFFFFFu && GetLastError() != NO_ERROR){ CloseHandle(hs); return false; }
+    const ULONGLONG fileSize = (((ULONGLONG)sizeHi) << 32) | sizeLo;
+
     // Preflight dest: directory collision -> error; else clear R/O etc.
     DWORD da = GetFileAttributesA(d);
     if (da != INVALID_FILE_ATTRIBUTES) {
@@ -554,74 +812,209 @@ static bool CopyFileChunkedA(const char* s, const char* d,
         if (na != da) SetFileAttributesA(d, na);
     }
 
-    // Create/overwrite dest (no sharing)
-    HANDLE hd = CreateFileA(d, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+    // Resume only when the kept prefix is really there; otherwise start over.
+    if (startAt > fileSize) startAt = 0;
+    if (startAt && da == INVALID_FILE_ATTRIBUTES) startAt = 0;
+
+    // Create/overwrite dest (no sharing); on resume keep it and cut to startAt
+    HANDLE hd = CreateFileA(d, GENERIC_WRITE, 0, NULL, startAt ? OPEN_ALWAYS : CREATE_ALWAYS,
                             FILE_ATTRIBUTE_NORMAL, NULL);
     if (hd == INVALID_HANDLE_VALUE){ CloseHandle(hs); return false; }
+    if (startAt){
+        DWORD dHi = 0;
+        const DWORD dLo = GetFileSize(hd, &dHi);
+        const ULONGLONG have = (((ULONGLONG)dHi) << 32) | dLo;
+        if (dLo == 0xFFFFFFFFu && GetLastError() != NO_ERROR) startAt = 0;
+        else if (have < startAt)                             startAt = 0;
+
+        // The tail is appended at startAt: a file that keeps a stale tail
+        // would be vouched for by the cursor, so failing here fails the file
+        if (!SetFileSizeA(hd, startAt, startAt)){
+            const DWORD err = GetLastError();
+            CloseHandle(hs); CloseHandle(hd);
+            DeleteFileA(d);
+            SetLastError(err);
+            return false;
+        }
+    }
+
+    // Reserve the whole file now (fails fast when the volume is full); the
+    // tail past what is written gets cut again if the copy stops early.
+    bool      ok       = true;
+    if (fileSize > kSmallFileMax && !SetFileSizeA(hd, fileSize, startAt)){
+        const DWORD err = GetLastError();
+        CloseHandle(hs); CloseHandle(hd);
+        if (startAt) SetFileAttributesA(d, FILE_ATTRIBUTE_NORMAL);   // keep the resumable prefix
+        else         DeleteFileA(d);
+        SetLastError(err);
+        return false;
+    }
 
-    const DWORD BUFSZ = 64 * 1024;
-    char* buf = (char*)LocalAlloc(LMEM_FIXED, BUFSZ);
-    if (!buf){ CloseHandle(hs); CloseHandle(hd); return false; }
+    // Prime the ring: up to kCopySlots reads in flight.
+    bool      canceled = false;
+    uLong     crc      = crc32(0L, Z_NULL, 0);
+    if (startAt) verify = NULL;   // prefix was written by an earlier run
+    ULONGLONG issued  = startAt;   // bytes requested so far
+    ULONGLONG written = startAt;   // bytes written so far
+    inoutBytesDone += startAt;
+    for (int i=0; i<kCopySlots && issued<fileSize; ++i){
+        const ULONGLONG left = fileSize - issued;
+        const DWORD     want = (left > kCopyChunk) ? kCopyChunk : (DWORD)left;
+        if (!CopySlotIssue(hs, pipe.slot[i], issued, want)) { ok = false; break; }
+        issued += want;
+    }
 
-    bool ok = true;
-    for (;;){
-        DWORD rd = 0;
-        if (!ReadFile(hs, buf, BUFSZ, &rd, NULL)) { ok = false; break; }
-        if (rd == 0) break;
+    // Consume in order; refill each slot as soon as its data is written.
+    int head = 0;
+    while (ok && written < fileSize){
+        CopySlot& cur = pipe.slot[head];
+
+        DWORD got = 0;
+        if (!CopySlotReap(hs, cur, got)) { ok = false; break; }
+        if (got == 0) { SetLastError(ERROR_HANDLE_EOF); ok = false; break; } // source shrank
+
+        // Checksum while the other slots' reads are still in flight
+        if (verify) crc = crc32(crc, (const Bytef*)cur.buf, got);
 
         DWORD wr = 0;
-        if (!WriteFile(hd, buf, rd, &wr, NULL)) { ok = false; break; }
+        if (!WriteFile(hd, cur.buf, got, &wr, NULL) || wr != got) { ok = false; break; }
+        written += wr;
+
+        // Short read => file shrank under us; stop issuing past what we have.
+        if (got < cur.want) { SetLastError(ERROR_HANDLE_EOF); ok = false; break; }
+
+        if (issued < fileSize){
+            const ULONGLONG left = fileSize - issued;
+            const DWORD     want = (left > kCopyChunk) ? kCopyChunk : (DWORD)left;
+            if (!CopySlotIssue(hs, cur, issued, want)) { ok = false; break; }
+            issued += want;
+        }
+        head = (head + 1) % kCopySlots;
 
         inoutBytesDone += wr;
 
+        // Journal checkpoint (the sink decides when to persist)
+        if (cursor && cursor->fn) cursor->fn(entry, written, hd, cursor->user);
+
         // Progress/cancel callback
         if (CopyProgress::g_copyProgFn){
             if (!CopyProgress::g_copyProgFn(inoutBytesDone, totalBytes, s, CopyProgress::g_copyProgUser)){
-                ok = false; break; // canceled
+                ok = false; canceled = true; break;
             }
         }
     }
 
-    LocalFree(buf);
+    CopyPipeDrain(hs, pipe);
     CloseHandle(hs);
+    // A kept partial must end at the last byte written, not the reservation
+    if (!ok && cursor && canceled){
+        const DWORD err = GetLastError();
+        SetFileSizeA(hd, written, written);
+        SetLastError(err);
+    }
     CloseHandle(hd);
 
-    // Normalize dest; on failure, remove partial
-    if (!ok) { DeleteFileA(d); }
+    // Normalize dest; on failure, remove partial (journaled cancel keeps it)
+    if (!ok) { if (!(cursor && canceled)) DeleteFileA(d); }
     else     { SetFileAttributesA(d, FILE_ATTRIBUTE_NORMAL); }
+
+    if (ok && verify){
+        bool match = false; DWORD readErr = NO_ERROR;
+        if (!VerifyFileCrcA(d, fileSize, crc, pipe, inoutBytesDone, totalBytes, match, readErr)) return false;
+        if (readErr != NO_ERROR) verify->unreadable.push_back(d);
+        else { ++verify->checked; if (!match) verify->mismatched.push_back(d); }
+    }
     return ok;
 }
 
-// Core recursive copy: directory creation + per-file copy.
-static bool CopyRecursiveCoreA(const char* srcPath, const char* dstDir,
-                               ULONGLONG& inoutBytesDone, ULONGLONG totalBytes)
+// ============================================================================
+// Operation manifest
+//  - BuildManifestA enumerates each source tree exactly once into a flat,
+//    pre-order entry list (24 bytes + relative path per entry)
+//  - Copy and delete replay the list; no second FindFirstFileA walk
+// ============================================================================
+
+static DWORD ManifestAddName(OpManifest& m, const char* s){
+    const DWORD off = (DWORD)m.names.size();
+    m.names.insert(m.names.end(), s, s + strlen(s) + 1);
+    return off;
+}
+
+// Append the children of 'path' (and their subtrees). 'path' is a scratch
+// buffer of 'cap' bytes; on return it holds the original directory again.
+// Whatever cannot be addressed is counted in 'inoutSkipped', never dropped
+// silently: a move must not delete a source folder that still holds it.
+static void ManifestWalkDirA(OpManifest& m, char* path, size_t cap, size_t relStart,
+                             ULONGLONG& inoutBytes, DWORD& inoutSkipped)
 {
-    DWORD a = GetFileAttributesA(srcPath);
-    if (a == INVALID_FILE_ATTRIBUTES) return false;
+    size_t n = strlen(path);
+    if (n && path[n-1] != '\\'){
+        if (n+1 >= cap) { ++inoutSkipped; return; }
+        path[n++] = '\\'; path[n] = 0;
+    }
+    if (n+1 >= cap) { ++inoutSkipped; return; }
 
-    const char* base = strrchr(srcPath, '\\'); base = base ? base+1 : srcPath;
-    char dstPath[512]; JoinPath(dstPath, sizeof(dstPath), dstDir, base);
+    path[n] = '*'; path[n+1] = 0;
+    WIN32_FIND_DATAA fd; HANDLE h = FindFirstFileA(path, &fd);
+    path[n] = 0;
+    if (h == INVALID_HANDLE_VALUE) return;
 
-    if (a & FILE_ATTRIBUTE_DIRECTORY){
-        if (!EnsureDirA(dstPath)) return false;
+    do{
+        if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
+        const size_t len = strlen(fd.cFileName);
+        if (n + len + 1 >= cap) { ++inoutSkipped; continue; }   // cannot be addressed with our buffers
+        memcpy(path + n, fd.cFileName, len + 1);
+
+        ManifestEntry e;
+        e.attr    = fd.dwFileAttributes;
+        e.size    = (e.attr & FILE_ATTRIBUTE_DIRECTORY) ? 0
+                  : ((((ULONGLONG)fd.nFileSizeHigh)<<32) | fd.nFileSizeLow);
+        e.mtime   = (((ULONGLONG)fd.ftLastWriteTime.dwHighDateTime)<<32) | fd.ftLastWriteTime.dwLowDateTime;
+        e.nameOff = ManifestAddName(m, path + relStart);
+        m.entries.push_back(e);
+
+        if (e.attr & FILE_ATTRIBUTE_DIRECTORY) ManifestWalkDirA(m, path, cap, relStart, inoutBytes, inoutSkipped);
+        else                                   inoutBytes += e.size;
+        path[n] = 0;
+    } while (FindNextFileA(h, &fd));
+    FindClose(h);
+}
 
-        // Do NOT preserve source dir attributes
-        SetFileAttributesA(dstPath, FILE_ATTRIBUTE_NORMAL);
+void BuildManifestA(const std::vector<std::string>& srcs, OpManifest& out){
+    out.names.clear(); out.entries.clear(); out.roots.clear();
+    out.totalBytes = 0;
+    out.roots.reserve(srcs.size());
+
+    for (size_t i=0; i<srcs.size(); ++i){
+        ManifestRoot r;
+        _snprintf(r.srcPath, sizeof(r.srcPath), "%s", srcs[i].c_str()); r.srcPath[sizeof(r.srcPath)-1]=0;
+        const char* bn = strrchr(r.srcPath, '\\');
+        r.relStart = bn ? (size_t)(bn - r.srcPath) + 1 : 0;
+        r.first    = out.entries.size();
+        r.count    = 0;
+        r.bytes    = 0;
+        r.skipped  = 0;
 
-        char mask[512]; JoinPath(mask, sizeof(mask), srcPath, "*");
-        WIN32_FIND_DATAA fd; HANDLE h = FindFirstFileA(mask, &fd);
-        if (h != INVALID_HANDLE_VALUE){
-            do{
-                if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
-                char subSrc[512]; JoinPath(subSrc, sizeof(subSrc), srcPath, fd.cFileName);
-                if (!CopyRecursiveCoreA(subSrc, dstPath, inoutBytesDone, totalBytes))
-                    { FindClose(h); return false; }
-            }while (FindNextFileA(h,&fd));
-            FindClose(h);
+        WIN32_FILE_ATTRIBUTE_DATA fad;
+        if (r.srcPath[r.relStart] && GetFileAttributesExA(r.srcPath, GetFileExInfoStandard, &fad)){
+            ManifestEntry e;
+            e.attr    = fad.dwFileAttributes;
+            e.size    = (e.attr & FILE_ATTRIBUTE_DIRECTORY) ? 0
+                      : ((((ULONGLONG)fad.nFileSizeHigh)<<32) | fad.nFileSizeLow);
+            e.mtime   = (((ULONGLONG)fad.ftLastWriteTime.dwHighDateTime)<<32) | fad.ftLastWriteTime.dwLowDateTime;
+            e.nameOff = ManifestAddName(out, r.srcPath + r.relStart);
+            out.entries.push_back(e);
+
+            if (e.attr & FILE_ATTRIBUTE_DIRECTORY){
+                char path[512]; memcpy(path, r.srcPath, sizeof(path));
+                ManifestWalkDirA(out, path, sizeof(path), r.relStart, r.bytes, r.skipped);
+            } else {
+                r.bytes = e.size;
+            }
+            r.count = out.entries.size() - r.first;
         }
-        return true;
-    } else {
-        return CopyFileChunkedA(srcPath, dstPath, inoutBytesDone, totalBytes);
+        out.totalBytes += r.bytes;
+        out.roots.push_back(r);
     }
 }
 
@@ -637,17 +1030,688 @@ static bool IsSubPathCI(const char* parent, const char* child) {
     return _strnicmp(p, c, strlen(p)) == 0;
 }
 
-// Public entry for recursive copy with progress and a safety check.
-bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
-                                ULONGLONG totalBytes)
+// Rebuild "<prefix><rel>" into dst (prefix already in place, prefixLen chars).
+static bool ManifestPathA(char* dst, size_t cap, size_t prefixLen, const char* rel){
+    const size_t rl = strlen(rel);
+    if (prefixLen + rl + 1 > cap) { SetLastError(ERROR_FILENAME_EXCED_RANGE); return false; }
+    memcpy(dst + prefixLen, rel, rl + 1);
+    return true;
+}
+
+ULONGLONG ManifestBytesBefore(const OpManifest& m, size_t root,
+                              size_t entry, ULONGLONG offset)
+{
+    if (root >= m.roots.size()) return 0;
+    const ManifestRoot& r = m.roots[root];
+    const size_t end = r.first + r.count;
+    if (entry <= r.first) return 0;
+    if (entry >= end)     return r.bytes;
+
+    ULONGLONG sum = offset;
+    for (size_t i = r.first; i < entry; ++i) sum += m.entries[i].size;
+    return sum;
+}
+
+static const DWORD kFatxDirentBytes = 64;
+
+ULONGLONG ClusterRoundUp(ULONGLONG bytes, DWORD clusterBytes){
+    if (!clusterBytes) return bytes;
+    return (bytes + clusterBytes - 1) / clusterBytes * clusterBytes;
+}
+
+ULONGLONG FolderOnDiskBytes(DWORD entries, DWORD clusterBytes){
+    if (!clusterBytes) return 0;
+    const ULONGLONG b = ClusterRoundUp((ULONGLONG)(entries + 1) * kFatxDirentBytes, clusterBytes);
+    return b ? b : clusterBytes;
+}
+
+// Entries are pre-order, so a folder's children follow it until the first
+// path outside it: a stack of open folders counts their direct entries.
+struct OpenFolder { const char* path; size_t len; DWORD entries; };
+
+ULONGLONG ManifestOnDiskBytes(const OpManifest& m, size_t firstRoot, size_t rootCount,
+                              DWORD clusterBytes)
+{
+    std::vector<OpenFolder> stack;
+    ULONGLONG sum = 0;
+
+    const size_t endRoot = (firstRoot + rootCount < m.roots.size()) ? firstRoot + rootCount : m.roots.size();
+    for (size_t r = firstRoot; r < endRoot; ++r){
+        const ManifestRoot& mr = m.roots[r];
+        for (size_t i = mr.first; i < mr.first + mr.count; ++i){
+            const ManifestEntry& e = m.entries[i];
+            const char* rel = m.RelPath(e);
+            while (!stack.empty() &&
+                   !(_strnicmp(rel, stack.back().path, stack.back().len) == 0 && rel[stack.back().len] == '\\')){
+                sum += FolderOnDiskBytes(stack.back().entries, clusterBytes);
+                stack.pop_back();
+            }
+            if (!stack.empty()) ++stack.back().entries;
+
+            if (e.attr & FILE_ATTRIBUTE_DIRECTORY){
+                OpenFolder o = { rel, strlen(rel), 0 };
+                stack.push_back(o);
+            } else {
+                sum += ClusterRoundUp(e.size, clusterBytes);
+            }
+        }
+        for (; !stack.empty(); stack.pop_back())
+            sum += FolderOnDiskBytes(stack.back().entries, clusterBytes);
+    }
+    return sum;
+}
+
+// Small-file path: one synchronous read of the whole file into the pipe
+// block, one write. 'freshDst' means the destination folder was created by
+// this copy, so there is nothing to probe or unprotect at 'd'.
+// Returns false with *outFallback set when the file outgrew the block.
+static bool CopySmallFileA(const char* s, const char* d, bool freshDst, CopyPipe& pipe,
+                           CopyVerify* verify, ULONGLONG& inoutBytesDone, ULONGLONG totalBytes,
+                           bool* outFallback)
 {
-    // Compute dstTop = dstDir\basename(srcPath)
-    const char* base = strrchr(srcPath, '\\'); base = base ? base+1 : srcPath;
-    char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), dstDir, base);
+    *outFallback = false;
+
+    HANDLE hs = CreateFileA(s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hs == INVALID_HANDLE_VALUE) return false;
+
+    DWORD got = 0;
+    const BOOL rd = ReadFile(hs, pipe.block, kSmallFileMax, &got, NULL);
+    CloseHandle(hs);
+    if (!rd) return false;
+    if (got == kSmallFileMax) { *outFallback = true; return false; }  // grew since the walk
+
+    if (!freshDst){
+        // Same preflight as the chunked path
+        DWORD da = GetFileAttributesA(d);
+        if (da != INVALID_FILE_ATTRIBUTES) {
+            if (da & FILE_ATTRIBUTE_DIRECTORY) { SetLastError(ERROR_ALREADY_EXISTS); return false; }
+            DWORD na = da & ~(FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN);
+            if (na != da) SetFileAttributesA(d, na);
+        }
+    }
+
+    HANDLE hd = CreateFileA(d, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hd == INVALID_HANDLE_VALUE) return false;
+    DWORD wr = 0;
+    const BOOL ok = WriteFile(hd, pipe.block, got, &wr, NULL) && wr == got;
+    CloseHandle(hd);
+    if (!ok) { DeleteFileA(d); return false; }
+
+    inoutBytesDone += got;
+
+    if (verify){
+        const uLong crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef*)pipe.block, got);
+        bool match = false; DWORD readErr = NO_ERROR;
+        if (!VerifyFileCrcA(d, got, crc, pipe, inoutBytesDone, totalBytes, match, readErr)) return false;
+        if (readErr != NO_ERROR) verify->unreadable.push_back(d);
+        else { ++verify->checked; if (!match) verify->mismatched.push_back(d); }
+    }
+
+    // Progress/cancel callback
+    if (CopyProgress::g_copyProgFn &&
+        !CopyProgress::g_copyProgFn(inoutBytesDone, totalBytes, s, CopyProgress::g_copyProgUser))
+        return false; // canceled (file itself is complete)
+    return true;
+}
+
+// True if 'rel' lies inside the folder 'dirRel' (dirLen chars).
+static inline bool RelUnder(const char* rel, const char* dirRel, size_t dirLen){
+    return dirLen && _strnicmp(rel, dirRel, dirLen) == 0 && rel[dirLen] == '\\';
+}
+
+bool CopyManifestRootA(const OpManifest& m, size_t root, const char* dstDir,
+                       ULONGLONG totalBytes, CopyCursor* cursor, CopyVerify* verify)
+{
+    if (root >= m.roots.size()) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+    const ManifestRoot& r = m.roots[root];
+    if (!r.count) { SetLastError(ERROR_FILE_NOT_FOUND); return false; }
+
+    char src[512]; memcpy(src, r.srcPath, r.relStart);
+    char dst[512]; _snprintf(dst, sizeof(dst), "%s", dstDir); dst[sizeof(dst)-1]=0;
+    NormalizeDirA(dst);
+    const size_t dstLen = strlen(dst);
 
     // Guard: prevent copying into own subfolder
-    if (IsSubPathCI(srcPath, dstTop)) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+    if (!ManifestPathA(dst, sizeof(dst), dstLen, m.RelPath(m.entries[r.first]))) return false;
+    if (IsSubPathCI(r.srcPath, dst)) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+
+    CopyPipe pipe;
+    if (!CopyPipeInit(pipe)) { CopyPipeFree(pipe); SetLastError(ERROR_NOT_ENOUGH_MEMORY); return false; }
+
+    // Resume point: entries before it are complete at the destination.
+    size_t    start   = r.first;
+    ULONGLONG startAt = 0;
+    if (cursor && cursor->entry > r.first){
+        start   = (cursor->entry < r.first + r.count) ? cursor->entry : r.first + r.count;
+        startAt = cursor->offset;
+    }
+
+    const size_t end = r.first + r.count;
+    bool ok = true;
+
+    // Pass 1: every folder, parents first (pre-order). A folder we just
+    // created has no existing children, so below it CreateDirectoryA is
+    // enough - no attribute probe or reset. fresh[] remembers which ones.
+    std::vector<char> fresh(r.count, 0);
+    {
+        const char* freshRel = NULL; size_t freshLen = 0;   // outermost fresh folder
+        for (size_t i = r.first; ok && i < end; ++i){
+            const ManifestEntry& e = m.entries[i];
+            if (!(e.attr & FILE_ATTRIBUTE_DIRECTORY)) continue;
+            const char* rel = m.RelPath(e);
+            if (!ManifestPathA(dst, sizeof(dst), dstLen, rel)) { ok = false; break; }
+
+            if (RelUnder(rel, freshRel, freshLen)){
+                if (!CreateDirectoryA(dst, NULL)) { ok = false; break; }
+                fresh[i - r.first] = 1;
+            } else if (CreateDirectoryA(dst, NULL)){
+                fresh[i - r.first] = 1;
+                freshRel = rel; freshLen = strlen(rel);
+            } else {
+                if (!EnsureDirA(dst)) { ok = false; break; }
+                // Do NOT preserve source dir attributes
+                SetFileAttributesA(dst, FILE_ATTRIBUTE_NORMAL);
+            }
+        }
+    }
+
+    // Pass 2: files, in manifest order so the resume cursor stays valid.
+    ULONGLONG done = ManifestBytesBefore(m, root, start, 0);
+    const char* freshRel = NULL; size_t freshLen = 0;
+    for (size_t i = r.first; ok && i < end; ++i){
+        const ManifestEntry& e = m.entries[i];
+        const char* rel = m.RelPath(e);
+
+        if (e.attr & FILE_ATTRIBUTE_DIRECTORY){
+            if (fresh[i - r.first] && !RelUnder(rel, freshRel, freshLen)) { freshRel = rel; freshLen = strlen(rel); }
+            continue;
+        }
+        if (i < start) continue;
+
+        if (!ManifestPathA(src, sizeof(src), r.relStart, rel) ||
+            !ManifestPathA(dst, sizeof(dst), dstLen, rel)) { ok = false; break; }
+
+        const ULONGLONG from = (i == start) ? startAt : 0;
+        bool fallback = true;
+        if (from == 0 && e.size < kSmallFileMax){
+            ok = CopySmallFileA(src, dst, RelUnder(rel, freshRel, freshLen), pipe,
+                                verify, done, totalBytes, &fallback);
+        }
+        if (fallback){
+            ok = CopyFileChunkedA(src, dst, pipe, from, cursor, i, verify, done, totalBytes);
+        }
+
+        if (ok && cursor){
+            cursor->entry  = i + 1;
+            cursor->offset = 0;
+            if (cursor->fn) cursor->fn(i + 1, 0, INVALID_HANDLE_VALUE, cursor->user);
+        }
+    }
+    // Everything listed is in place, but the walk had to leave entries out
+    if (ok && r.skipped) { ok = false; SetLastError(ERROR_FILENAME_EXCED_RANGE); }
+
+    // Keep the copy's error code across the cleanup calls
+    const DWORD err = GetLastError();
+    CopyPipeFree(pipe);
+    SetLastError(err);
+    return ok;
+}
+
+// ============================================================================
+// Fan-out copy (read once, write many)
+//  - Same manifest replay as CopyManifestRootA, but every chunk read from the
+//    source goes to all live destinations before the slot is refilled, so a
+//    tree staged to N places costs one source pass (DVD!) instead of N
+//  - Each destination fails on its own: the first error is kept in err,
+//    its partial file is removed and the rest of the tree skips it
+//  - No resume cursor and no verify; progress reports source bytes
+// ============================================================================
+
+struct FanOutDst {
+    char   path[512];   // dstDir + current relative path
+    size_t len;         // length of the dstDir prefix
+    HANDLE h;           // current file, INVALID_HANDLE_VALUE between files
+    DWORD  err;         // NO_ERROR while the destination is live
+};
+
+// Drop destination d with 'err'; closes and removes its current file.
+static void FanOutFail(FanOutDst& d, DWORD err){
+    if (d.h != INVALID_HANDLE_VALUE){
+        CloseHandle(d.h);
+        d.h = INVALID_HANDLE_VALUE;
+        DeleteFileA(d.path);
+    }
+    d.err = err ? err : ERROR_GEN_FAILURE;
+}
+
+// Clear R/O etc. on an existing destination file and create/overwrite it.
+static HANDLE FanOutCreateA(const char* d){
+    DWORD da = GetFileAttributesA(d);
+    if (da != INVALID_FILE_ATTRIBUTES) {
+        if (da & FILE_ATTRIBUTE_DIRECTORY) { SetLastError(ERROR_ALREADY_EXISTS); return INVALID_HANDLE_VALUE; }
+        DWORD na = da & ~(FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN);
+        if (na != da) SetFileAttributesA(d, na);
+    }
+    return CreateFileA(d, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+// Write 'n' bytes to every live destination; false when none is left.
+static bool FanOutWrite(std::vector<FanOutDst>& dst, const char* buf, DWORD n){
+    bool any = false;
+    for (size_t k=0; k<dst.size(); ++k){
+        FanOutDst& d = dst[k];
+        if (d.err != NO_ERROR || d.h == INVALID_HANDLE_VALUE) continue;
+        DWORD wr = 0;
+        if (!WriteFile(d.h, buf, n, &wr, NULL)) { FanOutFail(d, GetLastError()); continue; }
+        if (wr != n)                            { FanOutFail(d, ERROR_DISK_FULL); continue; }
+        any = true;
+    }
+    return any;
+}
+
+// Copy one file to every live destination (paths already in dst[k].path).
+// Returns false on cancel or a source error (which fails all destinations).
+static bool CopyFileFanOutA(const char* s, ULONGLONG size, std::vector<FanOutDst>& dst,
+                            CopyPipe& pipe, ULONGLONG& inoutBytesDone, ULONGLONG totalBytes)
+{
+    // Small file: one blocking read, then the whole block to each destination.
+    bool small = (size < kSmallFileMax);
+    HANDLE hs = CreateFileA(s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | (small ? 0 : FILE_FLAG_OVERLAPPED), NULL);
+    DWORD srcErr = (hs == INVALID_HANDLE_VALUE) ? GetLastError() : NO_ERROR;
+
+    ULONGLONG fileSize = size;
+    DWORD     got      = 0;
+    if (srcErr == NO_ERROR && small){
+        if (!ReadFile(hs, pipe.block, kSmallFileMax, &got, NULL)) srcErr = GetLastError();
+        fileSize = got;
+        CloseHandle(hs);
+        hs = INVALID_HANDLE_VALUE;
+        if (srcErr == NO_ERROR && got == kSmallFileMax){
+            // Grew since the walk: take the chunked path (as CopySmallFileA falls back)
+            small = false;
+            hs = CreateFileA(s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, NULL);
+            if (hs == INVALID_HANDLE_VALUE) srcErr = GetLastError();
+        }
+    }
+    if (srcErr == NO_ERROR && !small){
+        DWORD sizeHi = 0;
+        const DWORD sizeLo = GetFileSize(hs, &sizeHi);
+        if (sizeLo == 0xFFFFFFFFu && GetLastError() != NO_ERROR) srcErr = GetLastError();
+        fileSize = (((ULONGLONG)sizeHi) << 32) | sizeLo;
+    }
+    if (srcErr != NO_ERROR){
+        if (hs != INVALID_HANDLE_VALUE) CloseHandle(hs);
+        for (size_t k=0; k<dst.size(); ++k) if (dst[k].err == NO_ERROR) FanOutFail(dst[k], srcErr);
+        SetLastError(srcErr);
+        return false;
+    }
+
+    // Open every live destination
+    bool any = false;
+    for (size_t k=0; k<dst.size(); ++k){
+        FanOutDst& d = dst[k];
+        if (d.err != NO_ERROR) continue;
+        d.h = FanOutCreateA(d.path);
+        if (d.h == INVALID_HANDLE_VALUE) { FanOutFail(d, GetLastError()); continue; }
+        if (!small && !SetFileSizeA(d.h, fileSize, 0)) { FanOutFail(d, GetLastError()); continue; }
+        any = true;
+    }
+
+    bool ok       = any;
+    bool canceled = false;
+    if (small){
+        if (ok && got) ok = FanOutWrite(dst, pipe.block, got);
+        inoutBytesDone += got;
+    } else if (ok){
+        // Same ring as CopyFileChunkedA; a slot is refilled only after its
+        // chunk went to every destination.
+        ULONGLONG issued = 0, written = 0;
+        for (int i=0; i<kCopySlots && issued<fileSize; ++i){
+            const ULONGLONG left = fileSize - issued;
+            const DWORD     want = (left > kCopyChunk) ? kCopyChunk : (DWORD)left;
+            if (!CopySlotIssue(hs, pipe.slot[i], issued, want)) { srcErr = GetLastError(); break; }
+            issued += want;
+        }
+        int head = 0;
+        while (srcErr == NO_ERROR && written < fileSize){
+            CopySlot& cur = pipe.slot[head];
+            DWORD n = 0;
+            if (!CopySlotReap(hs, cur, n)) { srcErr = GetLastError(); break; }
+            if (n == 0 || n < cur.want)    { srcErr = ERROR_HANDLE_EOF; break; }  // source shrank
+
+            if (!FanOutWrite(dst, cur.buf, n)) { ok = false; break; }   // every destination failed
+            written += n;
+
+            if (issued < fileSize){
+                const ULONGLONG left = fileSize - issued;
+                const DWORD     want = (left > kCopyChunk) ? kCopyChunk : (DWORD)left;
+                if (!CopySlotIssue(hs, cur, issued, want)) { srcErr = GetLastError(); break; }
+                issued += want;
+            }
+            head = (head + 1) % kCopySlots;
+
+            inoutBytesDone += n;
+            if (CopyProgress::g_copyProgFn &&
+                !CopyProgress::g_copyProgFn(inoutBytesDone, totalBytes, s, CopyProgress::g_copyProgUser)){
+                canceled = true; break;
+            }
+        }
+        CopyPipeDrain(hs, pipe);
+    }
+    if (!small) CloseHandle(hs);   // open even when no destination took the file
+
+    // Close out: a source error or cancel takes every partial file with it.
+    if (srcErr != NO_ERROR || canceled) ok = false;
+    for (size_t k=0; k<dst.size(); ++k){
+        FanOutDst& d = dst[k];
+        if (d.h == INVALID_HANDLE_VALUE) continue;
+        if (srcErr != NO_ERROR) { FanOutFail(d, srcErr); continue; }
+        CloseHandle(d.h);
+        d.h = INVALID_HANDLE_VALUE;
+        if (canceled) DeleteFileA(d.path);   // destination itself stays live
+        else          SetFileAttributesA(d.path, FILE_ATTRIBUTE_NORMAL);
+    }
+    if (canceled || srcErr != NO_ERROR){ SetLastError(canceled ? ERROR_CANCELLED : srcErr); return false; }
 
+    // Small files report once, after the writes (same as CopySmallFileA)
+    if (small && CopyProgress::g_copyProgFn &&
+        !CopyProgress::g_copyProgFn(inoutBytesDone, totalBytes, s, CopyProgress::g_copyProgUser)){
+        SetLastError(ERROR_CANCELLED);
+        return false;
+    }
+    return ok;
+}
+
+bool CopyManifestRootFanOutA(const OpManifest& m, size_t root,
+                             const std::vector<std::string>& dstDirs,
+                             ULONGLONG totalBytes, std::vector<DWORD>& ioErr)
+{
+    ioErr.resize(dstDirs.size(), NO_ERROR);
+    if (root >= m.roots.size()) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+    const ManifestRoot& r = m.roots[root];
+    if (!r.count) { SetLastError(ERROR_FILE_NOT_FOUND); return false; }
+
+    char src[512]; memcpy(src, r.srcPath, r.relStart);
+    const char* topRel = m.RelPath(m.entries[r.first]);
+
+    // Per-destination state; same guards as the single-destination copy
+    std::vector<FanOutDst> dst(dstDirs.size());
+    size_t live = 0;
+    for (size_t k=0; k<dst.size(); ++k){
+        FanOutDst& d = dst[k];
+        d.h   = INVALID_HANDLE_VALUE;
+        d.err = ioErr[k];
+        _snprintf(d.path, sizeof(d.path), "%s", dstDirs[k].c_str()); d.path[sizeof(d.path)-1]=0;
+        NormalizeDirA(d.path);
+        d.len = strlen(d.path);
+        if (d.err != NO_ERROR) continue;
+        if (!ManifestPathA(d.path, sizeof(d.path), d.len, topRel)) { d.err = GetLastError(); continue; }
+        if (IsSubPathCI(r.srcPath, d.path)) { d.err = ERROR_INVALID_PARAMETER; continue; }
+        ++live;
+    }
+    if (!live){
+        for (size_t k=0; k<dst.size(); ++k) ioErr[k] = dst[k].err;
+        SetLastError(ERROR_INVALID_PARAMETER);
+        return false;
+    }
+
+    CopyPipe pipe;
+    if (!CopyPipeInit(pipe)) { CopyPipeFree(pipe); SetLastError(ERROR_NOT_ENOUGH_MEMORY); return false; }
+
+    const size_t end = r.first + r.count;
+
+    // Pass 1: folders, parents first, on every destination
+    for (size_t k=0; k<dst.size(); ++k){
+        FanOutDst& d = dst[k];
+        for (size_t i = r.first; d.err == NO_ERROR && i < end; ++i){
+            const ManifestEntry& e = m.entries[i];
+            if (!(e.attr & FILE_ATTRIBUTE_DIRECTORY)) continue;
+            if (!ManifestPathA(d.path, sizeof(d.path), d.len, m.RelPath(e))) { d.err = GetLastError(); break; }
+            if (CreateDirectoryA(d.path, NULL)) continue;
+            if (!EnsureDirA(d.path)) { d.err = GetLastError() ? GetLastError() : ERROR_PATH_NOT_FOUND; break; }
+            SetFileAttributesA(d.path, FILE_ATTRIBUTE_NORMAL);   // do NOT preserve source dir attributes
+        }
+    }
+
+    // Pass 2: files, each read once
+    bool ok = true;
+    ULONGLONG done = 0;
+    for (size_t i = r.first; ok && i < end; ++i){
+        const ManifestEntry& e = m.entries[i];
+        if (e.attr & FILE_ATTRIBUTE_DIRECTORY) continue;
+        const char* rel = m.RelPath(e);
+        if (!ManifestPathA(src, sizeof(src), r.relStart, rel)) { ok = false; break; }
+
+        bool any = false;
+        for (size_t k=0; k<dst.size(); ++k){
+            FanOutDst& d = dst[k];
+            if (d.err != NO_ERROR) continue;
+            if (!ManifestPathA(d.path, sizeof(d.path), d.len, rel)) { d.err = GetLastError(); continue; }
+            any = true;
+        }
+        if (!any) { ok = false; break; }
+
+        if (!CopyFileFanOutA(src, e.size, dst, pipe, done, totalBytes)){
+            // Cancel leaves d.err alone; a source error already failed everyone
+            ok = false;
+        }
+    }
+
+    // Entries the walk left out are missing on every destination
+    if (ok && r.skipped)
+        for (size_t k=0; k<dst.size(); ++k)
+            if (dst[k].err == NO_ERROR) dst[k].err = ERROR_FILENAME_EXCED_RANGE;
+
+    // Keep the copy's error code across the cleanup calls
+    DWORD err = GetLastError();
+    CopyPipeFree(pipe);
+    for (size_t k=0; k<dst.size(); ++k){
+        ioErr[k] = dst[k].err;
+        if (dst[k].err != NO_ERROR){ ok = false; if (err == NO_ERROR) err = dst[k].err; }
+    }
+    SetLastError(err);
+    return ok;
+}
+
+bool DeleteManifestRootA(const OpManifest& m, size_t root,
+                         ULONGLONG& inoutDone, ULONGLONG total)
+{
+    if (root >= m.roots.size()) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+    const ManifestRoot& r = m.roots[root];
+    if (!r.count)                   { SetLastError(ERROR_FILE_NOT_FOUND);  return false; }
+    if (IsDriveRoot(r.srcPath))     { SetLastError(ERROR_ACCESS_DENIED);   return false; }
+    if (IsReadOnlyVolumeA(r.srcPath)) { SetLastError(ERROR_WRITE_PROTECT); return false; }
+
+    const DWORD kStrip = FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN;
+    char path[512]; memcpy(path, r.srcPath, r.relStart);
+    DWORD firstErr = NO_ERROR;
+
+    // Reverse pre-order = children before their directory.
+    for (size_t i = r.first + r.count; i-- > r.first; ){
+        const ManifestEntry& e = m.entries[i];
+        if (!ManifestPathA(path, sizeof(path), r.relStart, m.RelPath(e))){
+            if (firstErr == NO_ERROR) firstErr = GetLastError();
+            continue;
+        }
+
+        // Only pay for SetFileAttributes when the walk saw a blocking bit.
+        if (e.attr & kStrip) StripROSysHiddenA(path);
+
+        BOOL ok;
+        if (e.attr & FILE_ATTRIBUTE_DIRECTORY){
+            ok = RemoveDirectoryA(path);
+            if (!ok){ Sleep(1); StripROSysHiddenA(path); ok = RemoveDirectoryA(path); }
+        } else {
+            ok = DeleteFileA(path);
+            if (!ok){ StripROSysHiddenA(path); ok = DeleteFileA(path); }
+        }
+        if (!ok){
+            // Already gone (e.g. resumed move that died mid-delete) is fine
+            const DWORD err = GetLastError();
+            if (err != ERROR_FILE_NOT_FOUND && err != ERROR_PATH_NOT_FOUND && firstErr == NO_ERROR)
+                firstErr = err;
+        }
+
+        ++inoutDone;
+        if (CopyProgress::g_copyProgFn){
+            if (!CopyProgress::g_copyProgFn(inoutDone, total, path, CopyProgress::g_copyProgUser))
+                return false; // canceled
+        }
+    }
+
+    if (firstErr != NO_ERROR) { SetLastError(firstErr); return false; }
+    return true;
+}
+
+// ============================================================================
+// Sync planning (hash-join over two manifests)
+// ============================================================================
+
+// FNV-1a over the path, ASCII-lowercased (FATX names are case-insensitive).
+static DWORD HashRelPathCI(const char* s){
+    DWORD h = 2166136261u;
+    for (; *s; ++s){
+        unsigned char c = (unsigned char)*s;
+        if (c >= 'A' && c <= 'Z') c = (unsigned char)(c + 32);
+        h = (h ^ c) * 16777619u;
+    }
+    return h;
+}
+
+// CRC32 of a whole file through 'buf'; false if it cannot be read.
+static bool FileCrc32A(const char* path, char* buf, DWORD cap, uLong& outCrc){
+    HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    uLong crc = crc32(0L, Z_NULL, 0);
+    bool ok = true;
+    for (;;){
+        DWORD got = 0;
+        if (!ReadFile(h, buf, cap, &got, NULL)) { ok = false; break; }
+        if (got == 0) break;
+        crc = crc32(crc, (const Bytef*)buf, got);
+    }
+    CloseHandle(h);
+    outCrc = crc;
+    return ok;
+}
+
+// Start an output manifest that shares 'from's name pool and root table.
+static void PlanInit(OpManifest& out, const OpManifest& from){
+    out.names   = from.names;
+    out.entries.clear();
+    out.roots   = from.roots;
+    out.totalBytes = 0;
+    for (size_t i=0;i<out.roots.size();++i){ out.roots[i].count = 0; out.roots[i].bytes = 0; }
+}
+static void PlanAdd(OpManifest& out, size_t root, const ManifestEntry& e){
+    ManifestRoot& r = out.roots[root];
+    if (!r.count) r.first = out.entries.size();
+    out.entries.push_back(e);
+    ++r.count;
+    r.bytes        += e.size;
+    out.totalBytes += e.size;
+}
+
+bool BuildSyncPlanA(const OpManifest& src, const OpManifest& dst, bool byCrc,
+                    OpManifest& outCopy, OpManifest& outExtras, SyncStats& st)
+{
+    st = SyncStats();
+    PlanInit(outCopy, src);
+    PlanInit(outExtras, dst);
+    if (src.roots.size() != dst.roots.size()) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+
+    // Build side: open-addressing table over destination entries.
+    const DWORD kEmpty = 0xFFFFFFFFu;
+    size_t cap = 16; while (cap < dst.entries.size() * 2) cap <<= 1;
+    std::vector<DWORD> table(cap, kEmpty);
+    std::vector<DWORD> hashes(dst.entries.size());
+    for (size_t i=0;i<dst.entries.size();++i){
+        const DWORD h = HashRelPathCI(dst.RelPath(dst.entries[i]));
+        hashes[i] = h;
+        size_t slot = h & (cap - 1);
+        while (table[slot] != kEmpty) slot = (slot + 1) & (cap - 1);
+        table[slot] = (DWORD)i;
+    }
+    std::vector<char> matched(dst.entries.size(), 0);
+
+    char* buf = byCrc ? (char*)LocalAlloc(LMEM_FIXED, kCopyChunk) : NULL;
+    if (byCrc && !buf) { SetLastError(ERROR_NOT_ENOUGH_MEMORY); return false; }
+
+    char sp[512], dp[512];
+    bool ok = true;
+    ULONGLONG step = 0;
+    const ULONGLONG steps = src.entries.size();
+
+    // Probe side: each source entry once, roots kept apart (same rel path
+    // can only match inside the same root).
+    for (size_t r = 0; ok && r < src.roots.size(); ++r){
+        const ManifestRoot& sr = src.roots[r];
+        const ManifestRoot& dr = dst.roots[r];
+        memcpy(sp, sr.srcPath, sr.relStart);
+        memcpy(dp, dr.srcPath, dr.relStart);
+
+        for (size_t i = sr.first; i < sr.first + sr.count; ++i){
+            const ManifestEntry& e = src.entries[i];
+            const char* rel = src.RelPath(e);
+            const DWORD h = HashRelPathCI(rel);
+            const bool isDir = (e.attr & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+            DWORD hit = kEmpty;
+            for (size_t slot = h & (cap - 1); table[slot] != kEmpty; slot = (slot + 1) & (cap - 1)){
+                const DWORD k = table[slot];
+                if (hashes[k] == h && k >= dr.first && k < dr.first + dr.count &&
+                    _stricmp(dst.RelPath(dst.entries[k]), rel) == 0) { hit = k; break; }
+            }
+
+            const ManifestEntry* de = (hit != kEmpty) ? &dst.entries[hit] : NULL;
+            const bool sameType = de && (((de->attr & FILE_ATTRIBUTE_DIRECTORY) != 0) == isDir);
+            if (sameType) matched[hit] = 1;     // else: wrong type, stays an extra
+
+            if (isDir){
+                if (!sameType) PlanAdd(outCopy, r, e);            // folder to create
+            } else if (!sameType){
+                PlanAdd(outCopy, r, e); ++st.added;
+            } else {
+                bool changed = (e.size != de->size);
+                if (!changed && byCrc){
+                    uLong cs = 0, cd = 0;
+                    const bool okS = ManifestPathA(sp, sizeof(sp), sr.relStart, rel) && FileCrc32A(sp, buf, kCopyChunk, cs);
+                    const bool okD = ManifestPathA(dp, sizeof(dp), dr.relStart, dst.RelPath(*de)) && FileCrc32A(dp, buf, kCopyChunk, cd);
+                    changed = !(okS && okD && cs == cd);
+                } else if (!changed){
+                    changed = (e.mtime > de->mtime);     // source written after last sync
+                }
+                if (changed){ PlanAdd(outCopy, r, e); ++st.updated; st.replacedBytes += de->size; }
+                else         ++st.unchanged;
+            }
+
+            ++step;
+            if (CopyProgress::g_copyProgFn &&
+                !CopyProgress::g_copyProgFn(step, steps, rel, CopyProgress::g_copyProgUser))
+                { ok = false; break; } // canceled
+        }
+
+        // Anything on this root's destination side that found no partner
+        for (size_t k = dr.first; k < dr.first + dr.count; ++k){
+            if (matched[k]) continue;
+            PlanAdd(outExtras, r, dst.entries[k]);
+            ++st.extras;
+        }
+    }
+
+    if (buf) LocalFree(buf);
+    return ok;
+}
+
+// Public entry for recursive copy with progress and a safety check.
+bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
+                                ULONGLONG totalBytes)
+{
     // Optional free-space preflight (skip if unknown)
     if (totalBytes > 0) {
         ULONGLONG freeB=0, totalB=0;
@@ -655,8 +1719,10 @@ bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
         if (freeB > 0 && freeB < totalBytes) { SetLastError(ERROR_DISK_FULL); return false; }
     }
 
-    ULONGLONG done = 0;
-    return CopyRecursiveCoreA(srcPath, dstDir, done, totalBytes);
+    std::vector<std::string> one(1, std::string(srcPath));
+    OpManifest m;
+    BuildManifestA(one, m);
+    return CopyManifestRootA(m, 0, dstDir, totalBytes);
 }
 
 // ============================================================================
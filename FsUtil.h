@@ -16,6 +16,8 @@
 
 #include <xtl.h>
 #include <vector>
+#include <string>
+#include "Listing.h"
 
 #ifndef INVALID_FILE_ATTRIBUTES
 #define INVALID_FILE_ATTRIBUTES 0xFFFFFFFF
@@ -36,23 +38,16 @@
 #define DRIVE_CLOSED_MEDIA_PRESENT      4
 #endif
 
-// ----- Pane item (shared with UI) -------------------------------------------
-struct Item {
-    char        name[256];   // File/dir name or drive-root (e.g. "E:\")
-    bool        isDir;       // True if directory (incl. drive roots and "..")
-    ULONGLONG   size;        // File size (0 for dirs/roots/"..")
-    bool        isUpEntry;   // True only for synthetic ".." row
-    bool        marked;      // UI mark flag
-};
-
 // ===== Drive mapping / discovery ============================================
 void MapStandardDrives_Io();                     // Map C/E/F/G/X/Y/Z and D
 void RescanDrives();                             // Recompute present roots
-void BuildDriveItems(std::vector<Item>& out);    // Build UI items from roots
+void BuildDriveItems(Listing& out);              // Build UI items from roots
 unsigned int QueryDriveMaskAZ();                 // Bitmask A..Z (1<<('A'+n))
 
 // ===== Directory listing =====================================================
-bool ListDirectory(const char* path, std::vector<Item>& out);
+bool ListDirectory(const char* path, Listing& out);
+// Filter shared by all listers: skips "." / ".." and the trash folder at roots.
+bool IsListedName(const char* name, bool atRoot);
 
 // ===== Path helpers ==========================================================
 void JoinPath(char* dst, size_t cap, const char* base, const char* name);
@@ -65,10 +60,18 @@ bool IsDriveRoot(const char* p);
 bool DirExistsA(const char* path);
 bool EnsureDirA(const char* path);
 bool DeleteRecursiveA(const char* path);
+// Same, reporting the first failure (code + path) when firstErr != NULL.
+struct DeleteError {
+    DWORD code;
+    char  path[512];
+};
+bool DeleteTreeA(const char* path, DeleteError* firstErr);
 ULONGLONG DirSizeRecursiveA(const char* path);
 
 // ===== Misc info =============================================================
 void FormatSize(ULONGLONG sz, char* out, size_t cap);
+// "YYYY-MM-DD HH:MM" local time from a FILETIME as 64 bits; "" if 0/invalid.
+void FormatFileTime(ULONGLONG ft, char* out, size_t cap);
 void GetDriveFreeTotal(const char* anyPathInDrive,
                        ULONGLONG& freeBytes, ULONGLONG& totalBytes);
 bool CanWriteHereA(const char* dir);
@@ -90,6 +93,112 @@ void SetCopyProgressCallback(CopyProgressFn fn, void* user);
 bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
                                 ULONGLONG totalBytes);
 
+// ===== Operation manifest ===================================================
+// One FindFirst/FindNext walk per source tree, reused for the progress total,
+// free-space preflight, per-item accounting and the copy/delete itself.
+struct ManifestEntry {
+    ULONGLONG   size;        // file size (0 for dirs)
+    ULONGLONG   mtime;       // last-write FILETIME as one 64-bit value
+    DWORD       attr;        // FILE_ATTRIBUTE_* as enumerated
+    DWORD       nameOff;     // offset of the relative path in OpManifest::names
+};
+struct ManifestRoot {
+    char        srcPath[512];   // full source path as given
+    size_t      relStart;       // index of the basename in srcPath
+    size_t      first;          // first entry (the root itself), pre-order
+    size_t      count;          // entries in this tree (0 if missing)
+    ULONGLONG   bytes;          // sum of file sizes in this tree
+    DWORD       skipped;        // entries left out: path too long for our buffers
+};
+struct OpManifest {
+    std::vector<char>          names;    // NUL-terminated paths, relative to the root's parent
+    std::vector<ManifestEntry> entries;  // every root's tree, dirs before their children
+    std::vector<ManifestRoot>  roots;
+    ULONGLONG                  totalBytes;
+
+    OpManifest() : totalBytes(0) {}
+    const char* RelPath(const ManifestEntry& e) const { return &names[e.nameOff]; }
+};
+
+// Resume point + checkpoint sink for journaled copies (see CopyJournal).
+//  - entry/offset: first entry not yet complete and bytes of it already in
+//    place at the destination; CopyManifestRootA updates both as it goes.
+//  - fn is called after every chunk written (hDst = open destination) and
+//    once per finished entry (hDst = INVALID_HANDLE_VALUE).
+//  - With a cursor, a canceled file keeps its partial output.
+typedef void (*CopyCheckpointFn)(size_t entry, ULONGLONG offset, HANDLE hDst, void* user);
+struct CopyCursor {
+    size_t           entry;
+    ULONGLONG        offset;
+    CopyCheckpointFn fn;
+    void*            user;
+};
+
+// Verified copy: CRC32 of every chunk as it is read (no extra source pass),
+// compared against a re-read of the written file. A mismatch does not fail
+// the copy; the destination path is collected here for the final report.
+// Files resumed mid-way (startAt > 0) are not verified.
+struct CopyVerify {
+    std::vector<std::string> mismatched;   // destination paths that differ
+    std::vector<std::string> unreadable;   // destination paths the re-read failed on
+    unsigned                 checked;      // files compared
+    CopyVerify() : checked(0) {}
+};
+
+// Walk each source once; missing sources get count == 0. Entries whose
+// path does not fit are counted in ManifestRoot::skipped, and copying such
+// a root fails with ERROR_FILENAME_EXCED_RANGE once the rest is in place.
+void BuildManifestA(const std::vector<std::string>& srcs, OpManifest& out);
+// Copy roots[root] into dstDir (progress callback reports bytes of this root).
+// 'cursor' (optional) resumes mid-tree and receives checkpoints.
+// 'verify' (optional) turns on CRC32 verification.
+bool CopyManifestRootA(const OpManifest& m, size_t root, const char* dstDir,
+                       ULONGLONG totalBytes, CopyCursor* cursor = NULL,
+                       CopyVerify* verify = NULL);
+// Fan-out copy of roots[root] into every folder of dstDirs, reading each
+// source chunk once. ioErr (resized to dstDirs) holds one error per
+// destination: entries already set on input are skipped, and a destination
+// that fails keeps its first error while the others carry on. True only
+// when every destination got the whole tree. No cursor / verify support.
+bool CopyManifestRootFanOutA(const OpManifest& m, size_t root,
+                             const std::vector<std::string>& dstDirs,
+                             ULONGLONG totalBytes, std::vector<DWORD>& ioErr);
+// Bytes of roots[root] that lie before (entry, offset) in copy order.
+ULONGLONG ManifestBytesBefore(const OpManifest& m, size_t root,
+                              size_t entry, ULONGLONG offset);
+
+// ===== On-disk space estimate ================================================
+// FATX allocates whole clusters: a file takes its size rounded up, a folder
+// at least one cluster for its 64-byte entries (plus the end marker).
+// clusterBytes 0 counts raw bytes and no folder space.
+ULONGLONG ClusterRoundUp(ULONGLONG bytes, DWORD clusterBytes);
+ULONGLONG FolderOnDiskBytes(DWORD entries, DWORD clusterBytes);
+// What rootCount roots from firstRoot occupy once written out.
+ULONGLONG ManifestOnDiskBytes(const OpManifest& m, size_t firstRoot, size_t rootCount,
+                              DWORD clusterBytes);
+
+// ===== Sync planning (one-way mirror) =======================================
+// Hash-join of a source manifest against the manifest of the matching
+// destination trees (same roots, same relative paths; FATX names compare
+// case-insensitively). A file is copied when it is missing, its size
+// differs, or the source is newer - or, with byCrc, when size or CRC32
+// differ. Results are manifests the copy/delete engines run as-is:
+//  - outCopy:   per root, missing folders + files to (re)copy
+//  - outExtras: per root, destination entries with no source counterpart
+//               (or of the other type), for the optional mirror delete
+// The progress callback sees entry counts and may cancel (returns false).
+struct SyncStats {
+    unsigned   added, updated, unchanged, extras;
+    ULONGLONG  replacedBytes;    // dest bytes freed by files being replaced
+    SyncStats() : added(0), updated(0), unchanged(0), extras(0), replacedBytes(0) {}
+};
+bool BuildSyncPlanA(const OpManifest& src, const OpManifest& dst, bool byCrc,
+                    OpManifest& outCopy, OpManifest& outExtras, SyncStats& st);
+// Delete roots[root] children-first; progress callback counts entries.
+// Same safety rails as DeleteRecursiveA; continues past failures.
+bool DeleteManifestRootA(const OpManifest& m, size_t root,
+                         ULONGLONG& inoutDone, ULONGLONG total);
+
 // ===== extension functions ==================================================
 const char* GetExtension(const char* name);
 bool HasXbeExt(const char* name);
@@ -115,6 +224,11 @@ void  DvdMap_Io();                   // D: -> \Device\Cdrom0
 void  DvdUnmap_Io();                 // delete \??\D:
 void  DvdInvalidateSizeCache(); 
 
+// Bytes used on the disc with this serial: remembered in memory and in
+// T:\DvdSizes.dat, so a known disc is sized without walking it.
+bool  DvdGetUsedBytes(DWORD serial, ULONGLONG& used);
+void  DvdSetUsedBytes(DWORD serial, ULONGLONG used);
+
 // Detect media type in the tray (also forces a light probe of D:\)
 // Returns: 1=game, 2=video, 3=data, 0=unknown. Writes label like "DVD: Xbox Game".
 int   DvdDetectMediaSimple(char* outLabel, size_t cap);
@@ -0,0 +1,264 @@
+#include "JobQueue.h"
+#include "DirCache.h"
+#include "DebugPrint.h"
+
+#include <deque>
+#include <stdio.h>   // _vsnprintf
+#include <stdarg.h>
+#include <string.h>
+
+/*
+============================================================================
+ JobQueue (implementation)
+  - Worker: waits on a counting semaphore, pops one job at a time, runs it,
+    then posts JEV_END carrying the Job* back to the UI. While it runs the
+    listing cache is bypassed on the volumes the job may write.
+  - Event ring: fixed kEvtCap slots. The worker is the only writer of
+    s_evtTail, the UI the only writer of s_evtHead; each side publishes its
+    index with InterlockedExchange (full barrier on x86) after touching the
+    slot, so no lock is needed.
+  - Progress events are throttled to ~30 Hz and dropped when the ring is
+    full (the UI only needs the latest). Begin/status/end events wait for
+    room instead of being dropped.
+  - Statistics are kept on the worker from every progress call: rates are
+    exponential moving averages over ~0.5 s windows; a file is "finished"
+    when the progress label moves on to the next path.
+============================================================================
+*/
+
+namespace {
+    const int   kEvtCap          = 64;    // power of two
+    const DWORD kProgressEveryMs = 33;    // ~30 Hz is plenty for the HUD
+    const DWORD kWorkerStack     = 64 * 1024;
+
+    JobEvent         s_evt[kEvtCap];
+    volatile LONG    s_evtHead = 0;       // next slot the UI reads
+    volatile LONG    s_evtTail = 0;       // next slot the worker writes
+
+    CRITICAL_SECTION s_lock;              // guards s_pending
+    std::deque<Job*> s_pending;
+    HANDLE           s_wake    = NULL;    // counts submitted jobs
+    HANDLE           s_thread  = NULL;
+    volatile LONG    s_running = 0;       // 1 while a job executes
+    volatile LONG    s_cancel  = 0;       // cooperative cancel flag
+
+    DWORD            s_lastProgMs = 0;    // worker-side throttle
+
+    // Worker-side statistics
+    const DWORD      kStatWindowMs = 500;
+    JobStats         s_stats;
+    DWORD            s_statStartMs  = 0;
+    DWORD            s_fileStartMs  = 0;
+    char             s_statLabel[256];
+    DWORD            s_winMs        = 0;
+    ULONGLONG        s_winDone      = 0;
+    DWORD            s_winFiles     = 0;
+    ULONGLONG        s_baseDone     = 0;
+    bool             s_statPrimed   = false;  // first progress call seen
+
+    void StatsReset(bool isBytes){
+        ZeroMemory(&s_stats, sizeof(s_stats));
+        s_stats.isBytes = isBytes;
+        s_stats.etaSec  = kJobEtaUnknown;
+        s_statStartMs = s_fileStartMs = s_winMs = GetTickCount();
+        s_statLabel[0] = 0;
+        s_winDone  = 0;
+        s_winFiles = 0;
+        s_baseDone = 0;
+        s_statPrimed = false;
+    }
+
+    void StatsFileDone(DWORD now){
+        const DWORD ms = now - s_fileStartMs;
+        int b = 0;
+        while (b < kJobLatBuckets-1 && ms >= (1u << b)) ++b;
+        ++s_stats.latHist[b];
+        ++s_stats.files;
+        s_fileStartMs = now;
+    }
+
+    // Moving average with a fresh sample weighted 1/4.
+    DWORD Ewma(DWORD avg, DWORD sample){
+        return avg ? (DWORD)(((ULONGLONG)avg * 3 + sample) / 4) : sample;
+    }
+
+    void StatsUpdate(ULONGLONG done, ULONGLONG total, const char* label, DWORD now){
+        // A resumed job starts far from zero; rates only count this run.
+        if (!s_statPrimed){ s_statPrimed = true; s_baseDone = s_winDone = done; }
+
+        if (label && strcmp(label, s_statLabel) != 0){
+            if (s_statLabel[0]) StatsFileDone(now);
+            else                s_fileStartMs = now;
+            _snprintf(s_statLabel, sizeof(s_statLabel), "%s", label); s_statLabel[sizeof(s_statLabel)-1] = 0;
+        }
+
+        s_stats.done      = done;
+        s_stats.moved     = done - s_baseDone;
+        s_stats.elapsedMs = now - s_statStartMs;
+
+        const DWORD dt = now - s_winMs;
+        if (dt >= kStatWindowMs){
+            const ULONGLONG dDone = (done > s_winDone) ? done - s_winDone : 0;
+            s_stats.perSec      = Ewma(s_stats.perSec,      (DWORD)(dDone * 1000 / dt));
+            s_stats.filesPerSec = Ewma(s_stats.filesPerSec, (s_stats.files - s_winFiles) * 1000 / dt);
+            s_winMs    = now;
+            s_winDone  = done;
+            s_winFiles = s_stats.files;
+
+            s_stats.etaSec = (s_stats.perSec && total > done)
+                           ? (DWORD)((total - done) / s_stats.perSec) : kJobEtaUnknown;
+            if (total && done >= total) s_stats.etaSec = 0;
+        }
+    }
+
+    // Worker side: append one event; false if the ring is full.
+    bool TryPush(const JobEvent& e){
+        const LONG tail = s_evtTail;
+        const LONG next = (tail + 1) & (kEvtCap - 1);
+        if (next == s_evtHead) return false;
+        s_evt[tail] = e;
+        InterlockedExchange(&s_evtTail, next);  // publish after the copy
+        return true;
+    }
+
+    // Worker side: events the UI must see are retried until there is room.
+    void PushWait(const JobEvent& e){
+        while (!TryPush(e)) Sleep(1);
+    }
+
+    void InitEvent(JobEvent& e, JobEventType type){
+        ZeroMemory(&e, sizeof(e));
+        e.type = type;
+    }
+
+    DWORD WINAPI WorkerMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, INFINITE);
+
+            Job* job = NULL;
+            EnterCriticalSection(&s_lock);
+            if (!s_pending.empty()){
+                job = s_pending.front();
+                s_pending.pop_front();
+                InterlockedExchange(&s_cancel, 0);   // fresh job, fresh flag
+                InterlockedExchange(&s_running, 1);
+            }
+            LeaveCriticalSection(&s_lock);
+            if (!job) continue;                      // flushed by RequestCancel
+
+            s_lastProgMs = 0;
+            StatsReset(true);
+            DirCache::BeginWrite(job->volMask);      // EndWrite in FinishJob
+            if (job->run) job->run(*job);
+            if (s_cancel) job->canceled = true;
+
+            // Latency profile for spotting slow drives / small-file storms
+            if (s_statLabel[0]) StatsFileDone(GetTickCount());
+            if (s_stats.files){
+                char line[160]; int n = _snprintf(line, sizeof(line), "Job '%s': %lu files, latency ms hist:",
+                                                  job->title, (unsigned long)s_stats.files);
+                for (int b=0; b<kJobLatBuckets && n > 0 && n < (int)sizeof(line); ++b)
+                    n += _snprintf(line + n, sizeof(line) - n, " %lu", (unsigned long)s_stats.latHist[b]);
+                line[sizeof(line)-1] = 0;
+                XBUtil_DebugPrint("%s", line);
+            }
+
+            JobEvent e; InitEvent(e, JEV_END);
+            e.job = job;
+            InterlockedExchange(&s_running, 0);
+            PushWait(e);
+        }
+        return 0;
+    }
+}
+
+namespace JobQueue {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    s_wake = CreateSemaphore(NULL, 0, 0x7FFFFFFF, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kWorkerStack, WorkerMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    // Rendering/input win ties; the worker is I/O bound anyway.
+    SetThreadPriority(s_thread, THREAD_PRIORITY_BELOW_NORMAL);
+    return true;
+}
+
+void Submit(Job* job){
+    if (!job) return;
+    EnterCriticalSection(&s_lock);
+    s_pending.push_back(job);
+    LeaveCriticalSection(&s_lock);
+    ReleaseSemaphore(s_wake, 1, NULL);
+}
+
+bool Busy(){
+    if (s_running) return true;
+    EnterCriticalSection(&s_lock);
+    const bool any = !s_pending.empty();
+    LeaveCriticalSection(&s_lock);
+    return any;
+}
+
+void RequestCancel(){
+    EnterCriticalSection(&s_lock);
+    for (size_t i=0; i<s_pending.size(); ++i) delete s_pending[i];
+    s_pending.clear();
+    InterlockedExchange(&s_cancel, 1);
+    LeaveCriticalSection(&s_lock);
+}
+
+bool PollEvent(JobEvent& out){
+    const LONG head = s_evtHead;
+    if (head == s_evtTail) return false;
+    out = s_evt[head];
+    InterlockedExchange(&s_evtHead, (head + 1) & (kEvtCap - 1));  // release slot
+    return true;
+}
+
+bool CancelRequested(){
+    return s_cancel != 0;
+}
+
+void PostBegin(ULONGLONG total, const char* label, const char* title, bool isBytes){
+    JobEvent e; InitEvent(e, JEV_BEGIN);
+    e.total = total;
+    _snprintf(e.text,  sizeof(e.text),  "%s", label ? label : ""); e.text[sizeof(e.text)-1] = 0;
+    _snprintf(e.title, sizeof(e.title), "%s", title ? title : ""); e.title[sizeof(e.title)-1] = 0;
+    s_lastProgMs = GetTickCount();
+    StatsReset(isBytes);
+    PushWait(e);
+}
+
+void PostProgress(ULONGLONG done, ULONGLONG total, const char* label){
+    const DWORD now = GetTickCount();
+    StatsUpdate(done, total, label, now);
+    if (done < total && now - s_lastProgMs < kProgressEveryMs) return;
+
+    JobEvent e; InitEvent(e, JEV_PROGRESS);
+    e.done  = done;
+    e.total = total;
+    e.stats = s_stats;
+    _snprintf(e.text, sizeof(e.text), "%s", label ? label : ""); e.text[sizeof(e.text)-1] = 0;
+    if (TryPush(e)) s_lastProgMs = now;   // full ring: drop, UI keeps the last one
+}
+
+const JobStats& Stats(){
+    return s_stats;
+}
+
+void PostStatus(const char* fmt, ...){
+    JobEvent e; InitEvent(e, JEV_STATUS);
+    va_list ap; va_start(ap, fmt);
+    _vsnprintf(e.text, sizeof(e.text), fmt, ap);
+    va_end(ap);
+    e.text[sizeof(e.text)-1] = 0;
+    PushWait(e);
+}
+
+} // namespace JobQueue
@@ -0,0 +1,109 @@
+#ifndef JOBQUEUE_H
+#define JOBQUEUE_H
+/*
+============================================================================
+ JobQueue
+  - One background worker thread that runs long file operations
+    (copy / move / delete / unzip) so the browser keeps running.
+  - Pending jobs sit in a small FIFO (critical section; only touched on
+    submit / dequeue / cancel).
+  - Worker -> UI traffic goes through a lock-free single-producer /
+    single-consumer event ring: the worker posts, FrameMove drains.
+  - Cancel is cooperative: jobs poll CancelRequested() from their progress
+    callback and unwind on their own.
+  - VS2003/XDK friendly: plain C++98, Win32 threading primitives only.
+============================================================================
+*/
+
+#include <xtl.h>
+#include <vector>
+#include <string>
+
+// ----- Job description (built on the UI thread, run on the worker) ----------
+struct Job;
+typedef void (*JobRunFn)(Job& job);
+
+struct Job {
+    JobRunFn  run;                  // worker entry (AppActions job runners)
+    int       act;                  // Action that created it (informational)
+    std::vector<std::string> srcs;  // full source paths
+    char      srcDir[512];          // folder the sources were picked from
+    char      dstDir[512];          // destination folder (trailing slash)
+    std::vector<std::string> dsts;  // fan-out copy: every destination folder
+    char      title[24];            // overlay title ("Copying...", ...)
+    bool      verify;               // copy: CRC32-verify written files
+    DWORD     volMask;              // volumes it may write (DirCache::VolumeBit)
+
+    // Results, written by the worker before the JEV_END event
+    bool      canceled;
+    char      summary[256];         // final toast text
+
+    Job() : run(0), act(0), verify(false), volMask(0), canceled(false) {
+        srcDir[0] = 0; dstDir[0] = 0; title[0] = 0; summary[0] = 0;
+    }
+};
+
+// ----- Live job statistics (worker side, copied into progress events) -------
+// Per-file latency histogram: bucket i counts files that took < 2^i ms,
+// the last bucket everything from 2^(kJobLatBuckets-2) ms up.
+const int kJobLatBuckets = 12;
+
+struct JobStats {
+    bool      isBytes;                  // units are bytes (else items)
+    DWORD     elapsedMs;                // since PostBegin
+    ULONGLONG done;                     // units done (mirrors the progress event)
+    ULONGLONG moved;                    // units done in this phase (excludes a resumed prefix)
+    DWORD     perSec;                   // moving average, units/s
+    DWORD     files;                    // files finished
+    DWORD     filesPerSec;              // moving average
+    DWORD     etaSec;                   // kJobEtaUnknown until a rate exists
+    DWORD     latHist[kJobLatBuckets];
+};
+const DWORD kJobEtaUnknown = 0xFFFFFFFFu;
+
+// ----- Worker -> UI events ---------------------------------------------------
+enum JobEventType {
+    JEV_BEGIN,      // job started: total, text = first label, title
+    JEV_PROGRESS,   // done/total/text = current path (coalesced, may be dropped)
+    JEV_STATUS,     // text = toast line
+    JEV_END         // job finished; ownership of 'job' passes to the UI
+};
+
+struct JobEvent {
+    JobEventType type;
+    ULONGLONG    done;
+    ULONGLONG    total;
+    char         text[256];
+    char         title[24];     // JEV_BEGIN only
+    JobStats     stats;         // JEV_PROGRESS only
+    Job*         job;           // JEV_END only
+};
+
+namespace JobQueue {
+    // Spin up the worker (idempotent). Call once from Initialize().
+    bool Start();
+
+    // ---- UI thread ----------------------------------------------------------
+    // Queue a heap-allocated job; the worker owns it until JEV_END.
+    void Submit(Job* job);
+    // True while a job runs or is waiting in the queue.
+    bool Busy();
+    // Cancel the running job and drop anything still queued.
+    void RequestCancel();
+    // Pop the next event; returns false when the ring is empty.
+    bool PollEvent(JobEvent& out);
+
+    // ---- Worker thread (called from inside Job::run) ------------------------
+    bool CancelRequested();
+    // Starts a progress phase and resets the statistics. isBytes=false for
+    // item-counted phases (delete, compare) so the HUD labels rates right.
+    void PostBegin(ULONGLONG total, const char* label, const char* title, bool isBytes = true);
+    // Every call feeds the statistics (a label change = previous file done);
+    // only the events sent to the UI are throttled.
+    void PostProgress(ULONGLONG done, ULONGLONG total, const char* label);
+    void PostStatus(const char* fmt, ...);
+    // Statistics of the current phase, e.g. for the final summary.
+    const JobStats& Stats();
+}
+
+#endif // JOBQUEUE_H
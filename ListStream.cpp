@@ -0,0 +1,193 @@
+#include "ListStream.h"
+#include "FsUtil.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+
+/*
+============================================================================
+ ListStream (implementation)
+  - Slot state is guarded by one critical section; the worker takes it
+    only to pick up a request and to publish a batch.
+  - Each request bumps the slot generation; the worker checks it per entry
+    and abandons a superseded enumeration, and never publishes into a
+    newer request.
+  - Batches are sorted on the worker; if the UI has not taken the previous
+    one yet they are merged, so Take() always hands out one sorted run.
+  - Pane slots are served first. The prefetch slot checks them per entry
+    and drops its work when one is wanted; the auto-reset event is still
+    set from that Request, so the pane listing starts right after.
+============================================================================
+*/
+
+namespace {
+    const int    kSlots       = 3;      // two panes + prefetch
+    const size_t kFirstBatch  = 48;     // about a screenful
+    const size_t kBatch       = 1024;
+    const DWORD  kBatchMs     = 40;     // publish at least this often
+    const DWORD  kStreamStack = 64 * 1024;
+    const size_t kPrefetchMax   = 4096; // entries; bigger folders are not worth it
+    const DWORD  kPrefetchMaxMs = 1500;
+
+    struct Slot {
+        char          path[512];
+        SortMode      mode;         // order of the published batches
+        volatile LONG gen;          // bumped by Request/Cancel
+        bool          want;         // request not picked up yet
+        ListStream::State state;
+        Listing       pending;      // sorted, not yet taken
+    };
+
+    Slot             s_slot[kSlots];
+    CRITICAL_SECTION s_lock;
+    HANDLE           s_wake   = NULL;
+    HANDLE           s_thread = NULL;
+
+    // Sort 'batch' and hand it to the slot if the request is still current.
+    void Publish(int i, LONG gen, SortMode mode, Listing& batch, bool last){
+        batch.SetSortMode(mode);
+        batch.Sort(0);
+        EnterCriticalSection(&s_lock);
+        Slot& s = s_slot[i];
+        if (s.gen == gen){
+            if (s.pending.Empty()) s.pending.Swap(batch);
+            else                   s.pending.Merge(batch, 0, NULL);
+            if (last) s.state = ListStream::LS_DONE;
+        }
+        LeaveCriticalSection(&s_lock);
+        batch.Clear();
+    }
+
+    // Prefetch gave up: the slot goes idle with nothing to take.
+    void Abandon(int i, LONG gen){
+        EnterCriticalSection(&s_lock);
+        Slot& s = s_slot[i];
+        if (s.gen == gen) { s.state = ListStream::LS_IDLE; s.pending.Clear(); }
+        LeaveCriticalSection(&s_lock);
+    }
+
+    bool PaneWaiting(){
+        for (int i = 0; i < kSlots; ++i)
+            if (i != ListStream::kPrefetchSlot && s_slot[i].want) return true;
+        return false;
+    }
+
+    void RunSlot(int i){
+        char path[512];
+        LONG gen;
+        SortMode mode;
+        EnterCriticalSection(&s_lock);
+        Slot& s = s_slot[i];
+        const bool want = s.want;
+        s.want = false;
+        gen = s.gen;
+        mode = s.mode;
+        memcpy(path, s.path, sizeof(path));
+        LeaveCriticalSection(&s_lock);
+        if (!want) return;
+
+        char mask[512]; JoinPath(mask, sizeof(mask), path, "*");
+        const bool atRoot = (strlen(path) <= 3);
+
+        const bool  prefetch = (i == ListStream::kPrefetchSlot);
+        const DWORD t0       = GetTickCount();
+        bool        gaveUp   = false;
+
+        Listing batch;
+        batch.Reserve(kBatch, kBatch * 24);
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA(mask, &fd);
+        if (h != INVALID_HANDLE_VALUE){
+            size_t limit = kFirstBatch;
+            DWORD  last  = GetTickCount();
+            do{
+                if (s.gen != gen) break;   // superseded
+                if (!IsListedName(fd.cFileName, atRoot)) continue;
+                batch.Add(fd);
+
+                if (prefetch){
+                    // One result at the end; never hold up a pane
+                    gaveUp = PaneWaiting() || batch.Count() > kPrefetchMax ||
+                             GetTickCount() - t0 > kPrefetchMaxMs;
+                    if (gaveUp) break;
+                } else if (batch.Count() >= limit || GetTickCount() - last >= kBatchMs){
+                    Publish(i, gen, mode, batch, false);
+                    limit = kBatch;
+                    last  = GetTickCount();
+                }
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+        if (gaveUp) { Abandon(i, gen); return; }
+        Publish(i, gen, mode, batch, true);   // empty or unreadable folders end here too
+    }
+
+    DWORD WINAPI StreamMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, INFINITE);
+            for (int i = 0; i < kSlots; ++i) RunSlot(i);
+        }
+        return 0;
+    }
+}
+
+namespace ListStream {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    for (int i = 0; i < kSlots; ++i){
+        s_slot[i].path[0] = 0;
+        s_slot[i].mode    = SORT_NAME;
+        s_slot[i].gen     = 0;
+        s_slot[i].want    = false;
+        s_slot[i].state   = LS_IDLE;
+    }
+    s_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kStreamStack, StreamMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+    return true;
+}
+
+bool Request(int slot, const char* path, SortMode mode){
+    if (slot < 0 || slot >= kSlots || !s_thread) return false;
+    EnterCriticalSection(&s_lock);
+    Slot& s = s_slot[slot];
+    _snprintf(s.path, sizeof(s.path), "%s", path); s.path[sizeof(s.path)-1] = 0;
+    s.mode  = mode;
+    InterlockedIncrement(&s.gen);
+    s.want  = true;
+    s.state = LS_RUNNING;
+    s.pending.Clear();
+    LeaveCriticalSection(&s_lock);
+    SetEvent(s_wake);
+    return true;
+}
+
+void Cancel(int slot){
+    if (slot < 0 || slot >= kSlots || !s_thread) return;
+    EnterCriticalSection(&s_lock);
+    Slot& s = s_slot[slot];
+    InterlockedIncrement(&s.gen);
+    s.want  = false;
+    s.state = LS_IDLE;
+    s.pending.Clear();
+    LeaveCriticalSection(&s_lock);
+}
+
+State Take(int slot, Listing& out){
+    out.Clear();
+    if (slot < 0 || slot >= kSlots || !s_thread) return LS_IDLE;
+    EnterCriticalSection(&s_lock);
+    Slot& s = s_slot[slot];
+    out.Swap(s.pending);
+    const State st = s.state;
+    if (st == LS_DONE) s.state = LS_IDLE;
+    LeaveCriticalSection(&s_lock);
+    return st;
+}
+
+} // namespace ListStream
@@ -0,0 +1,44 @@
+#ifndef LISTSTREAM_H
+#define LISTSTREAM_H
+/*
+============================================================================
+ ListStream
+  - Asynchronous, incremental directory listing for the panes.
+  - A dedicated thread (not the JobQueue worker, which may be busy with a
+    long copy) enumerates the folder and publishes sorted batches: a small
+    first batch so the first screenful appears at once, then larger ones.
+  - The UI drains batches each frame with Take() and merges them into the
+    pane (Listing::Merge), keeping ".." and the selection in place.
+  - One slot per pane; a new Request() or Cancel() supersedes whatever the
+    slot was doing.
+  - kPrefetchSlot lists speculatively (a folder the user will probably
+    open next). It publishes only the complete listing, steps aside as
+    soon as a pane slot has a request, and gives up on folders past a
+    size / time budget (the slot just goes idle without a result).
+============================================================================
+*/
+
+#include <xtl.h>
+#include "Listing.h"
+
+namespace ListStream {
+    enum { kPrefetchSlot = 2 };
+
+    enum State {
+        LS_IDLE,       // nothing requested / result already delivered
+        LS_RUNNING,    // enumeration in progress (more batches coming)
+        LS_DONE        // last batch delivered by this Take()
+    };
+
+    bool  Start();
+    // Begin listing 'path' into 'slot' (0/1, kPrefetchSlot), batches sorted by 'mode'.
+    // False if the thread is not running (caller lists synchronously instead).
+    bool  Request(int slot, const char* path, SortMode mode);
+    // Drop the slot's listing in flight (results are discarded).
+    void  Cancel(int slot);
+    // Move the entries published since the last call into 'out' (replaces
+    // its contents; sorted, no ".." row).
+    State Take(int slot, Listing& out);
+}
+
+#endif // LISTSTREAM_H
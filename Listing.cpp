@@ -0,0 +1,464 @@
+#include "Listing.h"
+
+#include <algorithm>
+#include <string.h>
+
+/*
+============================================================================
+ Listing (implementation)
+  - The arena only grows while building; Clear() keeps its capacity so a
+    refresh of the same folder reuses the allocation.
+  - Sort builds one SortEnt (64-bit key + position) per entry: group
+    (dirs 0, files 1) in the high half, a mode-specific 32-bit prefix in
+    the low half (name key, extension key, inverted size or time). Most
+    comparisons end on the key; only ties look at the records. The
+    records are then gathered once in sorted order.
+  - Keys and the full comparison fold only ASCII A-Z, like _stricmp in
+    the C locale, so both agree on the order.
+  - Filter index: one WordRef per word start, sorted by the folded text
+    from there to the end of the name. All words starting with a prefix
+    are then one contiguous range, found with two binary searches.
+  - Internally everything works on record positions; only the public
+    accessors go through the view.
+============================================================================
+*/
+
+const size_t Listing::npos = (size_t)-1;
+
+namespace {
+    // Spare ListRec::flags bits that carry marks / the tracked row through
+    // a merge (never set outside Merge).
+    const BYTE kTmpMark  = 0x40;
+    const BYTE kTmpTrack = 0x80;
+
+    inline int  Lower(int c)   { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+    inline bool IsDigit(int c) { return c >= '0' && c <= '9'; }
+
+    // First four bytes of s[0..n), lower-cased, big-endian, zero-padded.
+    // 'natural': stop after the first digit, which stands for any digit.
+    DWORD PackKey(const char* s, size_t n, bool natural){
+        DWORD k = 0;
+        bool  stop = false;
+        for (size_t i = 0; i < 4; ++i){
+            int c = (!stop && i < n) ? Lower((unsigned char)s[i]) : 0;
+            if (natural && IsDigit(c)) { c = '0'; stop = true; }
+            k = (k << 8) | (DWORD)c;
+        }
+        return k;
+    }
+
+    // Names are equal up to the key; skip those bytes when both have them.
+    int NameCmp(const char* names, const ListRec& a, const ListRec& b){
+        if (a.key != b.key) return a.key < b.key ? -1 : 1;
+        if (a.nameLen >= 4 && b.nameLen >= 4)
+            return _stricmp(names + a.nameOff + 4, names + b.nameOff + 4);
+        return _stricmp(names + a.nameOff, names + b.nameOff);
+    }
+
+    // Case-insensitive, digit runs compared by value (leading zeros ignored).
+    int NaturalCmp(const char* a, const char* b){
+        for (;;){
+            if (IsDigit((unsigned char)*a) && IsDigit((unsigned char)*b)){
+                while (*a == '0') ++a;
+                while (*b == '0') ++b;
+                const char* ea = a; while (IsDigit((unsigned char)*ea)) ++ea;
+                const char* eb = b; while (IsDigit((unsigned char)*eb)) ++eb;
+                if (ea - a != eb - b) return (ea - a < eb - b) ? -1 : 1;
+                for (; a < ea; ++a, ++b) if (*a != *b) return (*a < *b) ? -1 : 1;
+                continue;
+            }
+            const int la = Lower((unsigned char)*a), lb = Lower((unsigned char)*b);
+            if (la != lb) return la < lb ? -1 : 1;
+            if (!la) return 0;
+            ++a; ++b;
+        }
+    }
+
+    // Full three-way comparison: directories first, then by mode.
+    int RecCmp(SortMode mode, const char* names, const ListRec& a, const ListRec& b){
+        const bool ad = (a.flags & LF_DIR) != 0, bd = (b.flags & LF_DIR) != 0;
+        if (ad != bd) return ad ? -1 : 1;
+        int c = 0;
+        switch (mode){
+        case SORT_NATURAL:
+            c = NaturalCmp(names + a.nameOff, names + b.nameOff);
+            break;
+        case SORT_EXT:
+            if (!ad) c = _stricmp(names + a.nameOff + a.extOff, names + b.nameOff + b.extOff);
+            break;
+        case SORT_SIZE:
+            if (!ad && a.size != b.size) c = (a.size > b.size) ? -1 : 1;
+            break;
+        case SORT_TIME:
+            if (a.mtime != b.mtime) c = (a.mtime > b.mtime) ? -1 : 1;
+            break;
+        default:
+            break;
+        }
+        return c ? c : NameCmp(names, a, b);
+    }
+
+    struct RecLess {
+        const char* names;
+        SortMode    mode;
+        RecLess(const char* n, SortMode m) : names(n), mode(m) {}
+        bool operator()(const ListRec& a, const ListRec& b) const {
+            return RecCmp(mode, names, a, b) < 0;
+        }
+    };
+
+    struct SortEnt {
+        ULONGLONG key;
+        DWORD     idx;
+    };
+
+    ULONGLONG SortKey(SortMode mode, const char* names, const ListRec& r){
+        const bool isDir = (r.flags & LF_DIR) != 0;
+        DWORD lo = r.key;
+        switch (mode){
+        case SORT_NATURAL:
+            lo = PackKey(names + r.nameOff, r.nameLen, true);
+            break;
+        case SORT_EXT:
+            if (!isDir) lo = PackKey(names + r.nameOff + r.extOff, r.nameLen - r.extOff, false);
+            break;
+        case SORT_SIZE:
+            if (!isDir) lo = ~(r.size > 0xFFFFFFFFu ? 0xFFFFFFFFu : (DWORD)r.size);
+            break;
+        case SORT_TIME:
+            lo = ~(DWORD)(r.mtime >> 32);
+            break;
+        default:
+            break;
+        }
+        return ((ULONGLONG)(isDir ? 0 : 1) << 32) | lo;
+    }
+
+    struct SortEntLess {
+        const ListRec* rec;
+        const char*    names;
+        SortMode       mode;
+        SortEntLess(const ListRec* r, const char* n, SortMode m) : rec(r), names(n), mode(m) {}
+        bool operator()(const SortEnt& a, const SortEnt& b) const {
+            if (a.key != b.key) return a.key < b.key;
+            const int c = RecCmp(mode, names, rec[a.idx], rec[b.idx]);
+            return c ? c < 0 : a.idx < b.idx;
+        }
+    };
+
+    inline bool IsWordSep(char c){
+        return c == ' ' || c == '_' || c == '-' || c == '.' || c == '(' || c == '[';
+    }
+
+    inline bool GetMark(const std::vector<DWORD>& m, size_t p){ return ((m[p >> 5] >> (p & 31)) & 1) != 0; }
+    inline void PutMark(std::vector<DWORD>& m, size_t p, bool on){
+        const DWORD bit = 1u << (p & 31);
+        if (on) m[p >> 5] |= bit; else m[p >> 5] &= ~bit;
+    }
+}
+
+bool IsWordStart(const char* name, size_t j){
+    return j == 0 || (IsWordSep(name[j-1]) && !IsWordSep(name[j]));
+}
+
+int FoldPrefixCmp(const char* s, const char* pre, size_t n){
+    for (size_t j = 0; j < n; ++j){
+        const int a = Lower((unsigned char)s[j]), b = Lower((unsigned char)pre[j]);
+        if (a != b) return a < b ? -1 : 1;   // also covers s ending first
+    }
+    return 0;
+}
+
+const char* SortModeName(SortMode m){
+    switch (m){
+    case SORT_NATURAL: return "Natural";
+    case SORT_EXT:     return "Type";
+    case SORT_SIZE:    return "Size";
+    case SORT_TIME:    return "Date";
+    default:           return "Name";
+    }
+}
+
+size_t Listing::Find(const char* name) const {
+    if (!name) return npos;
+    for (size_t i = 0; i < Count(); ++i)
+        if (_stricmp(Name(i), name) == 0) return i;
+    return npos;
+}
+
+void Listing::SetMarked(size_t i, bool on){
+    PutMark(m_marks, Pos(i), on);
+}
+
+size_t Listing::MarkedCount() const {
+    size_t n = 0;
+    if (m_filtered){
+        for (size_t i = 0; i < m_view.size(); ++i) if (GetMark(m_marks, m_view[i])) ++n;
+        return n;
+    }
+    for (size_t w = 0; w < m_marks.size(); ++w)
+        for (DWORD v = m_marks[w]; v; v &= v - 1) ++n;
+    return n;
+}
+
+bool Listing::AnyMarked() const {
+    if (m_filtered) return MarkedCount() != 0;
+    for (size_t w = 0; w < m_marks.size(); ++w) if (m_marks[w]) return true;
+    return false;
+}
+
+void Listing::ClearMarks(){
+    if (m_filtered){
+        for (size_t i = 0; i < m_view.size(); ++i) PutMark(m_marks, m_view[i], false);
+        return;
+    }
+    if (!m_marks.empty()) memset(&m_marks[0], 0, m_marks.size() * sizeof(DWORD));
+}
+
+void Listing::Clear(){
+    m_rec.clear();
+    m_names.clear();
+    m_marks.clear();
+    m_filtered  = false;
+    m_filter[0] = 0;
+    m_view.clear();
+    Touch();
+}
+
+void Listing::Reserve(size_t entries, size_t nameBytes){
+    m_rec.reserve(entries);
+    m_names.reserve(nameBytes);
+    m_marks.reserve((entries + 31) >> 5);
+}
+
+void Listing::Add(const char* name, bool isDir, ULONGLONG size, DWORD attr, bool isUp){
+    size_t len = strlen(name);
+    if (len > 255) len = 255;
+
+    size_t ext = len;
+    for (size_t i = len; i-- > 1; ) if (name[i] == '.') { ext = i + 1; break; }
+
+    ListRec r;
+    r.size    = size;
+    r.mtime   = 0;
+    r.nameOff = (DWORD)m_names.size();
+    r.attr    = attr;
+    r.key     = PackKey(name, len, false);
+    r.nameLen = (WORD)len;
+    r.flags   = (BYTE)((isDir ? LF_DIR : 0) | (isUp ? LF_UP : 0));
+    r.extOff  = (BYTE)ext;
+
+    m_names.insert(m_names.end(), name, name + len);
+    m_names.push_back(0);
+    m_rec.push_back(r);
+    if (((m_rec.size() + 31) >> 5) > m_marks.size()) m_marks.push_back(0);
+    Touch();
+}
+
+void Listing::Add(const WIN32_FIND_DATAA& fd){
+    Add(fd.cFileName, (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0,
+        (((ULONGLONG)fd.nFileSizeHigh) << 32) | fd.nFileSizeLow, fd.dwFileAttributes);
+    m_rec.back().mtime = (((ULONGLONG)fd.ftLastWriteTime.dwHighDateTime) << 32) |
+                         fd.ftLastWriteTime.dwLowDateTime;
+}
+
+void Listing::Sort(size_t first){
+    if (m_filtered) first = (first && !m_rec.empty() && (m_rec[0].flags & LF_UP)) ? 1 : 0;
+    if (m_rec.size() <= first + 1 || m_names.empty()) return;
+
+    const size_t   n     = m_rec.size() - first;
+    const ListRec* rec   = &m_rec[first];
+    const char*    names = &m_names[0];
+
+    std::vector<SortEnt> ent(n);
+    for (size_t i = 0; i < n; ++i){
+        ent[i].key = SortKey(m_mode, names, rec[i]);
+        ent[i].idx = (DWORD)i;
+    }
+    std::sort(ent.begin(), ent.end(), SortEntLess(rec, names, m_mode));
+
+    std::vector<ListRec> sorted;
+    sorted.reserve(n);
+    for (size_t i = 0; i < n; ++i) sorted.push_back(rec[ent[i].idx]);
+    std::copy(sorted.begin(), sorted.end(), m_rec.begin() + first);
+
+    bool anyMark = false;
+    for (size_t w = 0; w < m_marks.size() && !anyMark; ++w) anyMark = (m_marks[w] != 0);
+    if (anyMark){
+        std::vector<DWORD> old(m_marks);
+        for (size_t i = 0; i < n; ++i)
+            PutMark(m_marks, first + i, GetMark(old, first + ent[i].idx));
+    }
+
+    Touch();
+    if (m_filtered) Refilter();
+}
+
+void Listing::Merge(const Listing& b, size_t first, size_t* track){
+    if (b.m_rec.empty()) return;
+
+    const size_t mid = m_rec.size();
+    if (m_filtered){
+        // Caller's indices are view indices
+        first = (first && !m_rec.empty() && (m_rec[0].flags & LF_UP)) ? 1 : 0;
+        if (track) *track = (*track < m_view.size()) ? m_view[*track] : mid;
+    }
+    if (first > mid) first = mid;
+    for (size_t i = 0; i < mid; ++i) if (GetMark(m_marks, i)) m_rec[i].flags |= kTmpMark;
+    if (track && *track < mid) m_rec[*track].flags |= kTmpTrack;
+
+    // Append the batch (names rebased into our arena), then merge in place
+    const DWORD base = (DWORD)m_names.size();
+    m_names.insert(m_names.end(), b.m_names.begin(), b.m_names.end());
+    m_rec.reserve(mid + b.m_rec.size());
+    for (size_t i = 0; i < b.m_rec.size(); ++i){
+        ListRec r = b.m_rec[i];
+        r.nameOff += base;
+        r.flags   &= (BYTE)(LF_DIR | LF_UP);
+        m_rec.push_back(r);
+    }
+    std::inplace_merge(m_rec.begin() + first, m_rec.begin() + mid, m_rec.end(), RecLess(&m_names[0], m_mode));
+
+    m_marks.assign((m_rec.size() + 31) >> 5, 0);
+    for (size_t i = 0; i < m_rec.size(); ++i){
+        BYTE& f = m_rec[i].flags;
+        if (f & kTmpMark)  PutMark(m_marks, i, true);
+        if (f & kTmpTrack) *track = i;
+        f &= (BYTE)~(kTmpMark | kTmpTrack);
+    }
+
+    Touch();
+    if (m_filtered){
+        Refilter();
+        if (track){
+            const std::vector<DWORD>::const_iterator it =
+                std::lower_bound(m_view.begin(), m_view.end(), (DWORD)*track);
+            *track = (it != m_view.end() && *it == *track) ? (size_t)(it - m_view.begin()) : 0;
+        }
+    }
+}
+
+void Listing::Swap(Listing& o){
+    m_rec.swap(o.m_rec);
+    m_names.swap(o.m_names);
+    m_marks.swap(o.m_marks);
+    std::swap(m_mode, o.m_mode);
+    std::swap(m_filtered, o.m_filtered);
+    char tmp[sizeof(m_filter)];
+    memcpy(tmp, m_filter, sizeof(tmp));
+    memcpy(m_filter, o.m_filter, sizeof(tmp));
+    memcpy(o.m_filter, tmp, sizeof(tmp));
+    m_view.swap(o.m_view);
+    std::swap(m_indexed, o.m_indexed);
+    m_words.swap(o.m_words);
+}
+
+// ---- filter view ------------------------------------------------------------
+
+namespace {
+    struct WordLess {
+        const ListRec* rec;
+        const char*    names;
+        WordLess(const ListRec* r, const char* n) : rec(r), names(n) {}
+        template <class W>
+        bool operator()(const W& a, const W& b) const {
+            const char* x = names + rec[a.pos].nameOff + a.off;
+            const char* y = names + rec[b.pos].nameOff + b.off;
+            for (;; ++x, ++y){
+                const int cx = Lower((unsigned char)*x), cy = Lower((unsigned char)*y);
+                if (cx != cy) return cx < cy;
+                if (!cx) return a.pos < b.pos;
+            }
+        }
+    };
+}
+
+void Listing::BuildIndex() const {
+    if (m_indexed) return;
+    m_words.clear();
+    for (size_t p = 0; p < m_rec.size(); ++p){
+        const ListRec& r = m_rec[p];
+        if (r.flags & LF_UP) continue;
+        const char* n = &m_names[r.nameOff];
+        for (size_t j = 0; j < r.nameLen; ++j){
+            if (!IsWordStart(n, j)) continue;
+            WordRef w; w.pos = (DWORD)p; w.off = (DWORD)j;
+            m_words.push_back(w);
+        }
+    }
+    if (!m_words.empty())
+        std::sort(m_words.begin(), m_words.end(), WordLess(&m_rec[0], &m_names[0]));
+    m_indexed = true;
+}
+
+// [lo, hi) of m_words whose text starts with 'text'.
+void Listing::WordRange(const char* text, size_t& lo, size_t& hi) const {
+    BuildIndex();
+    const size_t n = strlen(text);
+    size_t a = 0, b = m_words.size();
+    while (a < b){
+        const size_t m = (a + b) / 2;
+        if (FoldPrefixCmp(&m_names[m_rec[m_words[m].pos].nameOff + m_words[m].off], text, n) < 0) a = m + 1;
+        else b = m;
+    }
+    lo = a;
+    b  = m_words.size();
+    while (a < b){
+        const size_t m = (a + b) / 2;
+        if (FoldPrefixCmp(&m_names[m_rec[m_words[m].pos].nameOff + m_words[m].off], text, n) <= 0) a = m + 1;
+        else b = m;
+    }
+    hi = a;
+}
+
+void Listing::Refilter(){
+    size_t lo, hi;
+    WordRange(m_filter, lo, hi);
+
+    m_view.clear();
+    m_view.reserve(hi - lo + 1);
+    for (size_t k = lo; k < hi; ++k) m_view.push_back(m_words[k].pos);
+    std::sort(m_view.begin(), m_view.end());
+    m_view.erase(std::unique(m_view.begin(), m_view.end()), m_view.end());
+    if (!m_rec.empty() && (m_rec[0].flags & LF_UP)) m_view.insert(m_view.begin(), 0);
+}
+
+void Listing::SetFilter(const char* text){
+    if (!text || !text[0]){
+        m_filtered  = false;
+        m_filter[0] = 0;
+        m_view.clear();
+        return;
+    }
+    strncpy(m_filter, text, sizeof(m_filter) - 1);
+    m_filter[sizeof(m_filter) - 1] = 0;
+    m_filtered = true;
+    Refilter();
+}
+
+size_t Listing::FindPrefix(const char* text) const {
+    if (!text || !text[0]) return npos;
+    size_t lo, hi;
+    WordRange(text, lo, hi);
+
+    // Name starts only, earliest in listing order that is visible
+    size_t best = npos, bestView = npos;
+    for (size_t k = lo; k < hi; ++k){
+        const WordRef& w = m_words[k];
+        if (w.off != 0 || w.pos >= best) continue;
+        size_t v = w.pos;
+        if (m_filtered){
+            const std::vector<DWORD>::const_iterator it =
+                std::lower_bound(m_view.begin(), m_view.end(), w.pos);
+            if (it == m_view.end() || *it != w.pos) continue;
+            v = (size_t)(it - m_view.begin());
+        }
+        best = w.pos; bestView = v;
+    }
+    return bestView;
+}
+
+size_t Listing::Bytes() const {
+    return m_rec.capacity() * sizeof(ListRec) + m_names.capacity() + m_marks.capacity() * sizeof(DWORD) +
+           m_view.capacity() * sizeof(DWORD) + m_words.capacity() * sizeof(WordRef);
+}
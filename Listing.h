@@ -0,0 +1,152 @@
+#ifndef LISTING_H
+#define LISTING_H
+/*
+============================================================================
+ Listing
+  - Compact storage for one pane listing (replaces std::vector<Item>).
+  - One small record per entry (size, attributes, flags, name offset);
+    names live back to back in a per-listing arena and marks in a bitset.
+    About 24 bytes + name length per entry instead of ~280.
+  - Sorting permutes an index of (collation key, position) pairs and then
+    moves each record once; names never move. The name key (first four
+    case-folded bytes) is computed when the entry is added, so most
+    comparisons never fold a character.
+  - Read through the accessors; indices are stable until the next
+    Clear()/Add()/Sort(). The sort mode belongs to the listing and
+    survives Clear().
+  - Optional filter view: while a filter is set, every accessor (and
+    Count, marks, Find) sees only the matching entries, in listing order,
+    with ".." kept on top. Marks belong to the underlying entries, so they
+    survive filter changes; hidden entries are out of reach of anything
+    that walks the listing (marking, operations) until the filter clears.
+  - Matching goes through a case-folded word-start index, built on the
+    first filter / prefix query after the listing changed: each keystroke
+    is a binary search plus the matches, not a rescan of every name.
+  - VS2003/XDK friendly: plain C++98.
+============================================================================
+*/
+
+#include <xtl.h>
+#include <vector>
+
+// Per-entry flags (ListRec::flags)
+enum {
+    LF_DIR = 0x01,     // directory (incl. drive roots and "..")
+    LF_UP  = 0x02      // synthetic ".." row
+};
+
+// Sort orders (directories always come first)
+enum SortMode {
+    SORT_NAME,         // case-insensitive name
+    SORT_NATURAL,      // name, digit runs compared by value ("file2" < "file10")
+    SORT_EXT,          // extension, then name
+    SORT_SIZE,         // largest first, then name
+    SORT_TIME,         // newest first, then name
+    SORT_COUNT
+};
+
+struct ListRec {
+    ULONGLONG size;        // file size (0 for dirs/roots/"..")
+    ULONGLONG mtime;       // last-write FILETIME (0 if synthetic)
+    DWORD     nameOff;     // offset of the NUL-terminated name in the arena
+    DWORD     attr;        // FILE_ATTRIBUTE_* as enumerated (0 if synthetic)
+    DWORD     key;         // first 4 name bytes, lower-cased, big-endian
+    WORD      nameLen;     // strlen(name)
+    BYTE      flags;       // LF_*
+    BYTE      extOff;      // offset of the extension (after the last '.'), nameLen if none
+};
+
+class Listing {
+public:
+    static const size_t npos;
+
+    Listing() : m_mode(SORT_NAME), m_filtered(false), m_indexed(false) { m_filter[0] = 0; }
+
+    // ---- read access (through the filter view, if any) --------------------
+    size_t      Count() const                { return m_filtered ? m_view.size() : m_rec.size(); }
+    bool        Empty() const                { return Count() == 0; }
+    const char* Name(size_t i) const         { return &m_names[m_rec[Pos(i)].nameOff]; }
+    size_t      NameLen(size_t i) const      { return m_rec[Pos(i)].nameLen; }
+    bool        IsDir(size_t i) const        { return (m_rec[Pos(i)].flags & LF_DIR) != 0; }
+    bool        IsUpEntry(size_t i) const    { return (m_rec[Pos(i)].flags & LF_UP)  != 0; }
+    ULONGLONG   Size(size_t i) const         { return m_rec[Pos(i)].size; }
+    DWORD       Attr(size_t i) const         { return m_rec[Pos(i)].attr; }
+    ULONGLONG   Time(size_t i) const         { return m_rec[Pos(i)].mtime; }
+    const ListRec& Rec(size_t i) const       { return m_rec[Pos(i)]; }
+
+    // Case-insensitive name lookup; npos if absent.
+    size_t      Find(const char* name) const;
+
+    // ---- filter view -------------------------------------------------------
+    // Show only entries with a word (name start, or after ' ' _ - . ( [)
+    // starting with 'text', case-insensitive. NULL/"" shows everything.
+    void        SetFilter(const char* text);
+    bool        Filtered() const             { return m_filtered; }
+    const char* Filter() const               { return m_filter; }
+    size_t      Total() const                { return m_rec.size(); }   // ignoring the filter
+    // First entry (view index, listing order) whose name starts with
+    // 'text', case-insensitive; npos if none.
+    size_t      FindPrefix(const char* text) const;
+
+    // ---- marks (bitset, one bit per entry) --------------------------------
+    bool        Marked(size_t i) const       { const size_t p = Pos(i); return (m_marks[p >> 5] >> (p & 31)) & 1; }
+    void        SetMarked(size_t i, bool on);
+    size_t      MarkedCount() const;             // visible entries only
+    bool        AnyMarked() const;
+    void        ClearMarks();                    // visible entries only
+
+    // ---- building (positions are underlying; Clear also drops the filter) ---
+    void        Clear();
+    void        Reserve(size_t entries, size_t nameBytes);
+    void        Add(const char* name, bool isDir, ULONGLONG size, DWORD attr, bool isUp = false);
+    void        Add(const WIN32_FIND_DATAA& fd);     // name, kind, size, attributes, time
+    // Order used by Sort and Merge; changing it does not re-sort.
+    SortMode    Mode() const                 { return m_mode; }
+    void        SetSortMode(SortMode m)      { m_mode = m; }
+    // Sort entries [first, Count) by Mode(); marks follow their entries.
+    void        Sort(size_t first);
+    // Merge a batch sorted in the same mode into this listing (sorted from 'first'); marks
+    // follow their entries. 'track' (optional) is an index that is updated
+    // to the same entry's new position (e.g. the selected row).
+    void        Merge(const Listing& sorted, size_t first, size_t* track);
+    void        Swap(Listing& other);
+
+    // Approximate heap footprint (records + arena + marks), for diagnostics.
+    size_t      Bytes() const;
+
+private:
+    // One word start of one entry (see SetFilter)
+    struct WordRef {
+        DWORD pos;       // index into m_rec
+        DWORD off;       // byte offset of the word in the name
+    };
+
+    size_t      Pos(size_t i) const          { return m_filtered ? m_view[i] : i; }
+    void        BuildIndex() const;
+    void        WordRange(const char* text, size_t& lo, size_t& hi) const;
+    void        Touch()                      { m_indexed = false; }
+    void        Refilter();
+
+    std::vector<ListRec> m_rec;
+    std::vector<char>    m_names;
+    std::vector<DWORD>   m_marks;
+    SortMode             m_mode;
+
+    bool                 m_filtered;
+    char                 m_filter[64];
+    std::vector<DWORD>   m_view;             // visible positions, ascending
+    mutable bool         m_indexed;
+    mutable std::vector<WordRef> m_words;    // sorted by folded text from 'off'
+};
+
+// Short label of a sort mode ("Name", "Size", ...).
+const char* SortModeName(SortMode m);
+
+// Name matching shared with SearchIndex (ASCII case folding, as _stricmp):
+// true if a word starts at name[j] (j == 0, or after ' ' _ - . ( [) ...
+bool IsWordStart(const char* name, size_t j);
+// ... and the folded comparison of s against the first n bytes of pre
+// (0 if s starts with pre, negative if s sorts before it).
+int  FoldPrefixCmp(const char* s, const char* pre, size_t n);
+
+#endif // LISTING_H
@@ -282,6 +282,7 @@ OnScreenKeyboard::OnScreenKeyboard(){
     m_waitRelease = false;
 
     m_parent[0] = m_old[0] = m_buf[0] = 0;
+    _snprintf(m_title, sizeof(m_title), "Rename");
     m_cursor = 0; m_row = 0; m_col = 0;
 
     m_prevA = m_prevB = m_prevY = m_prevLT = m_prevRT = m_prevX = 0;
@@ -293,7 +294,13 @@ OnScreenKeyboard::OnScreenKeyboard(){
     m_shiftOnce = false; // one-shot shift toggle in alpha mode
 }
 
+void OnScreenKeyboard::SetTitle(const char* title){
+    _snprintf(m_title, sizeof(m_title), "%s", title ? title : "");
+    m_title[sizeof(m_title)-1] = 0;
+}
+
 void OnScreenKeyboard::Open(const char* parentDir, const char* initialName, bool startLowerCase){
+    SetTitle("Rename");
     _snprintf(m_parent, sizeof(m_parent), "%s", parentDir ? parentDir : "");
     m_parent[sizeof(m_parent)-1] = 0;
 
@@ -428,9 +435,9 @@ void OnScreenKeyboard::Draw(CXBFont& font, LPDIRECT3DDEVICE8 dev, FLOAT lineH){
     DrawRect(dev, x,   y,   panelW,    panelH,    0xE0222222);
 
     // --- header ---
-    FLOAT titleW, titleH; MeasureTextWH(font, "Rename", titleW, titleH);
+    FLOAT titleW, titleH; MeasureTextWH(font, m_title, titleW, titleH);
     const FLOAT titleY = KB_Snap(y + (headerH - titleH) * 0.5f);
-    DrawAnsi(font, x + 12, titleY, 0xFFFFFFFF, "Rename");
+    DrawAnsi(font, x + 12, titleY, 0xFFFFFFFF, m_title);
 
     {
         int len = (int)strlen(m_buf);
@@ -30,6 +30,9 @@ public:
         Open(parentDir, initialName, kDefaultStartLowerCase);
     }
 
+    // Header caption ("Rename" after Open); call after Open to change it.
+    void   SetTitle(const char* title);
+
     void   Close();
     bool   Active() const { return m_active; }
     Result OnPad(const XBGAMEPAD& pad);
@@ -53,6 +56,7 @@ private:
     bool  m_lower;       // Alpha caps state: false=UPPER, true=lower
     bool  m_symbols;     // false=Alpha (ABC), true=Symbols
 
+    char  m_title[24];   // header caption
     char  m_parent[512]; // header ("In: <parent>")
     char  m_old[256];    // original name when opened
     char  m_buf[256];    // editable text buffer (FATX limit in .cpp)
@@ -6,12 +6,14 @@
 
 // Public, light-weight model used by renderer/actions
 struct Pane {
-    std::vector<Item> items;
+    Listing items;
     char  curPath[512];
-    int   mode;   // 0=drives, 1=dir
+    int   mode;   // 0=drives, 1=dir, 2=search results (curPath = query, names = full paths),
+                  // 3=disk usage (curPath = folder, names = full paths)
     int   sel;
     int   scroll;
-    Pane(){ curPath[0]=0; mode=0; sel=0; scroll=0; }
+    ULONGLONG usageBytes, usageOnDisk;   // mode 3: totals below curPath
+    Pane(){ curPath[0]=0; mode=0; sel=0; scroll=0; usageBytes=0; usageOnDisk=0; }
 };
 
 #endif // PANEMODEL_H
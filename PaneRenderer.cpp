@@ -1,5 +1,8 @@
 #include "PaneRenderer.h"
 #include "GfxPrims.h"
+#include "SizeService.h"
+#include "VolumeInfo.h"
+#include "DiskUsage.h"
 #include <wchar.h>
 #include <stdio.h>
 #include <string.h>
@@ -35,6 +38,28 @@ static const DWORD kMarqEndPauseMs  = 1200;  // pause when tail fully visible
 static const DWORD kMarqStepMs      = 150;   // time between steps (bigger = slower)
 static const int   kMarqStepChars   = 1;     // how many characters to advance per step
 
+// Folder row size from SizeService (blank until known). Search results
+// carry full paths; DVD folders are only shown once computed elsewhere.
+bool PaneRenderer::FolderSize(const Pane& p, int i, ULONGLONG& bytes, bool want){
+    char path[512];
+    if (p.mode == 2) { _snprintf(path, sizeof(path), "%s", p.items.Name(i)); path[sizeof(path)-1] = 0; }
+    else             JoinPath(path, sizeof(path), p.curPath, p.items.Name(i));
+    return SizeService::Get(path, bytes, want && !IsDPath(path));
+}
+
+// Usage view cell: size, share of the folder and running share of the rows
+// above in the same group (folders, then files): "1.20 GB 34% (61%)".
+void PaneRenderer::UsageCell(const Pane& p, int i, char* out, size_t cap){
+    const bool isDir = p.items.IsDir(i);
+    ULONGLONG cum = 0;
+    for (int k = i; k >= 0 && p.items.IsDir(k) == isDir; --k) cum += p.items.Size(k);
+    const ULONGLONG total = p.usageBytes ? p.usageBytes : 1;
+    char sz[32]; FormatSize(p.items.Size(i), sz, sizeof(sz));
+    _snprintf(out, cap, "%s %u%% (%u%%)", sz,
+              (unsigned)(p.items.Size(i) * 100 / total), (unsigned)(cum * 100 / total));
+    out[cap-1] = 0;
+}
+
 // --- shared size-column width backing --------------------------------------
 FLOAT PaneRenderer::s_sharedSizeColW = 0.0f;
 void  PaneRenderer::BeginFrameSharedCols(){ s_sharedSizeColW = 0.0f; }
@@ -103,24 +128,28 @@ FLOAT PaneRenderer::ComputeSizeColW(CXBFont& font, const Pane& p, const PaneStyl
     char buf[128];
 
     if (p.mode == 0){
-        int limit = (int)p.items.size(); if (limit > 32) limit = 32;
+        int limit = (int)p.items.Count(); if (limit > 32) limit = 32;
         for (int i=0;i<limit;++i){
-            const Item& it = p.items[i];
-            if (it.isDir && !it.isUpEntry){
-                ULONGLONG fb=0,tb=0; GetDriveFreeTotal(it.name, fb, tb);
+            if (p.items.IsDir(i) && !p.items.IsUpEntry(i)){
+                ULONGLONG fb=0,tb=0; VolumeInfo::GetFreeTotal(p.items.Name(i), fb, tb);
                 char f[64], t[64]; FormatSize(fb,f,sizeof(f)); FormatSize(tb,t,sizeof(t));
                 _snprintf(buf,sizeof(buf),"%s / %s",f,t); buf[sizeof(buf)-1]=0;
                 FLOAT w = MeasureTextW(font, buf); if (w > maxW) maxW = w;
             }
         }
     } else {
-        int limit = (int)p.items.size(); if (limit > 200) limit = 200;
+        int limit = (int)p.items.Count(); if (limit > 200) limit = 200;
         for (int i=0;i<limit;++i){
-            const Item& it = p.items[i];
-            if (!it.isDir && !it.isUpEntry){
-                FormatSize(it.size, buf, sizeof(buf));
+            if (p.items.IsUpEntry(i)) continue;
+            if (p.mode == 3) {
+                UsageCell(p, i, buf, sizeof(buf));
                 FLOAT w = MeasureTextW(font, buf); if (w > maxW) maxW = w;
+                continue;
             }
+            ULONGLONG bytes = p.items.Size(i);
+            if (p.items.IsDir(i) && !FolderSize(p, i, bytes, false)) continue;
+            FormatSize(bytes, buf, sizeof(buf));
+            FLOAT w = MeasureTextW(font, buf); if (w > maxW) maxW = w;
         }
     }
 
@@ -132,6 +161,13 @@ FLOAT PaneRenderer::ComputeSizeColW(CXBFont& font, const Pane& p, const PaneStyl
     return maxW;
 }
 
+FLOAT PaneRenderer::DateColW(CXBFont& font, const Pane& p, const PaneStyle& st){
+    if (!st.showDate || p.mode != 1) return 0.0f;
+    static FLOAT s_w = 0.0f;      // same font for the whole run
+    if (s_w == 0.0f) s_w = MeasureTextW(font, "0000-00-00 00:00") + 12.0f;
+    return s_w;
+}
+
 void PaneRenderer::PrimeSharedSizeColW(CXBFont& font, const Pane& p, const PaneStyle& st){
     const FLOAT localW = ComputeSizeColW(font, p, st);
     UpdateSharedSizeColW(localW);
@@ -341,6 +377,20 @@ void PaneRenderer::DrawPane(
     // Header text
     char hdr[600];
     if (p.mode == 0) _snprintf(hdr, sizeof(hdr), "%s", "Detected Drives");
+    else if (p.mode == 2 && p.items.Filtered())
+                     _snprintf(hdr, sizeof(hdr), "Find \"%s\"  [%s]", p.curPath, p.items.Filter());
+    else if (p.mode == 2)
+                     _snprintf(hdr, sizeof(hdr), "Find \"%s\" - %u found", p.curPath, (unsigned)p.items.Count());
+    else if (p.mode == 3) {
+        char used[32], disk[32];
+        FormatSize(p.usageBytes, used, sizeof(used));
+        FormatSize(p.usageOnDisk, disk, sizeof(disk));
+        const DiskUsage::Status us = DiskUsage::GetStatus();
+        _snprintf(hdr, sizeof(hdr), "Usage %s - %s, %s on disk%s", p.curPath, used, disk,
+                  us.done ? "" : " (scanning)");
+    }
+    else if (p.items.Filtered())
+                     _snprintf(hdr, sizeof(hdr), "%s  [%s]", p.curPath, p.items.Filter());
     else             _snprintf(hdr, sizeof(hdr), "%s",  p.curPath);
     hdr[sizeof(hdr)-1] = 0;
 
@@ -364,25 +414,36 @@ void PaneRenderer::DrawPane(
     const FLOAT sizeColW  = GetSharedSizeColW();
     const FLOAT sizeRight = baseX + st.listW - (st.scrollBarW + st.paddingX);
     const FLOAT sizeColX  = sizeRight - sizeColW;
+    const FLOAT dateColW  = DateColW(font, p, st);
+    const FLOAT dateRight = sizeColX - 6.0f;
 
     // ----- column headers -----
     const FLOAT colHdrY = st.hdrY + st.hdrH + PaneRenderer::MaxF(6.0f, st.lineH * 0.15f);
     const FLOAT colHdrH = PaneRenderer::MaxF(22.0f, st.lineH);
     DrawRect(dev, baseX, colHdrY, st.listW, colHdrH, 0x60333333);
 
-    FLOAT nameW, nameH; MeasureAnsiWH(font, "Name", nameW, nameH);
+    // Non-default order is shown next to the column title
+    char nameHdr[32] = "Name";
+    if (p.mode == 1 && p.items.Mode() != SORT_NAME) {
+        _snprintf(nameHdr, sizeof(nameHdr), "Name (by %s)", SortModeName(p.items.Mode()));
+        nameHdr[sizeof(nameHdr)-1] = 0;
+    }
+    FLOAT nameW, nameH; MeasureAnsiWH(font, nameHdr, nameW, nameH);
     const char* sizeHdr = (p.mode == 0) ? "Free / Total" : "Size";
     FLOAT sizeW, sizeH; MeasureAnsiWH(font, sizeHdr, sizeW, sizeH);
 
     const FLOAT nameY = colHdrY + (colHdrH - nameH) * 0.5f;
     const FLOAT sizeY = colHdrY + (colHdrH - sizeH) * 0.5f;
 
-    DrawAnsi(font, NameColX(baseX, st), nameY, 0xFFDDDDDD, "Name");
+    DrawAnsi(font, NameColX(baseX, st), nameY, 0xFFDDDDDD, nameHdr);
     DrawRightAligned(font, sizeHdr, sizeRight, sizeY, 0xFFDDDDDD);
+    if (dateColW > 0.0f) DrawRightAligned(font, "Modified", dateRight, sizeY, 0xFFDDDDDD);
 
     // underline + vertical divider
     DrawRect(dev, baseX,    colHdrY + colHdrH,  st.listW, 1.0f, 0x80444444);
     DrawRect(dev, sizeColX, colHdrY + 2.0f,     1.0f,     colHdrH - 4.0f, 0x40444444);
+    if (dateColW > 0.0f)
+        DrawRect(dev, sizeColX - dateColW, colHdrY + 2.0f, 1.0f, colHdrH - 4.0f, 0x40444444);
 
     // ----- list background + nudge (push first row down slightly) ------------
     const FLOAT listBgTop = colHdrY + colHdrH;
@@ -394,7 +455,7 @@ void PaneRenderer::DrawPane(
     DrawRect(dev, baseX, listBgTop, st.listW, kFirstRowNudge + listH, 0x30101010);
 
     // alternating stripes (start at first row, not at underline)
-    int end = p.scroll + st.visibleRows; if (end > (int)p.items.size()) end = (int)p.items.size();
+    int end = p.scroll + st.visibleRows; if (end > (int)p.items.Count()) end = (int)p.items.Count();
     int rowIndex = 0;
     for (int i = p.scroll; i < end; ++i, ++rowIndex) {
         D3DCOLOR stripe = (rowIndex & 1) ? 0x201E1E1E : 0x10000000;
@@ -402,7 +463,7 @@ void PaneRenderer::DrawPane(
     }
 
     // selection highlight
-    if (!p.items.empty() && p.sel >= p.scroll && p.sel < end) {
+    if (!p.items.Empty() && p.sel >= p.scroll && p.sel < end) {
         int selRow = p.sel - p.scroll;
         DrawRect(dev, baseX, listTop + selRow*st.lineH, st.listW, st.lineH, active?0x60FFFF00:0x30FFFF00);
     }
@@ -410,29 +471,31 @@ void PaneRenderer::DrawPane(
     // ----- rows -----
     FLOAT y = listTop;
     for (int i = p.scroll, r = 0; i < end; ++i, ++r) {
-        const Item& it = p.items[i];
-        DWORD nameCol = (i==p.sel)?0xFFFFFF00:0xFFE0E0E0;
+        const bool isUp  = p.items.IsUpEntry(i);
+        const bool isDir = p.items.IsDir(i);
+        const bool hidden = (p.items.Attr(i) & (FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM)) != 0;
+        DWORD nameCol = (i==p.sel)?0xFFFFFF00:(hidden ? 0xFF9A9A9A : 0xFFE0E0E0);
         DWORD sizeCol = (i==p.sel)?0xFFFFFF00:0xFFB0B0B0;
-        D3DCOLOR ico = it.isUpEntry ? 0xFFAAAAAA
-                            : (it.marked ? 0xFFFF4040
-                                         : (it.isDir ? 0xFF5EA4FF
-                                                     : 0xFF89D07E));
+        D3DCOLOR ico = isUp ? 0xFFAAAAAA
+                            : (p.items.Marked(i) ? 0xFFFF4040
+                                                 : (isDir ? 0xFF5EA4FF
+                                                          : 0xFF89D07E));
 
         // icon gutter
         const FLOAT gutterX = baseX + 2.0f;
         const FLOAT gutterW = st.gutterW - 4.0f;
         const FLOAT gutterH = st.lineH - 6.0f;
         DrawRect(dev, gutterX, y + (st.lineH - gutterH) * 0.5f, gutterW, gutterH, ico);
-        const char* glyph = it.isUpEntry ? ".." : (it.isDir?"+":"-");
+        const char* glyph = isUp ? ".." : (isDir?"+":"-");
         DrawAnsi(font, gutterX + 2.0f, y + 2.0f, 0xFFFFFFFF, glyph);
 
         // filename area (compute available width once)
-        char nameBuf[300]; _snprintf(nameBuf, sizeof(nameBuf), "%s", it.name); nameBuf[sizeof(nameBuf)-1] = 0;
+        char nameBuf[300]; _snprintf(nameBuf, sizeof(nameBuf), "%s", p.items.Name(i)); nameBuf[sizeof(nameBuf)-1] = 0;
         const FLOAT nameXRaw     = NameColX(baseX, st);
         const FLOAT rightPad     = st.paddingX + st.scrollBarW;
         const FLOAT kNameSafePad = 2.0f;
 
-        const FLOAT nameRightEdge = Snap((baseX + st.listW) - rightPad - GetSharedSizeColW() - kNameSafePad - kRightGuardPx);
+        const FLOAT nameRightEdge = Snap((baseX + st.listW) - rightPad - GetSharedSizeColW() - dateColW - kNameSafePad - kRightGuardPx);
         const FLOAT nameLeftEdge  = Snap(nameXRaw);
         FLOAT nameMaxW = nameRightEdge - nameLeftEdge;
         if (nameMaxW < 0.0f) nameMaxW = 0.0f;
@@ -443,27 +506,38 @@ void PaneRenderer::DrawPane(
 
         // size column
         char sz[96] = "";
-        if (p.mode == 0 && it.isDir && !it.isUpEntry) {
-            ULONGLONG fb=0, tb=0; GetDriveFreeTotal(it.name, fb, tb);
+        if (p.mode == 3) {
+            UsageCell(p, i, sz, sizeof(sz));
+        } else if (p.mode == 0 && isDir && !isUp) {
+            ULONGLONG fb=0, tb=0; VolumeInfo::GetFreeTotal(p.items.Name(i), fb, tb);
             char f[32], t[32]; FormatSize(fb, f, sizeof(f)); FormatSize(tb, t, sizeof(t));
             _snprintf(sz, sizeof(sz), "%s / %s", f, t);
-        } else if (!it.isDir && !it.isUpEntry) {
-            FormatSize(it.size, sz, sizeof(sz));
+        } else if (!isDir && !isUp) {
+            FormatSize(p.items.Size(i), sz, sizeof(sz));
+        } else if (isDir && !isUp) {
+            ULONGLONG bytes = 0;
+            if (FolderSize(p, i, bytes, true)) FormatSize(bytes, sz, sizeof(sz));
         }
         DrawRightAligned(font, sz, sizeRight, y, sizeCol);
 
+        // date column (straight from the listing, no extra file I/O)
+        if (dateColW > 0.0f && !isUp) {
+            char dt[32]; FormatFileTime(p.items.Time(i), dt, sizeof(dt));
+            DrawRightAligned(font, dt, dateRight, y, sizeCol);
+        }
+
         y += st.lineH;
     }
 
     // ----- scrollbar -----
-    if ((int)p.items.size() > st.visibleRows) {
+    if ((int)p.items.Count() > st.visibleRows) {
         const FLOAT trackX = baseX + st.listW - st.scrollBarW;
         const FLOAT trackY = listTop;                 // align with first row after nudge
         const FLOAT trackH = st.visibleRows * st.lineH;
 
         DrawRect(dev, trackX, trackY, st.scrollBarW, trackH, 0x40282828);
 
-        int total = (int)p.items.size();
+        int total = (int)p.items.Count();
         FLOAT thumbH = (FLOAT)st.visibleRows/(FLOAT)total * trackH; if (thumbH < 10.0f) thumbH = 10.0f;
         FLOAT maxScroll = (FLOAT)(total - st.visibleRows);
         FLOAT t = (maxScroll > 0.0f) ? ((FLOAT)p.scroll / maxScroll) : 0.0f;
@@ -11,6 +11,8 @@
   - Public renderer API for a single file-browser pane (OG Xbox / XDK/VS2003)
   - Declares PaneStyle (layout metrics) and MarqueeState (scroll state)
   - Exposes DrawPane(...) and per-frame shared size-column helpers
+  - Optional date column (PaneStyle::showDate) from the listing's
+    last-write times; fixed width, so it lines up across panes
   - Character-step marquee for long names/paths (crisp, no subpixel drift)
   - No scissor: clipping achieved by measuring and drawing the substring that fits
   - Usage:
@@ -29,6 +31,7 @@ struct PaneStyle {
     FLOAT hdrY, hdrH, hdrW;                  // header band position/size
     FLOAT gutterW, paddingX, scrollBarW;     // icon gutter, left text pad, scroll width
     int   visibleRows;                       // rows visible in the list area
+    bool  showDate;                          // modified-time column left of Size
 };
 
 //------------------------------------------------------------------------------
@@ -100,6 +103,12 @@ private:
 
     // Data-driven size column width
     static FLOAT ComputeSizeColW(CXBFont& font, const Pane& p, const PaneStyle& st);
+    // Date column width (0 when hidden or in the drive list)
+    static FLOAT DateColW(CXBFont& font, const Pane& p, const PaneStyle& st);
+    // Known total of folder row i (want: queue it for computing)
+    static bool  FolderSize(const Pane& p, int i, ULONGLONG& bytes, bool want);
+    // Usage view (mode 3) size cell with percentages
+    static void  UsageCell(const Pane& p, int i, char* out, size_t cap);
 
     // Per-pane marquee state
     MarqueeState m_marq[2];      // rows
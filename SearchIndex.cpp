@@ -0,0 +1,652 @@
+#include "SearchIndex.h"
+#include "FsUtil.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+#include <ctype.h>
+#include <string>
+#include <algorithm>
+
+/*
+============================================================================
+ SearchIndex (implementation)
+  - Node table: one record per name, parent index always below the child
+    index, so "is any ancestor gone" is a single forward pass. Removed
+    names are only flagged dead; the table is compacted before a save
+    when more than a quarter of it is dead.
+  - Word list: (node << 8 | offset) for every word start of every name in
+    nodes [0, s_sorted), sorted by the folded suffix from there. Names
+    added later are scanned linearly by Query until kResortAt of them
+    pile up and the list is rebuilt.
+  - Only the indexer thread modifies the tables. It reads them without
+    the lock and writes under it; Query reads under the lock.
+  - File layout: FileHeader, Node[nodeCount], names[namesBytes]. The magic
+    is written last, so a torn save is rejected and the volumes are walked
+    again.
+============================================================================
+*/
+
+namespace {
+    const DWORD  kIndexStack = 64 * 1024;
+    const char*  kIndexPath  = "T:\\Search.idx";
+    const DWORD  kMagic      = 0x49534658;   // "XFSI"
+    const DWORD  kVersion    = 1;
+    const size_t kMaxNodes   = 100000;       // ~4 MB of tables at the cap
+    const DWORD  kNoParent   = 0xFFFFFFFFu;
+    const size_t kResortAt   = 4096;
+    const DWORD  kSaveIdleMs = 5000;         // save once changes settle
+    const size_t kMaxQueue   = 256;          // more pending changes: verify all
+    const size_t kMaxTerms   = 8;
+    const char   kVolumes[]  = { 'C', 'E', 'F', 'G' };
+
+    enum { NF_DIR = 1, NF_DEAD = 2, NF_ROOT = 4 };
+
+    struct Node {
+        DWORD parent;    // kNoParent for volume roots
+        DWORD nameOff;   // NUL-terminated, in s_names ("E:" for roots)
+        DWORD sizeLo;
+        DWORD stamp;     // folders: last-write time folded to 32 bits
+        WORD  sizeHi;
+        BYTE  nameLen;
+        BYTE  flags;     // NF_*
+    };
+
+    struct FileHeader {
+        DWORD magic;
+        DWORD version;
+        DWORD nodeCount;
+        DWORD namesBytes;
+    };
+
+    struct Change {
+        std::string path;
+        bool        tree;
+    };
+
+    CRITICAL_SECTION    s_lock;
+    HANDLE              s_wake     = NULL;
+    HANDLE              s_thread   = NULL;
+    std::vector<Node>   s_nodes;
+    std::vector<char>   s_names;
+    std::vector<DWORD>  s_words;
+    size_t              s_sorted   = 0;
+    size_t              s_dead     = 0;
+    std::vector<Change> s_queue;
+    bool                s_overflow = false;
+    volatile bool       s_ready    = false;
+    volatile bool       s_full     = false;
+    bool                s_dirty    = false;   // indexer thread only
+
+    inline int Lower(int c){ return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+    inline const char* NameOf(DWORD i){ return &s_names[s_nodes[i].nameOff]; }
+    inline const char* WordText(DWORD w){ return &s_names[s_nodes[w >> 8].nameOff + (w & 0xFF)]; }
+    inline bool Dead(DWORD i){ return (s_nodes[i].flags & NF_DEAD) != 0; }
+
+    DWORD Stamp(const FILETIME& ft){ return ft.dwLowDateTime ^ ft.dwHighDateTime; }
+
+    bool IndexedVolume(char c){
+        c = (char)toupper((unsigned char)c);
+        for (size_t i = 0; i < sizeof(kVolumes); ++i) if (kVolumes[i] == c) return true;
+        return false;
+    }
+
+    // Folded strcmp of two word suffixes (word list order)
+    struct WordLess {
+        bool operator()(DWORD a, DWORD b) const {
+            const unsigned char* x = (const unsigned char*)WordText(a);
+            const unsigned char* y = (const unsigned char*)WordText(b);
+            for (;; ++x, ++y){
+                const int p = Lower(*x), q = Lower(*y);
+                if (p != q) return p < q;
+                if (!p) return false;
+            }
+        }
+    };
+
+    // Some word of 'name' starts with 'term' (same rule as Listing::SetFilter)
+    bool HasWord(const char* name, size_t len, const char* term, size_t tl){
+        for (size_t j = 0; j + tl <= len; ++j)
+            if (IsWordStart(name, j) && FoldPrefixCmp(name + j, term, tl) == 0) return true;
+        return false;
+    }
+
+    // "E:\dir\name" of node i ("E:\" for a root); false if it does not fit
+    bool BuildPath(DWORD i, char* out, size_t cap){
+        DWORD chain[64];
+        size_t n = 0;
+        for (; i != kNoParent; i = s_nodes[i].parent){
+            if (n == sizeof(chain)/sizeof(chain[0])) return false;
+            chain[n++] = i;
+        }
+        size_t len = 0;
+        for (size_t k = n; k-- > 0; ){
+            const Node& nd = s_nodes[chain[k]];
+            if (len + nd.nameLen + 2 > cap) return false;
+            memcpy(out + len, &s_names[nd.nameOff], nd.nameLen);
+            len += nd.nameLen;
+            if (k || n == 1) out[len++] = '\\';
+        }
+        out[len] = 0;
+        return true;
+    }
+
+    // ---- mutation (indexer thread, under s_lock) --------------------------
+    DWORD AddNode(DWORD parent, const char* name, size_t len, BYTE flags,
+                  DWORD sizeLo, DWORD sizeHi, DWORD stamp){
+        if (s_nodes.size() >= kMaxNodes) { s_full = true; return kNoParent; }
+        Node nd;
+        nd.parent  = parent;
+        nd.nameOff = (DWORD)s_names.size();
+        nd.sizeLo  = sizeLo;
+        nd.stamp   = stamp;
+        nd.sizeHi  = (WORD)sizeHi;
+        nd.nameLen = (BYTE)len;
+        nd.flags   = flags;
+        s_names.insert(s_names.end(), name, name + len);
+        s_names.push_back(0);
+        s_nodes.push_back(nd);
+        return (DWORD)(s_nodes.size() - 1);
+    }
+
+    void Kill(DWORD i){
+        if (Dead(i)) return;
+        s_nodes[i].flags |= NF_DEAD;
+        ++s_dead;
+    }
+
+    // Kill every node whose parent is dead, from 'first' on
+    void Propagate(size_t first){
+        for (size_t i = first; i < s_nodes.size(); ++i){
+            const DWORD p = s_nodes[i].parent;
+            if (p != kNoParent && Dead(p)) Kill((DWORD)i);
+        }
+    }
+
+    void KillTree(DWORD i){
+        EnterCriticalSection(&s_lock);
+        Kill(i);
+        Propagate(i + 1);
+        LeaveCriticalSection(&s_lock);
+        s_dirty = true;
+    }
+
+    // ---- lookup (indexer thread, no lock needed) ---------------------------
+    DWORD FindRoot(char letter){
+        letter = (char)toupper((unsigned char)letter);
+        for (size_t i = 0; i < s_nodes.size(); ++i)
+            if ((s_nodes[i].flags & (NF_ROOT | NF_DEAD)) == NF_ROOT && NameOf((DWORD)i)[0] == letter)
+                return (DWORD)i;
+        return kNoParent;
+    }
+
+    DWORD FindChild(DWORD parent, const char* name, size_t len){
+        for (size_t i = parent + 1; i < s_nodes.size(); ++i){
+            const Node& nd = s_nodes[i];
+            if (nd.parent == parent && nd.nameLen == len && !(nd.flags & NF_DEAD) &&
+                _strnicmp(&s_names[nd.nameOff], name, len) == 0) return (DWORD)i;
+        }
+        return kNoParent;
+    }
+
+    // Live node of a full path; kNoParent if not indexed
+    DWORD FindNode(const char* path){
+        if (!path[0] || path[1] != ':') return kNoParent;
+        DWORD cur = FindRoot(path[0]);
+        const char* p = path + 2;
+        while (cur != kNoParent){
+            while (*p == '\\') ++p;
+            if (!*p) break;
+            const char* e = p;
+            while (*e && *e != '\\') ++e;
+            cur = FindChild(cur, p, (size_t)(e - p));
+            p = e;
+        }
+        return cur;
+    }
+
+    // ---- scanning (indexer thread) -----------------------------------------
+    struct Ent {
+        DWORD off;       // into the local name pool
+        DWORD sizeLo;
+        DWORD sizeHi;
+        DWORD stamp;
+        BYTE  len;
+        BYTE  dir;
+    };
+
+    // List folder d one level and reconcile its children: new names are
+    // added (new folders queued on 'walk' for a full scan), vanished ones
+    // die with their subtrees, file sizes are refreshed. Existing child
+    // folders keep their stamps: their own contents are checked separately.
+    // 'fresh' = d was just added, there is nothing to reconcile.
+    void ScanLevel(DWORD d, bool fresh, std::vector<DWORD>& walk){
+        char path[512];
+        if (!BuildPath(d, path, sizeof(path))) return;
+        const bool atRoot = (s_nodes[d].flags & NF_ROOT) != 0;
+
+        DWORD stamp = s_nodes[d].stamp;
+        if (!fresh && !atRoot){
+            WIN32_FILE_ATTRIBUTE_DATA fad;
+            if (!GetFileAttributesExA(path, GetFileExInfoStandard, &fad) ||
+                !(fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) { KillTree(d); return; }
+            stamp = Stamp(fad.ftLastWriteTime);
+        }
+
+        std::vector<Ent>  ents;
+        std::vector<char> pool;
+        char mask[512]; JoinPath(mask, sizeof(mask), path, "*");
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA(mask, &fd);
+        if (h != INVALID_HANDLE_VALUE){
+            do{
+                if (!IsListedName(fd.cFileName, atRoot)) continue;
+                const size_t len = strlen(fd.cFileName);
+                if (!len || len > 255) continue;
+                Ent e;
+                e.off    = (DWORD)pool.size();
+                e.dir    = (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? 1 : 0;
+                e.sizeLo = e.dir ? 0 : fd.nFileSizeLow;
+                e.sizeHi = e.dir ? 0 : fd.nFileSizeHigh;
+                e.stamp  = e.dir ? Stamp(fd.ftLastWriteTime) : 0;
+                e.len    = (BYTE)len;
+                pool.insert(pool.end(), fd.cFileName, fd.cFileName + len + 1);
+                ents.push_back(e);
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+
+        std::vector<DWORD> kids;
+        if (!fresh)
+            for (size_t i = d + 1; i < s_nodes.size(); ++i)
+                if (s_nodes[i].parent == d && !Dead((DWORD)i)) kids.push_back((DWORD)i);
+
+        EnterCriticalSection(&s_lock);
+        for (size_t e = 0; e < ents.size(); ++e){
+            const Ent&  en = ents[e];
+            const char* nm = &pool[en.off];
+
+            DWORD match = kNoParent;
+            for (size_t k = 0; k < kids.size(); ++k){
+                const DWORD c = kids[k];
+                if (c == kNoParent || ((s_nodes[c].flags & NF_DIR) != 0) != (en.dir != 0)) continue;
+                if (_stricmp(NameOf(c), nm) == 0) { match = c; kids[k] = kNoParent; break; }
+            }
+            if (match != kNoParent){
+                s_nodes[match].sizeLo = en.sizeLo;
+                s_nodes[match].sizeHi = (WORD)en.sizeHi;
+                continue;
+            }
+            const DWORD n = AddNode(d, nm, en.len, en.dir ? NF_DIR : 0, en.sizeLo, en.sizeHi, en.stamp);
+            if (n != kNoParent && en.dir) walk.push_back(n);
+        }
+        size_t first = s_nodes.size();
+        for (size_t k = 0; k < kids.size(); ++k)
+            if (kids[k] != kNoParent){ Kill(kids[k]); if (kids[k] < first) first = kids[k]; }
+        Propagate(first + 1);
+        s_nodes[d].stamp = stamp;
+        LeaveCriticalSection(&s_lock);
+        s_dirty = true;
+    }
+
+    // Full scan of everything queued on 'walk' (and below)
+    void Walk(std::vector<DWORD>& walk){
+        while (!walk.empty()){
+            const DWORD d = walk.back();
+            walk.pop_back();
+            ScanLevel(d, true, walk);
+        }
+    }
+
+    // Index a volume that has no root yet (if it is present)
+    void AddVolume(char letter){
+        letter = (char)toupper((unsigned char)letter);
+        const char root[4] = { letter, ':', '\\', 0 };
+        if (GetFileAttributesA(root) == INVALID_FILE_ATTRIBUTES) return;
+        EnterCriticalSection(&s_lock);
+        const DWORD r = AddNode(kNoParent, root, 2, NF_DIR | NF_ROOT, 0, 0, 0);
+        LeaveCriticalSection(&s_lock);
+        if (r == kNoParent) return;
+        std::vector<DWORD> walk(1, r);
+        Walk(walk);
+    }
+
+    void Compact();
+
+    // Dead names count against kMaxNodes: reclaim them before adding more.
+    // Only between scans (compaction renumbers the nodes).
+    void MaybeCompact(){
+        if (s_dead > s_nodes.size() / 4) Compact();
+    }
+
+    // Bring the whole index up to date with the disks: volumes that came or
+    // went, then every folder whose stamp changed is rescanned one level
+    // (new subfolders in full). Roots carry no stamp and are always rescanned.
+    void Verify(){
+        MaybeCompact();
+        const size_t n0 = s_nodes.size();
+        std::vector<DWORD> walk;
+        for (size_t v = 0; v < sizeof(kVolumes); ++v){
+            const char  root[4] = { kVolumes[v], ':', '\\', 0 };
+            const DWORD r       = FindRoot(kVolumes[v]);
+            if (r == kNoParent) AddVolume(kVolumes[v]);
+            else if (GetFileAttributesA(root) == INVALID_FILE_ATTRIBUTES) KillTree(r);
+        }
+        for (size_t i = 0; i < n0; ++i){
+            const Node nd = s_nodes[i];
+            if ((nd.flags & NF_DEAD) || !(nd.flags & NF_DIR)) continue;
+            if (!(nd.flags & NF_ROOT)){
+                char path[512];
+                if (!BuildPath((DWORD)i, path, sizeof(path))) continue;
+                WIN32_FILE_ATTRIBUTE_DATA fad;
+                if (!GetFileAttributesExA(path, GetFileExInfoStandard, &fad)) { KillTree((DWORD)i); continue; }
+                if (Stamp(fad.ftLastWriteTime) == nd.stamp) continue;
+            }
+            ScanLevel((DWORD)i, false, walk);
+            Walk(walk);
+        }
+    }
+
+    void ApplyChange(const Change& c){
+        char path[512];
+        _snprintf(path, sizeof(path), "%s", c.path.c_str()); path[sizeof(path)-1] = 0;
+        size_t n = strlen(path);
+        if (n < 2 || path[1] != ':' || !IndexedVolume(path[0])) return;
+        while (n > 3 && path[n-1] == '\\') path[--n] = 0;
+        if (n == 2) { path[2] = '\\'; path[3] = 0; }
+        MaybeCompact();
+
+        if (c.tree){
+            if (IsDriveRoot(path)){
+                // Whole volume (format, media change): index it again
+                const DWORD r = FindRoot(path[0]);
+                if (r != kNoParent) KillTree(r);
+                MaybeCompact();
+                AddVolume(path[0]);
+                return;
+            }
+            const DWORD i = FindNode(path);
+            if (i != kNoParent) KillTree(i);
+            ParentPath(path);   // the folder listing it picks up what is there now
+        }
+
+        // Nearest indexed folder at or above 'path'
+        DWORD d = kNoParent;
+        while (path[0]){
+            d = FindNode(path);
+            if (d != kNoParent && (s_nodes[d].flags & NF_DIR)) break;
+            d = kNoParent;
+            ParentPath(path);
+        }
+        if (d == kNoParent) return;
+
+        std::vector<DWORD> walk;
+        ScanLevel(d, false, walk);
+        Walk(walk);
+    }
+
+    // ---- word list / compaction / persistence (indexer thread) -------------
+    void Resort(){
+        const size_t n = s_nodes.size();
+        std::vector<DWORD> words;
+        words.reserve(n * 2);
+        for (size_t i = 0; i < n; ++i){
+            if (Dead((DWORD)i)) continue;
+            const char* nm = NameOf((DWORD)i);
+            for (size_t j = 0; j < s_nodes[i].nameLen; ++j)
+                if (IsWordStart(nm, j)) words.push_back((DWORD)(i << 8) | (DWORD)j);
+        }
+        std::sort(words.begin(), words.end(), WordLess());
+
+        EnterCriticalSection(&s_lock);
+        s_words.swap(words);
+        s_sorted = n;
+        LeaveCriticalSection(&s_lock);
+    }
+
+    void Compact(){
+        std::vector<DWORD> remap(s_nodes.size(), kNoParent);
+        std::vector<Node>  nodes;
+        std::vector<char>  names;
+        nodes.reserve(s_nodes.size() - s_dead);
+        names.reserve(s_names.size());
+        for (size_t i = 0; i < s_nodes.size(); ++i){
+            if (Dead((DWORD)i)) continue;
+            Node nd = s_nodes[i];
+            if (nd.parent != kNoParent) nd.parent = remap[nd.parent];   // live: parent is too
+            nd.nameOff = (DWORD)names.size();
+            names.insert(names.end(), NameOf((DWORD)i), NameOf((DWORD)i) + nd.nameLen + 1);
+            remap[i] = (DWORD)nodes.size();
+            nodes.push_back(nd);
+        }
+
+        EnterCriticalSection(&s_lock);
+        s_nodes.swap(nodes);
+        s_names.swap(names);
+        s_words.clear();     // indices changed: Query scans linearly until Resort
+        s_sorted = 0;
+        s_dead   = 0;
+        LeaveCriticalSection(&s_lock);
+        Resort();
+    }
+
+    bool WriteAll(HANDLE h, const void* p, DWORD n){
+        DWORD wr = 0;
+        return !n || (WriteFile(h, p, n, &wr, NULL) && wr == n);
+    }
+
+    bool ReadAll(HANDLE h, void* p, DWORD n){
+        DWORD rd = 0;
+        return !n || (ReadFile(h, p, n, &rd, NULL) && rd == n);
+    }
+
+    void Save(){
+        MaybeCompact();
+        s_dirty = false;   // a failed save is not retried until the next change
+
+        const DWORD t0 = GetTickCount();
+        HANDLE h = CreateFileA(kIndexPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE) return;
+
+        FileHeader hd;
+        hd.magic      = 0;   // until everything else is on disk
+        hd.version    = kVersion;
+        hd.nodeCount  = (DWORD)s_nodes.size();
+        hd.namesBytes = (DWORD)s_names.size();
+        bool ok = WriteAll(h, &hd, sizeof(hd)) &&
+                  WriteAll(h, hd.nodeCount ? &s_nodes[0] : NULL, hd.nodeCount * sizeof(Node)) &&
+                  WriteAll(h, hd.namesBytes ? &s_names[0] : NULL, hd.namesBytes);
+        if (ok){
+            FlushFileBuffers(h);
+            hd.magic = kMagic;
+            ok = SetFilePointer(h, 0, NULL, FILE_BEGIN) != 0xFFFFFFFFu && WriteAll(h, &hd, sizeof(hd));
+        }
+        CloseHandle(h);
+        if (!ok) { DeleteFileA(kIndexPath); return; }
+        XBUtil_DebugPrint("SearchIndex: saved %u names (%u KB) in %lu ms", (unsigned)hd.nodeCount,
+                          (unsigned)((hd.nodeCount * sizeof(Node) + hd.namesBytes) / 1024),
+                          (unsigned long)(GetTickCount() - t0));
+    }
+
+    bool Load(){
+        HANDLE h = CreateFileA(kIndexPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE) return false;
+
+        FileHeader hd;
+        std::vector<Node> nodes;
+        std::vector<char> names;
+        bool ok = ReadAll(h, &hd, sizeof(hd)) &&
+                  hd.magic == kMagic && hd.version == kVersion &&
+                  hd.nodeCount <= kMaxNodes && hd.namesBytes <= hd.nodeCount * 256;
+        if (ok){
+            nodes.resize(hd.nodeCount);
+            names.resize(hd.namesBytes);
+            ok = ReadAll(h, hd.nodeCount ? &nodes[0] : NULL, hd.nodeCount * sizeof(Node)) &&
+                 ReadAll(h, hd.namesBytes ? &names[0] : NULL, hd.namesBytes);
+        }
+        CloseHandle(h);
+
+        // Sanity: parents before children, names inside the pool
+        size_t dead = 0;
+        for (size_t i = 0; ok && i < nodes.size(); ++i){
+            const Node& nd = nodes[i];
+            if (nd.flags & NF_ROOT) ok = nd.parent == kNoParent && nd.nameLen == 2;
+            else                    ok = nd.parent < i;
+            ok = ok && (size_t)nd.nameOff + nd.nameLen < names.size() && names[nd.nameOff + nd.nameLen] == 0;
+            if (nd.flags & NF_DEAD) ++dead;
+        }
+        if (!ok) { XBUtil_DebugPrint("SearchIndex: %s unusable, rebuilding", kIndexPath); return false; }
+
+        EnterCriticalSection(&s_lock);
+        s_nodes.swap(nodes);
+        s_names.swap(names);
+        s_dead = dead;
+        LeaveCriticalSection(&s_lock);
+        return true;
+    }
+
+    DWORD WINAPI IndexMain(LPVOID){
+        const DWORD t0 = GetTickCount();
+        const bool loaded = Load();
+        Verify();   // with nothing loaded this is the full walk
+        if (!loaded) s_dirty = true;
+        Resort();
+        s_ready = true;
+        XBUtil_DebugPrint("SearchIndex: %u names %s in %lu ms", (unsigned)(s_nodes.size() - s_dead),
+                          loaded ? "verified" : "indexed", (unsigned long)(GetTickCount() - t0));
+
+        for (;;){
+            if (WaitForSingleObject(s_wake, s_dirty ? kSaveIdleMs : INFINITE) == WAIT_TIMEOUT){
+                Save();
+                continue;
+            }
+            for (;;){
+                Change c;
+                bool   all = false;
+                EnterCriticalSection(&s_lock);
+                if (s_overflow){
+                    all = true;
+                    s_overflow = false;
+                    s_queue.clear();
+                } else if (!s_queue.empty()){
+                    c = s_queue.front();
+                    s_queue.erase(s_queue.begin());
+                } else {
+                    LeaveCriticalSection(&s_lock);
+                    break;
+                }
+                LeaveCriticalSection(&s_lock);
+                if (all) Verify(); else ApplyChange(c);
+            }
+            if (s_nodes.size() - s_sorted > kResortAt) Resort();
+        }
+        return 0;
+    }
+}
+
+namespace SearchIndex {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    s_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kIndexStack, IndexMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    // Same as the trash reaper: never in the way of the UI or a job
+    SetThreadPriority(s_thread, THREAD_PRIORITY_LOWEST);
+    return true;
+}
+
+void Changed(const char* path, bool tree){
+    if (!s_thread || !path || !path[0] || path[1] != ':' || !IndexedVolume(path[0])) return;
+
+    EnterCriticalSection(&s_lock);
+    bool dup = false;
+    for (size_t i = 0; i < s_queue.size() && !dup; ++i)
+        dup = s_queue[i].tree == tree && _stricmp(s_queue[i].path.c_str(), path) == 0;
+    if (!dup){
+        if (s_queue.size() >= kMaxQueue) s_overflow = true;
+        else { Change c; c.path = path; c.tree = tree; s_queue.push_back(c); }
+    }
+    LeaveCriticalSection(&s_lock);
+    SetEvent(s_wake);
+}
+
+size_t Query(const char* text, Listing& out, size_t maxHits){
+    out.Clear();
+    if (!s_thread || !text) return 0;
+
+    // Terms; the longest one selects the candidates
+    char buf[128];
+    _snprintf(buf, sizeof(buf), "%s", text); buf[sizeof(buf)-1] = 0;
+    const char* terms[kMaxTerms];
+    size_t      lens[kMaxTerms];
+    size_t      nt = 0;
+    for (char* p = buf; *p && nt < kMaxTerms; ){
+        while (*p == ' ') *p++ = 0;
+        if (!*p) break;
+        terms[nt] = p;
+        while (*p && *p != ' ') ++p;
+        lens[nt] = (size_t)(p - terms[nt]);
+        if (lens[nt] > lens[0]) { std::swap(terms[0], terms[nt]); std::swap(lens[0], lens[nt]); }
+        ++nt;
+    }
+    if (!nt) return 0;
+
+    EnterCriticalSection(&s_lock);
+    std::vector<DWORD> cand;
+    size_t lo, hi;
+    {
+        size_t a = 0, b = s_words.size();
+        while (a < b){
+            const size_t m = (a + b) / 2;
+            if (FoldPrefixCmp(WordText(s_words[m]), terms[0], lens[0]) < 0) a = m + 1; else b = m;
+        }
+        lo = a; b = s_words.size();
+        while (a < b){
+            const size_t m = (a + b) / 2;
+            if (FoldPrefixCmp(WordText(s_words[m]), terms[0], lens[0]) <= 0) a = m + 1; else b = m;
+        }
+        hi = a;
+    }
+    for (size_t k = lo; k < hi; ++k) cand.push_back(s_words[k] >> 8);
+    for (size_t i = s_sorted; i < s_nodes.size(); ++i)
+        if (HasWord(NameOf((DWORD)i), s_nodes[i].nameLen, terms[0], lens[0])) cand.push_back((DWORD)i);
+    std::sort(cand.begin(), cand.end());
+    cand.erase(std::unique(cand.begin(), cand.end()), cand.end());
+
+    size_t total = 0;
+    for (size_t k = 0; k < cand.size(); ++k){
+        const DWORD i  = cand[k];
+        const Node& nd = s_nodes[i];
+        if (nd.flags & (NF_DEAD | NF_ROOT)) continue;
+        bool all = true;
+        for (size_t t = 1; t < nt && all; ++t) all = HasWord(NameOf(i), nd.nameLen, terms[t], lens[t]);
+        if (!all) continue;
+        ++total;
+        char path[512];
+        if (out.Count() >= maxHits || !BuildPath(i, path, sizeof(path)) || strlen(path) > 255) continue;
+        out.Add(path, (nd.flags & NF_DIR) != 0, ((ULONGLONG)nd.sizeHi << 32) | nd.sizeLo, 0);
+    }
+    LeaveCriticalSection(&s_lock);
+    return total;
+}
+
+Status GetStatus(){
+    Status st;
+    st.ready   = s_ready;
+    st.full    = s_full;
+    st.entries = 0;
+    if (!s_thread) return st;
+    EnterCriticalSection(&s_lock);
+    st.entries = s_nodes.size() - s_dead;
+    LeaveCriticalSection(&s_lock);
+    return st;
+}
+
+} // namespace SearchIndex
@@ -0,0 +1,46 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+/*
+============================================================================
+ SearchIndex
+  - Whole-volume file name search over the hard disk partitions (C, E, F,
+    G). Removable and DVD media are not indexed.
+  - Names live in a parent-linked node table (parent index always below
+    the child's) with one string arena, plus a list of word starts sorted
+    by folded suffix: a query term is a binary-searched range of that list,
+    the same matching rules as the pane filter (Listing::SetFilter).
+  - Persisted to T:\Search.idx. At start the saved index is loaded and
+    verified folder by folder against the folders' modification times, so
+    only folders that changed are rescanned; without a usable file the
+    volumes are walked once in full.
+  - Kept current incrementally: DirCache forwards every invalidation of
+    ours (Changed) and only the affected folders are rescanned.
+  - A low-priority thread does all disk work; Query may be called from the
+    UI at any time and searches whatever is indexed so far.
+============================================================================
+*/
+
+#include <xtl.h>
+#include "Listing.h"
+
+namespace SearchIndex {
+    struct Status {
+        bool   ready;     // initial load / walk / verify done
+        bool   full;      // node cap reached, some names are missing
+        size_t entries;   // live names
+    };
+
+    // Start the indexer thread. Call once.
+    bool   Start();
+    // 'path' changed: its folder's entries (tree=false, path is a folder) or
+    // the item itself and everything below it (tree=true). Any thread.
+    void   Changed(const char* path, bool tree);
+    // Clear 'out' and fill it with up to maxHits matches (full paths as
+    // names, files and folders). Space-separated terms must all match word
+    // starts of the name. Returns the number of matches, which may exceed
+    // maxHits.
+    size_t Query(const char* text, Listing& out, size_t maxHits);
+    Status GetStatus();
+}
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,389 @@
+#include "SizeService.h"
+#include "FsUtil.h"
+#include "JobQueue.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+#include <string>
+#include <vector>
+
+/*
+============================================================================
+ SizeService (implementation)
+  - Nodes are memoized folders, found by full path through a chained hash
+    (case-folded FNV-1a). 'parent' links a node to its parent folder's node
+    when that one is memoized too; nodes freed by a drop are reused.
+  - Invariant: a known node's subfolders are all known, so an ancestor of
+    a recomputed folder is either known (gets the delta) or unknown (and
+    so are its ancestors: stop there).
+  - A walk lists folders breadth-first, recording the visit order; totals
+    are then summed in reverse order (children before parents).
+  - Everything runs under s_lock except the directory enumeration itself.
+  - Over kSoftCap nodes the memo is dropped before the next walk.
+============================================================================
+*/
+
+namespace {
+    const DWORD  kSizeStack = 64 * 1024;
+    const DWORD  kNone      = 0xFFFFFFFFu;
+    const DWORD  kBuckets   = 8192;     // power of two
+    const size_t kSoftCap   = 40000;    // folders
+    const size_t kMaxWants  = 32;
+    const size_t kMaxChanges = 256;     // more: drop everything instead
+    const DWORD  kJobPollMs = 250;
+
+    struct Node {
+        std::string path;      // "E:\dir" (drive roots "E:\")
+        DWORD       hash;
+        DWORD       next;      // hash chain
+        DWORD       parent;    // kNone if the parent folder is not memoized
+        ULONGLONG   own;       // files directly inside
+        ULONGLONG   total;     // own + subfolders (if known)
+        ULONGLONG   acc;       // walk scratch: subfolder totals so far
+        bool        live, known, inWalk;
+    };
+
+    struct Change {
+        std::string path;
+        bool        tree;
+    };
+
+    CRITICAL_SECTION    s_lock;
+    HANDLE              s_wake   = NULL;
+    HANDLE              s_thread = NULL;
+    std::vector<Node>   s_nodes;
+    std::vector<DWORD>  s_free;
+    std::vector<DWORD>  s_bucket;
+    size_t              s_live   = 0;
+    std::vector<Change> s_changes;      // FIFO
+    bool                s_overflow = false;  // too many changes: worker drops everything
+    std::vector<std::string> s_wants;   // LIFO
+    Change              s_current;      // being applied (path empty: none)
+
+    inline int Lower(int c){ return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+    // "E:\a\b" (no trailing slash; roots keep theirs); false if no drive
+    bool Norm(const char* in, char* out, size_t cap){
+        if (!in || !in[0] || in[1] != ':') return false;
+        _snprintf(out, cap, "%s", in); out[cap-1] = 0;
+        size_t n = strlen(out);
+        while (n > 3 && out[n-1] == '\\') out[--n] = 0;
+        if (n == 2 && cap > 3) { out[2] = '\\'; out[3] = 0; }
+        return true;
+    }
+
+    DWORD Hash(const char* s){
+        DWORD h = 2166136261u;
+        for (; *s; ++s) { h ^= (DWORD)Lower((unsigned char)*s); h *= 16777619u; }
+        return h;
+    }
+
+    DWORD Find(const char* path){
+        const DWORD h = Hash(path);
+        for (DWORD i = s_bucket[h & (kBuckets - 1)]; i != kNone; i = s_nodes[i].next)
+            if (s_nodes[i].hash == h && _stricmp(s_nodes[i].path.c_str(), path) == 0) return i;
+        return kNone;
+    }
+
+    DWORD NewNode(const char* path, DWORD parent){
+        DWORD i;
+        if (!s_free.empty()) { i = s_free.back(); s_free.pop_back(); }
+        else                 { i = (DWORD)s_nodes.size(); s_nodes.push_back(Node()); }
+        Node& n  = s_nodes[i];
+        n.path   = path;
+        n.hash   = Hash(path);
+        n.parent = parent;
+        n.own = n.total = n.acc = 0;
+        n.live   = true;
+        n.known  = false;
+        n.inWalk = false;
+        const DWORD b = n.hash & (kBuckets - 1);
+        n.next = s_bucket[b];
+        s_bucket[b] = i;
+        ++s_live;
+        return i;
+    }
+
+    void Unlink(DWORD i){
+        DWORD* p = &s_bucket[s_nodes[i].hash & (kBuckets - 1)];
+        while (*p != i) p = &s_nodes[*p].next;
+        *p = s_nodes[i].next;
+        s_nodes[i].live = false;
+        s_nodes[i].path.clear();
+        s_free.push_back(i);
+        --s_live;
+    }
+
+    bool Below(DWORD i, DWORD top){
+        for (; i != kNone; i = s_nodes[i].parent) if (i == top) return true;
+        return false;
+    }
+
+    // Forget node 'top' and every memoized folder below it
+    void DropTree(DWORD top){
+        if (top == kNone) return;
+        std::vector<DWORD> doomed;
+        for (size_t i = 0; i < s_nodes.size(); ++i)
+            if (s_nodes[i].live && Below((DWORD)i, top)) doomed.push_back((DWORD)i);
+        for (size_t k = 0; k < doomed.size(); ++k) Unlink(doomed[k]);
+    }
+
+    void Reset(){
+        s_nodes.clear();
+        s_free.clear();
+        s_bucket.assign(kBuckets, kNone);
+        s_live = 0;
+    }
+
+    // 'path' is 'dir' or inside it
+    bool Within(const char* path, const char* dir){
+        const size_t n = strlen(dir);
+        if (_strnicmp(path, dir, n) != 0) return false;
+        return path[n] == 0 || path[n] == '\\' || dir[n-1] == '\\';
+    }
+
+    bool Affects(const Change& c, const char* dir){
+        if (c.path.empty()) return false;
+        return Within(c.path.c_str(), dir) || (c.tree && Within(dir, c.path.c_str()));
+    }
+
+    // A queued (or running) change may alter the total of 'dir'
+    bool Pending(const char* dir){
+        if (s_overflow || Affects(s_current, dir)) return true;
+        for (size_t i = 0; i < s_changes.size(); ++i)
+            if (Affects(s_changes[i], dir)) return true;
+        return false;
+    }
+
+    // List node i one level: own bytes, subfolders linked / created. Known
+    // subfolders contribute their total; the rest go on 'walk'. 'fresh'
+    // skips dropping subfolders that vanished (nothing memoized yet).
+    void ListLevel(DWORD i, bool fresh, std::vector<DWORD>& walk, std::vector<DWORD>& order){
+        char path[512];
+        EnterCriticalSection(&s_lock);
+        _snprintf(path, sizeof(path), "%s", s_nodes[i].path.c_str()); path[sizeof(path)-1] = 0;
+        LeaveCriticalSection(&s_lock);
+
+        const bool atRoot = IsDriveRoot(path);
+        ULONGLONG own = 0;
+        std::vector<std::string> subs;
+        char mask[512]; JoinPath(mask, sizeof(mask), path, "*");
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA(mask, &fd);
+        if (h != INVALID_HANDLE_VALUE){
+            do{
+                if (!IsListedName(fd.cFileName, atRoot)) continue;
+                if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY){
+                    char sub[512]; JoinPath(sub, sizeof(sub), path, fd.cFileName);
+                    subs.push_back(sub);
+                } else {
+                    own += (((ULONGLONG)fd.nFileSizeHigh) << 32) | fd.nFileSizeLow;
+                }
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+
+        EnterCriticalSection(&s_lock);
+        std::vector<DWORD> old;
+        if (!fresh)
+            for (size_t k = 0; k < s_nodes.size(); ++k)
+                if (s_nodes[k].live && s_nodes[k].parent == i) old.push_back((DWORD)k);
+
+        Node& n = s_nodes[i];
+        n.own    = own;
+        n.acc    = 0;
+        n.inWalk = true;
+        order.push_back(i);
+        for (size_t s = 0; s < subs.size(); ++s){
+            DWORD c = Find(subs[s].c_str());
+            if (c == kNone) c = NewNode(subs[s].c_str(), i);   // may move s_nodes: no refs kept
+            s_nodes[c].parent = i;
+            for (size_t k = 0; k < old.size(); ++k) if (old[k] == c) { old[k] = kNone; break; }
+            if (s_nodes[c].known) s_nodes[i].acc += s_nodes[c].total;
+            else                  walk.push_back(c);
+        }
+        for (size_t k = 0; k < old.size(); ++k) if (old[k] != kNone) DropTree(old[k]);
+        LeaveCriticalSection(&s_lock);
+    }
+
+    // (Re)compute node 'top': one level (not fresh) or a full walk (fresh),
+    // then totals bottom-up and the difference into known ancestors.
+    void Compute(DWORD top, bool fresh){
+        EnterCriticalSection(&s_lock);
+        const bool      wasKnown = s_nodes[top].known;
+        const ULONGLONG oldTotal = s_nodes[top].total;
+        LeaveCriticalSection(&s_lock);
+
+        std::vector<DWORD> walk, order;
+        ListLevel(top, fresh, walk, order);
+        while (!walk.empty()){
+            const DWORD c = walk.back();
+            walk.pop_back();
+            ListLevel(c, true, walk, order);
+        }
+
+        EnterCriticalSection(&s_lock);
+        for (size_t k = order.size(); k-- > 0; ){
+            Node& n = s_nodes[order[k]];
+            if (!n.live) continue;
+            n.total  = n.own + n.acc;
+            n.known  = true;
+            n.inWalk = false;
+            if (n.parent != kNone && s_nodes[n.parent].inWalk) s_nodes[n.parent].acc += n.total;
+        }
+        if (wasKnown && s_nodes[top].live){
+            const ULONGLONG now = s_nodes[top].total;
+            for (DWORD a = s_nodes[top].parent; a != kNone && s_nodes[a].known; a = s_nodes[a].parent)
+                s_nodes[a].total = s_nodes[a].total - oldTotal + now;
+        }
+        LeaveCriticalSection(&s_lock);
+    }
+
+    void ApplyChange(const Change& c){
+        char path[512];
+        if (!Norm(c.path.c_str(), path, sizeof(path))) return;
+
+        EnterCriticalSection(&s_lock);
+        if (c.tree){
+            DropTree(Find(path));
+            ParentPath(path);               // the folder that lists it
+        }
+        const DWORD d = path[0] ? Find(path) : kNone;
+        const bool  recompute = d != kNone && s_nodes[d].known;
+        LeaveCriticalSection(&s_lock);
+
+        if (recompute) Compute(d, false);   // unknown folders get computed on demand
+    }
+
+    void WalkWanted(const std::string& want){
+        char path[512];
+        if (!Norm(want.c_str(), path, sizeof(path))) return;
+
+        EnterCriticalSection(&s_lock);
+        if (s_live > kSoftCap) { XBUtil_DebugPrint("SizeService: %u folders memoized, starting over", (unsigned)s_live); Reset(); }
+        DWORD d = Find(path);
+        if (d != kNone && s_nodes[d].known) { LeaveCriticalSection(&s_lock); return; }
+        if (d == kNone){
+            char up[512]; memcpy(up, path, sizeof(up));
+            ParentPath(up);
+            d = NewNode(path, up[0] ? Find(up) : kNone);
+        }
+        LeaveCriticalSection(&s_lock);
+
+        if (GetFileAttributesA(path) == INVALID_FILE_ATTRIBUTES){
+            EnterCriticalSection(&s_lock);
+            DropTree(d);
+            LeaveCriticalSection(&s_lock);
+            return;
+        }
+        const DWORD  t0     = GetTickCount();
+        const size_t before = s_live;
+        Compute(d, true);
+        XBUtil_DebugPrint("SizeService: %s in %lu ms (%u new folders)", path,
+                          (unsigned long)(GetTickCount() - t0), (unsigned)(s_live - before + 1));
+    }
+
+    DWORD WINAPI SizeMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, INFINITE);
+            for (;;){
+                Change      c;
+                std::string want;
+                bool        haveChange = false;
+                EnterCriticalSection(&s_lock);
+                if (s_overflow){
+                    Reset();
+                    s_overflow = false;
+                }
+                if (!s_changes.empty()){
+                    c = s_changes.front();
+                    s_changes.erase(s_changes.begin());
+                    s_current = c;
+                    haveChange = true;
+                } else if (!s_wants.empty() && !JobQueue::Busy()){
+                    want = s_wants.back();
+                    s_wants.pop_back();
+                }
+                const bool waiting = !haveChange && want.empty() && !s_wants.empty();
+                LeaveCriticalSection(&s_lock);
+
+                if (haveChange){
+                    ApplyChange(c);
+                    EnterCriticalSection(&s_lock);
+                    s_current.path.clear();
+                    LeaveCriticalSection(&s_lock);
+                } else if (!want.empty()){
+                    WalkWanted(want);
+                } else if (waiting){
+                    WaitForSingleObject(s_wake, kJobPollMs);   // a job is using the disk
+                } else {
+                    break;
+                }
+            }
+        }
+        return 0;
+    }
+}
+
+namespace SizeService {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    Reset();
+    s_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kSizeStack, SizeMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    SetThreadPriority(s_thread, THREAD_PRIORITY_LOWEST);
+    return true;
+}
+
+bool Get(const char* dir, ULONGLONG& bytes, bool want){
+    char key[512];
+    if (!s_thread || !Norm(dir, key, sizeof(key))) return false;
+
+    EnterCriticalSection(&s_lock);
+    const DWORD i = Find(key);
+    if (i != kNone && s_nodes[i].known && !Pending(key)){
+        bytes = s_nodes[i].total;
+        LeaveCriticalSection(&s_lock);
+        return true;
+    }
+    bool queued = false;
+    if (want){
+        for (size_t k = 0; k < s_wants.size() && !queued; ++k)
+            queued = _stricmp(s_wants[k].c_str(), key) == 0;
+        if (!queued){
+            if (s_wants.size() >= kMaxWants) s_wants.erase(s_wants.begin());   // oldest gives way
+            s_wants.push_back(key);
+        }
+    }
+    LeaveCriticalSection(&s_lock);
+    if (want && !queued) SetEvent(s_wake);
+    return false;
+}
+
+void Changed(const char* path, bool tree){
+    char key[512];
+    if (!s_thread || !Norm(path, key, sizeof(key))) return;
+
+    EnterCriticalSection(&s_lock);
+    if (s_changes.size() >= kMaxChanges){
+        // Too much at once: nothing memoized can be trusted cheaply. The
+        // worker owns the node table, so it does the reset.
+        s_changes.clear();
+        s_overflow = true;
+    } else {
+        Change c; c.path = key; c.tree = tree;
+        s_changes.push_back(c);
+    }
+    LeaveCriticalSection(&s_lock);
+    SetEvent(s_wake);
+}
+
+} // namespace SizeService
@@ -0,0 +1,34 @@
+#ifndef SIZESERVICE_H
+#define SIZESERVICE_H
+/*
+============================================================================
+ SizeService
+  - Folder sizes (bytes of every file below a folder) computed by a
+    low-priority thread and memoized per folder, so the panes can show
+    folder sizes as they become known and "Calculate size" on an
+    unchanged tree is answered at once.
+  - Each memoized folder keeps its own files' bytes and its total; a
+    parent's total is its own bytes plus its subfolders' totals.
+  - Kept exact by our own operations: DirCache forwards every invalidation
+    (Changed). The changed folder is re-listed one level, subfolders that
+    were not touched keep their totals, and the difference is added to
+    every memoized ancestor. Sizes under a queued change read as unknown
+    until it is applied.
+  - Walks wait while a background job runs. Thread-safe.
+============================================================================
+*/
+
+#include <xtl.h>
+
+namespace SizeService {
+    bool Start();
+    // Total bytes below folder 'dir' if known and current. Otherwise false;
+    // with 'want' the folder is queued for computing (newest first).
+    bool Get(const char* dir, ULONGLONG& bytes, bool want);
+    // Same contract as SearchIndex::Changed: folder entries changed
+    // (tree=false), or the item and everything below it (tree=true; a
+    // drive root drops the whole volume).
+    void Changed(const char* path, bool tree);
+}
+
+#endif // SIZESERVICE_H
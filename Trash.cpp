@@ -0,0 +1,137 @@
+#include "Trash.h"
+#include "FsUtil.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <stdio.h>   // _snprintf
+
+/*
+============================================================================
+ Trash (implementation)
+  - Trash entries get unique generated names ("<tick><seq>"); the original
+    name does not matter once the item is gone from view.
+  - The reaper walks every write-capable volume's trash folder, deletes
+    each entry with DeleteTreeA and removes the emptied folder. A
+    rename racing that RemoveDirectoryA simply recreates it and retries.
+  - Kick() sets an auto-reset event; kicks during a pass are coalesced and
+    cause one more pass.
+============================================================================
+*/
+
+namespace {
+    const DWORD kReaperStack = 64 * 1024;
+    const char* kVolumes[]   = { "C:\\", "E:\\", "F:\\", "G:\\", "X:\\", "Y:\\", "Z:\\" };
+
+    HANDLE        s_wake   = NULL;
+    HANDLE        s_thread = NULL;
+    volatile LONG s_busy   = 0;     // 1 while a pass runs
+    volatile LONG s_seq    = 0;     // unique-name counter
+
+    // "X:\$Trash" for the volume of 'path'; false if path has no drive.
+    bool TrashDirFor(const char* path, char* out, size_t cap){
+        if (!path || !path[0] || path[1] != ':') return false;
+        _snprintf(out, cap, "%c:\\%s", path[0], Trash::kDirName);
+        out[cap-1] = 0;
+        return true;
+    }
+
+    // Delete every entry in one trash folder, then the folder itself.
+    unsigned DrainDir(const char* dir){
+        char mask[512]; JoinPath(mask, sizeof(mask), dir, "*");
+        WIN32_FIND_DATAA fd;
+        HANDLE h = FindFirstFileA(mask, &fd);
+        if (h == INVALID_HANDLE_VALUE) return 0;
+
+        unsigned n = 0;
+        do{
+            if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
+            char sub[512]; JoinPath(sub, sizeof(sub), dir, fd.cFileName);
+            DeleteError de;
+            if (DeleteTreeA(sub, &de)) ++n;
+            else XBUtil_DebugPrint("Trash: could not delete %s (err=%lu)", de.path[0] ? de.path : sub,
+                                   (unsigned long)GetLastError());
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+
+        SetFileAttributesA(dir, FILE_ATTRIBUTE_NORMAL);
+        RemoveDirectoryA(dir);   // fails harmlessly if something new arrived
+        return n;
+    }
+
+    DWORD WINAPI ReaperMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, INFINITE);
+            InterlockedExchange(&s_busy, 1);
+
+            const DWORD t0 = GetTickCount();
+            unsigned n = 0;
+            for (size_t i = 0; i < sizeof(kVolumes)/sizeof(kVolumes[0]); ++i){
+                char dir[16];
+                if (!TrashDirFor(kVolumes[i], dir, sizeof(dir))) continue;
+                if (GetFileAttributesA(dir) == INVALID_FILE_ATTRIBUTES) continue;
+                n += DrainDir(dir);
+            }
+            if (n) XBUtil_DebugPrint("Trash: reaped %u item(s) in %lu ms", n, (unsigned long)(GetTickCount() - t0));
+
+            InterlockedExchange(&s_busy, 0);
+        }
+        return 0;
+    }
+}
+
+namespace Trash {
+
+const char kDirName[] = "$Trash";
+
+bool Start(){
+    if (s_thread) return true;
+
+    s_wake = CreateEvent(NULL, FALSE, TRUE, NULL);   // signaled: purge leftovers now
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kReaperStack, ReaperMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    // Below the job worker: deleting the trash is never urgent.
+    SetThreadPriority(s_thread, THREAD_PRIORITY_LOWEST);
+    return true;
+}
+
+bool MoveToTrashA(const char* path){
+    if (!s_thread) { SetLastError(ERROR_NOT_READY); return false; }   // nobody would empty it
+    if (!path || !path[0] || IsDriveRoot(path)) { SetLastError(ERROR_ACCESS_DENIED); return false; }
+
+    char dir[16];
+    if (!TrashDirFor(path, dir, sizeof(dir))) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+
+    // Never trash the trash itself (or anything already in it)
+    const size_t dl = strlen(dir);
+    if (_strnicmp(path, dir, dl) == 0 && (path[dl] == 0 || path[dl] == '\\')){
+        SetLastError(ERROR_ACCESS_DENIED);
+        return false;
+    }
+
+    char dst[64];
+    _snprintf(dst, sizeof(dst), "%s\\%08lX%04lX", dir, (unsigned long)GetTickCount(),
+              (unsigned long)(InterlockedIncrement(&s_seq) & 0xFFFF));
+    dst[sizeof(dst)-1] = 0;
+
+    // The reaper may remove an emptied trash folder at any moment: retry once
+    for (int attempt = 0; attempt < 2; ++attempt){
+        if (CreateDirectoryA(dir, NULL))
+            SetFileAttributesA(dir, FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_HIDDEN);
+        if (MoveFileA(path, dst)) return true;
+        if (GetFileAttributesA(dir) != INVALID_FILE_ATTRIBUTES) break;   // real failure
+    }
+    return false;
+}
+
+void Kick(){
+    if (s_wake) SetEvent(s_wake);
+}
+
+bool Busy(){
+    return s_busy != 0;
+}
+
+} // namespace Trash
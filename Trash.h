@@ -0,0 +1,34 @@
+#ifndef TRASH_H
+#define TRASH_H
+/*
+============================================================================
+ Trash
+  - Instant delete: items are renamed into a hidden "$Trash" folder at the
+    root of their own volume (same-volume MoveFileA, no data touched) and
+    the pane can refresh right away.
+  - A low-priority reaper thread deletes whatever sits in the trash folders.
+    It runs once at start, which also purges anything a crash or power
+    loss left behind, and again whenever Kick() is called.
+  - Thread-safe: MoveToTrashA/Kick may be called from any thread.
+============================================================================
+*/
+
+#include <xtl.h>
+
+namespace Trash {
+    // Name of the per-volume trash folder (hidden from listings).
+    extern const char kDirName[];
+
+    // Start the reaper (first pass purges leftovers). Call once.
+    bool Start();
+    // Rename 'path' into its volume's trash. False if it cannot be renamed
+    // (read-only volume, drive root, name collision...); caller falls back
+    // to a real delete.
+    bool MoveToTrashA(const char* path);
+    // Wake the reaper after one or more MoveToTrashA calls.
+    void Kick();
+    // True while the reaper has work queued or in progress.
+    bool Busy();
+}
+
+#endif // TRASH_H
@@ -0,0 +1,148 @@
+#include "VolumeInfo.h"
+#include "FsUtil.h"
+#include "DebugPrint.h"
+
+#include <string.h>
+#include <ctype.h>
+
+/*
+============================================================================
+ VolumeInfo (implementation)
+  - One slot per drive letter. A slot is refreshed only once something has
+    asked for it ('used'), then every kRefreshMs, or right away when dirty.
+  - The syscalls happen outside the lock; results are copied in at the end.
+============================================================================
+*/
+
+namespace {
+    const DWORD kVolStack  = 64 * 1024;
+    const DWORD kRefreshMs = 5000;
+
+    struct Slot {
+        VolumeInfo::Info info;
+        bool  used;       // someone asked: keep it fresh
+        bool  known;      // read at least once
+        bool  dirty;      // refresh now
+        DWORD stamp;      // last refresh (GetTickCount)
+    };
+
+    CRITICAL_SECTION s_lock;
+    HANDLE           s_wake   = NULL;
+    HANDLE           s_thread = NULL;
+    Slot             s_vol[26];
+
+    int SlotOf(const char* p){
+        if (!p || !p[0] || p[1] != ':') return -1;
+        const int c = toupper((unsigned char)p[0]);
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : -1;
+    }
+
+    void Refresh(int v){
+        const char root[4] = { (char)('A' + v), ':', '\\', 0 };
+
+        EnterCriticalSection(&s_lock);
+        VolumeInfo::Info in = s_vol[v].info;
+        const bool wasPresent = s_vol[v].known && in.present;
+        LeaveCriticalSection(&s_lock);
+
+        in.present = GetFileAttributesA(root) != INVALID_FILE_ATTRIBUTES;
+        if (!in.present){
+            ZeroMemory(&in, sizeof(in));
+        } else {
+            GetDriveFreeTotal(root, in.freeBytes, in.totalBytes);
+            if (!wasPresent){
+                // New (or returning) volume: the slow, writing probe once
+                const bool dvd = (v == 'D' - 'A');
+                in.clusterBytes = dvd ? 0 : XGetDiskClusterSize(root);
+                in.writable     = !dvd && CanWriteHereA(root);
+                XBUtil_DebugPrint("VolumeInfo: %s cluster %lu, %s", root,
+                                  (unsigned long)in.clusterBytes, in.writable ? "writable" : "read-only");
+            }
+        }
+
+        EnterCriticalSection(&s_lock);
+        s_vol[v].info  = in;
+        s_vol[v].known = true;
+        s_vol[v].stamp = GetTickCount();
+        LeaveCriticalSection(&s_lock);
+    }
+
+    DWORD WINAPI VolMain(LPVOID){
+        for (;;){
+            WaitForSingleObject(s_wake, kRefreshMs);
+            for (int v = 0; v < 26; ++v){
+                EnterCriticalSection(&s_lock);
+                const bool due = s_vol[v].used &&
+                                 (s_vol[v].dirty || !s_vol[v].known ||
+                                  GetTickCount() - s_vol[v].stamp >= kRefreshMs);
+                s_vol[v].dirty = false;
+                LeaveCriticalSection(&s_lock);
+                if (due) Refresh(v);
+            }
+        }
+        return 0;
+    }
+}
+
+namespace VolumeInfo {
+
+bool Start(){
+    if (s_thread) return true;
+
+    InitializeCriticalSection(&s_lock);
+    ZeroMemory(s_vol, sizeof(s_vol));
+    s_wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (!s_wake) return false;
+
+    s_thread = CreateThread(NULL, kVolStack, VolMain, NULL, 0, NULL);
+    if (!s_thread) { CloseHandle(s_wake); s_wake = NULL; return false; }
+
+    SetThreadPriority(s_thread, THREAD_PRIORITY_LOWEST);
+    return true;
+}
+
+bool Get(const char* anyPath, Info& out){
+    ZeroMemory(&out, sizeof(out));
+    const int v = SlotOf(anyPath);
+    if (v < 0 || !s_thread) return false;
+
+    EnterCriticalSection(&s_lock);
+    const bool known = s_vol[v].known;
+    const bool first = !s_vol[v].used;
+    if (known) out = s_vol[v].info;
+    s_vol[v].used = true;
+    LeaveCriticalSection(&s_lock);
+
+    if (first) SetEvent(s_wake);
+    return known;
+}
+
+void GetFreeTotal(const char* anyPath, ULONGLONG& freeBytes, ULONGLONG& totalBytes){
+    Info in;
+    Get(anyPath, in);
+    freeBytes  = in.freeBytes;
+    totalBytes = in.totalBytes;
+}
+
+bool CanWrite(const char* dir){
+    Info in;
+    if (!Get(dir, in)) return CanWriteHereA(dir);
+
+    if (!in.present || !DirExistsA(dir)) { SetLastError(ERROR_PATH_NOT_FOUND); return false; }
+    if (!in.writable)                    { SetLastError(ERROR_WRITE_PROTECT);  return false; }
+    return true;
+}
+
+void Touch(const char* anyPath){
+    const int v = SlotOf(anyPath);
+    if (v < 0 || !s_thread) return;
+
+    EnterCriticalSection(&s_lock);
+    const bool wake = s_vol[v].used;
+    s_vol[v].dirty = true;
+    LeaveCriticalSection(&s_lock);
+
+    if (wake) SetEvent(s_wake);
+}
+
+} // namespace VolumeInfo
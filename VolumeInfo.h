@@ -0,0 +1,42 @@
+#ifndef VOLUMEINFO_H
+#define VOLUMEINFO_H
+/*
+============================================================================
+ VolumeInfo
+  - Per-volume free / total space, cluster size and writability kept in
+    memory, so the drive list, footer and action checks never touch the
+    disk on the UI thread.
+  - A low-priority thread refreshes the volumes that have been asked for:
+    on a timer, and at once after Touch (DirCache forwards every
+    invalidation, i.e. our own writes and media changes).
+  - Writability is probed once when a volume shows up (D: is never
+    writable); cluster size likewise.
+  - Thread-safe.
+============================================================================
+*/
+
+#include <xtl.h>
+
+namespace VolumeInfo {
+    struct Info {
+        bool      present;
+        bool      writable;
+        ULONGLONG freeBytes;     // D: reports 0 / bytes used (GetDriveFreeTotal)
+        ULONGLONG totalBytes;
+        DWORD     clusterBytes;  // 0 if unknown
+    };
+
+    bool Start();
+    // Last known state of the volume holding 'anyPath'. False (and 'out'
+    // zeroed) until it has been read once; asking queues the read.
+    bool Get(const char* anyPath, Info& out);
+    // GetDriveFreeTotal from memory (0 / 0 until known).
+    void GetFreeTotal(const char* anyPath, ULONGLONG& freeBytes, ULONGLONG& totalBytes);
+    // CanWriteHereA from memory: 'dir' exists and its volume is writable.
+    // Probes directly while the volume is not known yet. Sets last error.
+    bool CanWrite(const char* dir);
+    // Something on this volume changed: refresh it soon. Any thread.
+    void Touch(const char* anyPath);
+}
+
+#endif // VOLUMEINFO_H
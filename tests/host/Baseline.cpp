@@ -0,0 +1,326 @@
+/*
+============================================================================
+ Baseline (see Baseline.h)
+============================================================================
+*/
+
+#include "Baseline.h"
+#include "FsUtil.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <algorithm>
+
+#ifndef FILE_READ_ONLY_VOLUME
+#define FILE_READ_ONLY_VOLUME 0x00080000u  // for GetVolumeInformationA
+#endif
+
+namespace Baseline {
+
+// ============================================================================
+// Copy (chunked) + recursive copy with progress/cancel
+//  - 64 KiB fixed buffer (predictable RAM use on Xbox)
+//  - Normalizes dest attributes before overwrite
+//  - Progress callback may cancel; on cancel we delete the partial output
+// ============================================================================
+
+static bool CopyFileChunkedA(const char* s, const char* d,
+                             ULONGLONG& inoutBytesDone, ULONGLONG totalBytes)
+{
+    // Open source (read-only, allow readers to share)
+    HANDLE hs = CreateFileA(s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hs == INVALID_HANDLE_VALUE) return false;
+
+    // Preflight dest: directory collision -> error; else clear R/O etc.
+    DWORD da = GetFileAttributesA(d);
+    if (da != INVALID_FILE_ATTRIBUTES) {
+        if (da & FILE_ATTRIBUTE_DIRECTORY) {
+            CloseHandle(hs);
+            SetLastError(ERROR_ALREADY_EXISTS);
+            return false;
+        }
+        DWORD na = da & ~(FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN);
+        if (na != da) SetFileAttributesA(d, na);
+    }
+
+    // Create/overwrite dest (no sharing)
+    HANDLE hd = CreateFileA(d, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hd == INVALID_HANDLE_VALUE){ CloseHandle(hs); return false; }
+
+    const DWORD BUFSZ = 64 * 1024;
+    char* buf = (char*)LocalAlloc(LMEM_FIXED, BUFSZ);
+    if (!buf){ CloseHandle(hs); CloseHandle(hd); return false; }
+
+    bool ok = true;
+    for (;;){
+        DWORD rd = 0;
+        if (!ReadFile(hs, buf, BUFSZ, &rd, NULL)) { ok = false; break; }
+        if (rd == 0) break;
+
+        DWORD wr = 0;
+        if (!WriteFile(hd, buf, rd, &wr, NULL)) { ok = false; break; }
+
+        inoutBytesDone += wr;
+
+        // Progress/cancel callback
+        if (CopyProgress::g_copyProgFn){
+            if (!CopyProgress::g_copyProgFn(inoutBytesDone, totalBytes, s, CopyProgress::g_copyProgUser)){
+                ok = false; break; // canceled
+            }
+        }
+    }
+
+    LocalFree(buf);
+    CloseHandle(hs);
+    CloseHandle(hd);
+
+    // Normalize dest; on failure, remove partial
+    if (!ok) { DeleteFileA(d); }
+    else     { SetFileAttributesA(d, FILE_ATTRIBUTE_NORMAL); }
+    return ok;
+}
+
+// Core recursive copy: directory creation + per-file copy.
+static bool CopyRecursiveCoreA(const char* srcPath, const char* dstDir,
+                               ULONGLONG& inoutBytesDone, ULONGLONG totalBytes)
+{
+    DWORD a = GetFileAttributesA(srcPath);
+    if (a == INVALID_FILE_ATTRIBUTES) return false;
+
+    const char* base = strrchr(srcPath, '\\'); base = base ? base+1 : srcPath;
+    char dstPath[512]; JoinPath(dstPath, sizeof(dstPath), dstDir, base);
+
+    if (a & FILE_ATTRIBUTE_DIRECTORY){
+        if (!EnsureDirA(dstPath)) return false;
+
+        // Do NOT preserve source dir attributes
+        SetFileAttributesA(dstPath, FILE_ATTRIBUTE_NORMAL);
+
+        char mask[512]; JoinPath(mask, sizeof(mask), srcPath, "*");
+        WIN32_FIND_DATAA fd; HANDLE h = FindFirstFileA(mask, &fd);
+        if (h != INVALID_HANDLE_VALUE){
+            do{
+                if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
+                char subSrc[512]; JoinPath(subSrc, sizeof(subSrc), srcPath, fd.cFileName);
+                if (!CopyRecursiveCoreA(subSrc, dstPath, inoutBytesDone, totalBytes))
+                    { FindClose(h); return false; }
+            }while (FindNextFileA(h,&fd));
+            FindClose(h);
+        }
+        return true;
+    } else {
+        return CopyFileChunkedA(srcPath, dstPath, inoutBytesDone, totalBytes);
+    }
+}
+
+// Helpers to detect "copy into own subfolder" (case-insensitive).
+static void NormalizeSlashEnd(char* s, size_t cap) {
+    size_t n = strlen(s);
+    if (n && s[n-1] != '\\' && n+1 < cap) { s[n] = '\\'; s[n+1] = 0; }
+}
+static bool IsSubPathCI(const char* parent, const char* child) {
+    char p[512], c[512];
+    _snprintf(p, sizeof(p), "%s", parent); p[sizeof(p)-1]=0; NormalizeSlashEnd(p, sizeof(p));
+    _snprintf(c, sizeof(c), "%s", child ); c[sizeof(c)-1]=0; NormalizeSlashEnd(c, sizeof(c));
+    return _strnicmp(p, c, strlen(p)) == 0;
+}
+
+// Public entry for recursive copy with progress and a safety check.
+bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
+                                ULONGLONG totalBytes)
+{
+    // Compute dstTop = dstDir\basename(srcPath)
+    const char* base = strrchr(srcPath, '\\'); base = base ? base+1 : srcPath;
+    char dstTop[512]; JoinPath(dstTop, sizeof(dstTop), dstDir, base);
+
+    // Guard: prevent copying into own subfolder
+    if (IsSubPathCI(srcPath, dstTop)) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+
+    // Optional free-space preflight (skip if unknown)
+    if (totalBytes > 0) {
+        ULONGLONG freeB=0, totalB=0;
+        GetDriveFreeTotal(dstDir, freeB, totalB);
+        if (freeB > 0 && freeB < totalBytes) { SetLastError(ERROR_DISK_FULL); return false; }
+    }
+
+    ULONGLONG done = 0;
+    return CopyRecursiveCoreA(srcPath, dstDir, done, totalBytes);
+}
+
+// ============================================================================
+// Recursive delete
+// ============================================================================
+
+// Remove READONLY/SYSTEM/HIDDEN so we can delete/overwrite stubborn files.
+static inline void StripROSysHiddenA(const char* path){
+    DWORD a = GetFileAttributesA(path);
+    if (a == INVALID_FILE_ATTRIBUTES) return;
+    DWORD na = a & ~(FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_HIDDEN);
+    if (na != a) SetFileAttributesA(path, na);
+}
+
+// If GetVolumeInformationA fails, treat D:\ (DVD) as read-only to be safe.
+static bool IsReadOnlyVolumeA(const char* path){
+    if (!path || !path[0]) return false;
+    char root[4]; _snprintf(root, sizeof(root), "%c:\\", (char)toupper((unsigned char)path[0])); root[sizeof(root)-1]=0;
+    DWORD fsFlags = 0;
+    if (GetVolumeInformationA(root, NULL, 0, NULL, NULL, &fsFlags, NULL, 0))
+        return (fsFlags & FILE_READ_ONLY_VOLUME) != 0;
+    return (root[0] == 'D'); // OG Xbox DVD (CDFS)
+}
+
+// Recursively delete with safety rails:
+//  - Refuses drive roots
+//  - Refuses read-only volumes (CDFS / cache)
+//  - Clears READONLY/SYSTEM/HIDDEN before delete
+//  - Continues on child failures; tiny retry on RemoveDirectoryA
+bool DeleteRecursiveA(const char* path){
+    if (!path || !path[0]) { SetLastError(ERROR_INVALID_PARAMETER); return false; }
+    if (IsDriveRoot(path)) { SetLastError(ERROR_ACCESS_DENIED);     return false; }
+    if (IsReadOnlyVolumeA(path)) { SetLastError(ERROR_WRITE_PROTECT); return false; }
+
+    DWORD a = GetFileAttributesA(path);
+    if (a == INVALID_FILE_ATTRIBUTES) { SetLastError(ERROR_FILE_NOT_FOUND); return false; }
+
+    // Make the target itself writable so final delete can succeed.
+    StripROSysHiddenA(path);
+
+    if (a & FILE_ATTRIBUTE_DIRECTORY){
+        // Enumerate children
+        char mask[512]; JoinPath(mask, sizeof(mask), path, "*");
+        WIN32_FIND_DATAA fd; HANDLE h = FindFirstFileA(mask, &fd);
+        if (h != INVALID_HANDLE_VALUE){
+            do{
+                if (!strcmp(fd.cFileName,".") || !strcmp(fd.cFileName,"..")) continue;
+
+                char sub[512]; JoinPath(sub, sizeof(sub), path, fd.cFileName);
+
+                // Clear attributes on each child before deleting
+                StripROSysHiddenA(sub);
+
+                // Best-effort delete; continue on failure
+                if (!DeleteRecursiveA(sub)){
+                    // Optionally capture first error here
+                }
+            } while (FindNextFileA(h, &fd));
+            FindClose(h);
+        }
+
+        // Try removing the (now empty) directory (with a tiny retry)
+        if (!RemoveDirectoryA(path)){
+            Sleep(1);
+            StripROSysHiddenA(path);
+            return RemoveDirectoryA(path) ? true : false;
+        }
+        return true;
+    }else{
+        // File: clear attributes then delete (retry once)
+        if (!DeleteFileA(path)){
+            StripROSysHiddenA(path);
+            return DeleteFileA(path) ? true : false;
+        }
+        return true;
+    }
+}
+
+// Sort helpers of the old lister
+static inline int ci_cmp(const char* a,const char* b){ return _stricmp(a,b); }
+
+bool ItemLess(const Item& a,const Item& b){
+    if(a.isDir!=b.isDir) return a.isDir>b.isDir;
+    return ci_cmp(a.name,b.name)<0;
+}
+
+// ============================================================================
+// Directory listing
+//  - Prepends a synthetic ".." entry for non-root folders.
+//  - Sorts (dirs first, then by name) while keeping the ".." at index 0.
+// ============================================================================
+bool ListDirectory(const char* path,std::vector<Item>& out){
+    out.clear();
+
+    // For non-root, push ".." to allow going up.
+    if(strlen(path)>3){
+        Item up; ZeroMemory(&up,sizeof(up));
+        strncpy(up.name,"..",3); up.isDir=true; up.size=0; up.isUpEntry=true; up.marked=false; out.push_back(up);
+    }
+
+    char base[512]; _snprintf(base,sizeof(base),"%s",path); base[sizeof(base)-1]=0; EnsureTrailingSlash(base,sizeof(base));
+    char mask[512]; _snprintf(mask,sizeof(mask),"%s*",base); mask[sizeof(mask)-1]=0;
+
+    WIN32_FIND_DATAA fd; ZeroMemory(&fd,sizeof(fd));
+    HANDLE h=FindFirstFileA(mask,&fd); if(h==INVALID_HANDLE_VALUE) return false;
+    do{
+        const char* n=fd.cFileName; if(!strcmp(n,".")||!strcmp(n,"..")) continue;
+        Item it; ZeroMemory(&it,sizeof(it));
+        strncpy(it.name,n,255); it.name[255]=0;
+        it.isDir=(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)!=0;
+        it.size=(((ULONGLONG)fd.nFileSizeHigh)<<32)|fd.nFileSizeLow; it.isUpEntry=false; it.marked=false;
+        out.push_back(it);
+    }while(FindNextFileA(h,&fd));
+    FindClose(h);
+
+    size_t start=(strlen(path)>3)?1:0; // keep ".." in place
+    if(out.size()>start+1) std::sort(out.begin()+(int)start,out.end(),ItemLess);
+    return true;
+}
+
+// ============================================================================
+// Drive free/total with the DVD used-size walk (before the serial-keyed cache)
+// ============================================================================
+
+// DVD size cache (expensive to recompute on CDFS; keyed by volume serial)
+static DWORD      g_dvdSerialCache = 0xFFFFFFFFu;  // 0xFFFFFFFF => unknown
+static ULONGLONG  g_dvdUsedCache   = 0;            // bytes used on the disc
+static ULONGLONG  g_dvdTotalCache  = 0;            // disc capacity (for reference)
+
+void DvdInvalidateSizeCache(){
+    g_dvdSerialCache = 0xFFFFFFFFu;
+    g_dvdUsedCache   = 0;
+    g_dvdTotalCache  = 0;
+}
+
+// For normal drives, we return true "free / total".
+// For D:, CDFS reports "free=0". To match the UI label "Free / Total" and avoid
+// confusion, we intentionally return "0 / <used_on_disc>" for DVDs.
+// We recompute <used_on_disc> only when the volume serial changes.
+void GetDriveFreeTotal(const char* anyPathInDrive,
+                       ULONGLONG& freeBytes, ULONGLONG& totalBytes)
+{
+    freeBytes = 0; totalBytes = 0;
+    if (!anyPathInDrive || !anyPathInDrive[0]) return;
+
+    const char letter = (char)toupper((unsigned char)anyPathInDrive[0]);
+
+    if (letter == 'D') {
+        // If D:\ is gone, leave 0/0.
+        if (GetFileAttributesA("D:\\") == INVALID_FILE_ATTRIBUTES) return;
+
+        DWORD serial = 0xFFFFFFFF;
+        GetVolumeInformationA("D:\\", NULL, 0, &serial, NULL, NULL, NULL, 0);
+
+        if (serial != g_dvdSerialCache) {
+            // Disc changed (or first time)  recompute and cache
+            ULARGE_INTEGER a, t, f; a.QuadPart = t.QuadPart = f.QuadPart = 0;
+            GetDiskFreeSpaceExA("D:\\", &a, &t, &f);   // capacity of media
+            g_dvdTotalCache  = t.QuadPart;             // kept for reference
+            g_dvdUsedCache   = DirSizeRecursiveA("D:\\");
+            g_dvdSerialCache = serial;
+        }
+
+        // "Free / Total"   =>   "0 / <used>"
+        freeBytes  = 0;
+        totalBytes = g_dvdUsedCache;
+        return;
+    }
+
+    // Normal drives: true free/total via GetDiskFreeSpaceExA
+    char root[8]; _snprintf(root, sizeof(root), "%c:\\", letter); root[sizeof(root)-1]=0;
+    ULARGE_INTEGER a, t, f; a.QuadPart = t.QuadPart = f.QuadPart = 0;
+    if (GetDiskFreeSpaceExA(root, &a, &t, &f)) { freeBytes = f.QuadPart; totalBytes = t.QuadPart; }
+}
+
+} // namespace Baseline
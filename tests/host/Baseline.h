@@ -0,0 +1,48 @@
+#ifndef BASELINE_H
+#define BASELINE_H
+/*
+============================================================================
+ Baseline
+  - The code paths the benchmarks compare against, as they were before the
+    change being measured (taken from the first commit of FsUtil.cpp).
+    Kept verbatim apart from the namespace, so "before" numbers run the
+    old algorithm over the same shimmed calls as the new one.
+============================================================================
+*/
+
+#include <xtl.h>
+#include <vector>
+
+namespace Baseline {
+
+// Serial ReadFile -> WriteFile loop over one 64 KiB LocalAlloc buffer per
+// file; FindFirstFileA walk per folder. Same progress callback contract.
+bool CopyRecursiveWithProgressA(const char* srcPath, const char* dstDir,
+                                ULONGLONG totalBytes);
+
+// Recursion with a 512-byte path per level; attributes probed and cleared
+// per child in the parent loop and again inside the call.
+bool DeleteRecursiveA(const char* path);
+
+// Pane entry before Listing: fixed name buffer, one struct per row.
+struct Item {
+    char        name[256];   // File/dir name or drive-root (e.g. "E:\")
+    bool        isDir;       // True if directory (incl. drive roots and "..")
+    ULONGLONG   size;        // File size (0 for dirs/roots/"..")
+    bool        isUpEntry;   // True only for synthetic ".." row
+    bool        marked;      // UI mark flag
+};
+// Dirs first, then _stricmp on every comparison.
+bool ItemLess(const Item& a, const Item& b);
+bool ListDirectory(const char* path, std::vector<Item>& out);
+
+// D: reports "0 / used", the disc walked with DirSizeRecursiveA whenever
+// the volume serial differs from the one cached here; other drives
+// GetDiskFreeSpaceExA. DvdInvalidateSizeCache is what a remount did.
+void GetDriveFreeTotal(const char* anyPathInDrive,
+                       ULONGLONG& freeBytes, ULONGLONG& totalBytes);
+void DvdInvalidateSizeCache();
+
+} // namespace Baseline
+
+#endif // BASELINE_H
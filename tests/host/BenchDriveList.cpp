@@ -0,0 +1,126 @@
+/*
+============================================================================
+ BenchDriveList
+  - Volume syscalls per rendered frame with both panes on the drive list
+    (C, D, E, F, G). The frame makes the renderer's calls: per pane, the
+    size-column width pass and the row pass each ask every drive for
+    free / total. Before: the old GetDriveFreeTotal (Baseline; disc walk
+    on the first frame only). After: VolumeInfo::GetFreeTotal.
+  - Frames run at 60 Hz for longer than a VolumeInfo refresh (about 10 s:
+    the 5 s timer wait and the 5 s staleness check run in phase);
+    every shimmed call in that window is counted (the worker's included)
+    and divided by the frame count. Longest UI frame is reported too.
+  - "Dest not writable" checks: CanWriteHereA (create + delete probe)
+    against VolumeInfo::CanWrite, and a write of ours (Touch via
+    DirCache) shows up in the free space without waiting for the timer.
+
+   BenchDriveList [--frames 720] [--op-us 500]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "Baseline.h"
+#include "DirCache.h"
+#include "FsUtil.h"
+#include "VolumeInfo.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* const kDrives[] = { "C:\\", "D:\\", "E:\\", "F:\\", "G:\\" };
+static const int         kDriveCount = 5;
+
+struct Run {
+    double maxFrameMs;
+    DWORD  calls[HostFs::kCallCount];
+    DWORD  total;
+};
+
+static void Frame(bool current){
+    for (int pane = 0; pane < 2; ++pane)
+        for (int pass = 0; pass < 2; ++pass)          // ComputeSizeColW, rows
+            for (int d = 0; d < kDriveCount; ++d){
+                ULONGLONG fb = 0, tb = 0;
+                if (current) VolumeInfo::GetFreeTotal(kDrives[d], fb, tb);
+                else         Baseline::GetDriveFreeTotal(kDrives[d], fb, tb);
+            }
+}
+
+static Run Frames(bool current, DWORD frames){
+    Frame(current);   // first frame: disc walk (before), first reads queued (after)
+    usleep(100000);
+    HostFs::ResetCounters();
+    Run r; ZeroMemory(&r, sizeof(r));
+    for (DWORD i = 0; i < frames; ++i){
+        const double t0 = HostFs::NowMs();
+        Frame(current);
+        const double ms = HostFs::NowMs() - t0;
+        if (ms > r.maxFrameMs) r.maxFrameMs = ms;
+        usleep(16667);
+    }
+    for (int c = 0; c < HostFs::kCallCount; ++c) r.calls[c] = HostFs::Count((HostFs::Call)c);
+    r.total = HostFs::FileCalls();
+    return r;
+}
+
+int main(int argc, char** argv){
+    const DWORD frames = HostTest::ArgU(argc, argv, "--frames", 720);
+    const DWORD opUs   = HostTest::ArgU(argc, argv, "--op-us", 500);
+
+    HostTest::FreshRoot("BenchDriveList", "CDEFG");
+    HostTest::MakeTree("D:\\Disc", 4, 10, 1000);
+    HostFs::EnableFatx('E', 1024ull << 20, 16384);
+    HostFs::Device dev = { 0, 0, opUs, 0, 0 };
+    for (int d = 0; d < kDriveCount; ++d) HostFs::SetDevice(kDrives[d][0], dev);
+    CHECK(VolumeInfo::Start());
+
+    const Run before = Frames(false, frames);
+    const Run after  = Frames(true, frames);
+
+    printf("%u frames, both panes on the drive list (%d drives), %u us per volume call\n",
+           (unsigned)frames, kDriveCount, (unsigned)opUs);
+    printf("                          before      after\n");
+    printf("  calls / frame       %10.2f %10.3f\n", (double)before.total / frames, (double)after.total / frames);
+    for (int c = 0; c < HostFs::kCallCount; ++c){
+        if (!before.calls[c] && !after.calls[c]) continue;
+        printf("    %-20s %8u %10u\n", HostFs::CallName((HostFs::Call)c),
+               (unsigned)before.calls[c], (unsigned)after.calls[c]);
+    }
+    printf("  longest UI frame %10.2f %10.3f ms\n", before.maxFrameMs, after.maxFrameMs);
+
+    // 2 panes x 2 passes x (4 x GetDiskFreeSpaceEx + D: attributes + volume info)
+    CHECK(before.total == frames * 24);
+    CHECK(after.total * 100 < before.total);
+
+    // Destination checks
+    HostFs::ResetCounters();
+    CHECK(CanWriteHereA("E:\\"));
+    const DWORD probe = HostFs::FileCalls();
+    HostFs::ResetCounters();
+    CHECK(VolumeInfo::CanWrite("E:\\"));
+    const DWORD cached = HostFs::FileCalls();
+    printf("  dest check calls    %10u %10u\n", (unsigned)probe, (unsigned)cached);
+    CHECK(cached < probe && HostFs::Count(HostFs::kCreateFile) == 0);
+    CHECK(!VolumeInfo::CanWrite("D:\\Disc") && GetLastError() == ERROR_WRITE_PROTECT);
+    CHECK(!VolumeInfo::CanWrite("E:\\Missing") && GetLastError() == ERROR_PATH_NOT_FOUND);
+
+    // A write of ours: free space follows without waiting for the timer
+    ULONGLONG free0 = 0, total = 0, free1 = 0;
+    VolumeInfo::GetFreeTotal("E:\\", free0, total);
+    HANDLE h = CreateFileA("E:\\Big.bin", GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    CHECK(h != INVALID_HANDLE_VALUE);
+    CHECK(SetFilePointer(h, 64 << 20, NULL, FILE_BEGIN) == (DWORD)(64 << 20) && SetEndOfFile(h));
+    CloseHandle(h);
+    const double t0 = HostFs::NowMs();
+    DirCache::Invalidate("E:\\");
+    do {
+        usleep(1000);
+        VolumeInfo::GetFreeTotal("E:\\", free1, total);
+        CHECK(HostFs::NowMs() - t0 < 4000);
+    } while (free1 == free0);
+    printf("  free space after a 64 MB write: updated in %.1f ms (%llu -> %llu MB)\n", HostFs::NowMs() - t0,
+           (unsigned long long)(free0 >> 20), (unsigned long long)(free1 >> 20));
+    CHECK(free0 - free1 == 64ull << 20);
+    return 0;
+}
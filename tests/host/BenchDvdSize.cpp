@@ -0,0 +1,146 @@
+/*
+============================================================================
+ BenchDvdSize
+  - Disc insert on a slow CDFS D: (seek per open / find, cost per entry).
+    Before: the insert handler ran the old GetDriveFreeTotal (walks the
+    disc when the serial changed) and DirSizeRecursiveA (walks it again)
+    on the UI thread. After: BeginDvdStats / PumpDvdSize as in
+    FileBrowserApp - the serial-keyed cache on T:, else SizeService walks
+    the disc once on its thread while the frame loop polls.
+  - Reports UI time blocked by the insert (longest frame after) and time
+    until the used size is known, plus the D: finds.
+  - Re-inserting a known disc is answered from T:\DvdSizes.dat with no
+    D: access; another disc is walked; the file keeps the 64 most recent
+    discs.
+
+   BenchDvdSize [--dirs 40] [--files 50] [--op-ms 20] [--entry-us 300]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "Baseline.h"
+#include "DirCache.h"
+#include "FsUtil.h"
+#include "JobQueue.h"
+#include "SizeService.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+static const double kFrameMs = 16.0;
+
+struct Insert { double blockedMs, knownMs; DWORD finds; ULONGLONG used; bool walked; };
+
+// Old handler: everything inline in FrameMove.
+static Insert InsertBefore(){
+    DvdColdRemount();
+    Baseline::DvdInvalidateSizeCache();   // the old DvdMap_Io did this
+    HostFs::ResetCounters();
+    Insert r;
+    const double t0 = HostFs::NowMs();
+    DWORD serial = 0;
+    CHECK(GetDvdVolumeSerial(&serial));
+    ULONGLONG fb = 0, tb = 0;
+    Baseline::GetDriveFreeTotal("D:\\", fb, tb);
+    r.used      = DirSizeRecursiveA("D:\\");
+    r.blockedMs = r.knownMs = HostFs::NowMs() - t0;
+    r.finds     = HostFs::Count(HostFs::kFindFirstFile);
+    r.walked    = true;
+    CHECK(tb == r.used);
+    return r;
+}
+
+// BeginDvdStats, then PumpDvdSize once per frame until the size is known.
+static Insert InsertAfter(){
+    DvdColdRemount();
+    HostFs::ResetCounters();
+    Insert r;
+    r.blockedMs = 0;
+    const double t0 = HostFs::NowMs();
+    DWORD serial = 0xFFFFFFFF;
+    CHECK(GetDvdVolumeSerial(&serial));
+    ULONGLONG used = 0;
+    r.walked = !DvdGetUsedBytes(serial, used);
+    DirCache::InvalidateVolume('D');
+    r.blockedMs = HostFs::NowMs() - t0;
+
+    while (r.walked){
+        usleep((useconds_t)(kFrameMs * 1000));
+        const double f0 = HostFs::NowMs();
+        const bool known = SizeService::Get("D:\\", used, true);
+        const double f = HostFs::NowMs() - f0;
+        if (f > r.blockedMs) r.blockedMs = f;
+        if (known) { DvdSetUsedBytes(serial, used); break; }
+        CHECK(HostFs::NowMs() - t0 < 120000);
+    }
+    r.knownMs = HostFs::NowMs() - t0;
+    r.finds   = HostFs::Count(HostFs::kFindFirstFile);
+    r.used    = used;
+
+    ULONGLONG fb = 1, tb = 0;
+    GetDriveFreeTotal("D:\\", fb, tb);   // what the drive list shows
+    CHECK(fb == 0 && tb == used);
+    return r;
+}
+
+static void Print(const char* what, const Insert& r){
+    printf("  %-22s %9.1f %11.1f %9u  %s\n", what, r.blockedMs, r.knownMs, (unsigned)r.finds,
+           r.walked ? "walked" : "cached");
+}
+
+int main(int argc, char** argv){
+    const DWORD dirs    = HostTest::ArgU(argc, argv, "--dirs", 40);
+    const DWORD files   = HostTest::ArgU(argc, argv, "--files", 50);
+    const DWORD opMs    = HostTest::ArgU(argc, argv, "--op-ms", 20);
+    const DWORD entryUs = HostTest::ArgU(argc, argv, "--entry-us", 300);
+
+    HostTest::FreshRoot("BenchDvdSize", "DT");
+    const ULONGLONG disc1 = HostTest::MakeTree("D:\\Disc1", dirs, files, 3000);
+    HostFs::SetVolume('D', 0x1111AAAA, "CDFS");
+    HostFs::Device dvd = { 0, 0, opMs * 1000, entryUs, 0 };
+    HostFs::SetDevice('D', dvd);
+    CHECK(JobQueue::Start() && SizeService::Start());   // walks wait on JobQueue::Busy
+
+    printf("disc insert, %u folders x %u files on D: (%u ms per open/find, %u us per entry)\n",
+           (unsigned)dirs, (unsigned)files, (unsigned)opMs, (unsigned)entryUs);
+    printf("                         UI ms    known ms   D: finds\n");
+
+    const Insert before = InsertBefore();
+    CHECK(before.used == disc1);
+    Print("before, new disc", before);
+    const Insert beforeAgain = InsertBefore();
+    Print("before, same disc", beforeAgain);
+
+    const Insert first = InsertAfter();
+    CHECK(first.walked && first.used == disc1);
+    Print("after, new disc", first);
+    const Insert again = InsertAfter();
+    CHECK(!again.walked && again.used == disc1 && again.finds <= 1);   // the remount's root probe
+    Print("after, same disc", again);
+
+    // Another disc: walked and remembered next to the first one
+    HostFs::RemoveTree(HostFs::HostPath("D:\\Disc1").c_str());
+    const ULONGLONG disc2 = HostTest::MakeTree("D:\\Disc2", dirs / 2 + 1, files, 1000);
+    HostFs::SetVolume('D', 0x2222BBBB, "CDFS");
+    const Insert other = InsertAfter();
+    CHECK(other.walked && other.used == disc2);
+    Print("after, other disc", other);
+
+    ULONGLONG used = 0;
+    DvdMap_Io();
+    CHECK(DvdGetUsedBytes(0x1111AAAA, used) && used == disc1);
+    CHECK(DvdGetUsedBytes(0x2222BBBB, used) && used == disc2);
+
+    // 64 most recent discs: the two above drop out after 64 newer ones
+    for (DWORD s = 0; s < 64; ++s) DvdSetUsedBytes(0x30000000 + s, s);
+    DvdMap_Io();
+    CHECK(!DvdGetUsedBytes(0x1111AAAA, used) && !DvdGetUsedBytes(0x2222BBBB, used));
+    CHECK(DvdGetUsedBytes(0x30000000, used) && used == 0);
+    CHECK(DvdGetUsedBytes(0x3000003F, used) && used == 63);
+    CHECK(HostTest::FileSize("T:\\DvdSizes.dat") == 8 + 64 * 16);
+
+    // The UI is never held up by the walk; a known disc needs no walk
+    CHECK(first.blockedMs * 10 < before.blockedMs);
+    CHECK(again.knownMs * 10 < beforeAgain.knownMs);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+============================================================================
+ BenchListing
+  - Pane listing of one large folder: the old std::vector<Item> lister
+    (Baseline: 256-byte name per row, std::sort moving whole Items with
+    _stricmp per comparison) against Listing (compact records + name
+    arena, index sort on precomputed keys).
+  - Reports heap bytes per entry and ListDirectory + sort time for each
+    folder size (best of --runs). Both listings must hold the same names
+    in the same order.
+
+   BenchListing [--sizes 1000,10000,50000] [--runs 3]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "Baseline.h"
+#include "FsUtil.h"
+#include "Listing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Mixed-case names with shared prefixes, in scrambled creation order
+// (every 10th entry a folder), like a big homebrew or save folder.
+static void MakeFolder(const char* winDir, DWORD n){
+    static const char* kStem[] = { "Screenshot", "save", "Halo2_", "TRACK", "Rom ", "gamedata", "a" };
+    static const char* kExt[]  = { ".bmp", ".sav", ".xbe", ".wma", ".zip", "", ".bin" };
+    HostTest::MakeDir(winDir);
+    DWORD x = 12345;
+    for (DWORD i = 0; i < n; ++i){
+        x = x * 1103515245u + 12345u;
+        const DWORD k = (x >> 16) % 7;
+        char p[512];
+        if (i % 10 == 0){
+            _snprintf(p, sizeof(p), "%s\\%s Folder %u", winDir, kStem[k], (unsigned)(i * 7919u % 1000003u));
+            HostTest::MakeDir(p);
+        } else {
+            _snprintf(p, sizeof(p), "%s\\%s%u%s", winDir, kStem[k], (unsigned)(i * 7919u % 1000003u), kExt[(x >> 20) % 7]);
+            HostTest::WriteFile(p, i % 4096, i);
+        }
+    }
+}
+
+int main(int argc, char** argv){
+    const DWORD runs = HostTest::ArgU(argc, argv, "--runs", 3);
+    const char* sizes = "1000,10000,50000";
+    for (int i = 1; i + 1 < argc; ++i) if (!strcmp(argv[i], "--sizes")) sizes = argv[i + 1];
+
+    HostTest::FreshRoot("BenchListing", "E");
+    printf("  entries   bytes/entry (old / new)    list+sort ms (old / new)\n");
+
+    for (const char* s = sizes; *s; ){
+        const DWORD n = (DWORD)strtoul(s, (char**)&s, 10);
+        if (*s == ',') ++s;
+        if (!n) continue;
+
+        char dir[64]; _snprintf(dir, sizeof(dir), "E:\\Folder%u", (unsigned)n);
+        MakeFolder(dir, n);
+
+        double oldMs = 1e30, newMs = 1e30;
+        size_t oldBytes = 0, newBytes = 0;
+        std::vector<Baseline::Item> items;
+        Listing l;
+        for (DWORD r = 0; r < runs; ++r){
+            std::vector<Baseline::Item> a;
+            double t0 = HostFs::NowMs();
+            CHECK(Baseline::ListDirectory(dir, a));
+            const double o = HostFs::NowMs() - t0;
+            if (o < oldMs) oldMs = o;
+            oldBytes = a.capacity() * sizeof(Baseline::Item);
+            items.swap(a);
+
+            Listing b;
+            t0 = HostFs::NowMs();
+            CHECK(ListDirectory(dir, b));
+            const double w = HostFs::NowMs() - t0;
+            if (w < newMs) newMs = w;
+            newBytes = b.Bytes();
+            l.Swap(b);
+        }
+
+        // Same rows, same order (".." first, then dirs, then names)
+        CHECK(items.size() == l.Count() && items.size() == n + 1);
+        for (size_t i = 0; i < items.size(); ++i){
+            CHECK(!strcmp(items[i].name, l.Name(i)));
+            CHECK(items[i].isDir == l.IsDir(i));
+        }
+
+        printf("  %7u   %8.1f / %6.1f  (%.1fx)    %8.1f / %6.1f  (%.2fx)\n", (unsigned)n,
+               (double)oldBytes / items.size(), (double)newBytes / l.Count(),
+               newBytes ? (double)oldBytes / newBytes : 0.0,
+               oldMs, newMs, newMs > 0 ? oldMs / newMs : 0.0);
+        CHECK(newBytes * 4 < oldBytes);
+    }
+    return 0;
+}
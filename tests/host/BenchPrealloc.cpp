@@ -0,0 +1,154 @@
+/*
+============================================================================
+ BenchPrealloc
+  - Large files copied E: -> F: onto the shim's FATX model whose free
+    space is already chopped into short runs (FatxCheckerboard). The
+    original loop (Baseline) grows each file one 64 KiB write at a time,
+    so every write extends the cluster chain and lands in whatever hole
+    comes next; the current engine sets the final size first, so the
+    allocator can take one run long enough for the whole file.
+  - Reports wall time, cluster-chain changes and fragments per file.
+    --alloc-us models the cost of one chain change.
+  - Truncation: a journaled cancel keeps exactly the bytes written (the
+    reservation past them is released), a reservation that does not fit
+    fails the file at once and leaves no clusters behind.
+
+   BenchPrealloc [--files 4] [--mb 8] [--cluster-kb 16] [--hole 8] [--mbps 40] [--alloc-us 200]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "Baseline.h"
+#include "FsUtil.h"
+
+#include <stdio.h>
+
+static ULONGLONG s_capacity = 0;   // room for the copy plus the checkerboard
+
+struct Run {
+    double ms;
+    DWORD  allocs;
+    DWORD  maxFrags;
+    double avgFrags;
+};
+
+// Fresh F: model with every free run up to past the copy cut to 'hole'
+// clusters, so only a request that asks for its full size up front finds
+// a long run behind the checkerboard.
+static void FreshVolume(DWORD clusterKb, DWORD hole, ULONGLONG bytes){
+    HostFs::DisableFatx('F');
+    HostFs::RemoveTree(HostFs::HostPath("F:\\Copy").c_str());
+    HostTest::MakeDir("F:\\Copy");
+    HostFs::EnableFatx('F', s_capacity, clusterKb * 1024);
+    const DWORD cover = (DWORD)(bytes / (clusterKb * 1024)) * 2;
+    HostFs::FatxCheckerboard('F', hole, cover / (2 * hole) + 1);
+}
+
+static Run TimeCopy(bool prealloc, DWORD files, DWORD clusterKb, DWORD hole, ULONGLONG bytes){
+    FreshVolume(clusterKb, hole, bytes);
+    const DWORD a0 = HostFs::FatxAllocCalls('F');
+    const double t0 = HostFs::NowMs();
+    const bool ok = prealloc ? CopyRecursiveWithProgressA("E:\\Big", "F:\\Copy", 0)
+                             : Baseline::CopyRecursiveWithProgressA("E:\\Big", "F:\\Copy", 0);
+    Run r;
+    r.ms = HostFs::NowMs() - t0;
+    CHECK(ok);
+    CHECK(HostTest::SameTree("E:\\Big", "F:\\Copy\\Big"));
+    r.allocs = HostFs::FatxAllocCalls('F') - a0;
+    r.maxFrags = 0;
+    DWORD sum = 0;
+    for (DWORD i = 0; i < files; ++i){
+        char p[64]; _snprintf(p, sizeof(p), "F:\\Copy\\Big\\d000\\f%05u.bin", (unsigned)i);
+        const DWORD f = HostFs::FatxFragments(p);
+        CHECK(f >= 1);
+        sum += f;
+        if (f > r.maxFrags) r.maxFrags = f;
+    }
+    r.avgFrags = (double)sum / files;
+    return r;
+}
+
+// Journaled cancel at roughly half of the first file.
+static ULONGLONG s_cancelAt = 0;
+static bool CancelHalfway(ULONGLONG done, ULONGLONG, const char*, void*){ return done < s_cancelAt; }
+static ULONGLONG s_lastCheckpoint = 0;
+static void RecordCheckpoint(size_t, ULONGLONG offset, HANDLE, void*){ s_lastCheckpoint = offset; }
+
+static void CheckTruncation(DWORD clusterKb, ULONGLONG fileBytes){
+    const DWORD cl = clusterKb * 1024;
+
+    // Cancel with a cursor: the partial stays, cut back to what was written
+    HostFs::DisableFatx('F');
+    HostFs::RemoveTree(HostFs::HostPath("F:\\Copy").c_str());
+    HostTest::MakeDir("F:\\Copy");
+    HostFs::EnableFatx('F', s_capacity, cl);
+    std::vector<std::string> srcs(1, "E:\\Big");
+    OpManifest m;
+    BuildManifestA(srcs, m);
+    CopyCursor cur = { m.roots[0].first, 0, RecordCheckpoint, NULL };
+    s_cancelAt = fileBytes / 2;
+    SetCopyProgressCallback(CancelHalfway, NULL);
+    CHECK(!CopyManifestRootA(m, 0, "F:\\Copy\\", m.totalBytes, &cur));
+    SetCopyProgressCallback(NULL, NULL);
+    const ULONGLONG kept = HostTest::FileSize("F:\\Copy\\Big\\d000\\f00000.bin");
+    CHECK(kept == s_lastCheckpoint && kept >= s_cancelAt && kept < fileBytes);
+    // file clusters + the Big and d000 folders (the root's cluster is extra)
+    const DWORD wantClusters = (DWORD)((kept + cl - 1) / cl) + 2 + 1;
+    CHECK(HostFs::FatxUsedClusters('F') == wantClusters);
+    printf("  cancel      : kept %llu of %llu bytes, %u clusters in use\n",
+           (unsigned long long)kept, (unsigned long long)fileBytes, (unsigned)HostFs::FatxUsedClusters('F'));
+
+    // Reservation larger than the volume: fails before any data, nothing left
+    HostFs::DisableFatx('F');
+    HostFs::RemoveTree(HostFs::HostPath("F:\\Copy").c_str());
+    HostTest::MakeDir("F:\\Copy");
+    const ULONGLONG tight = fileBytes / 2;
+    HostFs::EnableFatx('F', tight, cl);
+    HostFs::ResetCounters();
+    CHECK(!CopyManifestRootA(m, 0, "F:\\Copy\\", m.totalBytes));
+    CHECK(GetLastError() == ERROR_DISK_FULL);
+    CHECK(!HostTest::Exists("F:\\Copy\\Big\\d000\\f00000.bin"));
+    CHECK(HostFs::Count(HostFs::kWriteFile) == 0);
+    CHECK(HostFs::FatxUsedClusters('F') == 2 + 1);
+    printf("  disk full   : failed before the first write, %u clusters in use\n",
+           (unsigned)HostFs::FatxUsedClusters('F'));
+}
+
+int main(int argc, char** argv){
+    const DWORD files     = HostTest::ArgU(argc, argv, "--files", 4);
+    const DWORD mb        = HostTest::ArgU(argc, argv, "--mb", 8);
+    const DWORD clusterKb = HostTest::ArgU(argc, argv, "--cluster-kb", 16);
+    const DWORD hole      = HostTest::ArgU(argc, argv, "--hole", 8);
+    const DWORD mbps      = HostTest::ArgU(argc, argv, "--mbps", 40);
+    const DWORD allocUs   = HostTest::ArgU(argc, argv, "--alloc-us", 200);
+
+    HostTest::FreshRoot("BenchPrealloc", "EF");
+    const ULONGLONG fileBytes = (ULONGLONG)mb * 1024 * 1024;
+    const ULONGLONG bytes = HostTest::MakeTree("E:\\Big", 1, files, fileBytes);
+    s_capacity = bytes * 3 + 64ull * 1024 * 1024;
+
+    // Only the destination is modeled: the serial and pipelined loops then
+    // cost the same, and the difference left is allocation.
+    HostFs::Device dst = { 0, mbps * 1024, 0, 0, allocUs };
+    HostFs::SetDevice('F', dst);
+
+    const Run grow = TimeCopy(false, files, clusterKb, hole, bytes);
+    const Run pre  = TimeCopy(true,  files, clusterKb, hole, bytes);
+
+    printf("copy %u files x %u MiB onto FATX (%u KiB clusters, free space in %u-cluster holes)\n",
+           (unsigned)files, (unsigned)mb, (unsigned)clusterKb, (unsigned)hole);
+    printf("                      growing  prealloc\n");
+    printf("  wall ms           %9.1f %9.1f\n", grow.ms, pre.ms);
+    printf("  MB/s              %9.1f %9.1f\n", HostTest::MBps(bytes, grow.ms), HostTest::MBps(bytes, pre.ms));
+    printf("  chain changes     %9u %9u\n", (unsigned)grow.allocs, (unsigned)pre.allocs);
+    printf("  fragments / file  %9.1f %9.1f  (max %u / %u)\n",
+           grow.avgFrags, pre.avgFrags, (unsigned)grow.maxFrags, (unsigned)pre.maxFrags);
+
+    // Every preallocated file must be one contiguous run
+    CHECK(pre.maxFrags == 1);
+    CHECK(grow.avgFrags > pre.avgFrags);
+    CHECK(pre.allocs < grow.allocs);
+
+    CheckTruncation(clusterKb, fileBytes);
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+============================================================================
+ BenchPrefetch
+  - Folder-open latency on a slow D: (seek per open / find, cost per
+    entry) with and without the dwell prefetch. A scripted session walks
+    the disc root: the cursor passes over a few folders, rests on one for
+    a dwell from a fixed mix (some shorter than the prefetch dwell), A
+    opens it, B goes back. The frame loop mirrors the app's
+    PumpPrefetch / StreamListing: ListStream's prefetch slot stores into
+    DirCache after kPrefetchDwellMs; an open is a DirCache lookup, else a
+    pane-slot stream to the end.
+  - Reports prefetch hit rate (DirCache prefetchHits per open), opens
+    served from the cache (repeats still in the LRU count in both runs)
+    and mean / worst open latency for both runs.
+  - Budget checks: a folder past the entry budget is abandoned without a
+    result, and a pane request during a prefetch is not held up by it.
+
+   BenchPrefetch [--opens 40] [--op-ms 80] [--entry-us 200]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "DirCache.h"
+#include "FsUtil.h"
+#include "ListStream.h"
+#include "Listing.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const double kFrameMs         = 16.0;
+static const double kPrefetchDwellMs = 300.0;   // FileBrowserApp.cpp
+static const DWORD  kFolders         = 24;
+
+// The app's prefetch pump, reduced to one pane sitting in D:\.
+struct Prefetcher {
+    bool   enabled;
+    char   at[512];
+    double since;
+    bool   tried, busy;
+    char   path[512];
+    DWORD  gen;
+    DWORD  issued, completed, abandoned;
+
+    void Reset(bool on){ ZeroMemory(this, sizeof(*this)); enabled = on; }
+
+    void Pump(const char* highlighted, double now){
+        if (busy){
+            Listing got;
+            const ListStream::State state = ListStream::Take(ListStream::kPrefetchSlot, got);
+            if (state != ListStream::LS_RUNNING){
+                busy = false;
+                if (state == ListStream::LS_DONE){
+                    Listing l;
+                    l.SetSortMode(got.Mode());
+                    if (strlen(path) > 3) l.Add("..", true, 0, 0, true);
+                    l.Merge(got, l.Count(), NULL);
+                    DirCache::StorePrefetched(path, l, gen);
+                    ++completed;
+                } else ++abandoned;
+            }
+        }
+        if (_stricmp(highlighted, at) != 0){
+            _snprintf(at, sizeof(at), "%s", highlighted); at[sizeof(at)-1] = 0;
+            since = now; tried = false;
+            return;
+        }
+        if (!enabled || busy || tried || now - since < kPrefetchDwellMs) return;
+        tried = true;
+        if (DirCache::Contains(at)) return;
+        memcpy(path, at, sizeof(path));
+        gen  = DirCache::Generation(at);
+        busy = ListStream::Request(ListStream::kPrefetchSlot, at, SORT_NAME);
+        if (busy) ++issued;
+    }
+};
+
+static Prefetcher s_pf;
+
+// Rest the cursor on 'dir' for 'ms', pumping once per frame.
+static void Dwell(const char* dir, double ms){
+    const double t0 = HostFs::NowMs();
+    for (;;){
+        const double now = HostFs::NowMs();
+        s_pf.Pump(dir, now);
+        if (now - t0 >= ms) break;
+        usleep((useconds_t)(kFrameMs * 1000));
+    }
+}
+
+// A on 'dir': from the cache, else stream it on pane slot 0 to the end.
+static double Open(const char* dir, Listing& l, bool* cached){
+    const double t0 = HostFs::NowMs();
+    *cached = DirCache::Lookup(dir, l);
+    if (!*cached){
+        const DWORD gen = DirCache::Generation(dir);
+        l.Clear();
+        l.Add("..", true, 0, 0, true);
+        CHECK(ListStream::Request(0, dir, l.Mode()));
+        for (;;){
+            Listing batch;
+            const ListStream::State st = ListStream::Take(0, batch);
+            if (!batch.Empty()) l.Merge(batch, 1, NULL);
+            if (st == ListStream::LS_DONE) break;
+            CHECK(st == ListStream::LS_RUNNING);
+            usleep(500);
+        }
+        DirCache::Store(dir, l, gen);
+    }
+    return HostFs::NowMs() - t0;
+}
+
+struct Result { double meanMs, worstMs; DWORD opens, cached, prefetchHits; };
+
+static Result Session(bool prefetch, DWORD opens){
+    DirCache::InvalidateVolume('D');   // cold disc
+    s_pf.Reset(prefetch);
+    const DirCache::Stats before = DirCache::GetStats();
+
+    // The disc root itself was listed when the pane opened
+    Listing root;
+    CHECK(ListDirectory("D:\\", root));
+    DirCache::Store("D:\\", root);
+
+    static const double kDwellMs[] = { 150, 250, 450, 600, 900, 1500, 2500, 700 };
+    Result r; ZeroMemory(&r, sizeof(r));
+    DWORD x = 777;
+    for (DWORD i = 0; i < opens; ++i){
+        x = x * 1103515245u + 12345u;
+        const DWORD target = (x >> 16) % kFolders;
+        char dir[64];
+        // Cursor passes over two neighbours (100 ms each), then rests
+        for (int k = 2; k > 0; --k){
+            _snprintf(dir, sizeof(dir), "D:\\Folder%02u", (unsigned)((target + kFolders - k) % kFolders));
+            Dwell(dir, 100);
+        }
+        _snprintf(dir, sizeof(dir), "D:\\Folder%02u", (unsigned)target);
+        Dwell(dir, kDwellMs[i % (sizeof(kDwellMs) / sizeof(kDwellMs[0]))]);
+
+        Listing l;
+        bool cached = false;
+        const double ms = Open(dir, l, &cached);
+        CHECK(l.Count() > 1);
+        r.meanMs += ms;
+        if (ms > r.worstMs) r.worstMs = ms;
+        if (cached) ++r.cached;
+
+        Dwell("", 50);                  // inside: ".." highlighted
+        Open("D:\\", root, &cached);    // B
+        CHECK(cached);
+    }
+    Dwell("", 2500);   // let a last prefetch settle
+    r.opens = opens;
+    r.meanMs /= opens;
+    r.prefetchHits = DirCache::GetStats().prefetchHits - before.prefetchHits;
+    return r;
+}
+
+int main(int argc, char** argv){
+    const DWORD opens   = HostTest::ArgU(argc, argv, "--opens", 40);
+    const DWORD opMs    = HostTest::ArgU(argc, argv, "--op-ms", 80);
+    const DWORD entryUs = HostTest::ArgU(argc, argv, "--entry-us", 200);
+
+    HostTest::FreshRoot("BenchPrefetch", "D");
+    for (DWORD f = 0; f < kFolders; ++f){
+        char dir[64]; _snprintf(dir, sizeof(dir), "D:\\Folder%02u", (unsigned)f);
+        HostTest::MakeDir(dir);
+        const DWORD n = 40 + (f * 37) % 600;
+        for (DWORD i = 0; i < n; ++i){
+            char p[96]; _snprintf(p, sizeof(p), "%s\\track%04u.wma", dir, (unsigned)i);
+            HostTest::WriteFile(p, 0, 0);
+        }
+    }
+    HostTest::MakeTree("D:\\Huge", 1, 6000, 0);
+    HostFs::Device dvd = { 0, 0, opMs * 1000, entryUs, 0 };
+    HostFs::SetDevice('D', dvd);
+    CHECK(ListStream::Start());
+
+    const Result off = Session(false, opens);
+    const Result on  = Session(true, opens);
+
+    printf("%u folder opens on D: (%u ms per open/find, %u us per entry)\n",
+           (unsigned)opens, (unsigned)opMs, (unsigned)entryUs);
+    printf("                       no prefetch    prefetch\n");
+    printf("  opens from cache     %8u     %8u\n", (unsigned)off.cached, (unsigned)on.cached);
+    printf("  prefetch hit rate    %8s     %7.0f%%   (%u issued, %u listed, %u abandoned)\n", "-",
+           100.0 * on.prefetchHits / on.opens, (unsigned)s_pf.issued, (unsigned)s_pf.completed,
+           (unsigned)s_pf.abandoned);
+    printf("  open latency mean    %8.1f     %8.1f ms  (%.1fx)\n", off.meanMs, on.meanMs,
+           on.meanMs > 0 ? off.meanMs / on.meanMs : 0.0);
+    printf("  open latency worst   %8.1f     %8.1f ms\n", off.worstMs, on.worstMs);
+
+    // Without prefetch only repeat opens still in the LRU come from memory
+    CHECK(off.prefetchHits == 0);
+    CHECK(on.prefetchHits > 0 && on.cached > off.cached);
+    CHECK(on.meanMs < off.meanMs);
+
+    // Entry budget: the huge folder is dropped, nothing cached
+    s_pf.Reset(true);
+    const DWORD dropped = s_pf.abandoned;
+    double t0 = HostFs::NowMs();
+    while (s_pf.issued == 0 || s_pf.busy){
+        s_pf.Pump("D:\\Huge\\d000", HostFs::NowMs());
+        CHECK(HostFs::NowMs() - t0 < 30000);
+        usleep((useconds_t)(kFrameMs * 1000));
+    }
+    CHECK(s_pf.abandoned == dropped + 1 && !DirCache::Contains("D:\\Huge\\d000"));
+    printf("  6000-entry folder    : prefetch abandoned after %.0f ms, not cached\n", HostFs::NowMs() - t0);
+
+    // A pane request during a prefetch is served first
+    DirCache::InvalidateVolume('D');
+    s_pf.Reset(true);
+    Dwell("D:\\Folder20", kPrefetchDwellMs + 20);   // prefetch just issued
+    CHECK(s_pf.busy);
+    Listing l;
+    bool cached = false;
+    const double ms = Open("D:\\Folder05", l, &cached);
+    CHECK(!cached);
+    Dwell("D:\\Folder20", 2 * kFrameMs);
+    printf("  open during prefetch : %.1f ms (prefetch %s)\n", ms, s_pf.abandoned ? "yielded" : "finished first");
+    CHECK(s_pf.abandoned == 1);
+    return 0;
+}
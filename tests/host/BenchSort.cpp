@@ -0,0 +1,117 @@
+/*
+============================================================================
+ BenchSort
+  - In-memory sort of one large folder listing: std::sort of
+    std::vector<Item> with the old ItemLess (dirs first, _stricmp on every
+    comparison, whole 280-byte Items moved) against Listing::Sort (index
+    of precomputed collation keys, records moved once) in every mode.
+  - Sort time only (the entries are re-added in scrambled order before
+    each run), best of --runs. SORT_NAME must give the old order.
+
+   BenchSort [--entries 20000] [--runs 20]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "Baseline.h"
+#include "Listing.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+struct Entry {
+    char      name[64];
+    bool      isDir;
+    ULONGLONG size;
+    ULONGLONG mtime;
+};
+
+// Mixed-case names with shared prefixes and digit runs, scrambled
+static void MakeEntries(DWORD n, std::vector<Entry>& out){
+    static const char* kStem[] = { "Screenshot", "save", "Halo2_", "TRACK", "Rom ", "gamedata", "a" };
+    static const char* kExt[]  = { ".bmp", ".sav", ".xbe", ".wma", ".zip", "", ".bin" };
+    DWORD x = 12345;
+    out.resize(n);
+    for (DWORD i = 0; i < n; ++i){
+        x = x * 1103515245u + 12345u;
+        Entry& e = out[i];
+        e.isDir = (i % 10 == 0);
+        _snprintf(e.name, sizeof(e.name), "%s%s%u%s", kStem[(x >> 16) % 7], e.isDir ? "Folder " : "",
+                  (unsigned)(i * 7919u % 1000003u), e.isDir ? "" : kExt[(x >> 20) % 7]);
+        e.name[sizeof(e.name)-1] = 0;
+        e.size  = e.isDir ? 0 : (x >> 4) % 5000000;
+        e.mtime = 0x01D0000000000000ull + (ULONGLONG)((x >> 3) % 100000000) * 10000000ull;
+    }
+}
+
+static void FillItems(const std::vector<Entry>& src, std::vector<Baseline::Item>& out){
+    out.resize(src.size());
+    for (size_t i = 0; i < src.size(); ++i){
+        Baseline::Item& it = out[i];
+        ZeroMemory(&it, sizeof(it));
+        strncpy(it.name, src[i].name, 255);
+        it.isDir = src[i].isDir;
+        it.size  = src[i].size;
+    }
+}
+
+static void FillListing(const std::vector<Entry>& src, Listing& out){
+    out.Clear();
+    for (size_t i = 0; i < src.size(); ++i){
+        WIN32_FIND_DATAA fd;
+        ZeroMemory(&fd, sizeof(fd));
+        strcpy(fd.cFileName, src[i].name);
+        fd.dwFileAttributes = src[i].isDir ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+        fd.nFileSizeLow  = (DWORD)src[i].size;
+        fd.nFileSizeHigh = (DWORD)(src[i].size >> 32);
+        fd.ftLastWriteTime.dwLowDateTime  = (DWORD)src[i].mtime;
+        fd.ftLastWriteTime.dwHighDateTime = (DWORD)(src[i].mtime >> 32);
+        out.Add(fd);
+    }
+}
+
+int main(int argc, char** argv){
+    const DWORD n    = HostTest::ArgU(argc, argv, "--entries", 20000);
+    const DWORD runs = HostTest::ArgU(argc, argv, "--runs", 20);
+
+    std::vector<Entry> src;
+    MakeEntries(n, src);
+
+    double oldMs = 1e30;
+    std::vector<Baseline::Item> items;
+    for (DWORD r = 0; r < runs; ++r){
+        FillItems(src, items);
+        const double t0 = HostFs::NowMs();
+        std::sort(items.begin(), items.end(), Baseline::ItemLess);
+        const double ms = HostFs::NowMs() - t0;
+        if (ms < oldMs) oldMs = ms;
+    }
+
+    printf("sort %u entries (best of %u)\n", (unsigned)n, (unsigned)runs);
+    printf("  ItemLess (old)    : %8.2f ms\n", oldMs);
+
+    double nameMs = 0;
+    Listing l;
+    for (int m = 0; m < SORT_COUNT; ++m){
+        l.SetSortMode((SortMode)m);
+        double best = 1e30;
+        for (DWORD r = 0; r < runs; ++r){
+            FillListing(src, l);
+            const double t0 = HostFs::NowMs();
+            l.Sort(0);
+            const double ms = HostFs::NowMs() - t0;
+            if (ms < best) best = ms;
+        }
+        printf("  Listing %-9s : %8.2f ms  (%.2fx)\n", SortModeName((SortMode)m), best,
+               best > 0 ? oldMs / best : 0.0);
+        if (m == SORT_NAME){
+            nameMs = best;
+            CHECK(l.Count() == items.size());
+            for (size_t i = 0; i < items.size(); ++i) CHECK(!strcmp(items[i].name, l.Name(i)));
+        }
+    }
+
+    CHECK(nameMs < oldMs);
+    return 0;
+}
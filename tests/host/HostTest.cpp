@@ -0,0 +1,145 @@
+/*
+============================================================================
+ HostTest (see HostTest.h)
+============================================================================
+*/
+
+#include "HostTest.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace HostTest {
+
+void Failed(const char* file, int line, const char* what){
+    fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, what);
+    exit(1);
+}
+
+void FreshRoot(const char* name, const char* drives){
+    char cwd[1024];
+    if (!getcwd(cwd, sizeof(cwd))) strcpy(cwd, "/tmp");
+    std::string root = std::string(cwd) + "/hostfs-" + name;
+    HostFs::RemoveTree(root.c_str());
+    HostFs::SetRoot(root.c_str());
+    for (const char* d = drives; *d; ++d) HostFs::AddDrive(*d);
+}
+
+void WriteFile(const char* winPath, ULONGLONG size, DWORD seed){
+    const std::string host = HostFs::HostPath(winPath);
+    FILE* f = fopen(host.c_str(), "wb");
+    CHECK(f != NULL);
+    std::vector<unsigned char> buf(64 * 1024);
+    ULONGLONG left = size;
+    DWORD x = seed * 2654435761u + 1;
+    while (left){
+        const size_t n = (size_t)std::min<ULONGLONG>(left, buf.size());
+        for (size_t i = 0; i < n; ++i){
+            x = x * 1103515245u + 12345u;
+            buf[i] = (unsigned char)(x >> 16);
+        }
+        CHECK(fwrite(&buf[0], 1, n, f) == n);
+        left -= n;
+    }
+    fclose(f);
+}
+
+void MakeDir(const char* winPath){
+    mkdir(HostFs::HostPath(winPath).c_str(), 0755);
+}
+
+ULONGLONG MakeTree(const char* winDir, DWORD dirs, DWORD filesPerDir, ULONGLONG size){
+    MakeDir(winDir);
+    ULONGLONG total = 0;
+    for (DWORD d = 0; d < dirs; ++d){
+        char dir[512]; snprintf(dir, sizeof(dir), "%s\\d%03u", winDir, (unsigned)d);
+        MakeDir(dir);
+        for (DWORD f = 0; f < filesPerDir; ++f){
+            char file[512]; snprintf(file, sizeof(file), "%s\\f%05u.bin", dir, (unsigned)f);
+            WriteFile(file, size, d * 100003u + f);
+            total += size;
+        }
+    }
+    return total;
+}
+
+static bool SameFile(const std::string& a, const std::string& b){
+    FILE* fa = fopen(a.c_str(), "rb");
+    FILE* fb = fopen(b.c_str(), "rb");
+    bool same = fa && fb;
+    std::vector<char> ba(64 * 1024), bb(64 * 1024);
+    while (same){
+        const size_t na = fread(&ba[0], 1, ba.size(), fa);
+        const size_t nb = fread(&bb[0], 1, bb.size(), fb);
+        if (na != nb || memcmp(&ba[0], &bb[0], na) != 0) same = false;
+        if (na == 0) break;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return same;
+}
+
+static void ListHost(const std::string& dir, std::vector<std::string>& out){
+    out.clear();
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL)
+        if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) out.push_back(e->d_name);
+    closedir(d);
+    std::sort(out.begin(), out.end());
+}
+
+static bool SameHost(const std::string& a, const std::string& b){
+    struct stat sa, sb;
+    if (stat(a.c_str(), &sa) != 0 || stat(b.c_str(), &sb) != 0) return false;
+    if (S_ISDIR(sa.st_mode) != S_ISDIR(sb.st_mode)) return false;
+    if (!S_ISDIR(sa.st_mode)) return sa.st_size == sb.st_size && SameFile(a, b);
+    std::vector<std::string> ka, kb;
+    ListHost(a, ka); ListHost(b, kb);
+    if (ka != kb) return false;
+    for (size_t i = 0; i < ka.size(); ++i)
+        if (!SameHost(a + "/" + ka[i], b + "/" + kb[i])) return false;
+    return true;
+}
+
+bool SameTree(const char* winA, const char* winB){
+    return SameHost(HostFs::HostPath(winA), HostFs::HostPath(winB));
+}
+
+bool Exists(const char* winPath){
+    struct stat st;
+    return stat(HostFs::HostPath(winPath).c_str(), &st) == 0;
+}
+
+ULONGLONG FileSize(const char* winPath){
+    struct stat st;
+    return stat(HostFs::HostPath(winPath).c_str(), &st) == 0 ? (ULONGLONG)st.st_size : 0;
+}
+
+DWORD ArgU(int argc, char** argv, const char* name, DWORD def){
+    for (int i = 1; i + 1 < argc; ++i) if (!strcmp(argv[i], name)) return (DWORD)strtoul(argv[i + 1], NULL, 10);
+    return def;
+}
+
+double ArgF(int argc, char** argv, const char* name, double def){
+    for (int i = 1; i + 1 < argc; ++i) if (!strcmp(argv[i], name)) return atof(argv[i + 1]);
+    return def;
+}
+
+bool ArgFlag(int argc, char** argv, const char* name){
+    for (int i = 1; i < argc; ++i) if (!strcmp(argv[i], name)) return true;
+    return false;
+}
+
+double MBps(ULONGLONG bytes, double ms){
+    return ms > 0 ? (bytes / (1024.0 * 1024.0)) / (ms / 1000.0) : 0;
+}
+
+} // namespace HostTest
@@ -0,0 +1,48 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+/*
+============================================================================
+ HostTest
+  - Helpers shared by the host tests and benchmarks: a scratch drive root
+    per test, tree builders and comparers working on the host side (so
+    they do not show up in the shim's syscall counters), argument parsing
+    and a CHECK macro that fails the test with file:line.
+============================================================================
+*/
+
+#include <xtl.h>
+#include <string>
+#include <vector>
+#include "shim/HostFs.h"
+
+#define CHECK(c) do { if (!(c)) { HostTest::Failed(__FILE__, __LINE__, #c); } } while (0)
+
+namespace HostTest {
+
+void Failed(const char* file, int line, const char* what);
+
+// Fresh <cwd>/hostfs-<name> as the drive root, with the given drive letters.
+void FreshRoot(const char* name, const char* drives);
+
+// Host-side file creation: 'size' bytes of a pattern derived from 'seed'.
+void WriteFile(const char* winPath, ULONGLONG size, DWORD seed);
+void MakeDir(const char* winPath);
+// dirs x files of 'size' bytes below 'winDir' (created): winDir\dNNN\fNNNNN.bin
+ULONGLONG MakeTree(const char* winDir, DWORD dirs, DWORD filesPerDir, ULONGLONG size);
+
+// True if both host trees hold the same names, types and bytes.
+bool SameTree(const char* winA, const char* winB);
+bool Exists(const char* winPath);
+ULONGLONG FileSize(const char* winPath);
+
+// "--name value" from argv, or 'def'.
+DWORD  ArgU(int argc, char** argv, const char* name, DWORD def);
+double ArgF(int argc, char** argv, const char* name, double def);
+bool   ArgFlag(int argc, char** argv, const char* name);
+
+// MB/s for 'bytes' in 'ms'.
+double MBps(ULONGLONG bytes, double ms);
+
+} // namespace HostTest
+
+#endif // HOST_TEST_H
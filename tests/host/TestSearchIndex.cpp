@@ -0,0 +1,191 @@
+/*
+============================================================================
+ TestSearchIndex
+  - Synthetic tree on E: and F: (--dirs x --files per volume plus a few
+    named files); each "power-on" is a forked child that starts the
+    indexer, so every session begins with empty statics like the console.
+     1. Full walk: every name indexed, queries find exact full paths, the
+        index is saved to T:\Search.idx once changes settle.
+     2. Reload after changes made outside the app (folder added, folder
+        deleted, file renamed): only changed folders are re-listed and
+        the queries see the new state. Then in-app updates through
+        Changed(): a folder move, and deleting F:\Media (half the names)
+        which must be compacted away before the next save.
+     3. Reload of the compacted file: same answers, roots-only re-list.
+  - Reports walk / reload times and FindFirstFile calls per session.
+
+   TestSearchIndex [--dirs 140] [--files 300]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "FsUtil.h"
+#include "Listing.h"
+#include "SearchIndex.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static DWORD s_dirs, s_files;
+
+// Index file complete on disk: its magic is written last.
+static bool IndexSaved(ULONGLONG* size){
+    FILE* f = fopen(HostFs::HostPath("T:\\Search.idx").c_str(), "rb");
+    if (!f) return false;
+    DWORD magic = 0;
+    const bool ok = fread(&magic, sizeof(magic), 1, f) == 1 && magic == 0x49534658;
+    fclose(f);
+    if (ok && size) *size = HostTest::FileSize("T:\\Search.idx");
+    return ok;
+}
+
+static size_t Hits(const char* q, Listing* out){
+    Listing tmp;
+    return SearchIndex::Query(q, out ? *out : tmp, 1000);
+}
+
+// Poll (the indexer runs at low priority on its own thread)
+static bool WaitHits(const char* q, size_t want, double timeoutMs){
+    const double t0 = HostFs::NowMs();
+    while (HostFs::NowMs() - t0 < timeoutMs){
+        if (Hits(q, NULL) == want) return true;
+        usleep(2000);
+    }
+    return false;
+}
+
+static double StartAndWait(){
+    const double t0 = HostFs::NowMs();
+    CHECK(SearchIndex::Start());
+    while (!SearchIndex::GetStatus().ready){
+        CHECK(HostFs::NowMs() - t0 < 120000);
+        usleep(1000);
+    }
+    return HostFs::NowMs() - t0;
+}
+
+static size_t Names(DWORD dirs, DWORD files){ return 1 + dirs + (size_t)dirs * files; }
+
+static void Session(int n){
+    fflush(stdout);
+    const pid_t pid = fork();
+    CHECK(pid >= 0);
+    if (pid){
+        int status = 0;
+        CHECK(waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        return;
+    }
+
+    HostFs::ResetCounters();
+    const double ms = StartAndWait();
+    const DWORD finds = HostFs::Count(HostFs::kFindFirstFile);
+    const SearchIndex::Status st = SearchIndex::GetStatus();
+    CHECK(!st.full);
+    Listing out;
+
+    if (n == 1){
+        // 2 roots + E:\Games + F:\Media trees + 2 named files
+        CHECK(st.entries == 2 + 2 * Names(s_dirs, s_files) + 2);
+        CHECK(Hits("halo combat", &out) == 1 && !strcmp(out.Name(0), "E:\\Games\\d005\\Halo Combat Evolved.xbe"));
+        CHECK(Hits("EVOL", NULL) == 1);
+        CHECK(Hits("f00003", NULL) == 2 * s_dirs);
+        CHECK(Hits("soundtrack", &out) == 1 && !strcmp(out.Name(0), "F:\\Media\\d001\\Soundtrack 01.wma"));
+        printf("  walk     : %u names in %.0f ms, %u FindFirstFile\n", (unsigned)st.entries, ms, (unsigned)finds);
+        CHECK(finds >= 2 * s_dirs);
+
+        double t0 = HostFs::NowMs();
+        while (!IndexSaved(NULL)) { CHECK(HostFs::NowMs() - t0 < 30000); usleep(10000); }
+        fflush(stdout);
+        _exit(0);
+    }
+
+    if (n == 2){
+        // Outside changes: d001\NewMod (+5), d002 gone, d003\f00000 renamed
+        CHECK(st.entries == 2 + 2 * Names(s_dirs, s_files) + 2 + 6 - (1 + s_files));
+        CHECK(Hits("mod part", NULL) == 5);
+        CHECK(Hits("renamed save", &out) == 1 && !strcmp(out.Name(0), "E:\\Games\\d003\\Renamed Save.sav"));
+        CHECK(Hits("f00003", NULL) == 2 * s_dirs - 1);
+        CHECK(Hits("f00000", NULL) == 2 * s_dirs - 2);
+        printf("  reload   : %u names in %.0f ms, %u FindFirstFile (changed folders only)\n",
+               (unsigned)st.entries, ms, (unsigned)finds);
+        CHECK(finds <= 8);
+
+        ULONGLONG before = 0;
+        CHECK(IndexSaved(&before));
+
+        // In-app: folder move on E:
+        CHECK(MoveFileA("E:\\Games\\d004", "E:\\Moved Folder"));
+        SearchIndex::Changed("E:\\Games\\d004", true);
+        SearchIndex::Changed("E:\\Moved Folder", true);
+        CHECK(WaitHits("moved folder", 1, 30000));
+        CHECK(Hits("moved f00007", NULL) == 0);   // words of one name only
+        CHECK(Hits("f00007", &out) == 2 * s_dirs - 1);
+        bool underMoved = false;
+        for (size_t i = 0; i < out.Count(); ++i) underMoved |= !strcmp(out.Name(i), "E:\\Moved Folder\\f00007.bin");
+        CHECK(underMoved);
+
+        // In-app: half the names go; the dead nodes must not reach the file
+        DeleteError de;
+        CHECK(DeleteTreeA("F:\\Media", &de));
+        SearchIndex::Changed("F:\\Media", true);
+        CHECK(WaitHits("soundtrack", 0, 30000));
+        CHECK(Hits("f00003", NULL) == s_dirs - 1);
+        const size_t live = SearchIndex::GetStatus().entries;
+        CHECK(live == 2 + Names(s_dirs, s_files) + 1 + 6 - (1 + s_files));
+
+        ULONGLONG after = 0;
+        const double t0 = HostFs::NowMs();
+        for (;;){
+            if (IndexSaved(&after) && after < before * 3 / 4) break;
+            CHECK(HostFs::NowMs() - t0 < 30000);
+            usleep(10000);
+        }
+        printf("  compact  : %u live names, index file %llu -> %llu bytes\n",
+               (unsigned)live, (unsigned long long)before, (unsigned long long)after);
+        fflush(stdout);
+        _exit(0);
+    }
+
+    // n == 3: compacted file, nothing changed since the save
+    CHECK(st.entries == 2 + Names(s_dirs, s_files) + 1 + 6 - (1 + s_files));
+    CHECK(Hits("halo combat", NULL) == 1);
+    CHECK(Hits("moved folder", NULL) == 1);
+    CHECK(Hits("soundtrack", NULL) == 0);
+    CHECK(Hits("f00003", NULL) == s_dirs - 1);
+    printf("  reload   : %u names in %.0f ms, %u FindFirstFile\n", (unsigned)st.entries, ms, (unsigned)finds);
+    CHECK(finds <= 2);
+    fflush(stdout);
+    _exit(0);
+}
+
+int main(int argc, char** argv){
+    s_dirs  = HostTest::ArgU(argc, argv, "--dirs", 140);
+    s_files = HostTest::ArgU(argc, argv, "--files", 300);
+    CHECK(s_dirs >= 8 && s_files >= 8);
+
+    HostTest::FreshRoot("TestSearchIndex", "EFT");
+    HostTest::MakeTree("E:\\Games", s_dirs, s_files, 0);
+    HostTest::MakeTree("F:\\Media", s_dirs, s_files, 0);
+    HostTest::WriteFile("E:\\Games\\d005\\Halo Combat Evolved.xbe", 100, 1);
+    HostTest::WriteFile("F:\\Media\\d001\\Soundtrack 01.wma", 100, 2);
+
+    Session(1);
+
+    // Changes made while the app is off
+    usleep(20000);   // folder stamps must move
+    HostTest::MakeDir("E:\\Games\\d001\\NewMod");
+    for (int i = 0; i < 5; ++i){
+        char p[128]; _snprintf(p, sizeof(p), "E:\\Games\\d001\\NewMod\\Mod Part %d.bin", i);
+        HostTest::WriteFile(p, 10, i);
+    }
+    HostFs::RemoveTree(HostFs::HostPath("E:\\Games\\d002").c_str());
+    CHECK(MoveFileA("E:\\Games\\d003\\f00000.bin", "E:\\Games\\d003\\Renamed Save.sav"));
+
+    Session(2);
+    Session(3);
+    printf("TestSearchIndex: walk, reload, in-app updates and compaction OK\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+============================================================================
+ TestSpaceEstimate
+  - ManifestOnDiskBytes against the shim's FATX allocation model. Source:
+    a game-like tree on E: (nested folders, many small files of mixed
+    sizes, empty files, a folder with more entries than one directory
+    cluster holds, one larger file).
+  - For each cluster size, on a fresh F: model:
+     1. capacity == estimate: the copy succeeds, and the clusters in use
+        afterwards are exactly the estimate;
+     2. capacity == estimate - 1 cluster: the copy fails with
+        ERROR_DISK_FULL;
+     3. capacity == raw bytes (what the old preflight compared): fails.
+
+   TestSpaceEstimate [--dirs 12] [--files 60]
+============================================================================
+*/
+
+#include "HostTest.h"
+#include "FsUtil.h"
+
+#include <stdio.h>
+
+static void BuildSource(DWORD dirs, DWORD files){
+    HostTest::MakeDir("E:\\Game");
+    DWORD x = 4242;
+    for (DWORD d = 0; d < dirs; ++d){
+        char dir[64]; _snprintf(dir, sizeof(dir), "E:\\Game\\Level%02u", (unsigned)d);
+        HostTest::MakeDir(dir);
+        char sub[80]; _snprintf(sub, sizeof(sub), "%s\\Textures", dir);
+        HostTest::MakeDir(sub);
+        for (DWORD f = 0; f < files; ++f){
+            x = x * 1103515245u + 12345u;
+            // Mostly a few KB; some empty, some exact cluster multiples
+            ULONGLONG size = (x >> 8) % 40000;
+            if (f % 17 == 0) size = 0;
+            if (f % 23 == 0) size = 16384 * (1 + f % 3);
+            char p[128]; _snprintf(p, sizeof(p), "%s\\%s%04u.dat", (f & 1) ? sub : dir,
+                                   (f & 1) ? "tex" : "obj", (unsigned)f);
+            HostTest::WriteFile(p, size, f);
+        }
+    }
+    HostTest::MakeDir("E:\\Game\\Sounds");   // more than 255 entries: 2+ directory clusters at 16 KB
+    for (DWORD f = 0; f < 300; ++f){
+        char p[64]; _snprintf(p, sizeof(p), "E:\\Game\\Sounds\\sfx%03u.wav", (unsigned)f);
+        HostTest::WriteFile(p, 100 + f * 13, f);
+    }
+    HostTest::MakeDir("E:\\Game\\Empty");
+    HostTest::WriteFile("E:\\Game\\default.xbe", 3u << 20, 7);
+}
+
+// Copy onto a fresh F: model of 'capacity' bytes.
+static bool CopyOnto(const OpManifest& m, ULONGLONG capacity, DWORD cluster, DWORD* err){
+    HostFs::DisableFatx('F');
+    HostFs::RemoveTree(HostFs::HostPath("F:\\Game").c_str());
+    HostFs::EnableFatx('F', capacity, cluster);
+    CHECK(HostFs::FatxUsedClusters('F') == 0);
+    SetLastError(0);
+    const bool ok = CopyManifestRootA(m, 0, "F:\\", m.totalBytes);
+    *err = ok ? 0 : GetLastError();
+    return ok;
+}
+
+int main(int argc, char** argv){
+    const DWORD dirs  = HostTest::ArgU(argc, argv, "--dirs", 12);
+    const DWORD files = HostTest::ArgU(argc, argv, "--files", 60);
+
+    HostTest::FreshRoot("TestSpaceEstimate", "EF");
+    BuildSource(dirs, files);
+
+    std::vector<std::string> srcs(1, "E:\\Game");
+    OpManifest m;
+    BuildManifestA(srcs, m);
+    CHECK(m.roots.size() == 1 && m.roots[0].count > 0 && !m.roots[0].skipped);
+
+    printf("%u entries, %llu raw bytes\n", (unsigned)m.roots[0].count, (unsigned long long)m.totalBytes);
+    printf("  cluster    estimate      used after copy   est - 1 cluster   raw-bytes volume\n");
+
+    static const DWORD kClusters[] = { 16384, 32768, 65536 };
+    for (int c = 0; c < 3; ++c){
+        const DWORD cl = kClusters[c];
+        const ULONGLONG est = ManifestOnDiskBytes(m, 0, 1, cl);
+        CHECK(est % cl == 0 && est > m.totalBytes);
+
+        DWORD err = 0;
+        CHECK(CopyOnto(m, est, cl, &err));
+        CHECK(HostTest::SameTree("E:\\Game", "F:\\Game"));
+        const ULONGLONG used = (ULONGLONG)HostFs::FatxUsedClusters('F') * cl;
+        CHECK(used == est);
+
+        CHECK(!CopyOnto(m, est - cl, cl, &err));
+        CHECK(err == ERROR_DISK_FULL);
+        DWORD rawErr = 0;
+        CHECK(!CopyOnto(m, ClusterRoundUp(m.totalBytes, cl), cl, &rawErr));
+        CHECK(rawErr == ERROR_DISK_FULL);
+
+        printf("  %5u KB  %10llu  %12llu (=)     fails (%u)       fails (%u), est %.2fx raw\n",
+               (unsigned)(cl / 1024), (unsigned long long)est, (unsigned long long)used,
+               (unsigned)err, (unsigned)rawErr, (double)est / (double)ClusterRoundUp(m.totalBytes, cl));
+    }
+
+    // No cluster size known: raw bytes, no folder space
+    CHECK(ManifestOnDiskBytes(m, 0, 1, 0) == m.totalBytes);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+/*
+============================================================================
+ HostFs (host shim control)
+  - Drive letters map to folders: "E:\a\b" is <root>/E/a/b.
+  - Per-drive device model: each drive is one device that serves one
+    request at a time (reads, writes, metadata), so a read on D: overlaps a
+    write on E: but not a write on D:. Costs are slept out while the device
+    is held; all zero (the default) means host speed.
+  - Syscall counters for every shimmed file/volume call.
+  - Fault injection: crash (_exit) after the Nth write or delete, corrupt
+    written data. Safe to fork() a crash run (the I/O threads restart).
+  - Optional FATX allocation model per drive: fixed capacity and cluster
+    size, per-file cluster chains, directory clusters (one 64-byte entry
+    per child plus the end marker, grown but never shrunk while the folder
+    lives), free space and disk-full from the model. The allocator extends
+    a chain in place when the next cluster is free, otherwise takes the
+    first free run long enough for the whole request, otherwise the first
+    free clusters it finds.
+============================================================================
+*/
+
+#include <xtl.h>
+#include <string>
+
+namespace HostFs {
+
+// ---- drives ------------------------------------------------------------------
+void        SetRoot(const char* dir);        // creates it; drives are subfolders
+const char* Root();
+void        AddDrive(char letter);           // mkdir <root>/<letter>
+void        RemoveTree(const char* hostPath); // rm -rf, for test setup/teardown
+std::string HostPath(const char* winPath);   // "E:\a" -> "<root>/E/a"
+
+// ---- device model -------------------------------------------------------------
+struct Device {
+    DWORD readKBps;     // 0 = unthrottled
+    DWORD writeKBps;    // 0 = unthrottled
+    DWORD opUs;         // per open / find / attribute / volume call
+    DWORD entryUs;      // per FindNextFile entry
+    DWORD allocUs;      // per cluster-chain change (FATX model only)
+};
+void  SetDevice(char letter, const Device& d);
+void  SetReadOnly(char letter, bool ro);     // FILE_READ_ONLY_VOLUME, writes fail
+void  SetVolume(char letter, DWORD serial, const char* fsName);
+
+// ---- syscall counters ---------------------------------------------------------
+enum Call {
+    kCreateFile, kReadFile, kWriteFile, kCloseHandle, kSetFilePointer, kSetEndOfFile,
+    kGetFileSize, kGetFileAttributes, kGetFileAttributesEx, kSetFileAttributes,
+    kFindFirstFile, kFindNextFile, kDeleteFile, kCreateDirectory, kRemoveDirectory,
+    kMoveFile, kGetDiskFreeSpaceEx, kGetVolumeInformation, kGetDiskClusterSize,
+    kLocalAlloc, kCallCount
+};
+void        ResetCounters();
+DWORD       Count(Call c);
+DWORD       FileCalls();                     // every call above except kLocalAlloc
+const char* CallName(Call c);
+
+// ---- fault injection ----------------------------------------------------------
+// _exit(exitCode) right after the nth completed call to c (kWriteFile,
+// kDeleteFile or kRemoveDirectory); n == 0 disables.
+void  CrashAfter(Call c, DWORD n, int exitCode);
+void  CorruptWritesTo(const char* nameSubstr);   // flip a byte in matching files; NULL off
+
+// ---- FATX allocation model ------------------------------------------------------
+// The root folder has its own cluster outside 'capacity'. Whatever is
+// already on the drive is allocated (in walk order) when the model starts.
+void      EnableFatx(char letter, ULONGLONG capacity, DWORD clusterBytes);
+void      DisableFatx(char letter);
+DWORD     FatxClusterBytes(char letter);
+DWORD     FatxUsedClusters(char letter);
+DWORD     FatxFreeClusters(char letter);
+DWORD     FatxAllocCalls(char letter);         // chain changes since EnableFatx
+// Contiguous runs in one file's chain (0 if empty or unknown).
+DWORD     FatxFragments(const char* winPath);
+// Occupy every other run of 'runClusters' clusters from the first free
+// cluster on: a volume whose free space is already chopped up.
+void      FatxCheckerboard(char letter, DWORD runClusters, DWORD runs);
+
+// ---- time -----------------------------------------------------------------------
+double    NowMs();                             // monotonic, sub-millisecond
+
+} // namespace HostFs
+
+#endif // HOST_FS_H
@@ -0,0 +1,1410 @@
+/*
+============================================================================
+ HostWin32 (host shim)
+  - POSIX implementation of the Win32 / XDK calls declared in shim/xtl.h,
+    plus the HostFs control API (device model, counters, faults, FATX).
+  - Files are plain host files; FILE_ATTRIBUTE_READONLY/HIDDEN/SYSTEM/
+    ARCHIVE live in a side table (the tests run as root, so mode bits
+    would not stop anything).
+  - Overlapped reads are served by one I/O thread per drive and complete
+    through the OVERLAPPED event, as on the console.
+============================================================================
+*/
+
+#include <xtl.h>
+#include "HostFs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/time.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#define ERROR_NOT_SAME_DEVICE  17
+#define ERROR_FILE_EXISTS      80
+#define ERROR_NEGATIVE_SEEK    131
+#define ERROR_IO_INCOMPLETE    996
+#define TRUNCATE_EXISTING      5
+#define FILE_READ_ONLY_VOLUME  0x00080000u
+
+namespace {
+
+// ============================================================================
+// Small helpers
+// ============================================================================
+
+__thread DWORD t_lastError = 0;
+
+pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;   // side tables + FATX
+std::string     g_root = "/tmp/hostfs";
+
+struct Lock {
+    pthread_mutex_t& m;
+    explicit Lock(pthread_mutex_t& mu) : m(mu) { pthread_mutex_lock(&m); }
+    ~Lock() { pthread_mutex_unlock(&m); }
+};
+
+DWORD ErrnoToWin(int e){
+    switch (e){
+    case ENOENT:    return ERROR_FILE_NOT_FOUND;
+    case ENOTDIR:   return ERROR_PATH_NOT_FOUND;
+    case EEXIST:    return ERROR_ALREADY_EXISTS;
+    case ENOTEMPTY: return ERROR_DIR_NOT_EMPTY;
+    case EACCES:
+    case EPERM:
+    case EISDIR:    return ERROR_ACCESS_DENIED;
+    case ENOSPC:    return ERROR_DISK_FULL;
+    case EROFS:     return ERROR_WRITE_PROTECT;
+    case ENAMETOOLONG: return ERROR_FILENAME_EXCED_RANGE;
+    case EXDEV:     return ERROR_NOT_SAME_DEVICE;
+    default:        return ERROR_GEN_FAILURE;
+    }
+}
+
+bool Fail(DWORD err){ t_lastError = err; return false; }
+
+int DriveIndex(const char* p){
+    if (!p || !p[0] || p[1] != ':') return -1;
+    const int c = toupper((unsigned char)p[0]);
+    return (c >= 'A' && c <= 'Z') ? c - 'A' : -1;
+}
+
+std::string ParentOf(const std::string& host){
+    const size_t s = host.rfind('/');
+    return (s == std::string::npos) ? std::string() : host.substr(0, s);
+}
+
+bool HostStat(const std::string& host, struct stat& st){
+    return stat(host.c_str(), &st) == 0;
+}
+
+// ENOENT on a path whose parent is missing is PATH_NOT_FOUND in Win32
+DWORD MissingError(const std::string& host){
+    struct stat st;
+    return HostStat(ParentOf(host), st) ? ERROR_FILE_NOT_FOUND : ERROR_PATH_NOT_FOUND;
+}
+
+FILETIME ToFileTime(time_t sec, long nsec){
+    const ULONGLONG t = ((ULONGLONG)sec + 11644473600ULL) * 10000000ULL + (ULONGLONG)(nsec / 100);
+    FILETIME ft; ft.dwLowDateTime = (DWORD)t; ft.dwHighDateTime = (DWORD)(t >> 32);
+    return ft;
+}
+
+// ============================================================================
+// Side tables: attributes, counters
+// ============================================================================
+
+std::map<std::string, DWORD> g_attr;       // host path -> RO/HIDDEN/SYSTEM/ARCHIVE
+volatile LONG g_count[HostFs::kCallCount];
+
+inline void Tally(HostFs::Call c){ __sync_fetch_and_add(&g_count[c], 1); }
+
+DWORD ExtraAttr(const std::string& host){
+    Lock l(g_lock);
+    std::map<std::string, DWORD>::const_iterator it = g_attr.find(host);
+    return it == g_attr.end() ? 0 : it->second;
+}
+
+DWORD AttrOf(const std::string& host, const struct stat& st){
+    DWORD a = ExtraAttr(host);
+    if (S_ISDIR(st.st_mode)) a |= FILE_ATTRIBUTE_DIRECTORY;
+    return a ? a : FILE_ATTRIBUTE_NORMAL;
+}
+
+// Move every side-table key at or below 'from' to 'to'.
+template <class V>
+void RekeyPrefix(std::map<std::string, V>& m, const std::string& from, const std::string& to){
+    std::vector<std::pair<std::string, V> > moved;
+    typename std::map<std::string, V>::iterator it = m.lower_bound(from);
+    while (it != m.end() && it->first.compare(0, from.size(), from) == 0){
+        if (it->first.size() == from.size() || it->first[from.size()] == '/'){
+            moved.push_back(std::make_pair(to + it->first.substr(from.size()), it->second));
+            m.erase(it++);
+        } else ++it;
+    }
+    for (size_t i = 0; i < moved.size(); ++i) m[moved[i].first] = moved[i].second;
+}
+
+template <class V>
+void ErasePrefix(std::map<std::string, V>& m, const std::string& from){
+    typename std::map<std::string, V>::iterator it = m.lower_bound(from);
+    while (it != m.end() && it->first.compare(0, from.size(), from) == 0){
+        if (it->first.size() == from.size() || it->first[from.size()] == '/') m.erase(it++);
+        else ++it;
+    }
+}
+
+// ============================================================================
+// FATX allocation model
+// ============================================================================
+
+const DWORD kDirent = 64;
+
+struct Fatx {
+    DWORD cluster;
+    DWORD total;
+    DWORD used;
+    DWORD firstFree;                                  // lowest free cluster (hint)
+    DWORD allocCalls;
+    std::string rootHost;
+    std::vector<unsigned char> map;                   // 1 = in use
+    std::map<std::string, std::vector<DWORD> > chain; // files + folders (root: clusters past its first)
+    std::map<std::string, DWORD> live;                // folder -> children
+    std::map<std::string, DWORD> slots;               // folder -> entries ever needed (incl. end marker)
+
+    DWORD Free() const { return total - used; }
+
+    DWORD DirNeed(const std::string& dir) const {
+        std::map<std::string, DWORD>::const_iterator it = slots.find(dir);
+        const DWORD s = (it == slots.end()) ? 1 : it->second;
+        DWORD n = (DWORD)(((ULONGLONG)s * kDirent + cluster - 1) / cluster);
+        if (n == 0) n = 1;
+        return dir == rootHost ? n - 1 : n;           // the root's first cluster is reserved
+    }
+
+    void Take(std::vector<DWORD>& c, DWORD k){
+        map[k] = 1; ++used; c.push_back(k);
+        if (k == firstFree) while (firstFree < total && map[firstFree]) ++firstFree;
+    }
+
+    // Caller checked Free() >= n.
+    void Alloc(std::vector<DWORD>& c, DWORD n){
+        if (!n) return;
+        ++allocCalls;
+        while (n && !c.empty() && c.back() + 1 < total && !map[c.back() + 1]){ Take(c, c.back() + 1); --n; }
+        if (!n) return;
+        // First free run long enough for the rest
+        DWORD run = 0;
+        for (DWORD k = firstFree; k < total; ++k){
+            run = map[k] ? 0 : run + 1;
+            if (run == n){
+                for (DWORD j = k + 1 - n; j <= k; ++j) Take(c, j);
+                return;
+            }
+        }
+        for (DWORD k = firstFree; n && k < total; ++k) if (!map[k]) { Take(c, k); --n; }
+    }
+
+    void Release(std::vector<DWORD>& c, DWORD keep){
+        if (c.size() <= keep) return;
+        ++allocCalls;
+        while (c.size() > keep){
+            const DWORD k = c.back(); c.pop_back();
+            map[k] = 0; --used;
+            if (k < firstFree) firstFree = k;
+        }
+    }
+
+    // Clusters needed for one more entry in 'dir'.
+    DWORD EntryGrowth(const std::string& dir) const {
+        std::map<std::string, DWORD>::const_iterator l = live.find(dir);
+        std::map<std::string, DWORD>::const_iterator s = slots.find(dir);
+        const DWORD nl = (l == live.end() ? 0 : l->second) + 1;
+        const DWORD ns = (s == slots.end() ? 1 : s->second);
+        if (nl + 1 <= ns) return 0;
+        Fatx tmp; tmp.cluster = cluster; tmp.rootHost = rootHost; tmp.slots[dir] = nl + 1;
+        const DWORD need = tmp.DirNeed(dir);
+        std::map<std::string, std::vector<DWORD> >::const_iterator c = chain.find(dir);
+        const DWORD have = (c == chain.end()) ? 0 : (DWORD)c->second.size();
+        return need > have ? need - have : 0;
+    }
+
+    void EntryAdd(const std::string& dir){
+        const DWORD nl = ++live[dir];
+        DWORD& s = slots[dir];
+        if (s < nl + 1) s = nl + 1;
+        std::vector<DWORD>& c = chain[dir];
+        const DWORD need = DirNeed(dir);
+        if (need > c.size()) Alloc(c, need - (DWORD)c.size());
+    }
+
+    void EntryRemove(const std::string& dir){
+        std::map<std::string, DWORD>::iterator it = live.find(dir);
+        if (it != live.end() && it->second) --it->second;
+    }
+
+    DWORD Clusters(ULONGLONG bytes) const { return (DWORD)((bytes + cluster - 1) / cluster); }
+
+    // Resize a file's chain; false (nothing changed) when the volume is full.
+    bool Resize(const std::string& file, ULONGLONG bytes, bool growOnly){
+        std::vector<DWORD>& c = chain[file];
+        const DWORD need = Clusters(bytes);
+        if (need > c.size()){
+            if (need - c.size() > Free()) return false;
+            Alloc(c, need - (DWORD)c.size());
+        } else if (!growOnly && need < c.size()) Release(c, need);
+        return true;
+    }
+
+    void Forget(const std::string& host){
+        std::map<std::string, std::vector<DWORD> >::iterator it = chain.find(host);
+        if (it != chain.end()){ Release(it->second, 0); chain.erase(it); }
+        live.erase(host); slots.erase(host);
+    }
+};
+
+// ============================================================================
+// Drives: device model, volume info, overlapped I/O thread
+// ============================================================================
+
+struct IoReq {
+    int         fd;
+    void*       buf;
+    DWORD       n;
+    ULONGLONG   off;
+    OVERLAPPED* ov;
+};
+
+struct Drive {
+    HostFs::Device  dev;
+    bool            ro;
+    DWORD           serial;
+    char            fsName[16];
+    pthread_mutex_t devLock;     // the device serves one request at a time
+    double          debtUs;      // modeled time not yet slept out (under devLock)
+    Fatx*           fatx;        // under g_lock
+
+    pthread_mutex_t qLock;
+    pthread_cond_t  qCond;
+    std::deque<IoReq> queue;
+    bool            ioStarted;
+};
+
+Drive           g_drive[26];
+pthread_once_t  g_once = PTHREAD_ONCE_INIT;
+
+// A forked child has none of the parent's I/O threads: start over.
+void AtForkChild(){
+    pthread_mutex_init(&g_lock, NULL);
+    for (int i = 0; i < 26; ++i){
+        Drive& d = g_drive[i];
+        pthread_mutex_init(&d.devLock, NULL);
+        pthread_mutex_init(&d.qLock, NULL);
+        pthread_cond_init(&d.qCond, NULL);
+        d.queue.clear();
+        d.ioStarted = false;
+    }
+}
+
+void InitDrives(){
+    pthread_atfork(NULL, NULL, AtForkChild);
+    for (int i = 0; i < 26; ++i){
+        Drive& d = g_drive[i];
+        memset(&d.dev, 0, sizeof(d.dev));
+        d.ro     = (i == 'D' - 'A');
+        d.serial = 0x5A000000u | (DWORD)(i + 'A');
+        snprintf(d.fsName, sizeof(d.fsName), "%s", i == 'D' - 'A' ? "CDFS" : "FATX");
+        pthread_mutex_init(&d.devLock, NULL);
+        d.debtUs = 0;
+        d.fatx   = NULL;
+        pthread_mutex_init(&d.qLock, NULL);
+        pthread_cond_init(&d.qCond, NULL);
+        d.ioStarted = false;
+    }
+}
+
+Drive* DriveOf(int idx){
+    pthread_once(&g_once, InitDrives);
+    return (idx >= 0 && idx < 26) ? &g_drive[idx] : NULL;
+}
+
+double NowUs(){
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Hold the device for 'us' of modeled time. Small costs accumulate and are
+// slept out in slices so per-entry costs of a few microseconds stay exact
+// on average.
+void Charge(int idx, double us){
+    Drive* d = DriveOf(idx);
+    if (!d || us <= 0) return;
+    Lock l(d->devLock);
+    d->debtUs += us;
+    if (d->debtUs < 500) return;
+    const double t0 = NowUs();
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(d->debtUs / 1e6);
+    ts.tv_nsec = (long)((d->debtUs - ts.tv_sec * 1e6) * 1e3);
+    nanosleep(&ts, NULL);
+    d->debtUs -= NowUs() - t0;
+}
+
+void ChargeOp(int idx){
+    Drive* d = DriveOf(idx);
+    if (d && d->dev.opUs) Charge(idx, d->dev.opUs);
+}
+
+void ChargeData(int idx, DWORD bytes, bool write){
+    Drive* d = DriveOf(idx);
+    if (!d) return;
+    const DWORD kbps = write ? d->dev.writeKBps : d->dev.readKBps;
+    if (kbps) Charge(idx, bytes * 1e6 / (kbps * 1024.0));
+}
+
+void ChargeAlloc(int idx, DWORD calls){
+    Drive* d = DriveOf(idx);
+    if (d && d->dev.allocUs && calls) Charge(idx, (double)d->dev.allocUs * calls);
+}
+
+// ============================================================================
+// Handles
+// ============================================================================
+
+enum { kFileObj = 1, kFindObj, kEventObj, kThreadObj };
+
+struct Obj {
+    int kind;
+    explicit Obj(int k) : kind(k) {}
+    virtual ~Obj() {}
+};
+
+struct FileObj : Obj {
+    int         fd;
+    int         drive;
+    std::string host;
+    bool        overlapped, canWrite, noBuffering, corrupt;
+    ULONGLONG   pos;
+    FileObj() : Obj(kFileObj), fd(-1), drive(-1), overlapped(false), canWrite(false),
+                noBuffering(false), corrupt(false), pos(0) {}
+};
+
+struct FindObj : Obj {
+    std::string              dirHost;
+    std::vector<std::string> names;
+    size_t                   next;
+    int                      drive;
+    FindObj() : Obj(kFindObj), next(0), drive(-1) {}
+};
+
+// Events, and semaphores (sem: 'sig' means count > 0)
+struct EventObj : Obj {
+    pthread_mutex_t m;
+    pthread_cond_t  c;
+    bool            manual, sig, sem;
+    LONG            count, maxCount;
+    EventObj(bool man, bool init) : Obj(kEventObj), manual(man), sig(init), sem(false), count(0), maxCount(0) {
+        pthread_mutex_init(&m, NULL); pthread_cond_init(&c, NULL);
+    }
+    ~EventObj(){ pthread_mutex_destroy(&m); pthread_cond_destroy(&c); }
+};
+
+struct ThreadObj : Obj {
+    pthread_t              t;
+    EventObj               done;
+    LPTHREAD_START_ROUTINE fn;
+    LPVOID                 arg;
+    volatile LONG          refs;    // handle + running thread
+    ThreadObj() : Obj(kThreadObj), done(true, false), fn(NULL), arg(NULL), refs(2) {}
+};
+
+void ThreadRelease(ThreadObj* t){
+    if (__sync_sub_and_fetch(&t->refs, 1) == 0) delete t;
+}
+
+void* ThreadMain(void* p){
+    ThreadObj* t = (ThreadObj*)p;
+    t->fn(t->arg);
+    SetEvent(&t->done);
+    ThreadRelease(t);
+    return NULL;
+}
+
+FileObj* AsFile(HANDLE h){
+    Obj* o = (Obj*)h;
+    return (o && h != INVALID_HANDLE_VALUE && o->kind == kFileObj) ? (FileObj*)o : NULL;
+}
+
+ULONGLONG HostFileSize(int fd){
+    struct stat st;
+    return fstat(fd, &st) == 0 ? (ULONGLONG)st.st_size : 0;
+}
+
+DWORD DoRead(int idx, int fd, void* buf, DWORD n, ULONGLONG off){
+    ssize_t got = pread(fd, buf, n, (off_t)off);
+    if (got < 0) got = 0;
+    ChargeData(idx, (DWORD)got, false);
+    return (DWORD)got;
+}
+
+void* IoThread(void* p){
+    Drive* d = (Drive*)p;
+    const int idx = (int)(d - g_drive);
+    for (;;){
+        pthread_mutex_lock(&d->qLock);
+        while (d->queue.empty()) pthread_cond_wait(&d->qCond, &d->qLock);
+        IoReq r = d->queue.front(); d->queue.pop_front();
+        pthread_mutex_unlock(&d->qLock);
+
+        const ULONGLONG size = HostFileSize(r.fd);
+        DWORD got = 0, err = 0;
+        if (r.n && r.off >= size) err = ERROR_HANDLE_EOF;
+        else got = DoRead(idx, r.fd, r.buf, r.n, r.off);
+        r.ov->InternalHigh = got;
+        r.ov->Internal     = err;
+        __sync_synchronize();
+        if (r.ov->hEvent) SetEvent(r.ov->hEvent);
+    }
+    return NULL;
+}
+
+void QueueRead(Drive* d, const IoReq& r){
+    pthread_mutex_lock(&d->qLock);
+    if (!d->ioStarted){
+        pthread_t t;
+        pthread_create(&t, NULL, IoThread, d);
+        pthread_detach(t);
+        d->ioStarted = true;
+    }
+    d->queue.push_back(r);
+    pthread_cond_signal(&d->qCond);
+    pthread_mutex_unlock(&d->qLock);
+}
+
+// ============================================================================
+// Fault injection
+// ============================================================================
+
+HostFs::Call  g_crashCall  = HostFs::kCallCount;
+volatile LONG g_crashAfter = 0;
+int           g_crashCode  = 0;
+std::string   g_corrupt;
+
+// Called once the call has taken effect on disk.
+void CrashPoint(HostFs::Call c){
+    if (c == g_crashCall && g_crashAfter > 0 && __sync_sub_and_fetch(&g_crashAfter, 1) == 0)
+        _exit(g_crashCode);
+}
+
+} // namespace
+
+// ============================================================================
+// HostFs control API
+// ============================================================================
+
+namespace HostFs {
+
+void SetRoot(const char* dir){
+    g_root = dir;
+    while (g_root.size() > 1 && g_root[g_root.size() - 1] == '/') g_root.erase(g_root.size() - 1);
+    mkdir(g_root.c_str(), 0755);
+}
+
+const char* Root(){ return g_root.c_str(); }
+
+void AddDrive(char letter){
+    mkdir(g_root.c_str(), 0755);
+    std::string p = g_root + "/" + (char)toupper((unsigned char)letter);
+    mkdir(p.c_str(), 0755);
+}
+
+static void RemoveHost(const std::string& p){
+    struct stat st;
+    if (lstat(p.c_str(), &st) != 0) return;
+    if (S_ISDIR(st.st_mode)){
+        DIR* d = opendir(p.c_str());
+        if (d){
+            struct dirent* e;
+            std::vector<std::string> kids;
+            while ((e = readdir(d)) != NULL)
+                if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) kids.push_back(p + "/" + e->d_name);
+            closedir(d);
+            for (size_t i = 0; i < kids.size(); ++i) RemoveHost(kids[i]);
+        }
+        rmdir(p.c_str());
+    } else unlink(p.c_str());
+}
+
+void RemoveTree(const char* hostPath){
+    RemoveHost(hostPath);
+    Lock l(g_lock);
+    ErasePrefix(g_attr, hostPath);
+}
+
+std::string HostPath(const char* win){
+    std::string out = g_root;
+    const int idx = DriveIndex(win);
+    const char* p = win;
+    if (idx >= 0){ out += '/'; out += (char)('A' + idx); p += 2; }
+    else out += "/_";
+    for (; *p; ++p){
+        const char c = (*p == '\\') ? '/' : *p;
+        if (c == '/' && out[out.size() - 1] == '/') continue;
+        out += c;
+    }
+    while (out.size() > g_root.size() + 2 && out[out.size() - 1] == '/') out.erase(out.size() - 1);
+    return out;
+}
+
+void SetDevice(char letter, const Device& dv){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    if (d) d->dev = dv;
+}
+
+void SetReadOnly(char letter, bool ro){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    if (d) d->ro = ro;
+}
+
+void SetVolume(char letter, DWORD serial, const char* fsName){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    if (!d) return;
+    d->serial = serial;
+    if (fsName) snprintf(d->fsName, sizeof(d->fsName), "%s", fsName);
+}
+
+void ResetCounters(){
+    for (int i = 0; i < kCallCount; ++i) g_count[i] = 0;
+}
+
+DWORD Count(Call c){ return (DWORD)g_count[c]; }
+
+DWORD FileCalls(){
+    DWORD n = 0;
+    for (int i = 0; i < kCallCount; ++i) if (i != kLocalAlloc) n += (DWORD)g_count[i];
+    return n;
+}
+
+const char* CallName(Call c){
+    static const char* const names[kCallCount] = {
+        "CreateFile", "ReadFile", "WriteFile", "CloseHandle", "SetFilePointer", "SetEndOfFile",
+        "GetFileSize", "GetFileAttributes", "GetFileAttributesEx", "SetFileAttributes",
+        "FindFirstFile", "FindNextFile", "DeleteFile", "CreateDirectory", "RemoveDirectory",
+        "MoveFile", "GetDiskFreeSpaceEx", "GetVolumeInformation", "XGetDiskClusterSize",
+        "LocalAlloc"
+    };
+    return (c >= 0 && c < kCallCount) ? names[c] : "?";
+}
+
+void CrashAfter(Call c, DWORD n, int exitCode){
+    g_crashCall  = c;
+    g_crashCode  = exitCode;
+    g_crashAfter = (LONG)n;
+}
+
+void CorruptWritesTo(const char* nameSubstr){
+    Lock l(g_lock);
+    g_corrupt = nameSubstr ? nameSubstr : "";
+}
+
+static void FatxScan(Fatx& f, const std::string& dir){
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    std::vector<std::string> kids;
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL)
+        if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) kids.push_back(dir + "/" + e->d_name);
+    closedir(d);
+    std::sort(kids.begin(), kids.end());
+    for (size_t i = 0; i < kids.size(); ++i){
+        struct stat st;
+        if (stat(kids[i].c_str(), &st) != 0) continue;
+        f.EntryAdd(dir);
+        if (S_ISDIR(st.st_mode)){
+            f.slots[kids[i]] = 1;
+            std::vector<DWORD>& c = f.chain[kids[i]];
+            f.Alloc(c, f.DirNeed(kids[i]));
+            FatxScan(f, kids[i]);
+        } else {
+            f.Resize(kids[i], (ULONGLONG)st.st_size, false);
+        }
+    }
+}
+
+void EnableFatx(char letter, ULONGLONG capacity, DWORD clusterBytes){
+    const int idx = toupper((unsigned char)letter) - 'A';
+    Drive* d = DriveOf(idx);
+    if (!d) return;
+    AddDrive(letter);
+    Fatx* f = new Fatx;
+    f->cluster    = clusterBytes ? clusterBytes : 16384;
+    f->total      = (DWORD)(capacity / f->cluster);
+    f->used       = 0;
+    f->firstFree  = 0;
+    f->allocCalls = 0;
+    f->rootHost   = HostPath(std::string(1, (char)('A' + idx)).append(":\\").c_str());
+    f->map.assign(f->total, 0);
+    f->slots[f->rootHost] = 1;
+    FatxScan(*f, f->rootHost);
+    f->allocCalls = 0;
+
+    Lock l(g_lock);
+    delete d->fatx;
+    d->fatx = f;
+}
+
+void DisableFatx(char letter){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    if (!d) return;
+    Lock l(g_lock);
+    delete d->fatx;
+    d->fatx = NULL;
+}
+
+DWORD FatxClusterBytes(char letter){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    Lock l(g_lock);
+    return (d && d->fatx) ? d->fatx->cluster : 0;
+}
+
+DWORD FatxUsedClusters(char letter){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    Lock l(g_lock);
+    return (d && d->fatx) ? d->fatx->used : 0;
+}
+
+DWORD FatxFreeClusters(char letter){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    Lock l(g_lock);
+    return (d && d->fatx) ? d->fatx->Free() : 0;
+}
+
+DWORD FatxAllocCalls(char letter){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    Lock l(g_lock);
+    return (d && d->fatx) ? d->fatx->allocCalls : 0;
+}
+
+DWORD FatxFragments(const char* winPath){
+    Drive* d = DriveOf(DriveIndex(winPath));
+    Lock l(g_lock);
+    if (!d || !d->fatx) return 0;
+    std::map<std::string, std::vector<DWORD> >::const_iterator it = d->fatx->chain.find(HostPath(winPath));
+    if (it == d->fatx->chain.end() || it->second.empty()) return 0;
+    const std::vector<DWORD>& c = it->second;
+    DWORD runs = 1;
+    for (size_t i = 1; i < c.size(); ++i) if (c[i] != c[i - 1] + 1) ++runs;
+    return runs;
+}
+
+void FatxCheckerboard(char letter, DWORD runClusters, DWORD runs){
+    Drive* d = DriveOf(toupper((unsigned char)letter) - 'A');
+    Lock l(g_lock);
+    if (!d || !d->fatx || !runClusters) return;
+    Fatx& f = *d->fatx;
+    std::vector<DWORD>& hold = f.chain[f.rootHost + "/<checkerboard>"];
+    DWORD k = f.firstFree;
+    for (DWORD r = 0; r < runs && k + 2 * runClusters <= f.total; ++r, k += 2 * runClusters)
+        for (DWORD j = 0; j < runClusters; ++j)
+            if (!f.map[k + runClusters + j]) f.Take(hold, k + runClusters + j);
+}
+
+double NowMs(){ return NowUs() / 1000.0; }
+
+} // namespace HostFs
+
+using HostFs::HostPath;
+
+namespace {
+
+Fatx* FatxOf(int idx){
+    Drive* d = DriveOf(idx);
+    return d ? d->fatx : NULL;
+}
+
+bool ReadOnlyDrive(int idx){
+    Drive* d = DriveOf(idx);
+    return d && d->ro;
+}
+
+} // namespace
+
+// ============================================================================
+// Memory
+// ============================================================================
+
+void ZeroMemory(void* p, size_t n){ memset(p, 0, n); }
+
+HLOCAL LocalAlloc(UINT flags, size_t n){
+    Tally(HostFs::kLocalAlloc);
+    void* p = malloc(n ? n : 1);
+    if (p && (flags & LMEM_ZEROINIT)) memset(p, 0, n);
+    return p;
+}
+
+HLOCAL LocalFree(HLOCAL p){ free(p); return NULL; }
+
+LPVOID VirtualAlloc(LPVOID, size_t n, DWORD, DWORD){
+    void* p = NULL;
+    if (posix_memalign(&p, 4096, n ? n : 1) != 0) return NULL;
+    memset(p, 0, n);
+    return p;
+}
+
+BOOL VirtualFree(LPVOID p, size_t, DWORD){ free(p); return TRUE; }
+
+// ============================================================================
+// Files
+// ============================================================================
+
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD, void*, DWORD disp, DWORD flags, HANDLE){
+    Tally(HostFs::kCreateFile);
+    const int idx = DriveIndex(path);
+    ChargeOp(idx);
+    const std::string host = HostPath(path);
+    const bool wantWrite = (access & GENERIC_WRITE) != 0;
+
+    struct stat st;
+    const bool exists = HostStat(host, st);
+    if (exists && S_ISDIR(st.st_mode)) { Fail(ERROR_ACCESS_DENIED); return INVALID_HANDLE_VALUE; }
+    if (wantWrite && ReadOnlyDrive(idx)) { Fail(ERROR_WRITE_PROTECT); return INVALID_HANDLE_VALUE; }
+    if (wantWrite && exists && (ExtraAttr(host) & FILE_ATTRIBUTE_READONLY))
+        { Fail(ERROR_ACCESS_DENIED); return INVALID_HANDLE_VALUE; }
+
+    int oflags = wantWrite ? ((access & GENERIC_READ) ? O_RDWR : O_WRONLY) : O_RDONLY;
+    bool create = false, trunc = false;
+    switch (disp){
+    case CREATE_NEW:
+        if (exists) { Fail(ERROR_FILE_EXISTS); return INVALID_HANDLE_VALUE; }
+        create = true; break;
+    case CREATE_ALWAYS:     create = !exists; trunc = exists; break;
+    case OPEN_EXISTING:
+        if (!exists) { Fail(MissingError(host)); return INVALID_HANDLE_VALUE; }
+        break;
+    case OPEN_ALWAYS:       create = !exists; break;
+    case TRUNCATE_EXISTING:
+        if (!exists) { Fail(MissingError(host)); return INVALID_HANDLE_VALUE; }
+        trunc = true; break;
+    default: Fail(ERROR_INVALID_PARAMETER); return INVALID_HANDLE_VALUE;
+    }
+    if ((create || trunc) && !wantWrite) oflags = O_RDWR;
+    if (create){
+        struct stat ps;
+        if (!HostStat(ParentOf(host), ps) || !S_ISDIR(ps.st_mode)) { Fail(ERROR_PATH_NOT_FOUND); return INVALID_HANDLE_VALUE; }
+        oflags |= O_CREAT;
+    }
+
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        Fatx* f = FatxOf(idx);
+        if (f){
+            const DWORD before = f->allocCalls;
+            if (create){
+                if (f->EntryGrowth(ParentOf(host)) > f->Free()) { Fail(ERROR_DISK_FULL); return INVALID_HANDLE_VALUE; }
+                f->EntryAdd(ParentOf(host));
+                f->chain[host];
+            } else if (trunc) f->Resize(host, 0, false);
+            allocCalls = f->allocCalls - before;
+        }
+        if (trunc) g_attr.erase(host);
+    }
+    ChargeAlloc(idx, allocCalls);
+
+    const int fd = open(host.c_str(), oflags | (trunc ? O_TRUNC : 0), 0644);
+    if (fd < 0) { Fail(ErrnoToWin(errno)); return INVALID_HANDLE_VALUE; }
+
+    FileObj* fo = new FileObj;
+    fo->fd          = fd;
+    fo->drive       = idx;
+    fo->host        = host;
+    fo->overlapped  = (flags & FILE_FLAG_OVERLAPPED) != 0;
+    fo->noBuffering = (flags & FILE_FLAG_NO_BUFFERING) != 0;
+    fo->canWrite    = wantWrite;
+    {
+        Lock l(g_lock);
+        fo->corrupt = wantWrite && !g_corrupt.empty() && host.find(g_corrupt) != std::string::npos;
+    }
+    t_lastError = (exists && (disp == CREATE_ALWAYS || disp == OPEN_ALWAYS)) ? ERROR_ALREADY_EXISTS : NO_ERROR;
+    return fo;
+}
+
+BOOL ReadFile(HANDLE h, void* buf, DWORD n, DWORD* got, LPOVERLAPPED ov){
+    Tally(HostFs::kReadFile);
+    FileObj* f = AsFile(h);
+    if (got) *got = 0;
+    if (!f) return Fail(ERROR_INVALID_HANDLE);
+    // Unbuffered I/O: sector-aligned buffer and length, as the console requires
+    if (f->noBuffering && ((((uintptr_t)buf) & 511) || (n & 511))) return Fail(ERROR_INVALID_PARAMETER);
+
+    if (ov){
+        const ULONGLONG off = ((ULONGLONG)ov->OffsetHigh << 32) | ov->Offset;
+        ov->Internal = ov->InternalHigh = 0;
+        if (f->overlapped){
+            IoReq r = { f->fd, buf, n, off, ov };
+            QueueRead(DriveOf(f->drive), r);
+            return Fail(ERROR_IO_PENDING);
+        }
+        const DWORD g = DoRead(f->drive, f->fd, buf, n, off);
+        ov->InternalHigh = g;
+        if (ov->hEvent) SetEvent(ov->hEvent);
+        if (got) *got = g;
+        return TRUE;
+    }
+
+    const DWORD g = DoRead(f->drive, f->fd, buf, n, f->pos);
+    f->pos += g;
+    if (got) *got = g;
+    t_lastError = NO_ERROR;
+    return TRUE;
+}
+
+BOOL WriteFile(HANDLE h, const void* buf, DWORD n, DWORD* put, LPOVERLAPPED ov){
+    Tally(HostFs::kWriteFile);
+    FileObj* f = AsFile(h);
+    if (put) *put = 0;
+    if (!f) return Fail(ERROR_INVALID_HANDLE);
+    if (!f->canWrite) return Fail(ERROR_ACCESS_DENIED);
+    const ULONGLONG off = ov ? (((ULONGLONG)ov->OffsetHigh << 32) | ov->Offset) : f->pos;
+
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        Fatx* fx = FatxOf(f->drive);
+        if (fx){
+            const DWORD before = fx->allocCalls;
+            if (!fx->Resize(f->host, off + n, true)) return Fail(ERROR_DISK_FULL);
+            allocCalls = fx->allocCalls - before;
+        }
+    }
+    ChargeAlloc(f->drive, allocCalls);
+
+    const char* src = (const char*)buf;
+    std::vector<char> bad;
+    if (f->corrupt && n){
+        bad.assign(src, src + n);
+        bad[n / 2] ^= 0x5A;
+        src = &bad[0];
+    }
+    const ssize_t w = pwrite(f->fd, src, n, (off_t)off);
+    if (w < 0) return Fail(ErrnoToWin(errno));
+    ChargeData(f->drive, (DWORD)w, true);
+    if (!ov) f->pos = off + (ULONGLONG)w;
+    if (put) *put = (DWORD)w;
+
+    CrashPoint(HostFs::kWriteFile);
+    t_lastError = NO_ERROR;
+    return TRUE;
+}
+
+BOOL GetOverlappedResult(HANDLE, LPOVERLAPPED ov, DWORD* got, BOOL wait){
+    if (!ov) return Fail(ERROR_INVALID_PARAMETER);
+    if (wait) WaitForSingleObject(ov->hEvent, INFINITE);
+    else if (WaitForSingleObject(ov->hEvent, 0) != WAIT_OBJECT_0) return Fail(ERROR_IO_INCOMPLETE);
+    __sync_synchronize();
+    if (got) *got = (DWORD)ov->InternalHigh;
+    if (ov->Internal) return Fail((DWORD)ov->Internal);
+    t_lastError = NO_ERROR;
+    return TRUE;
+}
+
+BOOL CloseHandle(HANDLE h){
+    Tally(HostFs::kCloseHandle);
+    Obj* o = (Obj*)h;
+    if (!o || h == INVALID_HANDLE_VALUE) return Fail(ERROR_INVALID_HANDLE);
+    switch (o->kind){
+    case kFileObj:   close(((FileObj*)o)->fd); delete (FileObj*)o; break;
+    case kFindObj:   delete (FindObj*)o; break;
+    case kEventObj:  delete (EventObj*)o; break;
+    case kThreadObj: ThreadRelease((ThreadObj*)o); break;
+    default:         return Fail(ERROR_INVALID_HANDLE);
+    }
+    return TRUE;
+}
+
+DWORD GetFileSize(HANDLE h, DWORD* hi){
+    Tally(HostFs::kGetFileSize);
+    FileObj* f = AsFile(h);
+    if (!f) { Fail(ERROR_INVALID_HANDLE); return 0xFFFFFFFFu; }
+    const ULONGLONG s = HostFileSize(f->fd);
+    if (hi) *hi = (DWORD)(s >> 32);
+    t_lastError = NO_ERROR;
+    return (DWORD)s;
+}
+
+DWORD SetFilePointer(HANDLE h, LONG lo, LONG* hi, DWORD how){
+    Tally(HostFs::kSetFilePointer);
+    FileObj* f = AsFile(h);
+    if (!f) { Fail(ERROR_INVALID_HANDLE); return INVALID_SET_FILE_POINTER; }
+    const LONGLONG dist = hi ? (LONGLONG)(((ULONGLONG)(DWORD)*hi << 32) | (DWORD)lo) : (LONGLONG)lo;
+    LONGLONG base = 0;
+    if (how == FILE_CURRENT)  base = (LONGLONG)f->pos;
+    else if (how == FILE_END) base = (LONGLONG)HostFileSize(f->fd);
+    const LONGLONG np = base + dist;
+    if (np < 0) { Fail(ERROR_NEGATIVE_SEEK); return INVALID_SET_FILE_POINTER; }
+    f->pos = (ULONGLONG)np;
+    if (hi) *hi = (LONG)(f->pos >> 32);
+    t_lastError = NO_ERROR;
+    return (DWORD)f->pos;
+}
+
+BOOL SetEndOfFile(HANDLE h){
+    Tally(HostFs::kSetEndOfFile);
+    FileObj* f = AsFile(h);
+    if (!f) return Fail(ERROR_INVALID_HANDLE);
+    if (!f->canWrite) return Fail(ERROR_ACCESS_DENIED);
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        Fatx* fx = FatxOf(f->drive);
+        if (fx){
+            const DWORD before = fx->allocCalls;
+            if (!fx->Resize(f->host, f->pos, false)) return Fail(ERROR_DISK_FULL);
+            allocCalls = fx->allocCalls - before;
+        }
+    }
+    ChargeAlloc(f->drive, allocCalls);
+    if (ftruncate(f->fd, (off_t)f->pos) != 0) return Fail(ErrnoToWin(errno));
+    t_lastError = NO_ERROR;
+    return TRUE;
+}
+
+BOOL FlushFileBuffers(HANDLE h){
+    return AsFile(h) ? TRUE : Fail(ERROR_INVALID_HANDLE);
+}
+
+DWORD GetFileAttributesA(LPCSTR path){
+    Tally(HostFs::kGetFileAttributes);
+    ChargeOp(DriveIndex(path));
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (!HostStat(host, st)) { Fail(MissingError(host)); return 0xFFFFFFFFu; }
+    return AttrOf(host, st);
+}
+
+BOOL GetFileAttributesExA(LPCSTR path, int, void* out){
+    Tally(HostFs::kGetFileAttributesEx);
+    ChargeOp(DriveIndex(path));
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (!HostStat(host, st)) return Fail(MissingError(host));
+    WIN32_FILE_ATTRIBUTE_DATA* d = (WIN32_FILE_ATTRIBUTE_DATA*)out;
+    memset(d, 0, sizeof(*d));
+    d->dwFileAttributes = AttrOf(host, st);
+    d->ftLastWriteTime  = ToFileTime(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    d->ftCreationTime   = d->ftLastWriteTime;
+    d->ftLastAccessTime = d->ftLastWriteTime;
+    if (!S_ISDIR(st.st_mode)){
+        d->nFileSizeLow  = (DWORD)st.st_size;
+        d->nFileSizeHigh = (DWORD)((ULONGLONG)st.st_size >> 32);
+    }
+    return TRUE;
+}
+
+BOOL SetFileAttributesA(LPCSTR path, DWORD attr){
+    Tally(HostFs::kSetFileAttributes);
+    const int idx = DriveIndex(path);
+    ChargeOp(idx);
+    if (ReadOnlyDrive(idx)) return Fail(ERROR_WRITE_PROTECT);
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (!HostStat(host, st)) return Fail(MissingError(host));
+    const DWORD keep = attr & (FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN |
+                               FILE_ATTRIBUTE_SYSTEM | FILE_ATTRIBUTE_ARCHIVE);
+    Lock l(g_lock);
+    if (keep) g_attr[host] = keep; else g_attr.erase(host);
+    return TRUE;
+}
+
+BOOL DeleteFileA(LPCSTR path){
+    Tally(HostFs::kDeleteFile);
+    const int idx = DriveIndex(path);
+    ChargeOp(idx);
+    if (ReadOnlyDrive(idx)) return Fail(ERROR_WRITE_PROTECT);
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (!HostStat(host, st)) return Fail(MissingError(host));
+    if (S_ISDIR(st.st_mode)) return Fail(ERROR_ACCESS_DENIED);
+    if (ExtraAttr(host) & FILE_ATTRIBUTE_READONLY) return Fail(ERROR_ACCESS_DENIED);
+    if (unlink(host.c_str()) != 0) return Fail(ErrnoToWin(errno));
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        g_attr.erase(host);
+        Fatx* f = FatxOf(idx);
+        if (f){
+            const DWORD before = f->allocCalls;
+            f->Forget(host);
+            f->EntryRemove(ParentOf(host));
+            allocCalls = f->allocCalls - before;
+        }
+    }
+    ChargeAlloc(idx, allocCalls);
+    CrashPoint(HostFs::kDeleteFile);
+    return TRUE;
+}
+
+BOOL CreateDirectoryA(LPCSTR path, void*){
+    Tally(HostFs::kCreateDirectory);
+    const int idx = DriveIndex(path);
+    ChargeOp(idx);
+    if (ReadOnlyDrive(idx)) return Fail(ERROR_WRITE_PROTECT);
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (HostStat(host, st)) return Fail(ERROR_ALREADY_EXISTS);
+    if (!HostStat(ParentOf(host), st) || !S_ISDIR(st.st_mode)) return Fail(ERROR_PATH_NOT_FOUND);
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        Fatx* f = FatxOf(idx);
+        if (f){
+            if (f->EntryGrowth(ParentOf(host)) + 1 > f->Free()) return Fail(ERROR_DISK_FULL);
+            const DWORD before = f->allocCalls;
+            f->EntryAdd(ParentOf(host));
+            f->slots[host] = 1;
+            f->Alloc(f->chain[host], 1);
+            allocCalls = f->allocCalls - before;
+        }
+    }
+    ChargeAlloc(idx, allocCalls);
+    if (mkdir(host.c_str(), 0755) != 0) return Fail(ErrnoToWin(errno));
+    return TRUE;
+}
+
+BOOL RemoveDirectoryA(LPCSTR path){
+    Tally(HostFs::kRemoveDirectory);
+    const int idx = DriveIndex(path);
+    ChargeOp(idx);
+    if (ReadOnlyDrive(idx)) return Fail(ERROR_WRITE_PROTECT);
+    const std::string host = HostPath(path);
+    struct stat st;
+    if (!HostStat(host, st)) return Fail(MissingError(host));
+    if (!S_ISDIR(st.st_mode)) return Fail(ERROR_PATH_NOT_FOUND);
+    if (ExtraAttr(host) & FILE_ATTRIBUTE_READONLY) return Fail(ERROR_ACCESS_DENIED);
+    if (rmdir(host.c_str()) != 0) return Fail(ErrnoToWin(errno));
+    DWORD allocCalls = 0;
+    {
+        Lock l(g_lock);
+        g_attr.erase(host);
+        Fatx* f = FatxOf(idx);
+        if (f){
+            const DWORD before = f->allocCalls;
+            f->Forget(host);
+            f->EntryRemove(ParentOf(host));
+            allocCalls = f->allocCalls - before;
+        }
+    }
+    ChargeAlloc(idx, allocCalls);
+    CrashPoint(HostFs::kRemoveDirectory);
+    return TRUE;
+}
+
+BOOL MoveFileA(LPCSTR from, LPCSTR to){
+    Tally(HostFs::kMoveFile);
+    const int si = DriveIndex(from), di = DriveIndex(to);
+    ChargeOp(si);
+    if (ReadOnlyDrive(si) || ReadOnlyDrive(di)) return Fail(ERROR_WRITE_PROTECT);
+    const std::string hf = HostPath(from), ht = HostPath(to);
+    struct stat st, ts;
+    if (!HostStat(hf, st)) return Fail(MissingError(hf));
+    if (HostStat(ht, ts)) return Fail(ERROR_ALREADY_EXISTS);
+    if (!HostStat(ParentOf(ht), ts) || !S_ISDIR(ts.st_mode)) return Fail(ERROR_PATH_NOT_FOUND);
+    if (si != di) return Fail(ERROR_NOT_SAME_DEVICE);   // only same-volume renames are modeled
+    {
+        Lock l(g_lock);
+        Fatx* f = FatxOf(si);
+        if (f && f->EntryGrowth(ParentOf(ht)) > f->Free()) return Fail(ERROR_DISK_FULL);
+    }
+    if (rename(hf.c_str(), ht.c_str()) != 0) return Fail(ErrnoToWin(errno));
+    Lock l(g_lock);
+    RekeyPrefix(g_attr, hf, ht);
+    Fatx* f = FatxOf(si);
+    if (f){
+        RekeyPrefix(f->chain, hf, ht);
+        RekeyPrefix(f->live,  hf, ht);
+        RekeyPrefix(f->slots, hf, ht);
+        f->EntryRemove(ParentOf(hf));
+        f->EntryAdd(ParentOf(ht));
+    }
+    return TRUE;
+}
+
+static void FillFind(const FindObj* fo, const std::string& name, WIN32_FIND_DATAA* fd){
+    memset(fd, 0, sizeof(*fd));
+    const std::string host = fo->dirHost + "/" + name;
+    struct stat st;
+    if (HostStat(host, st)){
+        fd->dwFileAttributes = AttrOf(host, st);
+        fd->ftLastWriteTime  = ToFileTime(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+        fd->ftCreationTime   = fd->ftLastWriteTime;
+        fd->ftLastAccessTime = fd->ftLastWriteTime;
+        if (!S_ISDIR(st.st_mode)){
+            fd->nFileSizeLow  = (DWORD)st.st_size;
+            fd->nFileSizeHigh = (DWORD)((ULONGLONG)st.st_size >> 32);
+        }
+    }
+    snprintf(fd->cFileName, sizeof(fd->cFileName), "%s", name.c_str());
+}
+
+HANDLE FindFirstFileA(LPCSTR pattern, WIN32_FIND_DATAA* fd){
+    Tally(HostFs::kFindFirstFile);
+    const int idx = DriveIndex(pattern);
+    ChargeOp(idx);
+    const char* slash = strrchr(pattern, '\\');
+    const std::string dir  = slash ? std::string(pattern, slash - pattern + 1) : std::string();
+    const std::string mask = slash ? std::string(slash + 1) : std::string(pattern);
+
+    FindObj* fo = new FindObj;
+    fo->dirHost = HostPath(dir.c_str());
+    fo->drive   = idx;
+    DIR* d = opendir(fo->dirHost.c_str());
+    if (!d){ const DWORD e = errno; delete fo; Fail(e == ENOENT || e == ENOTDIR ? ERROR_PATH_NOT_FOUND : ErrnoToWin(e)); return INVALID_HANDLE_VALUE; }
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL){
+        if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+        if (mask != "*" && mask != "*.*" && fnmatch(mask.c_str(), e->d_name, FNM_CASEFOLD) != 0) continue;
+        fo->names.push_back(e->d_name);
+    }
+    closedir(d);
+    if (fo->names.empty()){ delete fo; Fail(ERROR_FILE_NOT_FOUND); return INVALID_HANDLE_VALUE; }
+
+    Drive* dr = DriveOf(idx);
+    if (dr && dr->dev.entryUs) Charge(idx, dr->dev.entryUs);
+    FillFind(fo, fo->names[0], fd);
+    fo->next = 1;
+    return fo;
+}
+
+BOOL FindNextFileA(HANDLE h, WIN32_FIND_DATAA* fd){
+    Tally(HostFs::kFindNextFile);
+    Obj* o = (Obj*)h;
+    if (!o || h == INVALID_HANDLE_VALUE || o->kind != kFindObj) return Fail(ERROR_INVALID_HANDLE);
+    FindObj* fo = (FindObj*)o;
+    if (fo->next >= fo->names.size()) return Fail(ERROR_NO_MORE_FILES);
+    Drive* dr = DriveOf(fo->drive);
+    if (dr && dr->dev.entryUs) Charge(fo->drive, dr->dev.entryUs);
+    FillFind(fo, fo->names[fo->next++], fd);
+    return TRUE;
+}
+
+BOOL FindClose(HANDLE h){
+    Obj* o = (Obj*)h;
+    if (!o || h == INVALID_HANDLE_VALUE || o->kind != kFindObj) return Fail(ERROR_INVALID_HANDLE);
+    delete (FindObj*)o;
+    return TRUE;
+}
+
+BOOL GetDiskFreeSpaceExA(LPCSTR root, ULARGE_INTEGER* avail, ULARGE_INTEGER* total, ULARGE_INTEGER* freeB){
+    Tally(HostFs::kGetDiskFreeSpaceEx);
+    const int idx = DriveIndex(root);
+    ChargeOp(idx);
+    const std::string host = HostPath(root);
+    struct stat st;
+    if (idx < 0 || !HostStat(host, st)) return Fail(ERROR_PATH_NOT_FOUND);
+    ULONGLONG t = 0, f = 0;
+    {
+        Lock l(g_lock);
+        Fatx* fx = FatxOf(idx);
+        if (fx){ t = (ULONGLONG)fx->total * fx->cluster; f = (ULONGLONG)fx->Free() * fx->cluster; }
+    }
+    if (!t){
+        struct statvfs vs;
+        if (statvfs(host.c_str(), &vs) == 0){
+            t = (ULONGLONG)vs.f_blocks * vs.f_frsize;
+            f = (ULONGLONG)vs.f_bavail * vs.f_frsize;
+        }
+        if (ReadOnlyDrive(idx)) f = 0;
+    }
+    if (avail) avail->QuadPart = f;
+    if (total) total->QuadPart = t;
+    if (freeB) freeB->QuadPart = f;
+    return TRUE;
+}
+
+BOOL GetVolumeInformationA(LPCSTR root, LPSTR name, DWORD nameCap, DWORD* serial,
+                           DWORD* maxComp, DWORD* fsFlags, LPSTR fsName, DWORD fsNameCap){
+    Tally(HostFs::kGetVolumeInformation);
+    const int idx = DriveIndex(root);
+    ChargeOp(idx);
+    Drive* d = DriveOf(idx);
+    struct stat st;
+    if (!d || !HostStat(HostPath(root), st)) return Fail(ERROR_NOT_READY);
+    if (name && nameCap)     name[0] = 0;
+    if (serial)              *serial  = d->serial;
+    if (maxComp)             *maxComp = 42;
+    if (fsFlags)             *fsFlags = d->ro ? FILE_READ_ONLY_VOLUME : 0;
+    if (fsName && fsNameCap) { snprintf(fsName, fsNameCap, "%s", d->fsName); }
+    return TRUE;
+}
+
+DWORD XGetDiskClusterSize(LPCSTR root){
+    Tally(HostFs::kGetDiskClusterSize);
+    const int idx = DriveIndex(root);
+    Lock l(g_lock);
+    Fatx* f = FatxOf(idx);
+    return f ? f->cluster : 16384;
+}
+
+BOOL FileTimeToLocalFileTime(const FILETIME* utc, FILETIME* local){
+    *local = *utc;
+    return TRUE;
+}
+
+BOOL FileTimeToSystemTime(const FILETIME* ft, SYSTEMTIME* st){
+    const ULONGLONG t = ((ULONGLONG)ft->dwHighDateTime << 32) | ft->dwLowDateTime;
+    if (t < 116444736000000000ULL) return Fail(ERROR_INVALID_PARAMETER);
+    const time_t sec = (time_t)((t - 116444736000000000ULL) / 10000000ULL);
+    struct tm tm;
+    gmtime_r(&sec, &tm);
+    st->wYear = (WORD)(tm.tm_year + 1900); st->wMonth = (WORD)(tm.tm_mon + 1);
+    st->wDayOfWeek = (WORD)tm.tm_wday;     st->wDay = (WORD)tm.tm_mday;
+    st->wHour = (WORD)tm.tm_hour;          st->wMinute = (WORD)tm.tm_min;
+    st->wSecond = (WORD)tm.tm_sec;         st->wMilliseconds = (WORD)((t / 10000ULL) % 1000ULL);
+    return TRUE;
+}
+
+// ============================================================================
+// Threads / sync
+// ============================================================================
+
+DWORD GetLastError(){ return t_lastError; }
+void  SetLastError(DWORD err){ t_lastError = err; }
+
+DWORD GetTickCount(){ return (DWORD)(ULONGLONG)HostFs::NowMs(); }
+
+void Sleep(DWORD ms){
+    if (!ms) { sched_yield(); return; }
+    struct timespec ts; ts.tv_sec = ms / 1000; ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+HANDLE CreateThread(void*, DWORD, LPTHREAD_START_ROUTINE fn, LPVOID arg, DWORD, DWORD* id){
+    ThreadObj* t = new ThreadObj;
+    t->fn = fn; t->arg = arg;
+    if (pthread_create(&t->t, NULL, ThreadMain, t) != 0){ delete t; Fail(ERROR_NOT_ENOUGH_MEMORY); return NULL; }
+    pthread_detach(t->t);
+    if (id) *id = (DWORD)(uintptr_t)t;
+    return t;
+}
+
+BOOL SetThreadPriority(HANDLE, int){ return TRUE; }
+
+HANDLE CreateEvent(void*, BOOL manualReset, BOOL initial, LPCSTR){
+    return new EventObj(manualReset != 0, initial != 0);
+}
+
+static EventObj* AsEvent(HANDLE h){
+    Obj* o = (Obj*)h;
+    if (!o || h == INVALID_HANDLE_VALUE) return NULL;
+    if (o->kind == kEventObj)  return (EventObj*)o;
+    if (o->kind == kThreadObj) return &((ThreadObj*)o)->done;
+    return NULL;
+}
+
+BOOL SetEvent(HANDLE h){
+    EventObj* e = AsEvent(h);
+    if (!e) return Fail(ERROR_INVALID_HANDLE);
+    pthread_mutex_lock(&e->m);
+    e->sig = true;
+    if (e->manual) pthread_cond_broadcast(&e->c); else pthread_cond_signal(&e->c);
+    pthread_mutex_unlock(&e->m);
+    return TRUE;
+}
+
+HANDLE CreateSemaphore(void*, LONG initial, LONG maxCount, LPCSTR){
+    EventObj* e = new EventObj(false, initial > 0);
+    e->sem = true; e->count = initial; e->maxCount = maxCount;
+    return e;
+}
+
+BOOL ReleaseSemaphore(HANDLE h, LONG n, LONG* prev){
+    EventObj* e = AsEvent(h);
+    if (!e || !e->sem) return Fail(ERROR_INVALID_HANDLE);
+    pthread_mutex_lock(&e->m);
+    if (prev) *prev = e->count;
+    const bool ok = e->count + n <= e->maxCount;
+    if (ok){
+        e->count += n;
+        e->sig = true;
+        pthread_cond_broadcast(&e->c);
+    }
+    pthread_mutex_unlock(&e->m);
+    return ok ? TRUE : Fail(ERROR_INVALID_PARAMETER);
+}
+
+BOOL ResetEvent(HANDLE h){
+    EventObj* e = AsEvent(h);
+    if (!e) return Fail(ERROR_INVALID_HANDLE);
+    pthread_mutex_lock(&e->m);
+    e->sig = false;
+    pthread_mutex_unlock(&e->m);
+    return TRUE;
+}
+
+DWORD WaitForSingleObject(HANDLE h, DWORD ms){
+    EventObj* e = AsEvent(h);
+    if (!e) { Fail(ERROR_INVALID_HANDLE); return 0xFFFFFFFFu; }
+    struct timespec dl;
+    if (ms != INFINITE){
+        clock_gettime(CLOCK_REALTIME, &dl);
+        dl.tv_sec  += ms / 1000;
+        dl.tv_nsec += (long)(ms % 1000) * 1000000L;
+        if (dl.tv_nsec >= 1000000000L){ dl.tv_sec++; dl.tv_nsec -= 1000000000L; }
+    }
+    pthread_mutex_lock(&e->m);
+    while (!e->sig){
+        if (ms == INFINITE) pthread_cond_wait(&e->c, &e->m);
+        else if (pthread_cond_timedwait(&e->c, &e->m, &dl) == ETIMEDOUT) break;
+    }
+    const bool got = e->sig;
+    if (got && e->sem) e->sig = (--e->count > 0);
+    else if (got && !e->manual) e->sig = false;
+    pthread_mutex_unlock(&e->m);
+    return got ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+}
+
+void InitializeCriticalSection(CRITICAL_SECTION* cs){
+    pthread_mutexattr_t a;
+    pthread_mutexattr_init(&a);
+    pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_t* m = new pthread_mutex_t;
+    pthread_mutex_init(m, &a);
+    pthread_mutexattr_destroy(&a);
+    cs->impl = m;
+}
+
+void DeleteCriticalSection(CRITICAL_SECTION* cs){
+    pthread_mutex_t* m = (pthread_mutex_t*)cs->impl;
+    if (m){ pthread_mutex_destroy(m); delete m; }
+    cs->impl = NULL;
+}
+
+void EnterCriticalSection(CRITICAL_SECTION* cs){ pthread_mutex_lock((pthread_mutex_t*)cs->impl); }
+void LeaveCriticalSection(CRITICAL_SECTION* cs){ pthread_mutex_unlock((pthread_mutex_t*)cs->impl); }
+
+LONG InterlockedExchange(LONG volatile* p, LONG v){ return __sync_lock_test_and_set(p, v); }
+LONG InterlockedIncrement(LONG volatile* p){ return __sync_add_and_fetch(p, 1); }
+LONG InterlockedDecrement(LONG volatile* p){ return __sync_sub_and_fetch(p, 1); }
+LONG InterlockedCompareExchange(LONG volatile* p, LONG v, LONG cmp){ return __sync_val_compare_and_swap(p, cmp, v); }
+
+int MultiByteToWideChar(UINT, DWORD, LPCSTR s, int n, WCHAR* out, int cap){
+    if (n < 0) n = (int)strlen(s) + 1;
+    if (!out || !cap) return n;
+    int i = 0;
+    for (; i < n && i < cap; ++i) out[i] = (WCHAR)(unsigned char)s[i];
+    return i;
+}
+
+void OutputDebugStringA(LPCSTR s){
+    if (getenv("HOSTFS_DEBUG")) fputs(s, stderr);
+}
+
+int _stricmp(const char* a, const char* b){ return strcasecmp(a, b); }
+int _strnicmp(const char* a, const char* b, size_t n){ return strncasecmp(a, b, n); }
+
+// ============================================================================
+// XDK / kernel entry points the modules link against
+// ============================================================================
+
+DWORD XLaunchNewImageA(LPCSTR, PLAUNCH_DATA){ return ERROR_GEN_FAILURE; }
+
+extern "C" {
+LONG    IoCreateSymbolicLink(void*, void*)            { return 0; }
+LONG    IoDeleteSymbolicLink(void*)                   { return 0; }
+LONG    IoDismountVolumeByName(void*)                 { return 0; }
+VOID    HalReadSMCTrayState(DWORD* state, DWORD* count){ if (state) *state = 0x60; if (count) *count = 0; }
+BOOLEAN HalWriteSMBusValue(UCHAR, UCHAR, BOOLEAN, UCHAR){ return 0; }
+BOOL    XapiFormatFATVolumeEx(void*, ULONG)           { return FALSE; }
+}
@@ -0,0 +1,224 @@
+#ifndef HOST_XTL_H
+#define HOST_XTL_H
+/*
+============================================================================
+ xtl.h (host shim)
+  - The slice of the XDK / Win32 API the file modules use, declared for a
+    POSIX host so FsUtil, Listing, SearchIndex, ... build unchanged for the
+    tests and benchmarks under tests/host.
+  - Win32 widths: DWORD / LONG are 32-bit as on the console.
+  - Implemented over the host file system in HostWin32.cpp; drive letters
+    map to folders below HostFs::Root() (see HostFs.h).
+============================================================================
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+
+#define __stdcall
+#define __cdecl
+#define WINAPI
+#define VOID void
+
+typedef uint32_t            DWORD;
+typedef int32_t             LONG;
+typedef uint32_t            ULONG;
+typedef int                 BOOL;
+typedef unsigned char       BYTE;
+typedef unsigned short      WORD;
+typedef unsigned short      USHORT;
+typedef unsigned char       UCHAR;
+typedef unsigned char       BOOLEAN;
+typedef unsigned int        UINT;
+typedef char                CHAR;
+typedef char*               PCHAR;
+typedef float               FLOAT;
+typedef wchar_t             WCHAR;
+typedef unsigned long long  ULONGLONG;
+typedef long long           LONGLONG;
+typedef void*               HANDLE;
+typedef void*               LPVOID;
+typedef const void*         LPCVOID;
+typedef void*               HLOCAL;
+typedef DWORD*              LPDWORD;
+typedef const char*         LPCSTR;
+typedef char*               LPSTR;
+typedef long                HRESULT;
+typedef void*               PLAUNCH_DATA;
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+
+#define TRUE  1
+#define FALSE 0
+#define S_OK  0
+#define SUCCEEDED(x) ((HRESULT)(x) >= 0)
+#define FAILED(x)    ((HRESULT)(x) <  0)
+#define MAX_PATH 260
+#define INFINITE 0xFFFFFFFFu
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+
+#define WAIT_OBJECT_0 0
+#define WAIT_TIMEOUT  258
+
+#define GENERIC_READ    0x80000000u
+#define GENERIC_WRITE   0x40000000u
+#define FILE_SHARE_READ  1
+#define FILE_SHARE_WRITE 2
+#define CREATE_NEW    1
+#define CREATE_ALWAYS 2
+#define OPEN_EXISTING 3
+#define OPEN_ALWAYS   4
+#define FILE_BEGIN   0
+#define FILE_CURRENT 1
+#define FILE_END     2
+#define INVALID_SET_FILE_POINTER 0xFFFFFFFFu
+
+#define FILE_ATTRIBUTE_READONLY  0x01
+#define FILE_ATTRIBUTE_HIDDEN    0x02
+#define FILE_ATTRIBUTE_SYSTEM    0x04
+#define FILE_ATTRIBUTE_DIRECTORY 0x10
+#define FILE_ATTRIBUTE_ARCHIVE   0x20
+#define FILE_ATTRIBUTE_NORMAL    0x80
+#define FILE_ATTRIBUTE_TEMPORARY 0x100
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000u
+#define FILE_FLAG_NO_BUFFERING    0x20000000u
+#define FILE_FLAG_OVERLAPPED      0x40000000u
+#define FILE_FLAG_WRITE_THROUGH   0x80000000u
+
+#define LMEM_FIXED    0
+#define LMEM_ZEROINIT 0x40
+#define LPTR          0x40
+#define MEM_COMMIT     0x1000
+#define MEM_RELEASE    0x8000
+#define PAGE_READWRITE 0x04
+
+#define NO_ERROR                   0
+#define ERROR_SUCCESS              0
+#define ERROR_FILE_NOT_FOUND       2
+#define ERROR_PATH_NOT_FOUND       3
+#define ERROR_ACCESS_DENIED        5
+#define ERROR_INVALID_HANDLE       6
+#define ERROR_NOT_ENOUGH_MEMORY    8
+#define ERROR_INVALID_DATA         13
+#define ERROR_NO_MORE_FILES        18
+#define ERROR_WRITE_PROTECT        19
+#define ERROR_NOT_READY            21
+#define ERROR_CRC                  23
+#define ERROR_READ_FAULT           30
+#define ERROR_GEN_FAILURE          31
+#define ERROR_HANDLE_EOF           38
+#define ERROR_INVALID_PARAMETER    87
+#define ERROR_OPEN_FAILED          110
+#define ERROR_DISK_FULL            112
+#define ERROR_DIR_NOT_EMPTY        145
+#define ERROR_BUSY                 170
+#define ERROR_ALREADY_EXISTS       183
+#define ERROR_FILENAME_EXCED_RANGE 206
+#define ERROR_OPERATION_ABORTED    995
+#define ERROR_IO_PENDING           997
+#define ERROR_CANCELLED            1223
+
+#define THREAD_PRIORITY_IDLE         -15
+#define THREAD_PRIORITY_LOWEST       -2
+#define THREAD_PRIORITY_BELOW_NORMAL -1
+#define THREAD_PRIORITY_NORMAL        0
+#define CREATE_SUSPENDED 4
+#define CP_ACP 0
+
+typedef struct { DWORD dwLowDateTime, dwHighDateTime; } FILETIME;
+typedef struct { WORD wYear, wMonth, wDayOfWeek, wDay, wHour, wMinute, wSecond, wMilliseconds; } SYSTEMTIME;
+typedef struct {
+    DWORD    dwFileAttributes;
+    FILETIME ftCreationTime, ftLastAccessTime, ftLastWriteTime;
+    DWORD    nFileSizeHigh, nFileSizeLow;
+    DWORD    dwReserved0, dwReserved1;
+    char     cFileName[MAX_PATH];
+    char     cAlternateFileName[14];
+} WIN32_FIND_DATAA, WIN32_FIND_DATA;
+typedef struct {
+    DWORD    dwFileAttributes;
+    FILETIME ftCreationTime, ftLastAccessTime, ftLastWriteTime;
+    DWORD    nFileSizeHigh, nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+enum { GetFileExInfoStandard };
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; ULONGLONG QuadPart; } ULARGE_INTEGER;
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; LONGLONG  QuadPart; } LARGE_INTEGER;
+typedef struct { uintptr_t Internal, InternalHigh; DWORD Offset, OffsetHigh; HANDLE hEvent; } OVERLAPPED, *LPOVERLAPPED;
+typedef struct { void* impl; } CRITICAL_SECTION;
+
+// ---- memory ----------------------------------------------------------------
+void   ZeroMemory(void* p, size_t n);
+#define CopyMemory memcpy
+#define FillMemory(d,n,c) memset(d,c,n)
+HLOCAL LocalAlloc(UINT flags, size_t n);
+HLOCAL LocalFree(HLOCAL p);
+LPVOID VirtualAlloc(LPVOID at, size_t n, DWORD type, DWORD protect);
+BOOL   VirtualFree(LPVOID p, size_t n, DWORD type);
+
+// ---- files -----------------------------------------------------------------
+HANDLE CreateFileA(LPCSTR path, DWORD access, DWORD share, void* sa, DWORD disp, DWORD flags, HANDLE tmpl);
+BOOL   ReadFile(HANDLE h, void* buf, DWORD n, DWORD* got, LPOVERLAPPED ov);
+BOOL   WriteFile(HANDLE h, const void* buf, DWORD n, DWORD* put, LPOVERLAPPED ov);
+BOOL   GetOverlappedResult(HANDLE h, LPOVERLAPPED ov, DWORD* got, BOOL wait);
+BOOL   CloseHandle(HANDLE h);
+DWORD  GetFileSize(HANDLE h, DWORD* hi);
+DWORD  SetFilePointer(HANDLE h, LONG lo, LONG* hi, DWORD how);
+BOOL   SetEndOfFile(HANDLE h);
+BOOL   FlushFileBuffers(HANDLE h);
+DWORD  GetFileAttributesA(LPCSTR path);
+BOOL   GetFileAttributesExA(LPCSTR path, int level, void* out);
+BOOL   SetFileAttributesA(LPCSTR path, DWORD attr);
+BOOL   DeleteFileA(LPCSTR path);
+BOOL   CreateDirectoryA(LPCSTR path, void* sa);
+BOOL   RemoveDirectoryA(LPCSTR path);
+BOOL   MoveFileA(LPCSTR from, LPCSTR to);
+HANDLE FindFirstFileA(LPCSTR pattern, WIN32_FIND_DATAA* fd);
+BOOL   FindNextFileA(HANDLE h, WIN32_FIND_DATAA* fd);
+BOOL   FindClose(HANDLE h);
+BOOL   GetDiskFreeSpaceExA(LPCSTR root, ULARGE_INTEGER* availToCaller, ULARGE_INTEGER* total, ULARGE_INTEGER* freeBytes);
+BOOL   GetVolumeInformationA(LPCSTR root, LPSTR name, DWORD nameCap, DWORD* serial,
+                             DWORD* maxComp, DWORD* fsFlags, LPSTR fsName, DWORD fsNameCap);
+BOOL   FileTimeToLocalFileTime(const FILETIME* utc, FILETIME* local);
+BOOL   FileTimeToSystemTime(const FILETIME* ft, SYSTEMTIME* st);
+DWORD  XGetDiskClusterSize(LPCSTR root);
+#define CreateFile      CreateFileA
+#define CreateDirectory CreateDirectoryA
+
+// ---- threads / sync --------------------------------------------------------
+DWORD  GetLastError();
+void   SetLastError(DWORD err);
+DWORD  GetTickCount();
+void   Sleep(DWORD ms);
+HANDLE CreateThread(void* sa, DWORD stack, LPTHREAD_START_ROUTINE fn, LPVOID arg, DWORD flags, DWORD* id);
+BOOL   SetThreadPriority(HANDLE h, int prio);
+HANDLE CreateEvent(void* sa, BOOL manualReset, BOOL initial, LPCSTR name);
+BOOL   SetEvent(HANDLE h);
+BOOL   ResetEvent(HANDLE h);
+HANDLE CreateSemaphore(void* sa, LONG initial, LONG maxCount, LPCSTR name);
+BOOL   ReleaseSemaphore(HANDLE h, LONG n, LONG* prev);
+DWORD  WaitForSingleObject(HANDLE h, DWORD ms);
+void   InitializeCriticalSection(CRITICAL_SECTION* cs);
+void   DeleteCriticalSection(CRITICAL_SECTION* cs);
+void   EnterCriticalSection(CRITICAL_SECTION* cs);
+void   LeaveCriticalSection(CRITICAL_SECTION* cs);
+LONG   InterlockedExchange(LONG volatile* p, LONG v);
+LONG   InterlockedIncrement(LONG volatile* p);
+LONG   InterlockedDecrement(LONG volatile* p);
+LONG   InterlockedCompareExchange(LONG volatile* p, LONG v, LONG cmp);
+int    MultiByteToWideChar(UINT cp, DWORD flags, LPCSTR s, int n, WCHAR* out, int cap);
+void   OutputDebugStringA(LPCSTR s);
+
+// ---- CRT names -------------------------------------------------------------
+#define _snprintf  snprintf
+#define _vsnprintf vsnprintf
+int    _stricmp(const char* a, const char* b);
+int    _strnicmp(const char* a, const char* b, size_t n);
+
+// ---- XDK -------------------------------------------------------------------
+DWORD  XLaunchNewImageA(LPCSTR path, PLAUNCH_DATA data);
+
+#endif // HOST_XTL_H